@@ -0,0 +1,1002 @@
+/*******************************************************************************
+ * FILENAME: HexDumpDisplay.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has a binary display processor that shows the data as
+ *    'hexdump -C' style rows.  Each row has the offset, the hex bytes, and
+ *    an ASCII column:
+ *
+ *      00000000  48 65 6C 6C 6F 20 57 6F  72 6C 64 0D 0A 00 01 02  |Hello World.....|
+ *
+ *    Rows are built in a buffer using lookup tables and sent with one
+ *    BinaryAddText() call per row (instead of a BinaryAddHex() call per
+ *    byte).
+ *
+ *    A row that isn't full yet is carried over to the next bytes (the rows
+ *    are always the same no matter how the bytes are split up).  The hex
+ *    for the bytes we have is still shown right away, the ASCII column and
+ *    the end of the line are added when the row fills (or the direction
+ *    changes).
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "HexDumpDisplay.h"
+#include "PluginSDK/Plugin.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+
+/*** DEFINES                  ***/
+#define REGISTER_PLUGIN_FUNCTION_PRIV_NAME      HexDumpDisplay // The name to append on the RegisterPlugin() function for built in version
+#define NEEDED_MIN_API_VERSION                  0x01010000
+#define HDD_DEFAULT_ROW_WIDTH                   16
+#define HDD_MAX_ROW_WIDTH                       64
+#define HDD_DEFAULT_GROUP                       8
+/* 16 offset digits + 2 spaces, 3 chars per byte + 1 group space per byte,
+   then " |" + the ASCII column + "|\n" + '\0' */
+#define HDD_MAX_LINE_LEN                        (16+2+HDD_MAX_ROW_WIDTH*4+2+HDD_MAX_ROW_WIDTH+3)
+/* On the byte path a part filled row is only shown if it's bytes have been
+   waiting this long, or the byte came in after a gap this long */
+#define HDD_PARTIAL_ROW_NS                      (10*1000*1000)
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+typedef enum
+{
+    e_HDD_Dir_Rx,
+    e_HDD_Dir_Tx,
+    e_HDD_DirMAX
+} e_HDD_DirType;
+
+/* The row we are filling for one direction */
+struct HexDumpDisplay_Row
+{
+    uint64_t Offset;                        // Offset of Bytes[0] in the stream
+    uint32_t Fill;                          // How many bytes are in 'Bytes'
+    uint32_t Shown;                         // How many are already on the screen
+    uint8_t Bytes[HDD_MAX_ROW_WIDTH];
+};
+
+struct HexDumpDisplayData
+{
+    unsigned int RowWidth;                  // Bytes per row
+    unsigned int Group;                     // Extra space every this many bytes (0=none)
+    bool ShowASCII;
+    bool ShowTx;
+    uint32_t FGColor[e_HDD_DirMAX];
+    uint32_t BGColor;
+    struct HexDumpDisplay_Row Rows[e_HDD_DirMAX];
+    e_HDD_DirType LastDir;                  // The direction of the last bytes
+    e_HDD_DirType StyleDir;                 // The colors that were last sent (e_HDD_DirMAX=none)
+    uint64_t LastByteNS;                    // When the last byte came in on the byte path
+    uint64_t PendingNS;                     // When the first Rx byte not shown yet came in
+    char Line[HDD_MAX_LINE_LEN];            // The row being built
+};
+
+struct HexDumpDisplay_SettingsWidgets
+{
+    t_WidgetSysHandle *WidgetHandle;
+    struct PI_NumberInput *RowWidth;
+    struct PI_NumberInput *Group;
+    struct PI_Checkbox *ShowASCII;
+    struct PI_Checkbox *ShowTx;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+const struct DataProcessorInfo *HexDumpDisplay_GetProcessorInfo(
+        unsigned int *SizeOfInfo);
+static void HexDumpDisplay_ProcessIncomingBinaryByte(
+        t_DataProcessorHandleType *DataHandle,const uint8_t Byte);
+static void HexDumpDisplay_ProcessIncomingBinaryBlock(
+        t_DataProcessorHandleType *DataHandle,const uint8_t *RxData,int Bytes);
+static void HexDumpDisplay_ProcessOutGoingData(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *TxData,int Bytes);
+static t_DataProSettingsWidgetsType *HexDumpDisplay_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
+static void HexDumpDisplay_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
+static void HexDumpDisplay_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings);
+static void HexDumpDisplay_ApplySettings(t_DataProcessorHandleType *DataHandle,
+        t_PIKVList *Settings);
+static t_DataProcessorHandleType *HexDumpDisplay_AllocateData(void);
+static void HexDumpDisplay_FreeData(t_DataProcessorHandleType *DataHandle);
+static void HexDumpDisplay_InitLookupTables(void);
+static void HexDumpDisplay_GetSettings(t_PIKVList *Settings,
+        unsigned int *RowWidth,unsigned int *Group,bool *ShowASCII,
+        bool *ShowTx);
+static unsigned int HexDumpDisplay_GrabNumber(t_PIKVList *Settings,
+        const char *Key,unsigned int Min,unsigned int Max,
+        unsigned int DefaultValue);
+static void HexDumpDisplay_AddBytes(struct HexDumpDisplayData *Data,
+        e_HDD_DirType Dir,const uint8_t *Bytes,uint32_t Len,bool ShowPartial);
+static void HexDumpDisplay_ShowRow(struct HexDumpDisplayData *Data,
+        e_HDD_DirType Dir,bool EndRow);
+
+/*** VARIABLE DEFINITIONS     ***/
+struct DataProcessorAPI m_HexDumpDisplayCBs=
+{
+    HexDumpDisplay_AllocateData,
+    HexDumpDisplay_FreeData,
+    HexDumpDisplay_GetProcessorInfo,        // GetProcessorInfo
+    NULL,                                   // ProcessKeyPress
+    NULL,                                   // ProcessIncomingTextByte
+    HexDumpDisplay_ProcessIncomingBinaryByte,   // ProcessIncomingBinaryByte
+    /* V2 */
+    HexDumpDisplay_ProcessOutGoingData,
+    HexDumpDisplay_AllocSettingsWidgets,
+    HexDumpDisplay_FreeSettingsWidgets,
+    HexDumpDisplay_SetSettingsFromWidgets,
+    HexDumpDisplay_ApplySettings,
+    /* V4 */
+    NULL,                                   // ProcessIncomingTextBlock
+    HexDumpDisplay_ProcessIncomingBinaryBlock,  // ProcessIncomingBinaryBlock
+};
+
+struct DataProcessorInfo m_HexDumpDisplay_Info=
+{
+    "Hex Dump Display Processor",
+    "Shows binary data as hexdump -C style rows",
+    "Shows the incoming (and outgoing) bytes as rows with the offset, the "
+    "bytes in hex, and an ASCII column (like 'hexdump -C').  The number of "
+    "bytes per row and how they are grouped can be set in the settings.",
+    e_DataProcessorType_Binary,
+    {
+        .BinClass=e_BinaryDataProcessorClass_Decoder,
+    },
+    e_BinaryDataProcessorMode_Text
+};
+
+static const struct PI_SystemAPI *m_HDD_SysAPI;
+static const struct DPS_API *m_HDD_DPS;
+static const struct PI_UIAPI *m_HDD_UIAPI;
+
+/* Byte to 2 hex digits and byte to what we show in the ASCII column */
+static char m_HDD_HexLUT[256][2];
+static char m_HDD_ASCIILUT[256];
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_RegisterPlugin
+ *
+ * SYNOPSIS:
+ *    unsigned int HexDumpDisplay_RegisterPlugin(const struct PI_SystemAPI *SysAPI,
+ *          unsigned int Version);
+ *
+ * PARAMETERS:
+ *    SysAPI [I] -- The main API to WhippyTerm
+ *    Version [I] -- What version of WhippyTerm is running.  This is used
+ *                   to make sure we are compatible.  This is in the
+ *                   Major<<24 | Minor<<16 | Rev<<8 | Patch format
+ *
+ * FUNCTION:
+ *    This function registers this plugin with the system.
+ *
+ * RETURNS:
+ *    0 if we support this version of WhippyTerm, and the minimum version
+ *    we need if we are not.
+ *
+ * NOTES:
+ *    This function is normally is called from the RegisterPlugin() when
+ *    it is being used as a normal plugin.  As a std plugin it is called
+ *    from RegisterStdPlugins() instead.
+ *
+ * SEE ALSO:
+ *
+ ******************************************************************************/
+/* This needs to be extern "C" because it is the main entry point for the
+   plugin system */
+extern "C"
+{
+    unsigned int REGISTER_PLUGIN_FUNCTION(const struct PI_SystemAPI *SysAPI,
+            unsigned int Version)
+    {
+        if(Version<NEEDED_MIN_API_VERSION)
+            return NEEDED_MIN_API_VERSION;
+
+        m_HDD_SysAPI=SysAPI;
+        m_HDD_DPS=SysAPI->GetAPI_DataProcessors();
+        m_HDD_UIAPI=m_HDD_DPS->GetAPI_UI();
+
+        /* If we are have the correct experimental API */
+        if(SysAPI->GetExperimentalID()>0 &&
+                SysAPI->GetExperimentalID()<1)
+        {
+            return 0xFFFFFFFF;
+        }
+
+        HexDumpDisplay_InitLookupTables();
+
+        m_HDD_DPS->RegisterDataProcessor("HexDumpDisplay",
+                &m_HexDumpDisplayCBs,sizeof(m_HexDumpDisplayCBs));
+
+        return 0;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    AllocateData
+ *
+ * SYNOPSIS:
+ *    t_DataProcessorHandleType *AllocateData(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function allocates any needed data for this data processor.
+ *
+ * NOTES:
+ *    You can not use most of the API 'DPS_API' because there is no connection
+ *    when AllocateData() is called.
+ *
+ * RETURNS:
+ *   A pointer to the data, NULL if there was an error.
+ ******************************************************************************/
+static t_DataProcessorHandleType *HexDumpDisplay_AllocateData(void)
+{
+    struct HexDumpDisplayData *Data;
+    unsigned int r;
+
+    Data=(struct HexDumpDisplayData *)malloc(sizeof(struct HexDumpDisplayData));
+    if(Data==NULL)
+        return NULL;
+
+    /* Set some defaults, these will be overriden by
+       HexDumpDisplay_ApplySettings() */
+    Data->RowWidth=HDD_DEFAULT_ROW_WIDTH;
+    Data->Group=HDD_DEFAULT_GROUP;
+    Data->ShowASCII=true;
+    Data->ShowTx=true;
+    Data->FGColor[e_HDD_Dir_Rx]=0xFFFFFF;
+    Data->FGColor[e_HDD_Dir_Tx]=0xFF0000;
+    Data->BGColor=0x000000;
+
+    for(r=0;r<e_HDD_DirMAX;r++)
+    {
+        Data->Rows[r].Offset=0;
+        Data->Rows[r].Fill=0;
+        Data->Rows[r].Shown=0;
+    }
+    Data->LastDir=e_HDD_Dir_Rx;
+    Data->StyleDir=e_HDD_DirMAX;
+    Data->LastByteNS=0;
+    Data->PendingNS=0;
+
+    return (t_DataProcessorHandleType *)Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    FreeData
+ *
+ * SYNOPSIS:
+ *    void FreeData(t_DataProcessorHandleType *DataHandle);
+ *
+ * PARAMETERS:
+ *    DataHandle [I] -- The data handle to free.  This will need to be
+ *                      case to your internal data type before you use it.
+ *
+ * FUNCTION:
+ *    This function frees the memory allocated with AllocateData().
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HexDumpDisplay_FreeData(t_DataProcessorHandleType *DataHandle)
+{
+    struct HexDumpDisplayData *Data=(struct HexDumpDisplayData *)DataHandle;
+
+    free(Data);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_GetProcessorInfo
+ *
+ * SYNOPSIS:
+ *    const struct DataProcessorInfo *HexDumpDisplay_GetProcessorInfo(
+ *              unsigned int *SizeOfInfo);
+ *
+ * PARAMETERS:
+ *    SizeOfInfo [O] -- The size of 'struct DataProcessorInfo'.  This is used
+ *                        for forward / backward compatibility.
+ *
+ * FUNCTION:
+ *    This function gets info about the plugin.
+ *
+ * RETURNS:
+ *    The info about this plugin.
+ *
+ * SEE ALSO:
+ *
+ ******************************************************************************/
+const struct DataProcessorInfo *HexDumpDisplay_GetProcessorInfo(
+        unsigned int *SizeOfInfo)
+{
+    *SizeOfInfo=sizeof(struct DataProcessorInfo);
+    return &m_HexDumpDisplay_Info;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ProcessIncomingBinaryByte
+ *
+ * SYNOPSIS:
+ *    void ProcessIncomingBinaryByte(t_DataProcessorHandleType *DataHandle,
+ *          const uint8_t Byte);
+ *
+ * PARAMETERS:
+ *      DataHandle [I] -- The data handle to work on.  This is your internal
+ *                        data.
+ *      Byte [I] -- This is the byte that came in.
+ *
+ * FUNCTION:
+ *      This function is called for each byte that comes in if you are a
+ *      'e_DataProcessorType_Binary' type of processor.
+ *
+ *      The byte is added to the row the same as the block version, but
+ *      we don't get told where a read ends so a row that isn't full yet is
+ *      only shown if the byte came after a gap (someone typing) or the
+ *      bytes in it have been waiting HDD_PARTIAL_ROW_NS.  Otherwise a burst
+ *      would cost a BinaryAddText() call for every byte.
+ *
+ *      There is no idle call so the end of a burst that doesn't fill a row
+ *      shows up with the next byte after the timeout, or when the
+ *      direction changes.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    BinaryAddText()
+ ******************************************************************************/
+static void HexDumpDisplay_ProcessIncomingBinaryByte(
+        t_DataProcessorHandleType *DataHandle,const uint8_t Byte)
+{
+    struct HexDumpDisplayData *Data=(struct HexDumpDisplayData *)DataHandle;
+    struct HexDumpDisplay_Row *Row;
+    uint64_t Now;
+    bool ShowPartial;
+
+    Now=std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    Row=&Data->Rows[e_HDD_Dir_Rx];
+    if(Data->LastDir!=e_HDD_Dir_Rx || Row->Fill==Row->Shown ||
+            Row->Fill>=Data->RowWidth)
+    {
+        /* This byte starts a new lot of bytes that are waiting */
+        Data->PendingNS=Now;
+    }
+
+    ShowPartial=(Now-Data->LastByteNS>=HDD_PARTIAL_ROW_NS ||
+            Now-Data->PendingNS>=HDD_PARTIAL_ROW_NS);
+    Data->LastByteNS=Now;
+
+    HexDumpDisplay_AddBytes(Data,e_HDD_Dir_Rx,&Byte,1,ShowPartial);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ProcessIncomingBinaryBlock
+ *
+ * SYNOPSIS:
+ *    void ProcessIncomingBinaryBlock(t_DataProcessorHandleType *DataHandle,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *      DataHandle [I] -- The data handle to work on.  This is your internal
+ *                        data.
+ *      Data [I] -- This is the block of bytes that came in.
+ *      Bytes [I] -- The number of bytes in the 'Data' block.
+ *
+ * FUNCTION:
+ *      This function is called for each block of bytes that comes in if you
+ *      are a 'e_DataProcessorType_Binary' type of processor.  It is used in
+ *      place of ProcessIncomingBinaryByte() when the system supports it.
+ *
+ *      The last (short) row of the block is carried over to the next block
+ *      (but it's hex is shown right away so nothing is held back).
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    ProcessIncomingBinaryByte()
+ ******************************************************************************/
+static void HexDumpDisplay_ProcessIncomingBinaryBlock(
+        t_DataProcessorHandleType *DataHandle,const uint8_t *RxData,int Bytes)
+{
+    struct HexDumpDisplayData *Data=(struct HexDumpDisplayData *)DataHandle;
+
+    if(Bytes<=0)
+        return;
+
+    HexDumpDisplay_AddBytes(Data,e_HDD_Dir_Rx,RxData,Bytes,true);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ProcessOutGoingData
+ *
+ * SYNOPSIS:
+ *    void ProcessOutGoingData(t_DataProcessorHandleType *DataHandle,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *      DataHandle [I] -- The data handle to work on.  This is your internal
+ *                        data.
+ *      Data [I] -- This is the block of data that is about to be sent
+ *      Bytes [I] -- The number of bytes in the 'Data' block.
+ *
+ * FUNCTION:
+ *      This function is called for block of data being send to a IO driver.
+ *      The outgoing bytes get their own rows (and offsets) in a different
+ *      color.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    ProcessKeyPress()
+ ******************************************************************************/
+static void HexDumpDisplay_ProcessOutGoingData(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *TxData,int Bytes)
+{
+    struct HexDumpDisplayData *Data=(struct HexDumpDisplayData *)DataHandle;
+
+    if(!Data->ShowTx || Bytes<=0)
+        return;
+
+    HexDumpDisplay_AddBytes(Data,e_HDD_Dir_Tx,TxData,Bytes,true);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    AllocSettingsWidgets
+ *
+ * SYNOPSIS:
+ *    t_DataProSettingsWidgetsType *AllocSettingsWidgets(
+ *              t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
+ *
+ * PARAMETERS:
+ *    WidgetHandle [I] -- The handle to add new widgets to
+ *    Settings [I] -- The current settings.  This is a standard key/value
+ *                    list.
+ *
+ * FUNCTION:
+ *    This function is called when the user presses the "Settings" button
+ *    to change any settings for this plugin (in the settings dialog).
+ *
+ * RETURNS:
+ *    The private settings data that you want to use, NULL if there was an
+ *    error.
+ *
+ * SEE ALSO:
+ *    FreeSettingsWidgets(), SetCurrentSettingsTabName(), AddNewSettingsTab()
+ ******************************************************************************/
+t_DataProSettingsWidgetsType *HexDumpDisplay_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings)
+{
+    struct HexDumpDisplay_SettingsWidgets *WData;
+    unsigned int RowWidth;
+    unsigned int Group;
+    bool ShowASCII;
+    bool ShowTx;
+
+    WData=NULL;
+    try
+    {
+        WData=new HexDumpDisplay_SettingsWidgets;
+
+        /* Zero everything */
+        WData->WidgetHandle=WidgetHandle;
+        WData->RowWidth=NULL;
+        WData->Group=NULL;
+        WData->ShowASCII=NULL;
+        WData->ShowTx=NULL;
+
+        m_HDD_DPS->SetCurrentSettingsTabName("Hex Dump");
+
+        WData->RowWidth=m_HDD_UIAPI->AddNumberInput(WidgetHandle,
+                "Bytes per row",NULL,NULL);
+        if(WData->RowWidth==NULL)
+            throw(0);
+        m_HDD_UIAPI->SetNumberInputMinMax(WidgetHandle,WData->RowWidth->Ctrl,
+                1,HDD_MAX_ROW_WIDTH);
+
+        WData->Group=m_HDD_UIAPI->AddNumberInput(WidgetHandle,
+                "Add a space every (bytes, 0 = never)",NULL,NULL);
+        if(WData->Group==NULL)
+            throw(0);
+        m_HDD_UIAPI->SetNumberInputMinMax(WidgetHandle,WData->Group->Ctrl,
+                0,HDD_MAX_ROW_WIDTH);
+
+        WData->ShowASCII=m_HDD_UIAPI->AddCheckbox(WidgetHandle,
+                "Show ASCII column",NULL,NULL);
+        if(WData->ShowASCII==NULL)
+            throw(0);
+
+        WData->ShowTx=m_HDD_UIAPI->AddCheckbox(WidgetHandle,
+                "Show outgoing (Tx) bytes",NULL,NULL);
+        if(WData->ShowTx==NULL)
+            throw(0);
+
+        /* Set widgets to stored settings */
+        HexDumpDisplay_GetSettings(Settings,&RowWidth,&Group,&ShowASCII,
+                &ShowTx);
+
+        m_HDD_UIAPI->SetNumberInputValue(WidgetHandle,WData->RowWidth->Ctrl,
+                RowWidth);
+        m_HDD_UIAPI->SetNumberInputValue(WidgetHandle,WData->Group->Ctrl,
+                Group);
+        m_HDD_UIAPI->SetCheckboxChecked(WidgetHandle,WData->ShowASCII->Ctrl,
+                ShowASCII);
+        m_HDD_UIAPI->SetCheckboxChecked(WidgetHandle,WData->ShowTx->Ctrl,
+                ShowTx);
+    }
+    catch(...)
+    {
+        if(WData!=NULL)
+        {
+            HexDumpDisplay_FreeSettingsWidgets(
+                    (t_DataProSettingsWidgetsType *)WData);
+        }
+        return NULL;
+    }
+
+    return (t_DataProSettingsWidgetsType *)WData;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    FreeSettingsWidgets
+ *
+ * SYNOPSIS:
+ *    void FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
+ *
+ * PARAMETERS:
+ *    PrivData [I] -- The private data to free
+ *
+ * FUNCTION:
+ *      This function is called when the system frees the settings widets.
+ *      It should free any private data you allocated in AllocSettingsWidgets().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    AllocSettingsWidgets()
+ ******************************************************************************/
+void HexDumpDisplay_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData)
+{
+    struct HexDumpDisplay_SettingsWidgets *WData=(struct HexDumpDisplay_SettingsWidgets *)PrivData;
+    t_WidgetSysHandle *WidgetHandle=WData->WidgetHandle;
+
+    /* Free everything in reverse order */
+    if(WData->ShowTx!=NULL)
+        m_HDD_UIAPI->FreeCheckbox(WidgetHandle,WData->ShowTx);
+    if(WData->ShowASCII!=NULL)
+        m_HDD_UIAPI->FreeCheckbox(WidgetHandle,WData->ShowASCII);
+    if(WData->Group!=NULL)
+        m_HDD_UIAPI->FreeNumberInput(WidgetHandle,WData->Group);
+    if(WData->RowWidth!=NULL)
+        m_HDD_UIAPI->FreeNumberInput(WidgetHandle,WData->RowWidth);
+
+    delete WData;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    SetSettingsFromWidgets
+ *
+ * SYNOPSIS:
+ *    void SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,
+ *              t_PIKVList *Settings);
+ *
+ * PARAMETERS:
+ *    PrivData [I] -- Your private data allocated in AllocSettingsWidgets()
+ *    Settings [O] -- This is where you store the settings.
+ *
+ * FUNCTION:
+ *    This function takes the widgets added with AllocSettingsWidgets() and
+ *    stores them is a key/value pair list in 'Settings'.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    AllocSettingsWidgets()
+ ******************************************************************************/
+void HexDumpDisplay_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings)
+{
+    struct HexDumpDisplay_SettingsWidgets *WData=(struct HexDumpDisplay_SettingsWidgets *)PrivData;
+    t_WidgetSysHandle *WidgetHandle=WData->WidgetHandle;
+    char buff[21];
+    unsigned int Value;
+
+    Value=m_HDD_UIAPI->GetNumberInputValue(WidgetHandle,WData->RowWidth->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_HDD_SysAPI->KVAddItem(Settings,"RowWidth",buff);
+
+    Value=m_HDD_UIAPI->GetNumberInputValue(WidgetHandle,WData->Group->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_HDD_SysAPI->KVAddItem(Settings,"Group",buff);
+
+    Value=m_HDD_UIAPI->IsCheckboxChecked(WidgetHandle,WData->ShowASCII->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_HDD_SysAPI->KVAddItem(Settings,"ShowASCII",buff);
+
+    Value=m_HDD_UIAPI->IsCheckboxChecked(WidgetHandle,WData->ShowTx->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_HDD_SysAPI->KVAddItem(Settings,"ShowTx",buff);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ApplySettings
+ *
+ * SYNOPSIS:
+ *    void ApplySettings(t_DataProcessorHandleType *DataHandle,
+ *              t_PIKVList *Settings);
+ *
+ * PARAMETERS:
+ *    DataHandle [I] -- The data handle to work on.  This is your internal
+ *                      data.
+ *    Settings [I] -- This is where you get your settings from.
+ *
+ * FUNCTION:
+ *    This function takes the settings from 'Settings' and setups the
+ *    plugin to use them when new bytes come in or out.  A row that is
+ *    part way filled keeps its bytes (even if the row width got smaller).
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *
+ ******************************************************************************/
+static void HexDumpDisplay_ApplySettings(t_DataProcessorHandleType *DataHandle,
+        t_PIKVList *Settings)
+{
+    struct HexDumpDisplayData *Data=(struct HexDumpDisplayData *)DataHandle;
+    unsigned int RowWidth;
+    unsigned int Group;
+    bool ShowASCII;
+    bool ShowTx;
+
+    HexDumpDisplay_GetSettings(Settings,&RowWidth,&Group,&ShowASCII,&ShowTx);
+
+    /* If the layout changes finish the row that is part way though first */
+    if(RowWidth!=Data->RowWidth || Group!=Data->Group ||
+            ShowASCII!=Data->ShowASCII || ShowTx!=Data->ShowTx)
+    {
+        if(Data->Rows[Data->LastDir].Fill>0)
+            HexDumpDisplay_ShowRow(Data,Data->LastDir,true);
+        Data->RowWidth=RowWidth;
+        Data->Group=Group;
+        Data->ShowASCII=ShowASCII;
+        Data->ShowTx=ShowTx;
+    }
+
+    /* The colors may have changed, send them again */
+    Data->StyleDir=e_HDD_DirMAX;
+    Data->FGColor[e_HDD_Dir_Rx]=m_HDD_DPS->GetSysDefaultColor(e_DefaultColors_FG);
+    Data->FGColor[e_HDD_Dir_Tx]=m_HDD_DPS->GetSysColor(e_SysColShade_Normal,
+            e_SysCol_Red);
+    Data->BGColor=m_HDD_DPS->GetSysDefaultColor(e_DefaultColors_BG);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_InitLookupTables
+ *
+ * SYNOPSIS:
+ *    static void HexDumpDisplay_InitLookupTables(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function fills in the byte to hex and byte to ASCII column tables.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HexDumpDisplay_InitLookupTables(void)
+{
+    static const char HexDigits[]="0123456789ABCDEF";
+    unsigned int r;
+
+    for(r=0;r<256;r++)
+    {
+        m_HDD_HexLUT[r][0]=HexDigits[r>>4];
+        m_HDD_HexLUT[r][1]=HexDigits[r&0x0F];
+
+        if(r>=0x20 && r<0x7F)
+            m_HDD_ASCIILUT[r]=r;
+        else
+            m_HDD_ASCIILUT[r]='.';
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_GetSettings
+ *
+ * SYNOPSIS:
+ *    static void HexDumpDisplay_GetSettings(t_PIKVList *Settings,
+ *          unsigned int *RowWidth,unsigned int *Group,bool *ShowASCII,
+ *          bool *ShowTx);
+ *
+ * PARAMETERS:
+ *    Settings [I] -- The settings to read
+ *    RowWidth [O] -- The number of bytes per row
+ *    Group [O] -- Add an extra space every this many bytes (0 = never)
+ *    ShowASCII [O] -- Show the ASCII column
+ *    ShowTx [O] -- Show the outgoing bytes as well
+ *
+ * FUNCTION:
+ *    This function reads our settings (with defaults for anything missing
+ *    or out of range).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HexDumpDisplay_GetSettings(t_PIKVList *Settings,
+        unsigned int *RowWidth,unsigned int *Group,bool *ShowASCII,
+        bool *ShowTx)
+{
+    *RowWidth=HexDumpDisplay_GrabNumber(Settings,"RowWidth",1,
+            HDD_MAX_ROW_WIDTH,HDD_DEFAULT_ROW_WIDTH);
+    *Group=HexDumpDisplay_GrabNumber(Settings,"Group",0,HDD_MAX_ROW_WIDTH,
+            HDD_DEFAULT_GROUP);
+    *ShowASCII=HexDumpDisplay_GrabNumber(Settings,"ShowASCII",0,1,1);
+    *ShowTx=HexDumpDisplay_GrabNumber(Settings,"ShowTx",0,1,1);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_GrabNumber
+ *
+ * SYNOPSIS:
+ *    static unsigned int HexDumpDisplay_GrabNumber(t_PIKVList *Settings,
+ *          const char *Key,unsigned int Min,unsigned int Max,
+ *          unsigned int DefaultValue);
+ *
+ * PARAMETERS:
+ *    Settings [I] -- The settings to read
+ *    Key [I] -- The key to look for in the settings
+ *    Min [I] -- The smallest value allowed
+ *    Max [I] -- The largest value allowed
+ *    DefaultValue [I] -- What to use if it's missing or out of range
+ *
+ * FUNCTION:
+ *    This is a helper function that reads a number out of the settings.
+ *
+ * RETURNS:
+ *    The value from the settings or 'DefaultValue'.
+ ******************************************************************************/
+static unsigned int HexDumpDisplay_GrabNumber(t_PIKVList *Settings,
+        const char *Key,unsigned int Min,unsigned int Max,
+        unsigned int DefaultValue)
+{
+    const char *Str;
+    long Num;
+
+    Str=m_HDD_SysAPI->KVGetItem(Settings,Key);
+    if(Str==NULL)
+        return DefaultValue;
+
+    Num=strtol(Str,NULL,10);
+    if(Num<(long)Min || Num>(long)Max)
+        return DefaultValue;
+
+    return Num;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_AddBytes
+ *
+ * SYNOPSIS:
+ *    static void HexDumpDisplay_AddBytes(struct HexDumpDisplayData *Data,
+ *          e_HDD_DirType Dir,const uint8_t *Bytes,uint32_t Len,
+ *          bool ShowPartial);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The data for this connection
+ *    Dir [I] -- Are these incoming or outgoing bytes
+ *    Bytes [I] -- The bytes to add
+ *    Len [I] -- The number of bytes in 'Bytes'
+ *    ShowPartial [I] -- Show the hex we have so far for a row that isn't
+ *                       full yet (true), or only show full rows (false)
+ *
+ * FUNCTION:
+ *    This function adds bytes to the row for this direction and shows each
+ *    row as it fills.  If the other direction has a row part way filled it
+ *    is finished first so the rows stay in the order the bytes went by.
+ *
+ *    A row that isn't full is kept for the next bytes, if 'ShowPartial' is
+ *    set we show the hex we have so far.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HexDumpDisplay_AddBytes(struct HexDumpDisplayData *Data,
+        e_HDD_DirType Dir,const uint8_t *Bytes,uint32_t Len,bool ShowPartial)
+{
+    struct HexDumpDisplay_Row *Row;
+    uint32_t Space;
+
+    if(Dir!=Data->LastDir)
+    {
+        if(Data->Rows[Data->LastDir].Fill>0)
+            HexDumpDisplay_ShowRow(Data,Data->LastDir,true);
+        Data->LastDir=Dir;
+    }
+
+    Row=&Data->Rows[Dir];
+    while(Len>0)
+    {
+        if(Row->Fill>=Data->RowWidth)
+        {
+            HexDumpDisplay_ShowRow(Data,Dir,true);
+            continue;
+        }
+
+        Space=Data->RowWidth-Row->Fill;
+        if(Space>Len)
+            Space=Len;
+        memcpy(&Row->Bytes[Row->Fill],Bytes,Space);
+        Row->Fill+=Space;
+        Bytes+=Space;
+        Len-=Space;
+
+        if(Row->Fill==Data->RowWidth)
+            HexDumpDisplay_ShowRow(Data,Dir,true);
+    }
+
+    if(ShowPartial && Row->Fill>Row->Shown)
+        HexDumpDisplay_ShowRow(Data,Dir,false);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HexDumpDisplay_ShowRow
+ *
+ * SYNOPSIS:
+ *    static void HexDumpDisplay_ShowRow(struct HexDumpDisplayData *Data,
+ *          e_HDD_DirType Dir,bool EndRow);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The data for this connection
+ *    Dir [I] -- Which direction's row to show
+ *    EndRow [I] -- Finish the row (add the ASCII column and the end of the
+ *                  line) or just show the hex for the bytes we have so far
+ *
+ * FUNCTION:
+ *    This function builds the part of the row that isn't on the screen yet
+ *    in 'Data->Line' and adds it to the screen with one BinaryAddText()
+ *    call.  The offset is only added for the first bytes of the row.
+ *
+ *    When the row is ended a short row is padded out so the ASCII column
+ *    still lines up.  The row is then emptied and the offset moved on.
+ *
+ *    The offset is 8 hex digits (16 once it goes past 4G).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HexDumpDisplay_ShowRow(struct HexDumpDisplayData *Data,
+        e_HDD_DirType Dir,bool EndRow)
+{
+    struct HexDumpDisplay_Row *Row=&Data->Rows[Dir];
+    char *Out;
+    unsigned int Cols;
+    unsigned int Group;
+    unsigned int Digits;
+    unsigned int r;
+
+    Out=Data->Line;
+
+    /* Offset */
+    if(Row->Shown==0)
+    {
+        Digits=Row->Offset>0xFFFFFFFFULL?8:4;
+        for(r=Digits;r>0;r--)
+        {
+            memcpy(Out,m_HDD_HexLUT[(Row->Offset>>((r-1)*8))&0xFF],2);
+            Out+=2;
+        }
+        *Out++=' ';
+    }
+
+    /* Hex bytes (padded out if we have an ASCII column to line up) */
+    Cols=Row->Fill;
+    if(EndRow && Data->ShowASCII && Cols<Data->RowWidth)
+        Cols=Data->RowWidth;
+    Group=Data->Group;
+    for(r=Row->Shown;r<Cols;r++)
+    {
+        if(Group!=0 && r!=0 && r%Group==0)
+            *Out++=' ';
+        *Out++=' ';
+        if(r<Row->Fill)
+        {
+            memcpy(Out,m_HDD_HexLUT[Row->Bytes[r]],2);
+        }
+        else
+        {
+            Out[0]=' ';
+            Out[1]=' ';
+        }
+        Out+=2;
+    }
+
+    if(EndRow)
+    {
+        /* ASCII column */
+        if(Data->ShowASCII)
+        {
+            *Out++=' ';
+            *Out++=' ';
+            *Out++='|';
+            for(r=0;r<Row->Fill;r++)
+                *Out++=m_HDD_ASCIILUT[Row->Bytes[r]];
+            *Out++='|';
+        }
+        *Out++='\n';
+    }
+    *Out=0;
+
+    if(Data->StyleDir!=Dir)
+    {
+        m_HDD_DPS->SetFGColor(Data->FGColor[Dir]);
+        m_HDD_DPS->SetULineColor(Data->FGColor[Dir]);
+        m_HDD_DPS->SetBGColor(Data->BGColor);
+        m_HDD_DPS->SetAttribs(0);
+        Data->StyleDir=Dir;
+    }
+    m_HDD_DPS->BinaryAddText(Data->Line);
+
+    if(EndRow)
+    {
+        Row->Offset+=Row->Fill;
+        Row->Fill=0;
+        Row->Shown=0;
+    }
+    else
+    {
+        Row->Shown=Row->Fill;
+    }
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+ * FILENAME: Plugin.h
+ * 
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the main include file for all plugins.  Plugin's only
+ *    need to include this file.
+ *
+ * COPYRIGHT:
+ *    Copyright 2018 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (05 Jul 2018)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __PLUGIN_H_
+#define __PLUGIN_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include "PluginTypes.h"
+#include "IODriver.h"
+#include "DataProcessors.h"
+#include "FileTransferProtocol.h"
+#include "PluginUI.h"
+#include "PluginSystem.h"
+
+#endif
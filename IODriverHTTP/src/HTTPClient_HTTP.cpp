@@ -32,6 +32,9 @@
 #include "HTTPClient_Main.h"
 #include "HTTPClient_HTTP.h"
 #include "OS/HTTPClient_Socket.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 #include <string>
 
 using namespace std;
@@ -43,25 +46,39 @@ using namespace std;
 /*** TYPE DEFINITIONS         ***/
 
 /*** FUNCTION PROTOTYPES      ***/
+static void HTTPClient_ResetResponse(struct HTTPData *HTTPState);
+static void HTTPClient_AddToLine(struct HTTPData *HTTPState,
+        const uint8_t *Data,int Bytes);
+static bool HTTPClient_ProcessLine(struct HTTPData *HTTPState);
+static void HTTPClient_HeadersDone(struct HTTPData *HTTPState);
+static int HTTPClient_HexDigit(uint8_t c);
+static int HTTPClient_Inflate(struct HTTPData *HTTPState,uint8_t *Data,
+        int MaxBytes);
 
 /*** VARIABLE DEFINITIONS     ***/
 
 /*******************************************************************************
  * NAME:
- *    HTTPClient_StartHTTPHandShake
+ *    HTTPClient_BuildHTTPRequest
  *
  * SYNOPSIS:
- *    bool HTTPClient_StartHTTPHandShake(t_DriverIOHandleType *DriverIO,
- *              const t_PIKVList *Options,struct HTTPData *HTTPState);
+ *    bool HTTPClient_BuildHTTPRequest(const t_PIKVList *Options,
+ *              struct HTTPData *HTTPState,struct WSData *WS);
  *
  * PARAMETERS:
- *    DriverIO [I] -- The handle to this connection
  *    Options [I] -- The options to apply to this connection.
  *    HTTPState [I] -- State machine data for this HTTP connection.
+ *    WS [I] -- The WebSocket data if this is a WebSocket connection (we
+ *              ask to upgrade), NULL for a normal HTTP connection.
  *
  * FUNCTION:
- *    This function starts the HTTP hand shake.  It sends the first set
- *    of headers.
+ *    This function starts the HTTP hand shake.  It builds the first set
+ *    of headers in 'HTTPState->Request'.  The OS layer sends it (with one
+ *    write so it goes out as one packet, not a dozen small ones) once the
+ *    socket has connected.
+ *
+ *    With the "SSE" option we ask for an event stream (and never for
+ *    compression).  WebSocket connections ask for neither.
  *
  * RETURNS:
  *    true -- Things worked
@@ -70,16 +87,39 @@ using namespace std;
  * SEE ALSO:
  *    
  ******************************************************************************/
-bool HTTPClient_StartHTTPHandShake(t_DriverIOHandleType *DriverIO,
-        const t_PIKVList *Options,struct HTTPData *HTTPState)
+bool HTTPClient_BuildHTTPRequest(const t_PIKVList *Options,
+        struct HTTPData *HTTPState,struct WSData *WS)
 {
+    static const char *GenericHeaderKeys[]=
+    {
+        "GenericHeader1",
+        "GenericHeader2",
+        "GenericHeader3",
+    };
     const char *PathStr;
     const char *AddressStr;
     const char *GenericHeaderStr;
+    const char *CompressionStr;
+    const char *SSEStr;
     bool DidUserAgent;
+    unsigned int r;
+
+    HTTPClient_ResetResponse(HTTPState);
+
+    HTTPState->WebSocket=WS!=NULL;
+    if(HTTPState->WebSocket &&
+            !HTTPClient_WS_MakeKey(WS,HTTPState->WebSocketKey))
+    {
+        return false;
+    }
 
-    HTTPState->DoingHeaders=true;
-    HTTPState->HeaderEndCount=0;
+    SSEStr=g_HC_System->KVGetItem(Options,"SSE");
+    HTTPState->SSE=SSEStr!=NULL && atoi(SSEStr)!=0 && !HTTPState->WebSocket;
+    HTTPClient_SSE_Init(&HTTPState->SSEData);
+
+    CompressionStr=g_HC_System->KVGetItem(Options,"Compression");
+    HTTPState->Compression=CompressionStr!=NULL && atoi(CompressionStr)!=0 &&
+            !HTTPState->SSE && !HTTPState->WebSocket;
 
     DidUserAgent=false;
 
@@ -91,86 +131,63 @@ bool HTTPClient_StartHTTPHandShake(t_DriverIOHandleType *DriverIO,
     if(PathStr==NULL || *PathStr==0)
         PathStr="/";
 
-    if(HTTPClient_Write(DriverIO,(uint8_t *)"GET ",4)<=0)
-        return false;
-
-    if(HTTPClient_Write(DriverIO,(uint8_t *)PathStr,strlen(PathStr))<0)
-        return false;
-
-    if(HTTPClient_Write(DriverIO,(uint8_t *)" HTTP/1.1\r\n",11)<=0)
-        return false;
-
-    if(HTTPClient_Write(DriverIO,(uint8_t *)"Host: ",6)<=0)
-        return false;
+    /* Build the whole request so it can be sent in one go (clear() keeps
+       the buffer we allocated last time) */
+    try
+    {
+        HTTPState->Request.clear();
+        HTTPState->Request.reserve(HTTPCLIENT_REQUEST_BUFFER_SIZE);
 
-    if(HTTPClient_Write(DriverIO,(uint8_t *)AddressStr,strlen(AddressStr))<0)
-        return false;
+        HTTPState->Request+="GET ";
+        HTTPState->Request+=PathStr;
+        HTTPState->Request+=" HTTP/1.1\r\n";
 
-    if(HTTPClient_Write(DriverIO,(uint8_t *)"\r\n",2)<=0)
-        return false;
+        HTTPState->Request+="Host: ";
+        HTTPState->Request+=AddressStr;
+        HTTPState->Request+="\r\n";
 
-    GenericHeaderStr=g_HC_System->KVGetItem(Options,"GenericHeader1");
-    if(GenericHeaderStr!=NULL)
-    {
-        if(*GenericHeaderStr!=0)
+        for(r=0;r<sizeof(GenericHeaderKeys)/sizeof(GenericHeaderKeys[0]);r++)
         {
-            if(strncmp(GenericHeaderStr,"User-Agent:",11)==0)
-                DidUserAgent=true;
-            if(HTTPClient_Write(DriverIO,(uint8_t *)GenericHeaderStr,
-                    strlen(GenericHeaderStr))<0)
-            {
-                return false;
-            }
-            if(HTTPClient_Write(DriverIO,(uint8_t *)"\r\n",2)<=0)
-                return false;
-        }
-    }
+            GenericHeaderStr=g_HC_System->KVGetItem(Options,
+                    GenericHeaderKeys[r]);
+            if(GenericHeaderStr==NULL || *GenericHeaderStr==0)
+                continue;
 
-    GenericHeaderStr=g_HC_System->KVGetItem(Options,"GenericHeader2");
-    if(GenericHeaderStr!=NULL)
-    {
-        if(*GenericHeaderStr!=0)
-        {
             if(strncmp(GenericHeaderStr,"User-Agent:",11)==0)
                 DidUserAgent=true;
-            if(HTTPClient_Write(DriverIO,(uint8_t *)GenericHeaderStr,
-                    strlen(GenericHeaderStr))<0)
-            {
-                return false;
-            }
-            if(HTTPClient_Write(DriverIO,(uint8_t *)"\r\n",2)<=0)
-                return false;
+            HTTPState->Request+=GenericHeaderStr;
+            HTTPState->Request+="\r\n";
         }
-    }
 
-    GenericHeaderStr=g_HC_System->KVGetItem(Options,"GenericHeader3");
-    if(GenericHeaderStr!=NULL)
-    {
-        if(*GenericHeaderStr!=0)
+        if(!DidUserAgent)
+            HTTPState->Request+="User-Agent: Whippy Term\r\n";
+
+        if(HTTPState->Compression)
+            HTTPState->Request+="Accept-Encoding: gzip, deflate\r\n";
+
+        if(HTTPState->SSE)
         {
-            if(strncmp(GenericHeaderStr,"User-Agent:",11)==0)
-                DidUserAgent=true;
-            if(HTTPClient_Write(DriverIO,(uint8_t *)GenericHeaderStr,
-                    strlen(GenericHeaderStr))<0)
-            {
-                return false;
-            }
-            if(HTTPClient_Write(DriverIO,(uint8_t *)"\r\n",2)<=0)
-                return false;
+            HTTPState->Request+="Accept: text/event-stream\r\n";
+            HTTPState->Request+="Cache-Control: no-cache\r\n";
         }
-    }
 
-    if(!DidUserAgent)
-    {
-        if(HTTPClient_Write(DriverIO,(uint8_t *)"User-Agent: Whippy Term\r\n",
-                25)<=0)
+        if(HTTPState->WebSocket)
         {
-            return false;
+            HTTPState->Request+="Upgrade: websocket\r\n";
+            HTTPState->Request+="Connection: Upgrade\r\n";
+            HTTPState->Request+="Sec-WebSocket-Key: ";
+            HTTPState->Request+=HTTPState->WebSocketKey;
+            HTTPState->Request+="\r\n";
+            HTTPState->Request+="Sec-WebSocket-Version: 13\r\n";
         }
-    }
 
-    if(HTTPClient_Write(DriverIO,(uint8_t *)"\r\n",2)<=0)
+        HTTPState->RequestEnd=HTTPState->Request.length();
+        HTTPState->Request+="\r\n";
+    }
+    catch(...)
+    {
         return false;
+    }
 
 /* Header field to consider:
 Authorization
@@ -181,61 +198,953 @@ Authorization
 
 /*******************************************************************************
  * NAME:
- *    HTTPClient_ProcessHTTPHeaders
+ *    HTTPClient_ProcessHTTPResponse
  *
  * SYNOPSIS:
- *    int HTTPClient_ProcessHTTPHeaders(t_DriverIOHandleType *DriverIO,
+ *    int HTTPClient_ProcessHTTPResponse(t_DriverIOHandleType *DriverIO,
  *              struct HTTPData *HTTPState,uint8_t *Data,int BytesRead);
  *
  * PARAMETERS:
  *    DriverIO [I] -- The handle to this connection
  *    HTTPState [I] -- State machine data for this HTTP connection.
- *    Data [I] -- The data that was read from the connection
+ *    Data [I/O] -- The data that was read from the connection.  This is
+ *                  changed to only have the body bytes in it.
  *    BytesRead [I] -- The number of bytes in 'Data'
  *
  * FUNCTION:
  *    This function is called when a block comes in from the HTTP connection.
- *    It handles the headers.
+ *    It runs the response parser over the block (status line, headers,
+ *    chunked transfer encoding / Content-Length) and moves the body bytes
+ *    down to the start of 'Data' (in place, the body is never copied
+ *    anywhere else).
+ *
+ *    The block can end anywhere, the parser picks up where it left off next
+ *    time.  Use HTTPClient_ResponseDone() to see if the whole response
+ *    has come in.
  *
  * RETURNS:
- *    Number of bytes used from the headers.  Will be 0 if we are no longer
- *    doing headers.
+ *    The number of body bytes now at the start of 'Data' or -1 if this
+ *    isn't a HTTP/1.x response.
  *
  * SEE ALSO:
- *    
+ *    HTTPClient_ResponseDone()
  ******************************************************************************/
-int HTTPClient_ProcessHTTPHeaders(t_DriverIOHandleType *DriverIO,
+int HTTPClient_ProcessHTTPResponse(t_DriverIOHandleType *DriverIO,
         struct HTTPData *HTTPState,uint8_t *Data,int BytesRead)
 {
-    int BytesLeft;
-    const uint8_t *Pos;
+    uint8_t *In;
+    uint8_t *End;
+    uint8_t *Out;
+    const uint8_t *NewLine;
+    uint64_t Bytes;
+    int Digit;
+
+    In=Data;
+    End=Data+BytesRead;
+    Out=Data;
+    while(In<End)
+    {
+        switch(HTTPState->State)
+        {
+            case e_HTTPParse_StatusLine:
+            case e_HTTPParse_Headers:
+            case e_HTTPParse_Trailers:
+                NewLine=(const uint8_t *)memchr(In,'\n',End-In);
+                if(NewLine==NULL)
+                {
+                    HTTPClient_AddToLine(HTTPState,In,End-In);
+                    In=End;
+                    break;
+                }
+                HTTPClient_AddToLine(HTTPState,In,NewLine-In);
+                In=(uint8_t *)NewLine+1;
+                if(!HTTPClient_ProcessLine(HTTPState))
+                    return -1;
+            break;
+            case e_HTTPParse_ChunkSize:
+                while(In<End && *In!='\n')
+                {
+                    if(!HTTPState->ChunkExt)
+                    {
+                        Digit=HTTPClient_HexDigit(*In);
+                        if(Digit<0)
+                        {
+                            /* ";ext=val", whitespace or the \r */
+                            HTTPState->ChunkExt=true;
+                        }
+                        else
+                        {
+                            /* Way too big, we are out of sync */
+                            if(HTTPState->ChunkDigits>=15)
+                                return -1;
+                            HTTPState->BodyLeft=HTTPState->BodyLeft*16+Digit;
+                            HTTPState->ChunkDigits++;
+                        }
+                    }
+                    In++;
+                }
+                if(In==End)
+                    break;
+                In++;   // The \n
+
+                if(HTTPState->ChunkDigits==0)
+                    return -1;
+
+                if(HTTPState->BodyLeft==0)
+                    HTTPState->State=e_HTTPParse_Trailers;
+                else
+                    HTTPState->State=e_HTTPParse_ChunkData;
+            break;
+            case e_HTTPParse_Length:
+            case e_HTTPParse_ChunkData:
+                Bytes=End-In;
+                if(Bytes>HTTPState->BodyLeft)
+                    Bytes=HTTPState->BodyLeft;
+                if(Out!=In)
+                    memmove(Out,In,Bytes);
+                Out+=Bytes;
+                In+=Bytes;
+                HTTPState->BodyLeft-=Bytes;
+                if(HTTPState->BodyLeft==0)
+                {
+                    if(HTTPState->State==e_HTTPParse_ChunkData)
+                        HTTPState->State=e_HTTPParse_ChunkDataEnd;
+                    else
+                        HTTPState->State=e_HTTPParse_Done;
+                }
+            break;
+            case e_HTTPParse_ChunkDataEnd:
+                if(*In=='\n')
+                {
+                    HTTPState->BodyLeft=0;
+                    HTTPState->ChunkDigits=0;
+                    HTTPState->ChunkExt=false;
+                    HTTPState->State=e_HTTPParse_ChunkSize;
+                }
+                else if(*In!='\r')
+                {
+                    return -1;
+                }
+                In++;
+            break;
+            case e_HTTPParse_UntilClose:
+            case e_HTTPParse_Upgraded:
+                if(Out!=In)
+                    memmove(Out,In,End-In);
+                Out+=End-In;
+                In=End;
+            break;
+            case e_HTTPParse_Done:
+            case e_HTTPParseMAX:
+            default:
+                /* Anything after the response isn't ours */
+                In=End;
+            break;
+        }
+    }
+    return Out-Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_ResponseDone
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_ResponseDone(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function checks if the whole response has been read (the end
+ *    of the Content-Length body or the last chunk and trailers).
+ *
+ * RETURNS:
+ *    true -- The response is finished
+ *    false -- There is more to come (or the body ends when the server
+ *             closes the connection)
+ *
+ * SEE ALSO:
+ *    HTTPClient_ProcessHTTPResponse()
+ ******************************************************************************/
+bool HTTPClient_ResponseDone(struct HTTPData *HTTPState)
+{
+    return HTTPState->State==e_HTTPParse_Done;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_GotHeaders
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_GotHeaders(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function checks if we have all the headers of the response.
+ *
+ * RETURNS:
+ *    true -- The headers are done (we are in to the body or past it)
+ *    false -- Still reading the status line / headers
+ ******************************************************************************/
+bool HTTPClient_GotHeaders(struct HTTPData *HTTPState)
+{
+    return HTTPState->State!=e_HTTPParse_StatusLine &&
+            HTTPState->State!=e_HTTPParse_Headers;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WebSocketUpgraded
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_WebSocketUpgraded(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function checks if the server switched the connection to a
+ *    WebSocket.  It needs a 101, "Upgrade: websocket" and the right
+ *    "Sec-WebSocket-Accept" for the key we sent (RFC 6455 section 4.1).
+ *
+ * RETURNS:
+ *    true -- Everything after the headers is WebSocket frames
+ *    false -- The server didn't accept the upgrade
+ ******************************************************************************/
+bool HTTPClient_WebSocketUpgraded(struct HTTPData *HTTPState)
+{
+    char Accept[HTTPCLIENT_WS_ACCEPT_SIZE];
+
+    if(!HTTPState->WebSocket || HTTPState->State!=e_HTTPParse_Upgraded)
+        return false;
+
+    if(strcasecmp(HTTPState->Upgrade,"websocket")!=0)
+        return false;
+
+    HTTPClient_WS_AcceptKey(HTTPState->WebSocketKey,Accept);
+    return strcmp(HTTPState->WebSocketAccept,Accept)==0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_NextResponse
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_NextResponse(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function gets the parser ready for the response to the request
+ *    being sent again (when polling).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void HTTPClient_NextResponse(struct HTTPData *HTTPState)
+{
+    HTTPClient_ResetResponse(HTTPState);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_InitHTTPData
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_InitHTTPData(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- The state data to init
+ *
+ * FUNCTION:
+ *    This function sets up a new HTTPData.  It must be called before the
+ *    HTTPData is used and matched with a HTTPClient_FreeHTTPData().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_FreeHTTPData()
+ ******************************************************************************/
+void HTTPClient_InitHTTPData(struct HTTPData *HTTPState)
+{
+    HTTPState->RequestEnd=0;
+    HTTPState->Compression=false;
+    HTTPState->SSE=false;
+    HTTPState->WebSocket=false;
+    HTTPState->WebSocketKey[0]=0;
+    HTTPState->Inflating=false;
+    HTTPClient_SSE_Init(&HTTPState->SSEData);
+    HTTPClient_ResetResponse(HTTPState);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_FreeHTTPData
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_FreeHTTPData(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- The state data to free
+ *
+ * FUNCTION:
+ *    This function frees anything the response parser allocated.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_InitHTTPData()
+ ******************************************************************************/
+void HTTPClient_FreeHTTPData(struct HTTPData *HTTPState)
+{
+    if(HTTPState->Inflating)
+        inflateEnd(&HTTPState->Inflate);
+    HTTPState->Inflating=false;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_UseDecodeWindow
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_UseDecodeWindow(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function tells the socket code where to read the next block.  A
+ *    compressed body or an event stream can't be decoded in place, so it is
+ *    read in to 'HTTPState->Window' (at most HTTPCLIENT_DECODE_WINDOW bytes
+ *    at a time) and decoded from there in to the caller's buffer.  Until
+ *    the headers are done we don't know how the body will come, so if we
+ *    asked for compression or events the headers are read in to the window
+ *    too.
+ *
+ * RETURNS:
+ *    true -- Read in to 'HTTPState->Window', pass what
+ *            HTTPClient_ProcessHTTPResponse() leaves to
+ *            HTTPClient_DecodeInput() (if HTTPClient_BodyNeedsDecode())
+ *            or copy it to the caller.
+ *    false -- Read straight in to the caller's buffer
+ ******************************************************************************/
+bool HTTPClient_UseDecodeWindow(struct HTTPData *HTTPState)
+{
+    if(!HTTPState->Compression && !HTTPState->SSE)
+        return false;
+
+    return HTTPState->Inflating || HTTPState->SSEStream ||
+            HTTPState->State==e_HTTPParse_StatusLine ||
+            HTTPState->State==e_HTTPParse_Headers;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_BodyNeedsDecode
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_BodyNeedsDecode(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function checks if the body of this response is being inflated
+ *    or run through the event stream parser.
+ *
+ * RETURNS:
+ *    true -- The body must go through HTTPClient_Decode()
+ *    false -- The body is plain
+ ******************************************************************************/
+bool HTTPClient_BodyNeedsDecode(struct HTTPData *HTTPState)
+{
+    return HTTPState->Inflating || HTTPState->SSEStream;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_DecodeInput
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_DecodeInput(struct HTTPData *HTTPState,int Bytes);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *    Bytes [I] -- The number of body bytes at the start of
+ *                 'HTTPState->Window'
+ *
+ * FUNCTION:
+ *    This function gives the decoder the next block of the body.  The last
+ *    block must have been used up (HTTPClient_DecodePending() returns
+ *    false).
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_Decode()
+ ******************************************************************************/
+void HTTPClient_DecodeInput(struct HTTPData *HTTPState,int Bytes)
+{
+    HTTPState->InPos=0;
+    HTTPState->InLen=Bytes;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_DecodePending
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_DecodePending(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function checks if the decoder has more to give (body bytes left
+ *    in the window, or output that didn't fit last time).  While this is
+ *    true the socket shouldn't be read (and it shouldn't say it's drained).
+ *
+ * RETURNS:
+ *    true -- Call HTTPClient_Decode()
+ *    false -- The decoder needs more input
+ ******************************************************************************/
+bool HTTPClient_DecodePending(struct HTTPData *HTTPState)
+{
+    if(HTTPState->SSEStream)
+    {
+        return HTTPState->InPos<HTTPState->InLen ||
+                HTTPClient_SSE_Pending(&HTTPState->SSEData);
+    }
+
+    if(!HTTPState->Inflating || HTTPState->InflateEnded)
+        return false;
+    return HTTPState->InPos<HTTPState->InLen || HTTPState->InflateOutFull;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Decode
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_Decode(struct HTTPData *HTTPState,uint8_t *Data,
+ *          int MaxBytes);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *    Data [O] -- Where to put the decoded body
+ *    MaxBytes [I] -- The size of 'Data'
+ *
+ * FUNCTION:
+ *    This function decodes as much of the body in the window as will fit
+ *    in 'Data'.  Compressed bodies are inflated, event streams become one
+ *    line per event.
+ *
+ * RETURNS:
+ *    The number of bytes put in 'Data' or -1 if the compressed data is bad.
+ *
+ * SEE ALSO:
+ *    HTTPClient_DecodeInput(), HTTPClient_DecodePending()
+ ******************************************************************************/
+int HTTPClient_Decode(struct HTTPData *HTTPState,uint8_t *Data,int MaxBytes)
+{
+    if(HTTPState->SSEStream)
+    {
+        return HTTPClient_SSE_Decode(&HTTPState->SSEData,HTTPState->Window,
+                HTTPState->InLen,&HTTPState->InPos,Data,MaxBytes);
+    }
+
+    return HTTPClient_Inflate(HTTPState,Data,MaxBytes);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSEMode
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_SSEMode(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function checks if this connection asked for an event stream.
+ *
+ * RETURNS:
+ *    true -- The "SSE" option is on
+ *    false -- Normal page
+ ******************************************************************************/
+bool HTTPClient_SSEMode(struct HTTPData *HTTPState)
+{
+    return HTTPState->SSE;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSECanRetry
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_SSECanRetry(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function is called when the connection ends to see if we should
+ *    reconnect.  We only do that if the response was an event stream (an
+ *    error page or a normal page means reconnecting won't help).  If we
+ *    didn't get as far as the headers it was a network problem and we
+ *    try again.
+ *
+ * RETURNS:
+ *    true -- Reconnect after HTTPClient_SSERetryTime()
+ *    false -- Give up
+ ******************************************************************************/
+bool HTTPClient_SSECanRetry(struct HTTPData *HTTPState)
+{
+    if(!HTTPState->SSE)
+        return false;
+
+    return HTTPState->SSEStream || HTTPState->State==e_HTTPParse_StatusLine ||
+            HTTPState->State==e_HTTPParse_Headers;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSERetryTime
+ *
+ * SYNOPSIS:
+ *    unsigned int HTTPClient_SSERetryTime(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function gets how long to wait before reconnecting (the last
+ *    "retry:" the server sent, or HTTPCLIENT_SSE_DEFAULT_RETRY).
+ *
+ * RETURNS:
+ *    The time to wait in ms
+ ******************************************************************************/
+unsigned int HTTPClient_SSERetryTime(struct HTTPData *HTTPState)
+{
+    return HTTPState->SSEData.RetryMS;
+}
 
-    if(!HTTPState->DoingHeaders)
-        return BytesRead;
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSEResumeRequest
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_SSEResumeRequest(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function updates 'HTTPState->Request' for a reconnect.  If we
+ *    have seen an event ID it adds a "Last-Event-ID" header so the server
+ *    can send the events we missed.  It also gets the parser ready for the
+ *    new response.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- Out of memory
+ ******************************************************************************/
+bool HTTPClient_SSEResumeRequest(struct HTTPData *HTTPState)
+{
+    HTTPClient_ResetResponse(HTTPState);
 
-    /* Process this block ignoring all headers until we get to the end of the
-       headers */
-    BytesLeft=BytesRead;
-    Pos=Data;
-    while(BytesLeft>0)
+    try
     {
-        if(*Pos=='\n')
+        HTTPState->Request.resize(HTTPState->RequestEnd);
+        if(HTTPState->SSEData.LastEventID[0]!=0)
         {
-            HTTPState->HeaderEndCount++;
-            if(HTTPState->HeaderEndCount==2)
+            HTTPState->Request+="Last-Event-ID: ";
+            HTTPState->Request+=HTTPState->SSEData.LastEventID;
+            HTTPState->Request+="\r\n";
+        }
+        HTTPState->Request+="\r\n";
+    }
+    catch(...)
+    {
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Inflate
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_Inflate(struct HTTPData *HTTPState,uint8_t *Data,
+ *          int MaxBytes);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *    Data [O] -- Where to put the inflated body
+ *    MaxBytes [I] -- The size of 'Data'
+ *
+ * FUNCTION:
+ *    This function inflates as much of the compressed body in the window
+ *    as will fit in 'Data'.
+ *
+ * RETURNS:
+ *    The number of bytes put in 'Data' or -1 if the compressed data is bad.
+ *
+ * SEE ALSO:
+ *    HTTPClient_Decode()
+ ******************************************************************************/
+static int HTTPClient_Inflate(struct HTTPData *HTTPState,uint8_t *Data,
+        int MaxBytes)
+{
+    int Ret;
+
+    HTTPState->Inflate.next_in=&HTTPState->Window[HTTPState->InPos];
+    HTTPState->Inflate.avail_in=HTTPState->InLen-HTTPState->InPos;
+    HTTPState->Inflate.next_out=Data;
+    HTTPState->Inflate.avail_out=MaxBytes;
+
+    Ret=inflate(&HTTPState->Inflate,Z_NO_FLUSH);
+
+    HTTPState->InPos=HTTPState->InLen-HTTPState->Inflate.avail_in;
+    HTTPState->InflateOutFull=HTTPState->Inflate.avail_out==0;
+
+    switch(Ret)
+    {
+        case Z_STREAM_END:
+            /* Anything after the stream is ignored */
+            HTTPState->InflateEnded=true;
+            HTTPState->InPos=HTTPState->InLen;
+        break;
+        case Z_OK:
+        case Z_BUF_ERROR:   // Just means it needs more input
+        break;
+        default:
+            return -1;
+    }
+
+    return MaxBytes-HTTPState->Inflate.avail_out;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_ResetResponse
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_ResetResponse(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function gets the parser ready for a new response (or the real
+ *    response after a 1xx one).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_ResetResponse(struct HTTPData *HTTPState)
+{
+    if(HTTPState->Inflating)
+        inflateEnd(&HTTPState->Inflate);
+    HTTPState->Inflating=false;
+    HTTPState->InflateEnded=false;
+    HTTPState->InflateOutFull=false;
+    HTTPState->SSEStream=false;
+    HTTPState->InPos=0;
+    HTTPState->InLen=0;
+
+    HTTPState->State=e_HTTPParse_StatusLine;
+    HTTPState->StatusCode=0;
+    HTTPState->KeepAlive=true;
+    HTTPState->Chunked=false;
+    HTTPState->HaveLength=false;
+    HTTPState->ContentLength=0;
+    HTTPState->ContentType[0]=0;
+    HTTPState->ContentEncoding[0]=0;
+    HTTPState->Upgrade[0]=0;
+    HTTPState->WebSocketAccept[0]=0;
+    HTTPState->BodyLeft=0;
+    HTTPState->ChunkDigits=0;
+    HTTPState->ChunkExt=false;
+    HTTPState->LineLen=0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_AddToLine
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_AddToLine(struct HTTPData *HTTPState,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *    Data [I] -- The bytes to add
+ *    Bytes [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function adds bytes to the header line we are collecting.  A
+ *    line can be split over many reads.  Anything past
+ *    HTTPCLIENT_MAX_HEADER_LINE is dropped (none of the headers we look
+ *    at are that long).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_AddToLine(struct HTTPData *HTTPState,
+        const uint8_t *Data,int Bytes)
+{
+    unsigned int Space;
+
+    Space=sizeof(HTTPState->Line)-1-HTTPState->LineLen;
+    if((unsigned int)Bytes>Space)
+        Bytes=Space;
+    memcpy(&HTTPState->Line[HTTPState->LineLen],Data,Bytes);
+    HTTPState->LineLen+=Bytes;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_ProcessLine
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_ProcessLine(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function handles a full status / header / trailer line that has
+ *    been collected in 'HTTPState->Line'.  At the end of the headers it
+ *    works out how the body is framed.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- This isn't a HTTP response
+ ******************************************************************************/
+static bool HTTPClient_ProcessLine(struct HTTPData *HTTPState)
+{
+    char *Value;
+
+    if(HTTPState->LineLen>0 && HTTPState->Line[HTTPState->LineLen-1]=='\r')
+        HTTPState->LineLen--;
+    HTTPState->Line[HTTPState->LineLen]=0;
+
+    switch(HTTPState->State)
+    {
+        case e_HTTPParse_StatusLine:
+            /* Some servers send a blank line before the status */
+            if(HTTPState->LineLen==0)
+                break;
+
+            /* HTTP/1.x NNN Reason */
+            if(HTTPState->LineLen<12 ||
+                    strncmp(HTTPState->Line,"HTTP/1.",7)!=0)
             {
-                /* 2 new lines = end of the headers */
-                HTTPState->DoingHeaders=false;
-                BytesLeft--;
+                return false;
+            }
+            if(HTTPState->Line[7]=='0')
+                HTTPState->KeepAlive=false;
+            HTTPState->StatusCode=atoi(&HTTPState->Line[9]);
+            HTTPState->State=e_HTTPParse_Headers;
+        break;
+        case e_HTTPParse_Headers:
+            if(HTTPState->LineLen==0)
+            {
+                HTTPClient_HeadersDone(HTTPState);
                 break;
             }
-        }
-        else if(*Pos!='\r')
-        {
-            HTTPState->HeaderEndCount=0;
-        }
-        BytesLeft--;
-        Pos++;
+
+            Value=strchr(HTTPState->Line,':');
+            if(Value==NULL)
+                break;
+            *Value++=0;
+            while(*Value==' ' || *Value=='\t')
+                Value++;
+
+            if(strcasecmp(HTTPState->Line,"Content-Length")==0)
+            {
+                HTTPState->ContentLength=strtoull(Value,NULL,10);
+                HTTPState->HaveLength=true;
+            }
+            else if(strcasecmp(HTTPState->Line,"Transfer-Encoding")==0)
+            {
+                if(strcasestr(Value,"chunked")!=NULL)
+                    HTTPState->Chunked=true;
+            }
+            else if(strcasecmp(HTTPState->Line,"Connection")==0)
+            {
+                if(strcasestr(Value,"close")!=NULL)
+                    HTTPState->KeepAlive=false;
+                else if(strcasestr(Value,"keep-alive")!=NULL)
+                    HTTPState->KeepAlive=true;
+            }
+            else if(strcasecmp(HTTPState->Line,"Content-Type")==0)
+            {
+                snprintf(HTTPState->ContentType,
+                        sizeof(HTTPState->ContentType),"%s",Value);
+            }
+            else if(strcasecmp(HTTPState->Line,"Content-Encoding")==0)
+            {
+                snprintf(HTTPState->ContentEncoding,
+                        sizeof(HTTPState->ContentEncoding),"%s",Value);
+            }
+            else if(strcasecmp(HTTPState->Line,"Upgrade")==0)
+            {
+                snprintf(HTTPState->Upgrade,sizeof(HTTPState->Upgrade),"%s",
+                        Value);
+            }
+            else if(strcasecmp(HTTPState->Line,"Sec-WebSocket-Accept")==0)
+            {
+                snprintf(HTTPState->WebSocketAccept,
+                        sizeof(HTTPState->WebSocketAccept),"%s",Value);
+            }
+        break;
+        case e_HTTPParse_Trailers:
+            /* We don't use the trailers, just look for the end of them */
+            if(HTTPState->LineLen==0)
+                HTTPState->State=e_HTTPParse_Done;
+        break;
+        case e_HTTPParse_Length:
+        case e_HTTPParse_ChunkSize:
+        case e_HTTPParse_ChunkData:
+        case e_HTTPParse_ChunkDataEnd:
+        case e_HTTPParse_UntilClose:
+        case e_HTTPParse_Done:
+        case e_HTTPParse_Upgraded:
+        case e_HTTPParseMAX:
+        default:
+        break;
+    }
+
+    HTTPState->LineLen=0;
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_HeadersDone
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_HeadersDone(struct HTTPData *HTTPState);
+ *
+ * PARAMETERS:
+ *    HTTPState [I] -- State machine data for this HTTP connection.
+ *
+ * FUNCTION:
+ *    This function is called at the blank line after the headers.  It
+ *    picks how the body is framed (RFC 9112 section 6.3): chunked wins over
+ *    Content-Length, and with neither the body runs until the server
+ *    closes the connection.  If the body is compressed (and we asked for
+ *    that) it starts the inflater, if it's the event stream we asked for
+ *    it starts the event parser.
+ *
+ *    A 101 to our WebSocket upgrade ends the HTTP part, everything after
+ *    it is passed through as is.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_HeadersDone(struct HTTPData *HTTPState)
+{
+    if(HTTPState->StatusCode==101 && HTTPState->WebSocket)
+    {
+        HTTPState->State=e_HTTPParse_Upgraded;
+        return;
+    }
+
+    /* 1xx is just an update, the real response follows */
+    if(HTTPState->StatusCode>=100 && HTTPState->StatusCode<200)
+    {
+        HTTPClient_ResetResponse(HTTPState);
+        return;
+    }
+
+    /* These never have a body */
+    if(HTTPState->StatusCode==204 || HTTPState->StatusCode==304)
+    {
+        HTTPState->State=e_HTTPParse_Done;
+        return;
     }
-    return BytesLeft;
+
+    if(HTTPState->Chunked)
+    {
+        HTTPState->BodyLeft=0;
+        HTTPState->ChunkDigits=0;
+        HTTPState->ChunkExt=false;
+        HTTPState->State=e_HTTPParse_ChunkSize;
+    }
+    else if(HTTPState->HaveLength)
+    {
+        HTTPState->BodyLeft=HTTPState->ContentLength;
+        if(HTTPState->BodyLeft==0)
+            HTTPState->State=e_HTTPParse_Done;
+        else
+            HTTPState->State=e_HTTPParse_Length;
+    }
+    else
+    {
+        HTTPState->State=e_HTTPParse_UntilClose;
+    }
+
+    if(HTTPState->State==e_HTTPParse_Done)
+        return;
+
+    if(HTTPState->SSE && HTTPState->StatusCode==200 &&
+            strncasecmp(HTTPState->ContentType,"text/event-stream",17)==0)
+    {
+        HTTPState->SSEStream=true;
+        HTTPClient_SSE_StartStream(&HTTPState->SSEData);
+        return;
+    }
+
+    if(!HTTPState->Compression)
+        return;
+
+    /* "deflate" is zlib wrapped (RFC 9110), 15+32 takes zlib or gzip */
+    if(strcasecmp(HTTPState->ContentEncoding,"gzip")==0 ||
+            strcasecmp(HTTPState->ContentEncoding,"x-gzip")==0 ||
+            strcasecmp(HTTPState->ContentEncoding,"deflate")==0)
+    {
+        memset(&HTTPState->Inflate,0,sizeof(HTTPState->Inflate));
+        if(inflateInit2(&HTTPState->Inflate,15+32)==Z_OK)
+            HTTPState->Inflating=true;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_HexDigit
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_HexDigit(uint8_t c);
+ *
+ * PARAMETERS:
+ *    c [I] -- The char to convert
+ *
+ * FUNCTION:
+ *    This function converts a hex digit to it's value.
+ *
+ * RETURNS:
+ *    The value (0-15) or -1 if 'c' isn't a hex digit.
+ ******************************************************************************/
+static int HTTPClient_HexDigit(uint8_t c)
+{
+    if(c>='0' && c<='9')
+        return c-'0';
+    if(c>='a' && c<='f')
+        return c-'a'+10;
+    if(c>='A' && c<='F')
+        return c-'A'+10;
+    return -1;
 }
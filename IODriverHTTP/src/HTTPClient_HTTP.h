@@ -33,16 +33,75 @@
 
 /***  HEADER FILES TO INCLUDE          ***/
 #include "OS/HTTPClient_Socket.h"
+#include "HTTPClient_SSE.h"
+#include "HTTPClient_WebSocket.h"
+#include <string>
+#include <zlib.h>
 
 /***  DEFINES                          ***/
+#define HTTPCLIENT_REQUEST_BUFFER_SIZE          512 // Starting size, it will grow
+#define HTTPCLIENT_MAX_HEADER_LINE              1024 // Longer header lines are cut
+#define HTTPCLIENT_MAX_HEADER_VALUE             64
+#define HTTPCLIENT_DECODE_WINDOW                16384 // Encoded bytes read at a time
 
 /***  MACROS                           ***/
 
 /***  TYPE DEFINITIONS                 ***/
+/* Where we are in the response */
+typedef enum
+{
+    e_HTTPParse_StatusLine,
+    e_HTTPParse_Headers,
+    e_HTTPParse_Length,             // Body with a Content-Length
+    e_HTTPParse_ChunkSize,          // Chunk size line (with extensions)
+    e_HTTPParse_ChunkData,
+    e_HTTPParse_ChunkDataEnd,       // The CRLF after the chunk data
+    e_HTTPParse_Trailers,           // Headers after the last chunk
+    e_HTTPParse_UntilClose,         // Body with no length, ends at close
+    e_HTTPParse_Done,               // The whole response has been read
+    e_HTTPParse_Upgraded,           // 101, the rest is the new protocol
+    e_HTTPParseMAX
+} e_HTTPParseType;
+
 struct HTTPData
 {
-    bool DoingHeaders;
-    int HeaderEndCount;
+    e_HTTPParseType State;
+    std::string Request;        // The request we sent (reused)
+    std::string::size_type RequestEnd; // Where the blank line goes
+    bool Compression;           // We asked for gzip / deflate
+    bool SSE;                   // We asked for text/event-stream
+    bool WebSocket;             // We asked to upgrade to a WebSocket
+    char WebSocketKey[HTTPCLIENT_WS_KEY_SIZE];
+
+    /* From the headers */
+    int StatusCode;
+    bool KeepAlive;
+    bool Chunked;
+    bool HaveLength;
+    uint64_t ContentLength;
+    char ContentType[HTTPCLIENT_MAX_HEADER_VALUE];
+    char ContentEncoding[HTTPCLIENT_MAX_HEADER_VALUE];
+    char Upgrade[HTTPCLIENT_MAX_HEADER_VALUE];
+    char WebSocketAccept[HTTPCLIENT_MAX_HEADER_VALUE];
+
+    /* Parser working data */
+    uint64_t BodyLeft;          // Bytes left in the body / this chunk
+    unsigned int ChunkDigits;
+    bool ChunkExt;              // Skipping the rest of the chunk size line
+    unsigned int LineLen;
+    char Line[HTTPCLIENT_MAX_HEADER_LINE];
+
+    /* Content-Encoding / event streams (the body is read in to 'Window'
+       and decoded from there) */
+    bool Inflating;
+    bool InflateEnded;          // Got the end of the compressed stream
+    bool InflateOutFull;        // Last inflate() filled the output
+    z_stream Inflate;
+    bool SSEStream;             // This body is a text/event-stream
+    struct HTTPSSEData SSEData;
+    unsigned int InPos;
+    unsigned int InLen;
+    uint8_t Window[HTTPCLIENT_DECODE_WINDOW];
 };
 
 /***  CLASS DEFINITIONS                ***/
@@ -50,9 +109,24 @@ struct HTTPData
 /***  GLOBAL VARIABLE DEFINITIONS      ***/
 
 /***  EXTERNAL FUNCTION PROTOTYPES     ***/
-bool HTTPClient_StartHTTPHandShake(t_DriverIOHandleType *DriverIO,
-        const t_PIKVList *Options,struct HTTPData *HTTPState);
-int HTTPClient_ProcessHTTPHeaders(t_DriverIOHandleType *DriverIO,
+bool HTTPClient_BuildHTTPRequest(const t_PIKVList *Options,
+        struct HTTPData *HTTPState,struct WSData *WS);
+int HTTPClient_ProcessHTTPResponse(t_DriverIOHandleType *DriverIO,
         struct HTTPData *HTTPState,uint8_t *Data,int BytesRead);
+bool HTTPClient_ResponseDone(struct HTTPData *HTTPState);
+bool HTTPClient_GotHeaders(struct HTTPData *HTTPState);
+bool HTTPClient_WebSocketUpgraded(struct HTTPData *HTTPState);
+void HTTPClient_NextResponse(struct HTTPData *HTTPState);
+void HTTPClient_InitHTTPData(struct HTTPData *HTTPState);
+void HTTPClient_FreeHTTPData(struct HTTPData *HTTPState);
+bool HTTPClient_UseDecodeWindow(struct HTTPData *HTTPState);
+bool HTTPClient_BodyNeedsDecode(struct HTTPData *HTTPState);
+void HTTPClient_DecodeInput(struct HTTPData *HTTPState,int Bytes);
+bool HTTPClient_DecodePending(struct HTTPData *HTTPState);
+int HTTPClient_Decode(struct HTTPData *HTTPState,uint8_t *Data,int MaxBytes);
+bool HTTPClient_SSEMode(struct HTTPData *HTTPState);
+bool HTTPClient_SSECanRetry(struct HTTPData *HTTPState);
+unsigned int HTTPClient_SSERetryTime(struct HTTPData *HTTPState);
+bool HTTPClient_SSEResumeRequest(struct HTTPData *HTTPState);
 
 #endif
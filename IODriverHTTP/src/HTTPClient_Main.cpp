@@ -5,13 +5,16 @@
  *    Whippy Term
  *
  * FILE DESCRIPTION:
- *    This file has a HTTP client plugin in it.
+ *    This file has a HTTP client plugin in it.  It also has the WebSocket
+ *    client driver (the same connection upgraded to a WebSocket).
  *
  *    This plugin uses the URI format:
  *      HTTP://Domain/Path:Port
+ *      WS://Domain/Path:Port
  *    Example:
  *      HTTP://localhost:80
  *      HTTP://google.com/search?abc=1:8080
+ *      WS://localhost/telemetry:8080
  *
  * COPYRIGHT:
  *    Copyright 2021 Paul Hutchinson.
@@ -46,6 +49,7 @@ using namespace std;
 
 /*** DEFINES                  ***/
 #define HTTPCLIENT_URI_PREFIX                   "HTTP"
+#define WSCLIENT_URI_PREFIX                     "WS"
 #define REGISTER_PLUGIN_FUNCTION_PRIV_NAME      HTTPClient // The name to append on the RegisterPlugin() function for built in version
 #define NEEDED_MIN_API_VERSION                  0x01000400
 
@@ -60,6 +64,11 @@ struct HTTPClient_ConWidgets
     struct PI_TextInput *GenericHeader1;
     struct PI_TextInput *GenericHeader2;
     struct PI_TextInput *GenericHeader3;
+    struct PI_NumberInput *ConnectTimeout;
+    struct PI_Checkbox *Compression;
+    struct PI_NumberInput *PollInterval;
+    struct PI_Checkbox *SSE;
+    struct PI_Checkbox *Binary;
 };
 
 /*** FUNCTION PROTOTYPES      ***/
@@ -78,6 +87,26 @@ PG_BOOL HTTPClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
 PG_BOOL HTTPClient_Convert_Options_To_URI(const char *DeviceUniqueID,
             t_PIKVList *Options,char *URI,unsigned int MaxURILen);
 PG_BOOL HTTPClient_GetConnectionInfo(const char *DeviceUniqueID,t_PIKVList *Options,struct IODriverDetectedInfo *RetInfo);
+const struct IODriverInfo *WSClient_GetDriverInfo(unsigned int *SizeOfInfo);
+const struct IODriverDetectedInfo *WSClient_DetectDevices(void);
+t_ConnectionWidgetsType *WSClient_ConnectionOptionsWidgets_AllocWidgets(
+        t_WidgetSysHandle *WidgetHandle);
+PG_BOOL WSClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
+            char *DeviceUniqueID,unsigned int MaxDeviceUniqueIDLen,
+            PG_BOOL Update);
+PG_BOOL WSClient_Convert_Options_To_URI(const char *DeviceUniqueID,
+            t_PIKVList *Options,char *URI,unsigned int MaxURILen);
+PG_BOOL WSClient_GetConnectionInfo(const char *DeviceUniqueID,t_PIKVList *Options,struct IODriverDetectedInfo *RetInfo);
+static t_ConnectionWidgetsType *HTTPClient_AllocWidgets(
+        t_WidgetSysHandle *WidgetHandle,bool WebSocket);
+static PG_BOOL HTTPClient_URIToOptions(const char *Prefix,const char *URI,
+        t_PIKVList *Options,char *DeviceUniqueID,
+        unsigned int MaxDeviceUniqueIDLen);
+static PG_BOOL HTTPClient_OptionsToURI(const char *Prefix,t_PIKVList *Options,
+        char *URI,unsigned int MaxURILen);
+static PG_BOOL HTTPClient_FillConnectionInfo(
+        const struct IODriverDetectedInfo *DeviceInfo,t_PIKVList *Options,
+        struct IODriverDetectedInfo *RetInfo);
 
 /*** VARIABLE DEFINITIONS     ***/
 const struct IODriverAPI g_HTTPClientPluginAPI=
@@ -105,6 +134,33 @@ const struct IODriverAPI g_HTTPClientPluginAPI=
     NULL,                                                   // Transmit
 };
 
+/* The WS driver shares the connection code, only the URI, the options and
+   the device info are different */
+const struct IODriverAPI g_WSClientPluginAPI=
+{
+    HTTPClient_Init,
+    WSClient_GetDriverInfo,
+    NULL,                                               // InstallPlugin
+    NULL,                                               // UnInstallPlugin
+    WSClient_DetectDevices,
+    HTTPClient_FreeDetectedDevices,
+    WSClient_GetConnectionInfo,
+    WSClient_ConnectionOptionsWidgets_AllocWidgets,
+    HTTPClient_ConnectionOptionsWidgets_FreeWidgets,
+    HTTPClient_ConnectionOptionsWidgets_StoreUI,
+    HTTPClient_ConnectionOptionsWidgets_UpdateUI,
+    WSClient_Convert_URI_To_Options,
+    WSClient_Convert_Options_To_URI,
+    WSClient_AllocateHandle,
+    HTTPClient_FreeHandle,
+    HTTPClient_Open,
+    HTTPClient_Close,
+    HTTPClient_Read,
+    HTTPClient_Write,
+    HTTPClient_ChangeOptions,
+    NULL,                                                   // Transmit
+};
+
 struct IODriverInfo m_HTTPClientInfo=
 {
     0,
@@ -115,6 +171,16 @@ struct IODriverInfo m_HTTPClientInfo=
     "<Example>HTTP://localhost:2000/test.php?one=1</Example>"
 };
 
+struct IODriverInfo m_WSClientInfo=
+{
+    0,
+    "<URI>WS://[host][:port][/path]</URI>"
+    "<ARG>host -- The server to connect to</ARG>"
+    "<ARG>port -- The port number to connect to.  If this is provided then port 80 will be used.</ARG>"
+    "<ARG>path -- The path of the WebSocket on the server.  This can include a query (?).</ARG>"
+    "<Example>WS://localhost:8080/telemetry</Example>"
+};
+
 const struct IOS_API *g_HC_IOSystem;
 const struct PI_UIAPI *g_HC_UI;
 const struct PI_SystemAPI *g_HC_System;
@@ -129,6 +195,16 @@ static const struct IODriverDetectedInfo g_HC_DeviceInfo=
     "HTTPClient",           // Title
 };
 
+static const struct IODriverDetectedInfo g_WS_DeviceInfo=
+{
+    NULL,
+    sizeof(struct IODriverDetectedInfo),
+    0,                      // Flags
+    WSCLIENT_URI_PREFIX,    // DeviceUniqueID
+    "WebSocket Client",     // Name
+    "WSClient",             // Title
+};
+
 
 /*******************************************************************************
  * NAME:
@@ -182,6 +258,8 @@ extern "C"
 
         g_HC_IOSystem->RegisterDriver("HTTPClient",HTTPCLIENT_URI_PREFIX,
                 &g_HTTPClientPluginAPI,sizeof(g_HTTPClientPluginAPI));
+        g_HC_IOSystem->RegisterDriver("WSClient",WSCLIENT_URI_PREFIX,
+                &g_WSClientPluginAPI,sizeof(g_WSClientPluginAPI));
 
         return 0;
     }
@@ -240,6 +318,12 @@ const struct IODriverInfo *HTTPClient_GetDriverInfo(unsigned int *SizeOfInfo)
     return &m_HTTPClientInfo;
 }
 
+const struct IODriverInfo *WSClient_GetDriverInfo(unsigned int *SizeOfInfo)
+{
+    *SizeOfInfo=sizeof(struct IODriverInfo);
+    return &m_WSClientInfo;
+}
+
 /*******************************************************************************
  * NAME:
  *    DetectDevices
@@ -291,6 +375,11 @@ const struct IODriverDetectedInfo *HTTPClient_DetectDevices(void)
     return &g_HC_DeviceInfo;
 }
 
+const struct IODriverDetectedInfo *WSClient_DetectDevices(void)
+{
+    return &g_WS_DeviceInfo;
+}
+
 /*******************************************************************************
  * NAME:
  *    FreeDetectedDevices
@@ -349,6 +438,61 @@ void HTTPClient_FreeDetectedDevices(const struct IODriverDetectedInfo *Devices)
  ******************************************************************************/
 t_ConnectionWidgetsType *HTTPClient_ConnectionOptionsWidgets_AllocWidgets(
         t_WidgetSysHandle *WidgetHandle)
+{
+    return HTTPClient_AllocWidgets(WidgetHandle,false);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    WSClient_ConnectionOptionsWidgets_AllocWidgets
+ *
+ * SYNOPSIS:
+ *    t_ConnectionWidgetsType *WSClient_ConnectionOptionsWidgets_AllocWidgets(
+ *          t_WidgetSysHandle *WidgetHandle);
+ *
+ * PARAMETERS:
+ *    WidgetHandle [I] -- The handle to send to the widgets
+ *
+ * FUNCTION:
+ *    This function adds the options widgets for the WS driver.  It's the
+ *    same as HTTPClient_ConnectionOptionsWidgets_AllocWidgets() without
+ *    the options that only make sense for pages (compression, polling,
+ *    event streams) and with a text / binary option.
+ *
+ * RETURNS:
+ *    The private options data or NULL on error.
+ *
+ * SEE ALSO:
+ *    HTTPClient_ConnectionOptionsWidgets_AllocWidgets()
+ ******************************************************************************/
+t_ConnectionWidgetsType *WSClient_ConnectionOptionsWidgets_AllocWidgets(
+        t_WidgetSysHandle *WidgetHandle)
+{
+    return HTTPClient_AllocWidgets(WidgetHandle,true);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_AllocWidgets
+ *
+ * SYNOPSIS:
+ *    static t_ConnectionWidgetsType *HTTPClient_AllocWidgets(
+ *          t_WidgetSysHandle *WidgetHandle,bool WebSocket);
+ *
+ * PARAMETERS:
+ *    WidgetHandle [I] -- The handle to send to the widgets
+ *    WebSocket [I] -- Add the widgets for the WS driver (true) or the HTTP
+ *                     driver (false)
+ *
+ * FUNCTION:
+ *    This function does the work for the AllocWidgets() of both drivers.
+ *    The widgets a driver doesn't use are left NULL.
+ *
+ * RETURNS:
+ *    The private options data or NULL on error.
+ ******************************************************************************/
+static t_ConnectionWidgetsType *HTTPClient_AllocWidgets(
+        t_WidgetSysHandle *WidgetHandle,bool WebSocket)
 {
     struct HTTPClient_ConWidgets *ConWidgets;
 
@@ -363,6 +507,11 @@ t_ConnectionWidgetsType *HTTPClient_ConnectionOptionsWidgets_AllocWidgets(
         ConWidgets->GenericHeader1=NULL;
         ConWidgets->GenericHeader2=NULL;
         ConWidgets->GenericHeader3=NULL;
+        ConWidgets->ConnectTimeout=NULL;
+        ConWidgets->Compression=NULL;
+        ConWidgets->PollInterval=NULL;
+        ConWidgets->SSE=NULL;
+        ConWidgets->Binary=NULL;
 
         ConWidgets->ServerAddress=g_HC_UI->AddTextInput(WidgetHandle,
                 "Server",NULL,NULL);
@@ -396,6 +545,43 @@ t_ConnectionWidgetsType *HTTPClient_ConnectionOptionsWidgets_AllocWidgets(
                 "Extra Header",NULL,NULL);
         if(ConWidgets->GenericHeader3==NULL)
             throw(0);
+
+        ConWidgets->ConnectTimeout=g_HC_UI->AddNumberInput(WidgetHandle,
+                "Connect Timeout (ms)",NULL,NULL);
+        if(ConWidgets->ConnectTimeout==NULL)
+            throw(0);
+
+        g_HC_UI->SetNumberInputMinMax(WidgetHandle,
+                ConWidgets->ConnectTimeout->Ctrl,100,600000);
+
+        if(WebSocket)
+        {
+            ConWidgets->Binary=g_HC_UI->AddCheckbox(WidgetHandle,
+                    "Send binary messages (not text)",NULL,NULL);
+            if(ConWidgets->Binary==NULL)
+                throw(0);
+
+            return (t_ConnectionWidgetsType *)ConWidgets;
+        }
+
+        ConWidgets->Compression=g_HC_UI->AddCheckbox(WidgetHandle,
+                "Ask for compressed (gzip / deflate) pages",NULL,NULL);
+        if(ConWidgets->Compression==NULL)
+            throw(0);
+
+        ConWidgets->PollInterval=g_HC_UI->AddNumberInput(WidgetHandle,
+                "Poll every (ms, 0 = just once)",NULL,NULL);
+        if(ConWidgets->PollInterval==NULL)
+            throw(0);
+
+        g_HC_UI->SetNumberInputMinMax(WidgetHandle,
+                ConWidgets->PollInterval->Ctrl,0,3600000);
+
+        ConWidgets->SSE=g_HC_UI->AddCheckbox(WidgetHandle,
+                "Event stream (text/event-stream, one line per event)",NULL,
+                NULL);
+        if(ConWidgets->SSE==NULL)
+            throw(0);
     }
     catch(...)
     {
@@ -413,6 +599,16 @@ t_ConnectionWidgetsType *HTTPClient_ConnectionOptionsWidgets_AllocWidgets(
                 g_HC_UI->FreeTextInput(WidgetHandle,ConWidgets->GenericHeader2);
             if(ConWidgets->GenericHeader3!=NULL)
                 g_HC_UI->FreeTextInput(WidgetHandle,ConWidgets->GenericHeader3);
+            if(ConWidgets->ConnectTimeout!=NULL)
+                g_HC_UI->FreeNumberInput(WidgetHandle,ConWidgets->ConnectTimeout);
+            if(ConWidgets->Compression!=NULL)
+                g_HC_UI->FreeCheckbox(WidgetHandle,ConWidgets->Compression);
+            if(ConWidgets->PollInterval!=NULL)
+                g_HC_UI->FreeNumberInput(WidgetHandle,ConWidgets->PollInterval);
+            if(ConWidgets->SSE!=NULL)
+                g_HC_UI->FreeCheckbox(WidgetHandle,ConWidgets->SSE);
+            if(ConWidgets->Binary!=NULL)
+                g_HC_UI->FreeCheckbox(WidgetHandle,ConWidgets->Binary);
 
             delete ConWidgets;
         }
@@ -461,6 +657,16 @@ void HTTPClient_ConnectionOptionsWidgets_FreeWidgets(
         g_HC_UI->FreeTextInput(WidgetHandle,ConWidgets->GenericHeader2);
     if(ConWidgets->GenericHeader3!=NULL)
         g_HC_UI->FreeTextInput(WidgetHandle,ConWidgets->GenericHeader3);
+    if(ConWidgets->ConnectTimeout!=NULL)
+        g_HC_UI->FreeNumberInput(WidgetHandle,ConWidgets->ConnectTimeout);
+    if(ConWidgets->Compression!=NULL)
+        g_HC_UI->FreeCheckbox(WidgetHandle,ConWidgets->Compression);
+    if(ConWidgets->PollInterval!=NULL)
+        g_HC_UI->FreeNumberInput(WidgetHandle,ConWidgets->PollInterval);
+    if(ConWidgets->SSE!=NULL)
+        g_HC_UI->FreeCheckbox(WidgetHandle,ConWidgets->SSE);
+    if(ConWidgets->Binary!=NULL)
+        g_HC_UI->FreeCheckbox(WidgetHandle,ConWidgets->Binary);
 
     delete ConWidgets;
 }
@@ -504,11 +710,21 @@ void HTTPClient_ConnectionOptionsWidgets_StoreUI(
     uint16_t PortNum;
     const char *PathStr;
     const char *GenericHeaderStr;
-
+    char TimeoutStr[100];
+    unsigned int Timeout;
+    bool Compression;
+    char IntervalStr[100];
+    unsigned int Interval;
+    bool SSE;
+    bool Binary;
+
+    /* Compression, PollInterval, SSE and Binary are only there for one of
+       the drivers */
     if(ConWidgets->ServerAddress==NULL || ConWidgets->PortNumber==NULL ||
             ConWidgets->Path==NULL || ConWidgets->GenericHeader1==NULL ||
             ConWidgets->GenericHeader2==NULL ||
-            ConWidgets->GenericHeader3==NULL)
+            ConWidgets->GenericHeader3==NULL ||
+            ConWidgets->ConnectTimeout==NULL)
     {
         return;
     }
@@ -539,6 +755,39 @@ void HTTPClient_ConnectionOptionsWidgets_StoreUI(
     GenericHeaderStr=g_HC_UI->GetTextInputText(WidgetHandle,
             ConWidgets->GenericHeader3->Ctrl);
     g_HC_System->KVAddItem(Options,"GenericHeader3",GenericHeaderStr);
+
+    Timeout=g_HC_UI->GetNumberInputValue(WidgetHandle,
+            ConWidgets->ConnectTimeout->Ctrl);
+    sprintf(TimeoutStr,"%u",Timeout);
+    g_HC_System->KVAddItem(Options,"ConnectTimeout",TimeoutStr);
+
+    if(ConWidgets->Compression!=NULL)
+    {
+        Compression=g_HC_UI->IsCheckboxChecked(WidgetHandle,
+                ConWidgets->Compression->Ctrl);
+        g_HC_System->KVAddItem(Options,"Compression",Compression?"1":"0");
+    }
+
+    if(ConWidgets->PollInterval!=NULL)
+    {
+        Interval=g_HC_UI->GetNumberInputValue(WidgetHandle,
+                ConWidgets->PollInterval->Ctrl);
+        sprintf(IntervalStr,"%u",Interval);
+        g_HC_System->KVAddItem(Options,"PollInterval",IntervalStr);
+    }
+
+    if(ConWidgets->SSE!=NULL)
+    {
+        SSE=g_HC_UI->IsCheckboxChecked(WidgetHandle,ConWidgets->SSE->Ctrl);
+        g_HC_System->KVAddItem(Options,"SSE",SSE?"1":"0");
+    }
+
+    if(ConWidgets->Binary!=NULL)
+    {
+        Binary=g_HC_UI->IsCheckboxChecked(WidgetHandle,
+                ConWidgets->Binary->Ctrl);
+        g_HC_System->KVAddItem(Options,"Binary",Binary?"1":"0");
+    }
 }
 
 /*******************************************************************************
@@ -578,9 +827,14 @@ void HTTPClient_ConnectionOptionsWidgets_UpdateUI(
     const char *PortStr;
     uint16_t PortNum;
     const char *PathStr;
+    const char *TimeoutStr;
+    const char *CompressionStr;
+    const char *IntervalStr;
+    const char *SSEStr;
+    const char *BinaryStr;
 
     if(ConWidgets->ServerAddress==NULL || ConWidgets->PortNumber==NULL ||
-            ConWidgets->Path==NULL)
+            ConWidgets->Path==NULL || ConWidgets->ConnectTimeout==NULL)
     {
         return;
     }
@@ -588,11 +842,26 @@ void HTTPClient_ConnectionOptionsWidgets_UpdateUI(
     AddressStr=g_HC_System->KVGetItem(Options,"Address");
     PortStr=g_HC_System->KVGetItem(Options,"Port");
     PathStr=g_HC_System->KVGetItem(Options,"Path");
+    TimeoutStr=g_HC_System->KVGetItem(Options,"ConnectTimeout");
+    CompressionStr=g_HC_System->KVGetItem(Options,"Compression");
+    IntervalStr=g_HC_System->KVGetItem(Options,"PollInterval");
+    SSEStr=g_HC_System->KVGetItem(Options,"SSE");
+    BinaryStr=g_HC_System->KVGetItem(Options,"Binary");
 
     if(AddressStr==NULL)
         AddressStr="localhost";
     if(PortStr==NULL)
         PortStr="80";
+    if(TimeoutStr==NULL)
+        TimeoutStr="10000";
+    if(CompressionStr==NULL)
+        CompressionStr="0";
+    if(IntervalStr==NULL)
+        IntervalStr="0";
+    if(SSEStr==NULL)
+        SSEStr="0";
+    if(BinaryStr==NULL)
+        BinaryStr="0";
 
     g_HC_UI->SetTextInputText(WidgetHandle,ConWidgets->ServerAddress->Ctrl,
             AddressStr);
@@ -602,6 +871,33 @@ void HTTPClient_ConnectionOptionsWidgets_UpdateUI(
             PortNum);
 
     g_HC_UI->SetTextInputText(WidgetHandle,ConWidgets->Path->Ctrl,PathStr);
+
+    g_HC_UI->SetNumberInputValue(WidgetHandle,ConWidgets->ConnectTimeout->Ctrl,
+            atoi(TimeoutStr));
+
+    if(ConWidgets->Compression!=NULL)
+    {
+        g_HC_UI->SetCheckboxChecked(WidgetHandle,ConWidgets->Compression->Ctrl,
+                atoi(CompressionStr)!=0);
+    }
+
+    if(ConWidgets->PollInterval!=NULL)
+    {
+        g_HC_UI->SetNumberInputValue(WidgetHandle,
+                ConWidgets->PollInterval->Ctrl,atoi(IntervalStr));
+    }
+
+    if(ConWidgets->SSE!=NULL)
+    {
+        g_HC_UI->SetCheckboxChecked(WidgetHandle,ConWidgets->SSE->Ctrl,
+                atoi(SSEStr)!=0);
+    }
+
+    if(ConWidgets->Binary!=NULL)
+    {
+        g_HC_UI->SetCheckboxChecked(WidgetHandle,ConWidgets->Binary->Ctrl,
+                atoi(BinaryStr)!=0);
+    }
 }
 
 /*******************************************************************************
@@ -635,6 +931,44 @@ void HTTPClient_ConnectionOptionsWidgets_UpdateUI(
  ******************************************************************************/
 PG_BOOL HTTPClient_Convert_Options_To_URI(const char *DeviceUniqueID,
             t_PIKVList *Options,char *URI,unsigned int MaxURILen)
+{
+    return HTTPClient_OptionsToURI(HTTPCLIENT_URI_PREFIX,Options,URI,
+            MaxURILen);
+}
+
+PG_BOOL WSClient_Convert_Options_To_URI(const char *DeviceUniqueID,
+            t_PIKVList *Options,char *URI,unsigned int MaxURILen)
+{
+    return HTTPClient_OptionsToURI(WSCLIENT_URI_PREFIX,Options,URI,MaxURILen);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OptionsToURI
+ *
+ * SYNOPSIS:
+ *    static PG_BOOL HTTPClient_OptionsToURI(const char *Prefix,
+ *          t_PIKVList *Options,char *URI,unsigned int MaxURILen);
+ *
+ * PARAMETERS:
+ *    Prefix [I] -- The URI prefix for the driver ("HTTP" or "WS")
+ *    Options [I] -- The options for this connection.
+ *    URI [O] -- A buffer to fill with the URI for this connection.
+ *    MaxURILen [I] -- The size of the 'URI' buffer.
+ *
+ * FUNCTION:
+ *    This function does the work for Convert_Options_To_URI() for both
+ *    drivers.
+ *
+ * RETURNS:
+ *    true -- all ok
+ *    false -- There was an error
+ *
+ * SEE ALSO:
+ *    HTTPClient_Convert_Options_To_URI()
+ ******************************************************************************/
+static PG_BOOL HTTPClient_OptionsToURI(const char *Prefix,t_PIKVList *Options,
+        char *URI,unsigned int MaxURILen)
 {
     const char *AddressStr;
     const char *PortStr;
@@ -646,13 +980,13 @@ PG_BOOL HTTPClient_Convert_Options_To_URI(const char *DeviceUniqueID,
     if(AddressStr==NULL || PortStr==NULL || PathStr==NULL)
         return false;
 
-    if(strlen(HTTPCLIENT_URI_PREFIX)+1+strlen(AddressStr)+1+
+    if(strlen(Prefix)+3+strlen(AddressStr)+1+
             strlen(PathStr)+1+strlen(PortStr)+1>=MaxURILen)
     {
         return false;
     }
 
-    strcpy(URI,HTTPCLIENT_URI_PREFIX);
+    strcpy(URI,Prefix);
     strcat(URI,"://");
     strcat(URI,AddressStr);
     if(strcmp(PortStr,"80")!=0)
@@ -700,6 +1034,50 @@ PG_BOOL HTTPClient_Convert_Options_To_URI(const char *DeviceUniqueID,
 PG_BOOL HTTPClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
             char *DeviceUniqueID,unsigned int MaxDeviceUniqueIDLen,
             PG_BOOL Update)
+{
+    return HTTPClient_URIToOptions(HTTPCLIENT_URI_PREFIX,URI,Options,
+            DeviceUniqueID,MaxDeviceUniqueIDLen);
+}
+
+PG_BOOL WSClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
+            char *DeviceUniqueID,unsigned int MaxDeviceUniqueIDLen,
+            PG_BOOL Update)
+{
+    return HTTPClient_URIToOptions(WSCLIENT_URI_PREFIX,URI,Options,
+            DeviceUniqueID,MaxDeviceUniqueIDLen);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_URIToOptions
+ *
+ * SYNOPSIS:
+ *    static PG_BOOL HTTPClient_URIToOptions(const char *Prefix,
+ *          const char *URI,t_PIKVList *Options,char *DeviceUniqueID,
+ *          unsigned int MaxDeviceUniqueIDLen);
+ *
+ * PARAMETERS:
+ *    Prefix [I] -- The URI prefix for the driver ("HTTP" or "WS")
+ *    URI [I] -- The URI to convert to a device ID and options.
+ *    Options [O] -- The options for this new connection.
+ *    DeviceUniqueID [O] -- The unique ID for this device build from the 'URI'
+ *    MaxDeviceUniqueIDLen [I] -- The max length of the buffer for
+ *          'DeviceUniqueID'
+ *
+ * FUNCTION:
+ *    This function does the work for Convert_URI_To_Options() for both
+ *    drivers.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- There was an error
+ *
+ * SEE ALSO:
+ *    HTTPClient_Convert_URI_To_Options()
+ ******************************************************************************/
+static PG_BOOL HTTPClient_URIToOptions(const char *Prefix,const char *URI,
+        t_PIKVList *Options,char *DeviceUniqueID,
+        unsigned int MaxDeviceUniqueIDLen)
 {
     char *Pos;
     char FirstPathChar;
@@ -710,9 +1088,9 @@ PG_BOOL HTTPClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
     uint16_t PortNum;
     char PortBuff[100];
 
-    /* Make sure it starts with HTTP:// */
-    if(strncasecmp(URI,HTTPCLIENT_URI_PREFIX "://",
-            (sizeof(HTTPCLIENT_URI_PREFIX)-1)+2)!=0)   // +2 for '//'
+    /* Make sure it starts with HTTP:// (or WS://) */
+    if(strncasecmp(URI,Prefix,strlen(Prefix))!=0 ||
+            strncmp(&URI[strlen(Prefix)],"://",3)!=0)
     {
         return false;
     }
@@ -724,7 +1102,7 @@ PG_BOOL HTTPClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
 
     /* Pull apart the URI */
     Pos=URICopy;
-    Pos+=sizeof(HTTPCLIENT_URI_PREFIX)-1;  // -1 because of the \0
+    Pos+=strlen(Prefix);
     Pos+=3;    // Slip ://
 
     SrvAddress=Pos;
@@ -793,7 +1171,7 @@ PG_BOOL HTTPClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
         return false;
     }
 
-    strcpy(DeviceUniqueID,HTTPCLIENT_URI_PREFIX);
+    strcpy(DeviceUniqueID,Prefix);
 
     free(URICopy);
 
@@ -828,16 +1206,53 @@ PG_BOOL HTTPClient_Convert_URI_To_Options(const char *URI,t_PIKVList *Options,
  ******************************************************************************/
 PG_BOOL HTTPClient_GetConnectionInfo(const char *DeviceUniqueID,
         t_PIKVList *Options,struct IODriverDetectedInfo *RetInfo)
+{
+    return HTTPClient_FillConnectionInfo(&g_HC_DeviceInfo,Options,RetInfo);
+}
+
+PG_BOOL WSClient_GetConnectionInfo(const char *DeviceUniqueID,
+        t_PIKVList *Options,struct IODriverDetectedInfo *RetInfo)
+{
+    return HTTPClient_FillConnectionInfo(&g_WS_DeviceInfo,Options,RetInfo);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_FillConnectionInfo
+ *
+ * SYNOPSIS:
+ *    static PG_BOOL HTTPClient_FillConnectionInfo(
+ *          const struct IODriverDetectedInfo *DeviceInfo,t_PIKVList *Options,
+ *          struct IODriverDetectedInfo *RetInfo);
+ *
+ * PARAMETERS:
+ *    DeviceInfo [I] -- The device info for the driver
+ *    Options [I] -- The options for this connection
+ *    RetInfo [O] -- The structure to fill in with info about this device.
+ *
+ * FUNCTION:
+ *    This function does the work for GetConnectionInfo() for both drivers.
+ *
+ * RETURNS:
+ *    true -- 'RetInfo' has been filled in.
+ *    false -- There was an error in getting the info.
+ *
+ * SEE ALSO:
+ *    HTTPClient_GetConnectionInfo()
+ ******************************************************************************/
+static PG_BOOL HTTPClient_FillConnectionInfo(
+        const struct IODriverDetectedInfo *DeviceInfo,t_PIKVList *Options,
+        struct IODriverDetectedInfo *RetInfo)
 {
     const char *AddressStr;
     const char *PortStr;
     string Title;
 
     /* Fill in defaults */
-    strcpy(RetInfo->Name,g_HC_DeviceInfo.Name);
+    strcpy(RetInfo->Name,DeviceInfo->Name);
     RetInfo->Flags=0;
 
-    Title=g_HC_DeviceInfo.Title;
+    Title=DeviceInfo->Title;
 
     AddressStr=g_HC_System->KVGetItem(Options,"Address");
     if(AddressStr!=NULL)
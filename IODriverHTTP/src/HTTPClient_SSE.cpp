@@ -0,0 +1,493 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_SSE.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the Server-Sent Events (text/event-stream) parser.  It
+ *    takes the body of the response and turns each event in to one line
+ *    of output:
+ *       "type: data" (or just "data" for events without an "event:" field)
+ *    with more than one "data:" line joined with spaces.
+ *
+ *    The parser is fed a byte at a time (it can stop anywhere) and only
+ *    uses the fixed buffers in 'struct HTTPSSEData'.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "HTTPClient_SSE.h"
+#include <string.h>
+
+/*** DEFINES                  ***/
+#define HTTPCLIENT_SSE_MAX_RETRY                3600000 // ms
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+
+/*** FUNCTION PROTOTYPES      ***/
+static void HTTPClient_SSE_StartField(struct HTTPSSEData *SSE);
+static void HTTPClient_SSE_AddValue(struct HTTPSSEData *SSE,
+        const uint8_t *Value,unsigned int Len);
+static void HTTPClient_SSE_EndOfLine(struct HTTPSSEData *SSE);
+static void HTTPClient_SSE_Dispatch(struct HTTPSSEData *SSE);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_Init
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_SSE_Init(struct HTTPSSEData *SSE);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data to init
+ *
+ * FUNCTION:
+ *    This function sets up the SSE data for a new connection (forgets the
+ *    last event ID and retry time).
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_SSE_StartStream()
+ ******************************************************************************/
+void HTTPClient_SSE_Init(struct HTTPSSEData *SSE)
+{
+    SSE->LastEventID[0]=0;
+    SSE->RetryMS=HTTPCLIENT_SSE_DEFAULT_RETRY;
+    HTTPClient_SSE_StartStream(SSE);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_StartStream
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_SSE_StartStream(struct HTTPSSEData *SSE);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *
+ * FUNCTION:
+ *    This function gets the parser ready for a new event stream (after we
+ *    reconnect).  Anything from a half sent event is thrown away (including
+ *    it's ID), the last event ID and the retry time are kept.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void HTTPClient_SSE_StartStream(struct HTTPSSEData *SSE)
+{
+    SSE->State=e_SSEParse_FieldName;
+    SSE->Field=e_SSEField_Ignore;
+    SSE->LastWasCR=false;
+    SSE->FieldNameLen=0;
+    SSE->DataLines=0;
+    SSE->DataLen=0;
+    SSE->EventTypeLen=0;
+    SSE->IDLen=0;
+    SSE->IDHasNull=false;
+    SSE->HavePendingID=false;
+    SSE->RetryValue=0;
+    SSE->RetryValid=false;
+    SSE->EmitPos=0;
+    SSE->EmitLen=0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_Pending
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_SSE_Pending(struct HTTPSSEData *SSE);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *
+ * FUNCTION:
+ *    This function checks if there is part of an event line that didn't fit
+ *    in the caller's buffer last time.
+ *
+ * RETURNS:
+ *    true -- Call HTTPClient_SSE_Decode() again (even with no input)
+ *    false -- Nothing is waiting
+ ******************************************************************************/
+bool HTTPClient_SSE_Pending(struct HTTPSSEData *SSE)
+{
+    return SSE->EmitPos<SSE->EmitLen;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_Decode
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_SSE_Decode(struct HTTPSSEData *SSE,const uint8_t *In,
+ *          unsigned int InLen,unsigned int *InPos,uint8_t *Out,int MaxBytes);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *    In [I] -- The event stream bytes
+ *    InLen [I] -- The number of bytes in 'In'
+ *    InPos [I/O] -- How far through 'In' we are.  This is moved along as
+ *                   bytes are used.
+ *    Out [O] -- Where to put the event lines
+ *    MaxBytes [I] -- The size of 'Out'
+ *
+ * FUNCTION:
+ *    This function runs the event stream parser over 'In' and puts a line
+ *    in 'Out' for each event that is finished.  It stops when 'Out' is
+ *    full (the rest of the line is kept for next time and 'InPos' is left
+ *    where we stopped) or all of 'In' has been used.
+ *
+ * RETURNS:
+ *    The number of bytes put in 'Out'
+ *
+ * SEE ALSO:
+ *    HTTPClient_SSE_Pending()
+ ******************************************************************************/
+int HTTPClient_SSE_Decode(struct HTTPSSEData *SSE,const uint8_t *In,
+        unsigned int InLen,unsigned int *InPos,uint8_t *Out,int MaxBytes)
+{
+    unsigned int Pos;
+    unsigned int Run;
+    unsigned int Bytes;
+    int OutLen;
+    uint8_t c;
+
+    Pos=*InPos;
+    OutLen=0;
+    while(OutLen<MaxBytes)
+    {
+        if(SSE->EmitPos<SSE->EmitLen)
+        {
+            Bytes=SSE->EmitLen-SSE->EmitPos;
+            if(Bytes>(unsigned int)(MaxBytes-OutLen))
+                Bytes=MaxBytes-OutLen;
+            memcpy(&Out[OutLen],&SSE->Emit[SSE->EmitPos],Bytes);
+            SSE->EmitPos+=Bytes;
+            OutLen+=Bytes;
+            continue;
+        }
+
+        if(Pos>=InLen)
+            break;
+
+        c=In[Pos];
+        if(SSE->LastWasCR)
+        {
+            /* The \n of a \r\n */
+            SSE->LastWasCR=false;
+            if(c=='\n')
+            {
+                Pos++;
+                continue;
+            }
+        }
+        if(c=='\r' || c=='\n')
+        {
+            SSE->LastWasCR=(c=='\r');
+            Pos++;
+            HTTPClient_SSE_EndOfLine(SSE);
+            continue;
+        }
+
+        switch(SSE->State)
+        {
+            case e_SSEParse_FieldName:
+                if(c==':')
+                {
+                    HTTPClient_SSE_StartField(SSE);
+                    SSE->State=e_SSEParse_ValueStart;
+                }
+                else
+                {
+                    if(SSE->FieldNameLen<sizeof(SSE->FieldName))
+                        SSE->FieldName[SSE->FieldNameLen]=c;
+                    SSE->FieldNameLen++;
+                }
+                Pos++;
+            break;
+            case e_SSEParse_ValueStart:
+                /* One space after the ':' isn't part of the value */
+                SSE->State=e_SSEParse_Value;
+                if(c==' ')
+                    Pos++;
+            break;
+            case e_SSEParse_Value:
+                for(Run=Pos;Run<InLen && In[Run]!='\n' && In[Run]!='\r';Run++)
+                    ;
+                HTTPClient_SSE_AddValue(SSE,&In[Pos],Run-Pos);
+                Pos=Run;
+            break;
+            case e_SSEParseMAX:
+            default:
+                SSE->State=e_SSEParse_FieldName;
+            break;
+        }
+    }
+    *InPos=Pos;
+
+    return OutLen;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_StartField
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_SSE_StartField(struct HTTPSSEData *SSE);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *
+ * FUNCTION:
+ *    This function is called when we have the whole field name (at the ':'
+ *    or the end of the line).  It works out where the value goes.  Lines
+ *    starting with ':' are comments (an empty field name) and fall in to
+ *    e_SSEField_Ignore.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_SSE_StartField(struct HTTPSSEData *SSE)
+{
+    SSE->Field=e_SSEField_Ignore;
+    if(SSE->FieldNameLen==4 && memcmp(SSE->FieldName,"data",4)==0)
+    {
+        SSE->Field=e_SSEField_Data;
+        if(SSE->DataLines>0 && SSE->DataLen<sizeof(SSE->Data))
+            SSE->Data[SSE->DataLen++]=' ';
+        SSE->DataLines++;
+    }
+    else if(SSE->FieldNameLen==5 && memcmp(SSE->FieldName,"event",5)==0)
+    {
+        SSE->Field=e_SSEField_Event;
+        SSE->EventTypeLen=0;
+    }
+    else if(SSE->FieldNameLen==2 && memcmp(SSE->FieldName,"id",2)==0)
+    {
+        SSE->Field=e_SSEField_ID;
+        SSE->IDLen=0;
+        SSE->IDHasNull=false;
+    }
+    else if(SSE->FieldNameLen==5 && memcmp(SSE->FieldName,"retry",5)==0)
+    {
+        SSE->Field=e_SSEField_Retry;
+        SSE->RetryValue=0;
+        SSE->RetryValid=false;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_AddValue
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_SSE_AddValue(struct HTTPSSEData *SSE,
+ *          const uint8_t *Value,unsigned int Len);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *    Value [I] -- Part of the value of the current field
+ *    Len [I] -- The number of bytes in 'Value'
+ *
+ * FUNCTION:
+ *    This function adds to the value of the current field.  Anything that
+ *    doesn't fit in the buffers is dropped.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_SSE_AddValue(struct HTTPSSEData *SSE,
+        const uint8_t *Value,unsigned int Len)
+{
+    unsigned int Space;
+    unsigned int r;
+
+    switch(SSE->Field)
+    {
+        case e_SSEField_Data:
+            Space=sizeof(SSE->Data)-SSE->DataLen;
+            if(Len>Space)
+                Len=Space;
+            memcpy(&SSE->Data[SSE->DataLen],Value,Len);
+            SSE->DataLen+=Len;
+        break;
+        case e_SSEField_Event:
+            Space=sizeof(SSE->EventType)-SSE->EventTypeLen;
+            if(Len>Space)
+                Len=Space;
+            memcpy(&SSE->EventType[SSE->EventTypeLen],Value,Len);
+            SSE->EventTypeLen+=Len;
+        break;
+        case e_SSEField_ID:
+            if(memchr(Value,0,Len)!=NULL)
+                SSE->IDHasNull=true;
+            Space=sizeof(SSE->ID)-1-SSE->IDLen;
+            if(Len>Space)
+                Len=Space;
+            memcpy(&SSE->ID[SSE->IDLen],Value,Len);
+            SSE->IDLen+=Len;
+        break;
+        case e_SSEField_Retry:
+            /* Only ASCII digits, anything else and the field is ignored */
+            SSE->RetryValid=true;
+            for(r=0;r<Len;r++)
+            {
+                if(Value[r]<'0' || Value[r]>'9')
+                {
+                    SSE->Field=e_SSEField_Ignore;
+                    SSE->RetryValid=false;
+                    break;
+                }
+                if(SSE->RetryValue<HTTPCLIENT_SSE_MAX_RETRY)
+                    SSE->RetryValue=SSE->RetryValue*10+(Value[r]-'0');
+            }
+        break;
+        case e_SSEField_Ignore:
+        case e_SSEFieldMAX:
+        default:
+        break;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_EndOfLine
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_SSE_EndOfLine(struct HTTPSSEData *SSE);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *
+ * FUNCTION:
+ *    This function finishes the current line.  A blank line sends the
+ *    event and the "retry" field takes effect here.  The "id" field is
+ *    held with the event until it's sent (so if the stream drops before
+ *    the blank line we resume from the event before it).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_SSE_EndOfLine(struct HTTPSSEData *SSE)
+{
+    if(SSE->State==e_SSEParse_FieldName)
+    {
+        if(SSE->FieldNameLen==0)
+        {
+            HTTPClient_SSE_Dispatch(SSE);
+            return;
+        }
+
+        /* A field name with no ':' has an empty value */
+        HTTPClient_SSE_StartField(SSE);
+    }
+
+    switch(SSE->Field)
+    {
+        case e_SSEField_ID:
+            if(!SSE->IDHasNull)
+            {
+                memcpy(SSE->PendingID,SSE->ID,SSE->IDLen);
+                SSE->PendingID[SSE->IDLen]=0;
+                SSE->HavePendingID=true;
+            }
+        break;
+        case e_SSEField_Retry:
+            if(SSE->RetryValid)
+            {
+                SSE->RetryMS=SSE->RetryValue;
+                if(SSE->RetryMS>HTTPCLIENT_SSE_MAX_RETRY)
+                    SSE->RetryMS=HTTPCLIENT_SSE_MAX_RETRY;
+            }
+        break;
+        case e_SSEField_Data:
+        case e_SSEField_Event:
+        case e_SSEField_Ignore:
+        case e_SSEFieldMAX:
+        default:
+        break;
+    }
+
+    SSE->State=e_SSEParse_FieldName;
+    SSE->Field=e_SSEField_Ignore;
+    SSE->FieldNameLen=0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SSE_Dispatch
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_SSE_Dispatch(struct HTTPSSEData *SSE);
+ *
+ * PARAMETERS:
+ *    SSE [I] -- The SSE data
+ *
+ * FUNCTION:
+ *    This function is called at the blank line at the end of an event.  It
+ *    builds the output line for the event in 'SSE->Emit' (if there was any
+ *    data), makes the event's ID the last event ID, and clears the event
+ *    buffers.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_SSE_Dispatch(struct HTTPSSEData *SSE)
+{
+    unsigned int Len;
+
+    if(SSE->HavePendingID)
+    {
+        strcpy(SSE->LastEventID,SSE->PendingID);
+        SSE->HavePendingID=false;
+    }
+
+    if(SSE->DataLines>0)
+    {
+        Len=0;
+        if(SSE->EventTypeLen>0)
+        {
+            memcpy(&SSE->Emit[Len],SSE->EventType,SSE->EventTypeLen);
+            Len+=SSE->EventTypeLen;
+            SSE->Emit[Len++]=':';
+            SSE->Emit[Len++]=' ';
+        }
+        memcpy(&SSE->Emit[Len],SSE->Data,SSE->DataLen);
+        Len+=SSE->DataLen;
+        SSE->Emit[Len++]='\n';
+
+        SSE->EmitPos=0;
+        SSE->EmitLen=Len;
+    }
+
+    SSE->DataLines=0;
+    SSE->DataLen=0;
+    SSE->EventTypeLen=0;
+}
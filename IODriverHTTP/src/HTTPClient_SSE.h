@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_SSE.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is the .h file for the Server-Sent Events (text/event-stream)
+ *    parser.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __HTTPCLIENT_SSE_H_
+#define __HTTPCLIENT_SSE_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+#define HTTPCLIENT_SSE_MAX_DATA                 4096 // Longer events are cut
+#define HTTPCLIENT_SSE_MAX_EVENT_TYPE           64
+#define HTTPCLIENT_SSE_MAX_ID                   128
+#define HTTPCLIENT_SSE_MAX_FIELD_NAME           8
+#define HTTPCLIENT_SSE_DEFAULT_RETRY            3000 // ms
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+typedef enum
+{
+    e_SSEParse_FieldName,
+    e_SSEParse_ValueStart,          // Just after the ':' (skip one space)
+    e_SSEParse_Value,
+    e_SSEParseMAX
+} e_SSEParseType;
+
+typedef enum
+{
+    e_SSEField_Data,
+    e_SSEField_Event,
+    e_SSEField_ID,
+    e_SSEField_Retry,
+    e_SSEField_Ignore,              // Comments and fields we don't know
+    e_SSEFieldMAX
+} e_SSEFieldType;
+
+/* Everything is fixed size, nothing is allocated per event */
+struct HTTPSSEData
+{
+    e_SSEParseType State;
+    e_SSEFieldType Field;
+    bool LastWasCR;                 // Lines can end in \r\n, \n or \r
+    unsigned int FieldNameLen;
+    char FieldName[HTTPCLIENT_SSE_MAX_FIELD_NAME];
+
+    /* The event being built */
+    unsigned int DataLines;
+    unsigned int DataLen;
+    char Data[HTTPCLIENT_SSE_MAX_DATA];
+    unsigned int EventTypeLen;
+    char EventType[HTTPCLIENT_SSE_MAX_EVENT_TYPE];
+    unsigned int IDLen;
+    char ID[HTTPCLIENT_SSE_MAX_ID];
+    bool IDHasNull;
+    bool HavePendingID;             // Becomes LastEventID when sent
+    char PendingID[HTTPCLIENT_SSE_MAX_ID];
+    unsigned int RetryValue;
+    bool RetryValid;
+
+    /* Kept between connections */
+    char LastEventID[HTTPCLIENT_SSE_MAX_ID];
+    unsigned int RetryMS;
+
+    /* The formatted line for the last event (waiting to be read) */
+    unsigned int EmitPos;
+    unsigned int EmitLen;
+    char Emit[HTTPCLIENT_SSE_MAX_EVENT_TYPE+2+HTTPCLIENT_SSE_MAX_DATA+1];
+};
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+void HTTPClient_SSE_Init(struct HTTPSSEData *SSE);
+void HTTPClient_SSE_StartStream(struct HTTPSSEData *SSE);
+bool HTTPClient_SSE_Pending(struct HTTPSSEData *SSE);
+int HTTPClient_SSE_Decode(struct HTTPSSEData *SSE,const uint8_t *In,
+        unsigned int InLen,unsigned int *InPos,uint8_t *Out,int MaxBytes);
+
+#endif
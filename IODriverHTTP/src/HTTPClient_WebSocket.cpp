@@ -0,0 +1,997 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_WebSocket.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the WebSocket (RFC 6455) code used by the WS driver.  The
+ *    connection and the upgrade request / response are the same as the HTTP
+ *    driver (see HTTPClient_HTTP.cpp), this is just the handshake key and
+ *    the frames that come after it.
+ *
+ *    Frames are parsed in place in the read buffer.  The payload of text,
+ *    binary and continuation frames is moved down over the frame headers
+ *    (so a fragmented message just comes out as one run of bytes).  Pings
+ *    are answered and a close is echoed back.
+ *
+ *    The handshake key and the masking keys come from std::random_device
+ *    (RFC 6455 wants them from a strong source of entropy, the server may
+ *    not be the only one looking at them).
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "HTTPClient_WebSocket.h"
+#include "OS/HTTPClient_Socket.h"
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*** DEFINES                  ***/
+#define HTTPCLIENT_WS_GUID                  "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+
+/*** FUNCTION PROTOTYPES      ***/
+static bool HTTPClient_WS_Random(struct WSData *WS,uint8_t *Buff,
+        unsigned int Bytes);
+static bool HTTPClient_WS_IsUTF8(const uint8_t *Data,unsigned int Bytes);
+static bool HTTPClient_WS_StartFrame(struct WSData *WS,const uint8_t *Head);
+static unsigned int HTTPClient_WS_HeaderSize(const uint8_t *Head);
+static bool HTTPClient_WS_FrameDone(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS);
+static int HTTPClient_WS_SendFrame(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,uint8_t Opcode,bool Fin,const uint8_t *Data,
+        unsigned int Bytes);
+static void HTTPClient_WS_SHA1(const uint8_t *Data,unsigned int Len,
+        uint8_t *Digest);
+static void HTTPClient_WS_Base64(const uint8_t *Data,unsigned int Len,
+        char *Out);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_Init
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_WS_Init(struct WSData *WS,bool Binary);
+ *
+ * PARAMETERS:
+ *    WS [I] -- The WebSocket data to init
+ *    Binary [I] -- Send binary messages (true) or text messages (false).
+ *                  Text that isn't UTF-8 is still sent as binary.
+ *
+ * FUNCTION:
+ *    This function gets the WebSocket data ready for a new connection.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void HTTPClient_WS_Init(struct WSData *WS,bool Binary)
+{
+    WS->Open=false;
+    WS->Binary=Binary;
+    WS->CloseSent=false;
+    WS->CloseReceived=false;
+
+    WS->State=e_WSParse_Header;
+    WS->HeadLen=0;
+    WS->Opcode=0;
+    WS->Masked=false;
+    WS->PayloadLeft=0;
+    WS->MaskOffset=0;
+    WS->ControlLen=0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_MakeKey
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_WS_MakeKey(struct WSData *WS,char *Key);
+ *
+ * PARAMETERS:
+ *    WS [I] -- The WebSocket data
+ *    Key [O] -- Where to put the key.  This must be HTTPCLIENT_WS_KEY_SIZE
+ *               bytes.
+ *
+ * FUNCTION:
+ *    This function makes a new random "Sec-WebSocket-Key" for the upgrade
+ *    request (16 random bytes in base64).
+ *
+ * RETURNS:
+ *    true -- 'Key' has the new key
+ *    false -- We couldn't get any random bytes
+ *
+ * SEE ALSO:
+ *    HTTPClient_WS_AcceptKey()
+ ******************************************************************************/
+bool HTTPClient_WS_MakeKey(struct WSData *WS,char *Key)
+{
+    uint8_t Nonce[16];
+
+    if(!HTTPClient_WS_Random(WS,Nonce,sizeof(Nonce)))
+        return false;
+    HTTPClient_WS_Base64(Nonce,sizeof(Nonce),Key);
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_AcceptKey
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_WS_AcceptKey(const char *Key,char *Accept);
+ *
+ * PARAMETERS:
+ *    Key [I] -- The "Sec-WebSocket-Key" we sent
+ *    Accept [O] -- Where to put the "Sec-WebSocket-Accept" the server must
+ *                  send back.  This must be HTTPCLIENT_WS_ACCEPT_SIZE bytes.
+ *
+ * FUNCTION:
+ *    This function works out the accept value for a key (base64 of the
+ *    SHA-1 of the key with the RFC 6455 GUID on the end).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void HTTPClient_WS_AcceptKey(const char *Key,char *Accept)
+{
+    char Buff[HTTPCLIENT_WS_KEY_SIZE+sizeof(HTTPCLIENT_WS_GUID)];
+    uint8_t Digest[20];
+    unsigned int Len;
+
+    Len=strlen(Key);
+    if(Len>=HTTPCLIENT_WS_KEY_SIZE)
+        Len=HTTPCLIENT_WS_KEY_SIZE-1;
+    memcpy(Buff,Key,Len);
+    memcpy(&Buff[Len],HTTPCLIENT_WS_GUID,sizeof(HTTPCLIENT_WS_GUID)-1);
+    Len+=sizeof(HTTPCLIENT_WS_GUID)-1;
+
+    HTTPClient_WS_SHA1((uint8_t *)Buff,Len,Digest);
+    HTTPClient_WS_Base64(Digest,sizeof(Digest),Accept);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_ProcessFrames
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_WS_ProcessFrames(t_DriverIOHandleType *DriverIO,
+ *          struct WSData *WS,uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection (for pong / close)
+ *    WS [I] -- The WebSocket data
+ *    Data [I/O] -- The bytes read from the connection.  This is changed to
+ *                  only have the message payload in it.
+ *    Bytes [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function runs the frame parser over a block read from the
+ *    connection and moves the payload of the data frames down to the start
+ *    of 'Data'.  The block can end anywhere in a frame.
+ *
+ *    When the server sends a close we send one back and set
+ *    'WS->CloseReceived' (the caller should close the connection).
+ *
+ * RETURNS:
+ *    The number of payload bytes now at the start of 'Data' or -1 if the
+ *    server broke the protocol.
+ ******************************************************************************/
+int HTTPClient_WS_ProcessFrames(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,uint8_t *Data,int Bytes)
+{
+    uint8_t *In;
+    uint8_t *End;
+    uint8_t *Out;
+    const uint8_t *Head;
+    uint64_t Len;
+    unsigned int Size;
+
+    In=Data;
+    End=Data+Bytes;
+    Out=Data;
+    while(In<End)
+    {
+        switch(WS->State)
+        {
+            case e_WSParse_Header:
+                if(WS->HeadLen==0 && End-In>=2 &&
+                        End-In>=HTTPClient_WS_HeaderSize(In))
+                {
+                    /* The whole header is here, use it where it is */
+                    Head=In;
+                    In+=HTTPClient_WS_HeaderSize(In);
+                }
+                else
+                {
+                    /* Split over reads, collect it a byte at a time (it's at
+                       most 14 bytes) */
+                    WS->Head[WS->HeadLen++]=*In++;
+                    if(WS->HeadLen<2 ||
+                            WS->HeadLen<HTTPClient_WS_HeaderSize(WS->Head))
+                    {
+                        break;
+                    }
+                    Head=WS->Head;
+                    WS->HeadLen=0;
+                }
+
+                if(!HTTPClient_WS_StartFrame(WS,Head))
+                    return -1;
+
+                if(WS->PayloadLeft==0 && !HTTPClient_WS_FrameDone(DriverIO,WS))
+                    return Out-Data;
+            break;
+            case e_WSParse_Payload:
+                Len=End-In;
+                if(Len>WS->PayloadLeft)
+                    Len=WS->PayloadLeft;
+
+                /* Servers shouldn't mask, but undo it if they do */
+                if(WS->Masked)
+                    HTTPClient_WS_Mask(In,Len,WS->MaskKey,WS->MaskOffset);
+                WS->MaskOffset=(WS->MaskOffset+Len)&3;
+
+                if(WS->Opcode&0x8)
+                {
+                    /* Control frame, keep it for when it's all here */
+                    Size=Len;
+                    memcpy(&WS->Control[WS->ControlLen],In,Size);
+                    WS->ControlLen+=Size;
+                }
+                else
+                {
+                    if(Out!=In)
+                        memmove(Out,In,Len);
+                    Out+=Len;
+                }
+                In+=Len;
+                WS->PayloadLeft-=Len;
+
+                if(WS->PayloadLeft==0 && !HTTPClient_WS_FrameDone(DriverIO,WS))
+                    return Out-Data;
+            break;
+            case e_WSParseMAX:
+            default:
+                return -1;
+        }
+    }
+
+    return Out-Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_SendMessage
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_WS_SendMessage(t_DriverIOHandleType *DriverIO,
+ *          struct WSData *WS,const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection
+ *    WS [I] -- The WebSocket data
+ *    Data [I] -- The message to send
+ *    Bytes [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function sends 'Data' as one text or binary message.  Anything
+ *    bigger than HTTPCLIENT_WS_SEND_FRAGMENT is sent as a fragmented
+ *    message.
+ *
+ *    A text message must be UTF-8 (the server will close on us if it
+ *    isn't) but the user can type anything, so in text mode a write that
+ *    isn't UTF-8 (including one that splits a character) goes out as a
+ *    binary message.
+ *
+ *    If a fragment after the first one fails the server has the start of
+ *    a message that will never be finished, so we close the connection
+ *    (1011, RFC 6455 section 7.4.1).
+ *
+ * RETURNS:
+ *    The number of bytes sent or one of the RETERROR_* values.
+ ******************************************************************************/
+int HTTPClient_WS_SendMessage(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,const uint8_t *Data,int Bytes)
+{
+    uint8_t Opcode;
+    unsigned int Fragment;
+    int Sent;
+    int Ret;
+
+    if(!WS->Open)
+        return RETERROR_BUSY;
+    if(WS->CloseSent)
+        return RETERROR_DISCONNECT;
+
+    Opcode=HTTPCLIENT_WS_OP_BINARY;
+    if(!WS->Binary && HTTPClient_WS_IsUTF8(Data,Bytes))
+        Opcode=HTTPCLIENT_WS_OP_TEXT;
+    Sent=0;
+    do
+    {
+        Fragment=Bytes-Sent;
+        if(Fragment>HTTPCLIENT_WS_SEND_FRAGMENT)
+            Fragment=HTTPCLIENT_WS_SEND_FRAGMENT;
+
+        Ret=HTTPClient_WS_SendFrame(DriverIO,WS,Opcode,
+                Sent+(int)Fragment==Bytes,&Data[Sent],Fragment);
+        if(Ret<0)
+        {
+            if(Sent>0)
+            {
+                HTTPClient_WS_SendClose(DriverIO,WS,1011);
+                HTTPClient_Close(DriverIO);
+                return RETERROR_DISCONNECT;
+            }
+            return Ret;
+        }
+
+        Opcode=HTTPCLIENT_WS_OP_CONTINUATION;
+        Sent+=Fragment;
+    } while(Sent<Bytes);
+
+    return Sent;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_SendClose
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_WS_SendClose(t_DriverIOHandleType *DriverIO,
+ *          struct WSData *WS,uint16_t Code);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection
+ *    WS [I] -- The WebSocket data
+ *    Code [I] -- The close status code (1000 for a normal close)
+ *
+ * FUNCTION:
+ *    This function sends a close frame (once).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void HTTPClient_WS_SendClose(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,uint16_t Code)
+{
+    uint8_t Payload[2];
+
+    if(!WS->Open || WS->CloseSent)
+        return;
+
+    Payload[0]=Code>>8;
+    Payload[1]=Code&0xFF;
+    HTTPClient_WS_SendFrame(DriverIO,WS,HTTPCLIENT_WS_OP_CLOSE,true,Payload,
+            sizeof(Payload));
+    WS->CloseSent=true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_Mask
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_WS_Mask(uint8_t *Data,uint64_t Len,const uint8_t *Key,
+ *          unsigned int Offset);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- The payload to mask / unmask (in place)
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Key [I] -- The 4 byte masking key
+ *    Offset [I] -- How far in to the payload 'Data' starts (mod 4)
+ *
+ * FUNCTION:
+ *    This function XORs the payload with the masking key (masking and
+ *    unmasking are the same thing).  The key is repeated to 32 / 16 / 8
+ *    bytes so it is done a vector (or a uint64_t) at a time instead of a
+ *    byte at a time.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void HTTPClient_WS_Mask(uint8_t *Data,uint64_t Len,const uint8_t *Key,
+        unsigned int Offset)
+{
+    uint8_t K[4];
+    uint32_t Key32;
+    uint64_t Key64;
+    uint64_t Block;
+    unsigned int r;
+#ifdef __AVX2__
+    __m256i Key256;
+    __m256i Block256;
+#endif
+#ifdef __SSE2__
+    __m128i Key128;
+    __m128i Block128;
+#endif
+
+    /* Turn the key so it lines up with the start of 'Data' */
+    for(r=0;r<4;r++)
+        K[r]=Key[(Offset+r)&3];
+    memcpy(&Key32,K,4);
+    Key64=((uint64_t)Key32<<32)|Key32;
+
+    /* Every step is a multiple of 4 so the key stays lined up */
+#ifdef __AVX2__
+    Key256=_mm256_set1_epi32(Key32);
+    while(Len>=32)
+    {
+        Block256=_mm256_loadu_si256((__m256i *)Data);
+        Block256=_mm256_xor_si256(Block256,Key256);
+        _mm256_storeu_si256((__m256i *)Data,Block256);
+        Data+=32;
+        Len-=32;
+    }
+#endif
+#ifdef __SSE2__
+    Key128=_mm_set1_epi32(Key32);
+    while(Len>=16)
+    {
+        Block128=_mm_loadu_si128((__m128i *)Data);
+        Block128=_mm_xor_si128(Block128,Key128);
+        _mm_storeu_si128((__m128i *)Data,Block128);
+        Data+=16;
+        Len-=16;
+    }
+#endif
+    while(Len>=8)
+    {
+        memcpy(&Block,Data,8);
+        Block^=Key64;
+        memcpy(Data,&Block,8);
+        Data+=8;
+        Len-=8;
+    }
+    for(r=0;r<Len;r++)
+        Data[r]^=K[r&3];
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_HeaderSize
+ *
+ * SYNOPSIS:
+ *    static unsigned int HTTPClient_WS_HeaderSize(const uint8_t *Head);
+ *
+ * PARAMETERS:
+ *    Head [I] -- The first 2 bytes of a frame header
+ *
+ * FUNCTION:
+ *    This function works out how big the frame header is from its first 2
+ *    bytes (2 + 0, 2 or 8 bytes of length + 0 or 4 bytes of mask).
+ *
+ * RETURNS:
+ *    The size of the header
+ ******************************************************************************/
+static unsigned int HTTPClient_WS_HeaderSize(const uint8_t *Head)
+{
+    unsigned int Size;
+
+    Size=2;
+    if((Head[1]&0x7F)==126)
+        Size+=2;
+    else if((Head[1]&0x7F)==127)
+        Size+=8;
+    if(Head[1]&0x80)
+        Size+=4;
+    return Size;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_StartFrame
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_WS_StartFrame(struct WSData *WS,
+ *          const uint8_t *Head);
+ *
+ * PARAMETERS:
+ *    WS [I] -- The WebSocket data
+ *    Head [I] -- The whole frame header
+ *
+ * FUNCTION:
+ *    This function decodes a frame header and gets ready for the payload.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- The header is bad (reserved bits, unknown opcode, a control
+ *             frame that is too big or fragmented)
+ ******************************************************************************/
+static bool HTTPClient_WS_StartFrame(struct WSData *WS,const uint8_t *Head)
+{
+    const uint8_t *Pos;
+    uint64_t Len;
+    unsigned int r;
+
+    /* We don't do any extensions so the RSV bits must be 0 */
+    if(Head[0]&0x70)
+        return false;
+
+    WS->Opcode=Head[0]&0x0F;
+    switch(WS->Opcode)
+    {
+        case HTTPCLIENT_WS_OP_CONTINUATION:
+        case HTTPCLIENT_WS_OP_TEXT:
+        case HTTPCLIENT_WS_OP_BINARY:
+        break;
+        case HTTPCLIENT_WS_OP_CLOSE:
+        case HTTPCLIENT_WS_OP_PING:
+        case HTTPCLIENT_WS_OP_PONG:
+            /* Control frames can't be fragmented */
+            if(!(Head[0]&0x80) || (Head[1]&0x7F)>HTTPCLIENT_WS_MAX_CONTROL)
+                return false;
+        break;
+        default:
+            return false;
+    }
+
+    Pos=&Head[2];
+    Len=Head[1]&0x7F;
+    if(Len==126)
+    {
+        Len=((uint64_t)Pos[0]<<8)|Pos[1];
+        Pos+=2;
+    }
+    else if(Len==127)
+    {
+        Len=0;
+        for(r=0;r<8;r++)
+            Len=(Len<<8)|Pos[r];
+        Pos+=8;
+    }
+
+    WS->Masked=(Head[1]&0x80)!=0;
+    if(WS->Masked)
+        memcpy(WS->MaskKey,Pos,4);
+
+    WS->PayloadLeft=Len;
+    WS->MaskOffset=0;
+    WS->ControlLen=0;
+    WS->State=e_WSParse_Payload;
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_FrameDone
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_WS_FrameDone(t_DriverIOHandleType *DriverIO,
+ *          struct WSData *WS);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection
+ *    WS [I] -- The WebSocket data
+ *
+ * FUNCTION:
+ *    This function is called at the end of each frame.  It answers pings
+ *    and close frames.
+ *
+ * RETURNS:
+ *    true -- Keep going
+ *    false -- The server closed, stop parsing
+ ******************************************************************************/
+static bool HTTPClient_WS_FrameDone(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS)
+{
+    WS->State=e_WSParse_Header;
+    WS->HeadLen=0;
+
+    switch(WS->Opcode)
+    {
+        case HTTPCLIENT_WS_OP_PING:
+            if(!WS->CloseSent)
+            {
+                HTTPClient_WS_SendFrame(DriverIO,WS,HTTPCLIENT_WS_OP_PONG,true,
+                        WS->Control,WS->ControlLen);
+            }
+        break;
+        case HTTPCLIENT_WS_OP_CLOSE:
+            /* Echo the status code back (RFC 6455 section 5.5.1) */
+            if(!WS->CloseSent)
+            {
+                HTTPClient_WS_SendFrame(DriverIO,WS,HTTPCLIENT_WS_OP_CLOSE,true,
+                        WS->Control,WS->ControlLen>=2?2:0);
+                WS->CloseSent=true;
+            }
+            WS->CloseReceived=true;
+        return false;
+        case HTTPCLIENT_WS_OP_PONG:
+        case HTTPCLIENT_WS_OP_CONTINUATION:
+        case HTTPCLIENT_WS_OP_TEXT:
+        case HTTPCLIENT_WS_OP_BINARY:
+        default:
+        break;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_SendFrame
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_WS_SendFrame(t_DriverIOHandleType *DriverIO,
+ *          struct WSData *WS,uint8_t Opcode,bool Fin,const uint8_t *Data,
+ *          unsigned int Bytes);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection
+ *    WS [I] -- The WebSocket data
+ *    Opcode [I] -- The frame type (HTTPCLIENT_WS_OP_...)
+ *    Fin [I] -- Is this the last frame of the message
+ *    Data [I] -- The payload
+ *    Bytes [I] -- The number of bytes in 'Data' (at most
+ *                 HTTPCLIENT_WS_SEND_FRAGMENT)
+ *
+ * FUNCTION:
+ *    This function builds a frame (with a new masking key, clients must
+ *    mask) in 'WS->SendBuff' and sends it with one write.
+ *
+ * RETURNS:
+ *    The number of bytes sent or one of the RETERROR_* values.
+ ******************************************************************************/
+static int HTTPClient_WS_SendFrame(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,uint8_t Opcode,bool Fin,const uint8_t *Data,
+        unsigned int Bytes)
+{
+    uint8_t *Pos;
+    int Ret;
+
+    Pos=WS->SendBuff;
+    *Pos++=(Fin?0x80:0x00)|Opcode;
+    if(Bytes<126)
+    {
+        *Pos++=0x80|Bytes;
+    }
+    else
+    {
+        /* HTTPCLIENT_WS_SEND_FRAGMENT keeps us under 64K */
+        *Pos++=0x80|126;
+        *Pos++=Bytes>>8;
+        *Pos++=Bytes&0xFF;
+    }
+
+    if(!HTTPClient_WS_Random(WS,Pos,4))
+        return RETERROR_IOERROR;
+    Pos+=4;
+
+    memcpy(Pos,Data,Bytes);
+    HTTPClient_WS_Mask(Pos,Bytes,Pos-4,0);
+    Pos+=Bytes;
+
+    Ret=HTTPClient_SendBytes(DriverIO,WS->SendBuff,Pos-WS->SendBuff);
+    if(Ret<0)
+        return Ret;
+    return Bytes;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_Random
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_WS_Random(struct WSData *WS,uint8_t *Buff,
+ *          unsigned int Bytes);
+ *
+ * PARAMETERS:
+ *    WS [I] -- The WebSocket data
+ *    Buff [O] -- Where to put the random bytes
+ *    Bytes [I] -- The number of bytes to fill in
+ *
+ * FUNCTION:
+ *    This function fills 'Buff' from the OS's source of entropy (see
+ *    'WS->Entropy').
+ *
+ * RETURNS:
+ *    true -- 'Buff' has been filled in
+ *    false -- The entropy source failed
+ ******************************************************************************/
+static bool HTTPClient_WS_Random(struct WSData *WS,uint8_t *Buff,
+        unsigned int Bytes)
+{
+    uint32_t Rand;
+    unsigned int Len;
+    unsigned int r;
+
+    try
+    {
+        for(r=0;r<Bytes;r+=Len)
+        {
+            Rand=WS->Entropy();
+            Len=Bytes-r;
+            if(Len>sizeof(Rand))
+                Len=sizeof(Rand);
+            memcpy(&Buff[r],&Rand,Len);
+        }
+    }
+    catch(...)
+    {
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_IsUTF8
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_WS_IsUTF8(const uint8_t *Data,unsigned int Bytes);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The bytes to check
+ *    Bytes [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function checks if 'Data' is valid UTF-8 (RFC 3629).  Over long
+ *    forms, surrogates, code points past U+10FFFF and a character cut off
+ *    at the end are all invalid.
+ *
+ *    Most of what we send is ASCII so that is skipped 8 bytes at a time.
+ *
+ * RETURNS:
+ *    true -- 'Data' is UTF-8
+ *    false -- It isn't
+ ******************************************************************************/
+static bool HTTPClient_WS_IsUTF8(const uint8_t *Data,unsigned int Bytes)
+{
+    uint64_t Word;
+    unsigned int Pos;
+    unsigned int Follow;
+    unsigned int r;
+    uint8_t Low;
+    uint8_t High;
+    uint8_t c;
+
+    Pos=0;
+    while(Pos<Bytes)
+    {
+        if(Pos+sizeof(Word)<=Bytes)
+        {
+            memcpy(&Word,&Data[Pos],sizeof(Word));
+            if((Word&0x8080808080808080ULL)==0)
+            {
+                Pos+=sizeof(Word);
+                continue;
+            }
+        }
+
+        c=Data[Pos++];
+        if(c<0x80)
+            continue;
+
+        /* How many continuation bytes, and the range of the first one */
+        Low=0x80;
+        High=0xBF;
+        if(c>=0xC2 && c<=0xDF)
+        {
+            Follow=1;
+        }
+        else if(c>=0xE0 && c<=0xEF)
+        {
+            Follow=2;
+            if(c==0xE0)
+                Low=0xA0;       // Over long
+            if(c==0xED)
+                High=0x9F;      // Surrogates
+        }
+        else if(c>=0xF0 && c<=0xF4)
+        {
+            Follow=3;
+            if(c==0xF0)
+                Low=0x90;       // Over long
+            if(c==0xF4)
+                High=0x8F;      // Past U+10FFFF
+        }
+        else
+        {
+            return false;
+        }
+
+        if(Bytes-Pos<Follow)
+            return false;
+        if(Data[Pos]<Low || Data[Pos]>High)
+            return false;
+        for(r=1;r<Follow;r++)
+        {
+            if((Data[Pos+r]&0xC0)!=0x80)
+                return false;
+        }
+        Pos+=Follow;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_SHA1
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_WS_SHA1(const uint8_t *Data,unsigned int Len,
+ *          uint8_t *Digest);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The bytes to hash
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Digest [O] -- The 20 byte SHA-1
+ *
+ * FUNCTION:
+ *    This function does a SHA-1 (FIPS 180-4).  It's only used on the short
+ *    handshake key so it's kept simple.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_WS_SHA1(const uint8_t *Data,unsigned int Len,
+        uint8_t *Digest)
+{
+    uint32_t H[5]={0x67452301,0xEFCDAB89,0x98BADCFE,0x10325476,0xC3D2E1F0};
+    uint32_t W[80];
+    uint8_t Block[64];
+    uint64_t Bits;
+    uint32_t a,b,c,d,e,f,k,Temp;
+    unsigned int Blocks;
+    unsigned int Blk;
+    unsigned int Pos;
+    unsigned int r;
+
+    Bits=(uint64_t)Len*8;
+    Blocks=(Len+8)/64+1;    // Room for the 0x80 and the length
+    for(Blk=0;Blk<Blocks;Blk++)
+    {
+        /* Build the block (with the padding in the last one or two) */
+        for(r=0;r<64;r++)
+        {
+            Pos=Blk*64+r;
+            if(Pos<Len)
+                Block[r]=Data[Pos];
+            else if(Pos==Len)
+                Block[r]=0x80;
+            else
+                Block[r]=0;
+        }
+        if(Blk==Blocks-1)
+        {
+            for(r=0;r<8;r++)
+                Block[56+r]=Bits>>(56-r*8);
+        }
+
+        for(r=0;r<16;r++)
+        {
+            W[r]=((uint32_t)Block[r*4]<<24)|((uint32_t)Block[r*4+1]<<16)|
+                    ((uint32_t)Block[r*4+2]<<8)|Block[r*4+3];
+        }
+        for(r=16;r<80;r++)
+        {
+            Temp=W[r-3]^W[r-8]^W[r-14]^W[r-16];
+            W[r]=(Temp<<1)|(Temp>>31);
+        }
+
+        a=H[0];
+        b=H[1];
+        c=H[2];
+        d=H[3];
+        e=H[4];
+        for(r=0;r<80;r++)
+        {
+            if(r<20)
+            {
+                f=(b&c)|((~b)&d);
+                k=0x5A827999;
+            }
+            else if(r<40)
+            {
+                f=b^c^d;
+                k=0x6ED9EBA1;
+            }
+            else if(r<60)
+            {
+                f=(b&c)|(b&d)|(c&d);
+                k=0x8F1BBCDC;
+            }
+            else
+            {
+                f=b^c^d;
+                k=0xCA62C1D6;
+            }
+            Temp=((a<<5)|(a>>27))+f+e+k+W[r];
+            e=d;
+            d=c;
+            c=(b<<30)|(b>>2);
+            b=a;
+            a=Temp;
+        }
+        H[0]+=a;
+        H[1]+=b;
+        H[2]+=c;
+        H[3]+=d;
+        H[4]+=e;
+    }
+
+    for(r=0;r<20;r++)
+        Digest[r]=H[r/4]>>(24-(r%4)*8);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_WS_Base64
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_WS_Base64(const uint8_t *Data,unsigned int Len,
+ *          char *Out);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The bytes to encode
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Out [O] -- Where to put the base64 string.  This must be
+ *               (Len+2)/3*4+1 bytes.
+ *
+ * FUNCTION:
+ *    This function base64 encodes 'Data' (with '=' padding).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_WS_Base64(const uint8_t *Data,unsigned int Len,
+        char *Out)
+{
+    static const char Chars[]=
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t Triple;
+    unsigned int r;
+
+    for(r=0;r+2<Len;r+=3)
+    {
+        Triple=(Data[r]<<16)|(Data[r+1]<<8)|Data[r+2];
+        *Out++=Chars[(Triple>>18)&0x3F];
+        *Out++=Chars[(Triple>>12)&0x3F];
+        *Out++=Chars[(Triple>>6)&0x3F];
+        *Out++=Chars[Triple&0x3F];
+    }
+    if(r<Len)
+    {
+        Triple=Data[r]<<16;
+        if(r+1<Len)
+            Triple|=Data[r+1]<<8;
+        *Out++=Chars[(Triple>>18)&0x3F];
+        *Out++=Chars[(Triple>>12)&0x3F];
+        *Out++=r+1<Len?Chars[(Triple>>6)&0x3F]:'=';
+        *Out++='=';
+    }
+    *Out=0;
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_WebSocket.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is the .h file for the WebSocket (RFC 6455) framing code.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __HTTPCLIENT_WEBSOCKET_H_
+#define __HTTPCLIENT_WEBSOCKET_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include "PluginSDK/Plugin.h"
+#include <stdint.h>
+#include <random>
+
+/***  DEFINES                          ***/
+#define HTTPCLIENT_WS_KEY_SIZE                  25 // base64 of 16 bytes + \0
+#define HTTPCLIENT_WS_ACCEPT_SIZE               29 // base64 of a SHA-1 + \0
+#define HTTPCLIENT_WS_MAX_HEADER                14
+#define HTTPCLIENT_WS_MAX_CONTROL               125
+#define HTTPCLIENT_WS_SEND_FRAGMENT             16384 // Bigger writes are fragmented
+
+/* Opcodes */
+#define HTTPCLIENT_WS_OP_CONTINUATION           0x0
+#define HTTPCLIENT_WS_OP_TEXT                   0x1
+#define HTTPCLIENT_WS_OP_BINARY                 0x2
+#define HTTPCLIENT_WS_OP_CLOSE                  0x8
+#define HTTPCLIENT_WS_OP_PING                   0x9
+#define HTTPCLIENT_WS_OP_PONG                   0xA
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+typedef enum
+{
+    e_WSParse_Header,
+    e_WSParse_Payload,
+    e_WSParseMAX
+} e_WSParseType;
+
+struct WSData
+{
+    bool Open;                      // The upgrade is done
+    bool Binary;                    // Send binary (not text) messages
+    bool CloseSent;
+    bool CloseReceived;
+    std::random_device Entropy;     // For the key and the masking keys
+
+    /* Frame parser */
+    e_WSParseType State;
+    unsigned int HeadLen;
+    uint8_t Head[HTTPCLIENT_WS_MAX_HEADER]; // Header split over reads
+    uint8_t Opcode;
+    bool Masked;
+    uint8_t MaskKey[4];
+    uint64_t PayloadLeft;
+    unsigned int MaskOffset;
+    unsigned int ControlLen;
+    uint8_t Control[HTTPCLIENT_WS_MAX_CONTROL];
+
+    /* Frames we send (header + payload, sent in one go) */
+    uint8_t SendBuff[HTTPCLIENT_WS_MAX_HEADER+HTTPCLIENT_WS_SEND_FRAGMENT];
+};
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+void HTTPClient_WS_Init(struct WSData *WS,bool Binary);
+bool HTTPClient_WS_MakeKey(struct WSData *WS,char *Key);
+void HTTPClient_WS_AcceptKey(const char *Key,char *Accept);
+int HTTPClient_WS_ProcessFrames(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,uint8_t *Data,int Bytes);
+int HTTPClient_WS_SendMessage(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,const uint8_t *Data,int Bytes);
+void HTTPClient_WS_SendClose(t_DriverIOHandleType *DriverIO,
+        struct WSData *WS,uint16_t Code);
+void HTTPClient_WS_Mask(uint8_t *Data,uint64_t Len,const uint8_t *Key,
+        unsigned int Offset);
+
+#endif
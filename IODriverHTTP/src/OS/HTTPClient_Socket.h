@@ -51,8 +51,12 @@
 t_DriverIOHandleType *HTTPClient_AllocateHandle(const char *DeviceUniqueID,
         t_IOSystemHandle *IOHandle);
 void HTTPClient_FreeHandle(t_DriverIOHandleType *DriverIO);
+t_DriverIOHandleType *WSClient_AllocateHandle(const char *DeviceUniqueID,
+        t_IOSystemHandle *IOHandle);
 PG_BOOL HTTPClient_Open(t_DriverIOHandleType *DriverIO,const t_PIKVList *Options);
 int HTTPClient_Write(t_DriverIOHandleType *DriverIO,const uint8_t *Data,int Bytes);
+int HTTPClient_SendBytes(t_DriverIOHandleType *DriverIO,const uint8_t *Data,
+        int Bytes);
 int HTTPClient_Read(t_DriverIOHandleType *DriverIO,uint8_t *Data,int MaxBytes);
 void HTTPClient_Close(t_DriverIOHandleType *DriverIO);
 PG_BOOL HTTPClient_ChangeOptions(t_DriverIOHandleType *DriverIO,
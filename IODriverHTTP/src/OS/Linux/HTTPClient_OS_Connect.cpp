@@ -0,0 +1,1072 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_OS_Connect.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file looks up the server and connects to it in the background on
+ *    the reactor thread (see HTTPClient_OS_ConnectStart()).
+ *
+ *    The lookup is done with getaddrinfo() on a worker thread (so a dead DNS
+ *    server can't hang us) and the results are cached per host.  The
+ *    workers are joined when the last handle goes away (see
+ *    HTTPClient_OS_ConnectRemoveUser()) so none are left running when the
+ *    plugin is unloaded.  The
+ *    connect is non blocking and races the IPv6 and IPv4 addresses the way
+ *    "Happy Eyeballs" (RFC 8305) does: start on the first address, and if it
+ *    hasn't connected in HTTPCLIENT_HAPPY_EYEBALLS_DELAY start the next one
+ *    (alternating families) while still waiting on the first.  The first one
+ *    to connect wins.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "HTTPClient_OS_Connect.h"
+#include "HTTPClient_OS_Reactor.h"
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*** DEFINES                  ***/
+#define HTTPCLIENT_DNS_CACHE_TTL            60      // Seconds
+#define HTTPCLIENT_HAPPY_EYEBALLS_DELAY     250     // ms before trying the next address
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+typedef chrono::steady_clock t_HCClock;
+
+struct HTTPClient_Address
+{
+    struct sockaddr_storage Addr;
+    socklen_t Len;
+};
+
+struct HTTPClient_DNSEntry
+{
+    vector<struct HTTPClient_Address> Addrs;
+    t_HCClock::time_point Expires;
+};
+
+/* Shared between the caller and the lookup thread (the caller may give up
+   before the thread is done) */
+struct HTTPClient_DNSLookup
+{
+    string Host;
+    mutex Lock;
+    bool Finished;
+    int WakeFD;                             // eventfd to poke when done (-1 = none)
+    vector<struct HTTPClient_Address> Addrs;
+};
+
+/* A lookup thread.  They are joined, never detached, so they can't outlive
+   the plugin. */
+struct HTTPClient_DNSWorker
+{
+    thread Thread;
+    shared_ptr<struct HTTPClient_DNSLookup> Lookup;
+};
+
+struct HTTPClient_Connecting;
+
+/* Something a background connect is waiting on (it's timer, the lookup, or
+   one of the sockets) */
+struct HTTPClient_ConnectWatch
+{
+    struct HTTPClient_ReactorWatch Watch;   // Must be first
+    struct HTTPClient_Connecting *Con;
+    bool Failed;                            // Sockets: this address didn't work
+};
+
+/* A connect started with HTTPClient_OS_ConnectStart().  Everything after
+   'Lock' is only used with it held. */
+struct HTTPClient_Connecting
+{
+    struct HTTPClient_ConnectWatch Timer;   // Next address / give up
+    struct HTTPClient_ConnectWatch DNSDone; // eventfd the lookup pokes
+    t_HCConnectDoneCB Done;
+    void *UserData;
+    mutex Lock;
+    list<struct HTTPClient_ConnectWatch> Socks;
+    string Host;
+    uint16_t Port;
+    t_HCClock::time_point Deadline;
+    t_HCClock::time_point NextStart;
+    shared_ptr<struct HTTPClient_DNSLookup> Lookup;
+    vector<struct HTTPClient_Address> Addrs;
+    bool Resolved;
+    unsigned int Next;
+    unsigned int InFlight;
+    int Winner;
+    bool Finished;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static bool HTTPClient_OS_CachedLookup(const char *Host,
+        vector<struct HTTPClient_Address> &Addrs);
+static shared_ptr<struct HTTPClient_DNSLookup> HTTPClient_OS_StartLookup(
+        const char *Host,int WakeFD);
+static void HTTPClient_OS_Interleave(const vector<struct HTTPClient_Address> &Found,
+        vector<struct HTTPClient_Address> &Addrs);
+static void HTTPClient_OS_DNSWorker(shared_ptr<struct HTTPClient_DNSLookup> Lookup);
+static void HTTPClient_OS_CopyAddrInfo(const struct addrinfo *List,
+        vector<struct HTTPClient_Address> &Addrs);
+static void HTTPClient_OS_ForgetHost(const char *Host);
+static int HTTPClient_OS_StartConnect(const struct HTTPClient_Address *Address,
+        uint16_t Port,bool *Connected);
+static void HTTPClient_OS_SetupSocket(int fd);
+static void HTTPClient_OS_ConnectEvent(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events);
+static void HTTPClient_OS_ConnectStep(struct HTTPClient_Connecting *Con);
+static bool HTTPClient_OS_ConnectArm(struct HTTPClient_Connecting *Con,
+        t_HCClock::time_point When);
+static bool HTTPClient_OS_ConnectWatchSock(struct HTTPClient_Connecting *Con,
+        int fd);
+static void HTTPClient_OS_ConnectFinished(struct HTTPClient_Connecting *Con,
+        int Winner);
+
+/*** VARIABLE DEFINITIONS     ***/
+static mutex m_HC_DNSCacheLock;
+static map<string,struct HTTPClient_DNSEntry> m_HC_DNSCache;
+static mutex m_HC_DNSWorkersLock;
+static list<struct HTTPClient_DNSWorker> m_HC_DNSWorkers;
+static unsigned int m_HC_ConnectUsers;      // How many handles are around
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectAddUser
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_OS_ConnectAddUser(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function notes that there is another handle that may connect.
+ *    Every call must be matched with a HTTPClient_OS_ConnectRemoveUser().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_ConnectRemoveUser()
+ ******************************************************************************/
+void HTTPClient_OS_ConnectAddUser(void)
+{
+    lock_guard<mutex> Guard(m_HC_DNSWorkersLock);
+    m_HC_ConnectUsers++;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectRemoveUser
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_OS_ConnectRemoveUser(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function undoes a HTTPClient_OS_ConnectAddUser().  When the last
+ *    handle is gone we wait for any lookups that are still running (a
+ *    getaddrinfo() can't be stopped, so this can take as long as the
+ *    resolver's timeout) and empty the cache.  After this no thread is
+ *    running our code so the plugin can be unloaded.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_ConnectAddUser()
+ ******************************************************************************/
+void HTTPClient_OS_ConnectRemoveUser(void)
+{
+    list<struct HTTPClient_DNSWorker> Workers;
+    list<struct HTTPClient_DNSWorker>::iterator Worker;
+
+    {
+        lock_guard<mutex> Guard(m_HC_DNSWorkersLock);
+        if(m_HC_ConnectUsers==0 || --m_HC_ConnectUsers>0)
+            return;
+        Workers.splice(Workers.end(),m_HC_DNSWorkers);
+    }
+
+    for(Worker=Workers.begin();Worker!=Workers.end();Worker++)
+        Worker->Thread.join();
+
+    lock_guard<mutex> Guard(m_HC_DNSCacheLock);
+    m_HC_DNSCache.clear();
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectStart
+ *
+ * SYNOPSIS:
+ *    t_HCConnectType *HTTPClient_OS_ConnectStart(const char *Host,
+ *          uint16_t Port,unsigned int TimeoutMS,t_HCConnectDoneCB Done,
+ *          void *UserData);
+ *
+ * PARAMETERS:
+ *    Host [I] -- The host name or IP address (v4 or v6) to connect to
+ *    Port [I] -- The port to connect to
+ *    TimeoutMS [I] -- The most time to spend (looking up and connecting)
+ *    Done [I] -- Called (on the reactor thread) when we are connected,
+ *                every address has failed, or 'TimeoutMS' has gone by.
+ *                Call HTTPClient_OS_ConnectEnd() (not from 'Done') to get
+ *                the socket.
+ *    UserData [I] -- Passed to 'Done'
+ *
+ * FUNCTION:
+ *    This function starts looking up and connecting to 'Host' in the
+ *    background and returns right away.  The connect is done on the
+ *    reactor so the caller is never blocked.
+ *
+ *    The reactor must be running (HTTPClient_Reactor_Start()).
+ *
+ * RETURNS:
+ *    A handle to the connect or NULL if it couldn't be started.  It must be
+ *    freed with HTTPClient_OS_ConnectEnd().
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_ConnectEnd()
+ ******************************************************************************/
+t_HCConnectType *HTTPClient_OS_ConnectStart(const char *Host,uint16_t Port,
+        unsigned int TimeoutMS,t_HCConnectDoneCB Done,void *UserData)
+{
+    struct HTTPClient_Connecting *Con;
+
+    Con=NULL;
+    try
+    {
+        Con=new struct HTTPClient_Connecting;
+        Con->Timer.Watch.FD=-1;
+        Con->Timer.Watch.Callback=HTTPClient_OS_ConnectEvent;
+        Con->Timer.Watch.Active=false;
+        Con->Timer.Con=Con;
+        Con->Timer.Failed=false;
+        Con->DNSDone.Watch.FD=-1;
+        Con->DNSDone.Watch.Callback=HTTPClient_OS_ConnectEvent;
+        Con->DNSDone.Watch.Active=false;
+        Con->DNSDone.Con=Con;
+        Con->DNSDone.Failed=false;
+        Con->Done=Done;
+        Con->UserData=UserData;
+        Con->Port=Port;
+        Con->Deadline=t_HCClock::now()+chrono::milliseconds(TimeoutMS);
+        Con->NextStart=t_HCClock::now();
+        Con->Resolved=false;
+        Con->Next=0;
+        Con->InFlight=0;
+        Con->Winner=-1;
+        Con->Finished=false;
+        Con->Host=Host;
+
+        Con->Timer.Watch.FD=timerfd_create(CLOCK_MONOTONIC,
+                TFD_NONBLOCK|TFD_CLOEXEC);
+        if(Con->Timer.Watch.FD<0)
+            throw(0);
+
+        Con->DNSDone.Watch.FD=eventfd(0,EFD_NONBLOCK|EFD_CLOEXEC);
+        if(Con->DNSDone.Watch.FD<0)
+            throw(0);
+
+        if(!HTTPClient_Reactor_Add(&Con->Timer.Watch,EPOLLIN) ||
+                !HTTPClient_Reactor_Add(&Con->DNSDone.Watch,EPOLLIN))
+        {
+            throw(0);
+        }
+
+        /* Everything else is done on the reactor thread, starting now */
+        if(!HTTPClient_OS_ConnectArm(Con,t_HCClock::now()))
+            throw(0);
+    }
+    catch(...)
+    {
+        if(Con!=NULL)
+            HTTPClient_OS_ConnectEnd((t_HCConnectType *)Con);
+        return NULL;
+    }
+
+    return (t_HCConnectType *)Con;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectEnd
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_OS_ConnectEnd(t_HCConnectType *Connect);
+ *
+ * PARAMETERS:
+ *    Connect [I] -- The connect to end
+ *
+ * FUNCTION:
+ *    This function frees a connect started with HTTPClient_OS_ConnectStart().
+ *    If it's still going it is stopped ('Done' will not be called after
+ *    this returns).
+ *
+ *    This can't be called from the reactor thread.
+ *
+ * RETURNS:
+ *    The connected socket (non blocking with TCP_NODELAY set) or -1 if we
+ *    didn't connect.
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_ConnectStart()
+ ******************************************************************************/
+int HTTPClient_OS_ConnectEnd(t_HCConnectType *Connect)
+{
+    struct HTTPClient_Connecting *Con=(struct HTTPClient_Connecting *)Connect;
+    list<struct HTTPClient_ConnectWatch>::iterator Sock;
+    int Winner;
+
+    {
+        /* After this the reactor won't touch it (other than to skip the
+           events it already has) */
+        lock_guard<mutex> Guard(Con->Lock);
+        Con->Finished=true;
+        if(Con->Lookup!=NULL)
+        {
+            lock_guard<mutex> LookupGuard(Con->Lookup->Lock);
+            Con->Lookup->WakeFD=-1;
+        }
+        Winner=Con->Winner;
+    }
+
+    HTTPClient_Reactor_Remove(&Con->Timer.Watch);
+    HTTPClient_Reactor_Remove(&Con->DNSDone.Watch);
+    for(Sock=Con->Socks.begin();Sock!=Con->Socks.end();Sock++)
+    {
+        HTTPClient_Reactor_Remove(&Sock->Watch);
+        if(Sock->Watch.FD!=Winner)
+            close(Sock->Watch.FD);
+    }
+    if(Con->Timer.Watch.FD>=0)
+        close(Con->Timer.Watch.FD);
+    if(Con->DNSDone.Watch.FD>=0)
+        close(Con->DNSDone.Watch.FD);
+
+    delete Con;
+
+    if(Winner>=0)
+        HTTPClient_OS_SetupSocket(Winner);
+
+    return Winner;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectEvent
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_ConnectEvent(
+ *          struct HTTPClient_ReactorWatch *Watch,uint32_t Events);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- The 'struct HTTPClient_ConnectWatch' that has events
+ *    Events [I] -- The epoll events
+ *
+ * FUNCTION:
+ *    This is called on the reactor thread when a background connect's
+ *    timer goes off, it's lookup is done, or one of it's sockets connected
+ *    (or failed).  It moves the connect along.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_ConnectEvent(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events)
+{
+    struct HTTPClient_ConnectWatch *CWatch=
+            (struct HTTPClient_ConnectWatch *)Watch;
+    struct HTTPClient_Connecting *Con=CWatch->Con;
+    uint64_t Count;
+    socklen_t ErrLen;
+    int Err;
+
+    lock_guard<mutex> Guard(Con->Lock);
+    if(Con->Finished)
+        return;
+
+    if(CWatch==&Con->Timer || CWatch==&Con->DNSDone)
+    {
+        if(read(Watch->FD,&Count,sizeof(Count))<0)
+        {
+            /* Nothing to clear */
+        }
+    }
+    else
+    {
+        if(CWatch->Failed)
+            return;
+
+        Err=0;
+        ErrLen=sizeof(Err);
+        if(getsockopt(Watch->FD,SOL_SOCKET,SO_ERROR,&Err,&ErrLen)<0)
+            Err=errno;
+
+        if(Err==0)
+        {
+            if(Events&EPOLLOUT)
+                HTTPClient_OS_ConnectFinished(Con,Watch->FD);
+            return;
+        }
+
+        /* This one failed, don't wait to try the next */
+        CWatch->Failed=true;
+        Con->InFlight--;
+        Con->NextStart=t_HCClock::now();
+    }
+
+    HTTPClient_OS_ConnectStep(Con);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectStep
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_ConnectStep(struct HTTPClient_Connecting *Con);
+ *
+ * PARAMETERS:
+ *    Con [I] -- The connect to move along.  'Con->Lock' must be held.
+ *
+ * FUNCTION:
+ *    This function does whatever is next for a background connect: look up
+ *    the host, start on the next address (Happy Eyeballs style, see the top
+ *    of this file) or give up.  Then it sets the timer for the
+ *    next time we need to look at it.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_ConnectStep(struct HTTPClient_Connecting *Con)
+{
+    vector<struct HTTPClient_Address> Found;
+    t_HCClock::time_point Now;
+    t_HCClock::time_point WaitUntil;
+    bool LookupDone;
+    bool Connected;
+    int fd;
+
+    Now=t_HCClock::now();
+    if(Now>=Con->Deadline)
+    {
+        HTTPClient_OS_ConnectFinished(Con,-1);
+        return;
+    }
+
+    if(!Con->Resolved && Con->Lookup==NULL)
+    {
+        /* IP addresses and names we know don't need to wait */
+        if(HTTPClient_OS_CachedLookup(Con->Host.c_str(),Con->Addrs))
+        {
+            Con->Resolved=true;
+        }
+        else
+        {
+            Con->Lookup=HTTPClient_OS_StartLookup(Con->Host.c_str(),
+                    Con->DNSDone.Watch.FD);
+            if(Con->Lookup==NULL)
+            {
+                HTTPClient_OS_ConnectFinished(Con,-1);
+                return;
+            }
+        }
+    }
+
+    if(!Con->Resolved)
+    {
+        {
+            lock_guard<mutex> LookupGuard(Con->Lookup->Lock);
+            LookupDone=Con->Lookup->Finished;
+            if(LookupDone)
+            {
+                Found=Con->Lookup->Addrs;
+                Con->Lookup->WakeFD=-1;
+            }
+        }
+        if(!LookupDone)
+        {
+            /* The lookup will poke 'DNSDone' */
+            if(!HTTPClient_OS_ConnectArm(Con,Con->Deadline))
+                HTTPClient_OS_ConnectFinished(Con,-1);
+            return;
+        }
+        Con->Lookup=NULL;
+        Con->Resolved=true;
+        HTTPClient_OS_Interleave(Found,Con->Addrs);
+    }
+
+    /* Time to start on the next address? */
+    while(Con->Next<Con->Addrs.size() &&
+            (Con->InFlight==0 || Now>=Con->NextStart))
+    {
+        fd=HTTPClient_OS_StartConnect(&Con->Addrs[Con->Next++],Con->Port,
+                &Connected);
+        if(fd<0)
+            continue;
+        if(Connected)
+        {
+            HTTPClient_OS_ConnectFinished(Con,fd);
+            return;
+        }
+        if(!HTTPClient_OS_ConnectWatchSock(Con,fd))
+        {
+            close(fd);
+            continue;
+        }
+        Con->InFlight++;
+        Con->NextStart=Now+chrono::milliseconds(HTTPCLIENT_HAPPY_EYEBALLS_DELAY);
+    }
+
+    /* Nothing left to try */
+    if(Con->InFlight==0)
+    {
+        HTTPClient_OS_ConnectFinished(Con,-1);
+        return;
+    }
+
+    WaitUntil=Con->Deadline;
+    if(Con->Next<Con->Addrs.size() && Con->NextStart<WaitUntil)
+        WaitUntil=Con->NextStart;
+    if(!HTTPClient_OS_ConnectArm(Con,WaitUntil))
+        HTTPClient_OS_ConnectFinished(Con,-1);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectArm
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_ConnectArm(struct HTTPClient_Connecting *Con,
+ *          t_HCClock::time_point When);
+ *
+ * PARAMETERS:
+ *    Con [I] -- The connect
+ *    When [I] -- When the timer should go off
+ *
+ * FUNCTION:
+ *    This function sets a background connect's timer.  A time that has
+ *    already passed goes off right away.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- The timer couldn't be set
+ ******************************************************************************/
+static bool HTTPClient_OS_ConnectArm(struct HTTPClient_Connecting *Con,
+        t_HCClock::time_point When)
+{
+    struct itimerspec Wait;
+    int64_t WaitNS;
+
+    WaitNS=chrono::duration_cast<chrono::nanoseconds>(When-
+            t_HCClock::now()).count();
+    if(WaitNS<1)
+        WaitNS=1;   // 0 would turn the timer off
+
+    Wait.it_interval.tv_sec=0;
+    Wait.it_interval.tv_nsec=0;
+    Wait.it_value.tv_sec=WaitNS/1000000000;
+    Wait.it_value.tv_nsec=WaitNS%1000000000;
+
+    return timerfd_settime(Con->Timer.Watch.FD,0,&Wait,NULL)>=0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectWatchSock
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_ConnectWatchSock(
+ *          struct HTTPClient_Connecting *Con,int fd);
+ *
+ * PARAMETERS:
+ *    Con [I] -- The connect
+ *    fd [I] -- A socket that is connecting
+ *
+ * FUNCTION:
+ *    This function has the reactor tell us when a socket is done
+ *    connecting.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- We couldn't watch it (the caller still owns 'fd')
+ ******************************************************************************/
+static bool HTTPClient_OS_ConnectWatchSock(struct HTTPClient_Connecting *Con,
+        int fd)
+{
+    struct HTTPClient_ConnectWatch *Sock;
+
+    try
+    {
+        Con->Socks.emplace_back();
+    }
+    catch(...)
+    {
+        return false;
+    }
+
+    Sock=&Con->Socks.back();
+    Sock->Watch.FD=fd;
+    Sock->Watch.Callback=HTTPClient_OS_ConnectEvent;
+    Sock->Watch.Active=false;
+    Sock->Con=Con;
+    Sock->Failed=false;
+    if(!HTTPClient_Reactor_Add(&Sock->Watch,EPOLLOUT))
+    {
+        Con->Socks.pop_back();
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectFinished
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_ConnectFinished(
+ *          struct HTTPClient_Connecting *Con,int Winner);
+ *
+ * PARAMETERS:
+ *    Con [I] -- The connect.  'Con->Lock' must be held.
+ *    Winner [I] -- The socket that connected or -1 if we gave up
+ *
+ * FUNCTION:
+ *    This function ends a background connect and calls it's 'Done'.  The
+ *    other sockets are left for HTTPClient_OS_ConnectEnd() to close.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_ConnectFinished(struct HTTPClient_Connecting *Con,
+        int Winner)
+{
+    /* The address may have changed, look it up fresh next time */
+    if(Winner<0)
+        HTTPClient_OS_ForgetHost(Con->Host.c_str());
+
+    Con->Winner=Winner;
+    Con->Finished=true;
+    Con->Done(Con->UserData);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_SetupSocket
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_SetupSocket(int fd);
+ *
+ * PARAMETERS:
+ *    fd [I] -- The socket that connected
+ *
+ * FUNCTION:
+ *    This function gets a socket that we connected ready for the rest of
+ *    the driver.  It stays non blocking, the reactor reads it until
+ *    EAGAIN and HTTPClient_OS_Send() keeps what it can't send.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_SetupSocket(int fd)
+{
+    int NoDelay;
+
+    /* We send whole requests with one write, don't let Nagle hold them */
+    NoDelay=1;
+    setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&NoDelay,sizeof(NoDelay));
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_StartConnect
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_OS_StartConnect(
+ *          const struct HTTPClient_Address *Address,uint16_t Port,
+ *          bool *Connected);
+ *
+ * PARAMETERS:
+ *    Address [I] -- The address to connect to
+ *    Port [I] -- The port to connect to
+ *    Connected [O] -- Set to true if the connect finished right away
+ *
+ * FUNCTION:
+ *    This function makes a non blocking socket and starts connecting it.
+ *
+ * RETURNS:
+ *    The socket or -1 if this address failed.
+ ******************************************************************************/
+static int HTTPClient_OS_StartConnect(const struct HTTPClient_Address *Address,
+        uint16_t Port,bool *Connected)
+{
+    struct sockaddr_storage Addr;
+    int fd;
+
+    Addr=Address->Addr;
+    if(Addr.ss_family==AF_INET6)
+        ((struct sockaddr_in6 *)&Addr)->sin6_port=htons(Port);
+    else
+        ((struct sockaddr_in *)&Addr)->sin_port=htons(Port);
+
+    fd=socket(Addr.ss_family,SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC,0);
+    if(fd<0)
+        return -1;
+
+    *Connected=false;
+    if(connect(fd,(struct sockaddr *)&Addr,Address->Len)==0)
+    {
+        *Connected=true;
+        return fd;
+    }
+
+    if(errno!=EINPROGRESS)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_CachedLookup
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_CachedLookup(const char *Host,
+ *          vector<struct HTTPClient_Address> &Addrs);
+ *
+ * PARAMETERS:
+ *    Host [I] -- The host to look up
+ *    Addrs [O] -- The addresses for 'Host' (interleaved, see
+ *                 HTTPClient_OS_Interleave())
+ *
+ * FUNCTION:
+ *    This function looks up a host without waiting.  IP addresses are
+ *    converted right away, names come from the cache.
+ *
+ * RETURNS:
+ *    true -- We have the addresses
+ *    false -- 'Host' needs a lookup (see HTTPClient_OS_StartLookup())
+ ******************************************************************************/
+static bool HTTPClient_OS_CachedLookup(const char *Host,
+        vector<struct HTTPClient_Address> &Addrs)
+{
+    map<string,struct HTTPClient_DNSEntry>::iterator Entry;
+    vector<struct HTTPClient_Address> Found;
+    struct addrinfo Hints;
+    struct addrinfo *Results;
+
+    /* IP addresses don't need a lookup (or a thread) */
+    memset(&Hints,0,sizeof(Hints));
+    Hints.ai_family=AF_UNSPEC;
+    Hints.ai_socktype=SOCK_STREAM;
+    Hints.ai_flags=AI_NUMERICHOST;
+    if(getaddrinfo(Host,NULL,&Hints,&Results)==0)
+    {
+        HTTPClient_OS_CopyAddrInfo(Results,Addrs);
+        freeaddrinfo(Results);
+        return !Addrs.empty();
+    }
+
+    {
+        lock_guard<mutex> Guard(m_HC_DNSCacheLock);
+        Entry=m_HC_DNSCache.find(Host);
+        if(Entry!=m_HC_DNSCache.end())
+        {
+            if(t_HCClock::now()<Entry->second.Expires)
+                Found=Entry->second.Addrs;
+            else
+                m_HC_DNSCache.erase(Entry);
+        }
+    }
+
+    HTTPClient_OS_Interleave(Found,Addrs);
+
+    return !Addrs.empty();
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_StartLookup
+ *
+ * SYNOPSIS:
+ *    static shared_ptr<struct HTTPClient_DNSLookup> HTTPClient_OS_StartLookup(
+ *          const char *Host,int WakeFD);
+ *
+ * PARAMETERS:
+ *    Host [I] -- The host to look up
+ *    WakeFD [I] -- An eventfd to write to when the lookup is done (-1 for
+ *                  none).  Set the lookup's 'WakeFD' to -1 (with it's lock
+ *                  held) before you close it.
+ *
+ * FUNCTION:
+ *    This function starts a worker thread to look up 'Host' (see
+ *    HTTPClient_OS_DNSWorker()).  Workers that have finished are joined
+ *    first.
+ *
+ * RETURNS:
+ *    The lookup or NULL if we couldn't start it.  Wait on it's 'Done'
+ *    (or 'WakeFD') for 'Finished'.
+ ******************************************************************************/
+static shared_ptr<struct HTTPClient_DNSLookup> HTTPClient_OS_StartLookup(
+        const char *Host,int WakeFD)
+{
+    shared_ptr<struct HTTPClient_DNSLookup> Lookup;
+    list<struct HTTPClient_DNSWorker>::iterator Worker;
+    bool Finished;
+
+    try
+    {
+        Lookup=make_shared<struct HTTPClient_DNSLookup>();
+        Lookup->Host=Host;
+        Lookup->Finished=false;
+        Lookup->WakeFD=WakeFD;
+
+        lock_guard<mutex> Guard(m_HC_DNSWorkersLock);
+
+        /* Clean up the workers that are done */
+        for(Worker=m_HC_DNSWorkers.begin();Worker!=m_HC_DNSWorkers.end();)
+        {
+            {
+                lock_guard<mutex> LookupGuard(Worker->Lookup->Lock);
+                Finished=Worker->Lookup->Finished;
+            }
+            if(!Finished)
+            {
+                Worker++;
+                continue;
+            }
+            Worker->Thread.join();
+            Worker=m_HC_DNSWorkers.erase(Worker);
+        }
+
+        m_HC_DNSWorkers.emplace_back();
+        m_HC_DNSWorkers.back().Lookup=Lookup;
+        try
+        {
+            m_HC_DNSWorkers.back().Thread=thread(HTTPClient_OS_DNSWorker,
+                    Lookup);
+        }
+        catch(...)
+        {
+            m_HC_DNSWorkers.pop_back();
+            throw;
+        }
+    }
+    catch(...)
+    {
+        return NULL;
+    }
+
+    return Lookup;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_Interleave
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_Interleave(
+ *          const vector<struct HTTPClient_Address> &Found,
+ *          vector<struct HTTPClient_Address> &Addrs);
+ *
+ * PARAMETERS:
+ *    Found [I] -- The addresses from the lookup
+ *    Addrs [O] -- The addresses are added to this
+ *
+ * FUNCTION:
+ *    This function orders the addresses for connecting Happy Eyeballs
+ *    style.  The families are interleaved, starting with the first one we
+ *    got (what getaddrinfo() liked best).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_Interleave(const vector<struct HTTPClient_Address> &Found,
+        vector<struct HTTPClient_Address> &Addrs)
+{
+    unsigned int v4;
+    unsigned int v6;
+    unsigned int r;
+    bool V6Turn;
+
+    V6Turn=!Found.empty() && Found[0].Addr.ss_family==AF_INET6;
+    v4=0;
+    v6=0;
+    for(r=0;r<Found.size();r++)
+    {
+        while(v6<Found.size() && Found[v6].Addr.ss_family!=AF_INET6)
+            v6++;
+        while(v4<Found.size() && Found[v4].Addr.ss_family==AF_INET6)
+            v4++;
+
+        if((V6Turn && v6<Found.size()) || v4>=Found.size())
+            Addrs.push_back(Found[v6++]);
+        else
+            Addrs.push_back(Found[v4++]);
+        V6Turn=!V6Turn;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_DNSWorker
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_DNSWorker(
+ *          shared_ptr<struct HTTPClient_DNSLookup> Lookup);
+ *
+ * PARAMETERS:
+ *    Lookup [I] -- The lookup to do
+ *
+ * FUNCTION:
+ *    This is the thread that does the (blocking) getaddrinfo().  It adds
+ *    what it found to the cache and wakes up the background connect that
+ *    is waiting on it (if it hasn't given up).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_DNSWorker(shared_ptr<struct HTTPClient_DNSLookup> Lookup)
+{
+    vector<struct HTTPClient_Address> Addrs;
+    struct HTTPClient_DNSEntry NewEntry;
+    struct addrinfo Hints;
+    struct addrinfo *Results;
+    uint64_t One;
+
+    memset(&Hints,0,sizeof(Hints));
+    Hints.ai_family=AF_UNSPEC;
+    Hints.ai_socktype=SOCK_STREAM;
+    if(getaddrinfo(Lookup->Host.c_str(),NULL,&Hints,&Results)==0)
+    {
+        HTTPClient_OS_CopyAddrInfo(Results,Addrs);
+        freeaddrinfo(Results);
+    }
+
+    if(!Addrs.empty())
+    {
+        NewEntry.Addrs=Addrs;
+        NewEntry.Expires=t_HCClock::now()+
+                chrono::seconds(HTTPCLIENT_DNS_CACHE_TTL);
+
+        lock_guard<mutex> Guard(m_HC_DNSCacheLock);
+        m_HC_DNSCache[Lookup->Host]=NewEntry;
+    }
+
+    lock_guard<mutex> Guard(Lookup->Lock);
+    Lookup->Addrs=Addrs;
+    Lookup->Finished=true;
+    if(Lookup->WakeFD>=0)
+    {
+        One=1;
+        if(write(Lookup->WakeFD,&One,sizeof(One))<0)
+        {
+            /* Already poked */
+        }
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_CopyAddrInfo
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_CopyAddrInfo(const struct addrinfo *List,
+ *          vector<struct HTTPClient_Address> &Addrs);
+ *
+ * PARAMETERS:
+ *    List [I] -- What getaddrinfo() returned
+ *    Addrs [O] -- The IPv4 and IPv6 addresses from 'List' are added to this
+ *
+ * FUNCTION:
+ *    This function copies the addresses out of a getaddrinfo() list.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_CopyAddrInfo(const struct addrinfo *List,
+        vector<struct HTTPClient_Address> &Addrs)
+{
+    struct HTTPClient_Address NewAddr;
+
+    for(;List!=NULL;List=List->ai_next)
+    {
+        if(List->ai_family!=AF_INET && List->ai_family!=AF_INET6)
+            continue;
+        if(List->ai_addrlen>sizeof(NewAddr.Addr))
+            continue;
+        memset(&NewAddr,0,sizeof(NewAddr));
+        memcpy(&NewAddr.Addr,List->ai_addr,List->ai_addrlen);
+        NewAddr.Len=List->ai_addrlen;
+        Addrs.push_back(NewAddr);
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ForgetHost
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_ForgetHost(const char *Host);
+ *
+ * PARAMETERS:
+ *    Host [I] -- The host to remove from the cache
+ *
+ * FUNCTION:
+ *    This function removes a host from the DNS cache.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_ForgetHost(const char *Host)
+{
+    lock_guard<mutex> Guard(m_HC_DNSCacheLock);
+    m_HC_DNSCache.erase(Host);
+}
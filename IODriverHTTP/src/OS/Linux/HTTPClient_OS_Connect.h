@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_OS_Connect.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is the .h file for looking up and connecting to the server.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __HTTPCLIENT_OS_CONNECT_H_
+#define __HTTPCLIENT_OS_CONNECT_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+#define HTTPCLIENT_DEFAULT_CONNECT_TIMEOUT      10000   // ms
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+struct HTTPClientConnect {int PrivateDataHere;};
+typedef struct HTTPClientConnect t_HCConnectType;
+
+/* Called on the reactor thread when a HTTPClient_OS_ConnectStart() is done */
+typedef void (*t_HCConnectDoneCB)(void *UserData);
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+void HTTPClient_OS_ConnectAddUser(void);
+void HTTPClient_OS_ConnectRemoveUser(void);
+t_HCConnectType *HTTPClient_OS_ConnectStart(const char *Host,uint16_t Port,
+        unsigned int TimeoutMS,t_HCConnectDoneCB Done,void *UserData);
+int HTTPClient_OS_ConnectEnd(t_HCConnectType *Connect);
+
+#endif
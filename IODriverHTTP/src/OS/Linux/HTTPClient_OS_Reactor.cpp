@@ -0,0 +1,426 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_OS_Reactor.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the one thread that watches the sockets for every HTTP
+ *    client connection in it.  It sleeps in epoll_wait() (with no timeout)
+ *    until a socket has something for us, so idle connections cost
+ *    nothing.
+ *
+ *    The thread is started when the first handle is allocated and stopped
+ *    when the last one is freed (see HTTPClient_Reactor_Start() /
+ *    HTTPClient_Reactor_Stop()).  Sockets are added edge triggered.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "HTTPClient_OS_Reactor.h"
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/*** DEFINES                  ***/
+#define HTTPCLIENT_REACTOR_MAX_EVENTS       32
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+/* One run of the reactor thread.  The thread only uses it's own copy so a
+   Start() after a Stop() can't change the fd's out from under a thread
+   that is still shutting down. */
+struct HTTPClient_ReactorRun
+{
+    pthread_t Thread;
+    int EPollFD;
+    int WakeFD;                 // eventfd to kick the thread
+    std::atomic<bool> Quit;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static void *HTTPClient_Reactor_Thread(void *arg);
+static void HTTPClient_Reactor_Wake(struct HTTPClient_ReactorRun *Run);
+static void HTTPClient_Reactor_FreeRun(struct HTTPClient_ReactorRun *Run);
+
+/*** VARIABLE DEFINITIONS     ***/
+static pthread_mutex_t m_HC_ReactorLock=PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t m_HC_ReactorCond=PTHREAD_COND_INITIALIZER;
+static unsigned int m_HC_ReactorUsers;      // How many handles want the thread
+static struct HTTPClient_ReactorRun *m_HC_Reactor;  // NULL when not running
+static uint64_t m_HC_ReactorPass;           // Bumped after each epoll_wait() is handled
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Start
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_Reactor_Start(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function adds a user to the reactor.  The first user starts the
+ *    thread.  Every call must be matched with a HTTPClient_Reactor_Stop().
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- We couldn't start the thread
+ *
+ * SEE ALSO:
+ *    HTTPClient_Reactor_Stop()
+ ******************************************************************************/
+bool HTTPClient_Reactor_Start(void)
+{
+    struct HTTPClient_ReactorRun *Run;
+    struct epoll_event Event;
+
+    Run=NULL;
+    pthread_mutex_lock(&m_HC_ReactorLock);
+    try
+    {
+        if(m_HC_ReactorUsers==0)
+        {
+            Run=new struct HTTPClient_ReactorRun;
+            Run->EPollFD=-1;
+            Run->WakeFD=-1;
+            Run->Quit=false;
+
+            Run->EPollFD=epoll_create1(EPOLL_CLOEXEC);
+            if(Run->EPollFD<0)
+                throw(0);
+
+            Run->WakeFD=eventfd(0,EFD_NONBLOCK|EFD_CLOEXEC);
+            if(Run->WakeFD<0)
+                throw(0);
+
+            Event.events=EPOLLIN;
+            Event.data.ptr=NULL;    // NULL = the wake up eventfd
+            if(epoll_ctl(Run->EPollFD,EPOLL_CTL_ADD,Run->WakeFD,&Event)<0)
+                throw(0);
+
+            if(pthread_create(&Run->Thread,NULL,HTTPClient_Reactor_Thread,
+                    Run)!=0)
+            {
+                throw(0);
+            }
+            m_HC_Reactor=Run;
+        }
+        m_HC_ReactorUsers++;
+    }
+    catch(...)
+    {
+        if(Run!=NULL)
+            HTTPClient_Reactor_FreeRun(Run);
+        pthread_mutex_unlock(&m_HC_ReactorLock);
+        return false;
+    }
+    pthread_mutex_unlock(&m_HC_ReactorLock);
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Stop
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_Reactor_Stop(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function removes a user from the reactor.  When the last user
+ *    is gone the thread is stopped.  Everything you added must have been
+ *    removed first.
+ *
+ *    The run is taken out of the shared state while we hold the lock, so
+ *    a HTTPClient_Reactor_Start() that comes in while we are waiting for
+ *    the old thread to exit starts a new one with it's own fd's.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_Reactor_Start()
+ ******************************************************************************/
+void HTTPClient_Reactor_Stop(void)
+{
+    struct HTTPClient_ReactorRun *Run;
+
+    pthread_mutex_lock(&m_HC_ReactorLock);
+    if(m_HC_ReactorUsers==0 || --m_HC_ReactorUsers>0)
+    {
+        pthread_mutex_unlock(&m_HC_ReactorLock);
+        return;
+    }
+    Run=m_HC_Reactor;
+    m_HC_Reactor=NULL;
+    Run->Quit=true;
+    pthread_mutex_unlock(&m_HC_ReactorLock);
+
+    HTTPClient_Reactor_Wake(Run);
+    pthread_join(Run->Thread,NULL);
+
+    HTTPClient_Reactor_FreeRun(Run);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Add
+ *
+ * SYNOPSIS:
+ *    bool HTTPClient_Reactor_Add(struct HTTPClient_ReactorWatch *Watch,
+ *          uint32_t Events);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- What to watch.  'FD' and 'Callback' must be filled in.
+ *                 This must stay around until HTTPClient_Reactor_Remove()
+ *                 returns.
+ *    Events [I] -- The epoll events to watch for (EPOLLET is added)
+ *
+ * FUNCTION:
+ *    This function starts watching a file descriptor.  'Watch->Callback' is
+ *    called on the reactor thread when it has events.  It can be called
+ *    while the thread is waiting, epoll_wait() sees the new fd right away.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- There was an error
+ *
+ * SEE ALSO:
+ *    HTTPClient_Reactor_Remove()
+ ******************************************************************************/
+bool HTTPClient_Reactor_Add(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events)
+{
+    struct epoll_event Event;
+
+    Watch->Active=true;
+
+    Event.events=Events|EPOLLET;
+    Event.data.ptr=Watch;
+    if(epoll_ctl(m_HC_Reactor->EPollFD,EPOLL_CTL_ADD,Watch->FD,&Event)<0)
+    {
+        Watch->Active=false;
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Rearm
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_Reactor_Rearm(struct HTTPClient_ReactorWatch *Watch,
+ *          uint32_t Events);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- The watch to rearm
+ *    Events [I] -- The epoll events to watch for (EPOLLET is added)
+ *
+ * FUNCTION:
+ *    This function makes the reactor look at a watched fd again.  Because
+ *    fd's are edge triggered an fd that stopped being read while it still
+ *    had data will not get another event on its own.  After this the
+ *    callback is called (again) if the fd is ready.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_Reactor_Add()
+ ******************************************************************************/
+void HTTPClient_Reactor_Rearm(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events)
+{
+    struct epoll_event Event;
+
+    if(!Watch->Active)
+        return;
+
+    Event.events=Events|EPOLLET;
+    Event.data.ptr=Watch;
+    epoll_ctl(m_HC_Reactor->EPollFD,EPOLL_CTL_MOD,Watch->FD,&Event);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Remove
+ *
+ * SYNOPSIS:
+ *    void HTTPClient_Reactor_Remove(struct HTTPClient_ReactorWatch *Watch);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- What to stop watching
+ *
+ * FUNCTION:
+ *    This function stops watching a file descriptor.  When it returns
+ *    the callback will not be called again, so the fd can be closed and
+ *    'Watch' freed.
+ *
+ *    epoll_wait() may have already handed back an event for this fd, so we
+ *    kick the thread and wait for it to finish the pass it's on.  If we
+ *    are called from a callback there is nothing to wait for (the rest of
+ *    the pass skips 'Watch').
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_Reactor_Add()
+ ******************************************************************************/
+void HTTPClient_Reactor_Remove(struct HTTPClient_ReactorWatch *Watch)
+{
+    uint64_t Pass;
+
+    if(!Watch->Active.exchange(false))
+        return;
+
+    epoll_ctl(m_HC_Reactor->EPollFD,EPOLL_CTL_DEL,Watch->FD,NULL);
+
+    if(pthread_equal(pthread_self(),m_HC_Reactor->Thread))
+        return;
+
+    pthread_mutex_lock(&m_HC_ReactorLock);
+    Pass=m_HC_ReactorPass;
+    HTTPClient_Reactor_Wake(m_HC_Reactor);
+    while(m_HC_ReactorPass==Pass)
+        pthread_cond_wait(&m_HC_ReactorCond,&m_HC_ReactorLock);
+    pthread_mutex_unlock(&m_HC_ReactorLock);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Wake
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_Reactor_Wake(struct HTTPClient_ReactorRun *Run);
+ *
+ * PARAMETERS:
+ *    Run [I] -- The reactor run to wake
+ *
+ * FUNCTION:
+ *    This function makes the reactor thread return from epoll_wait().
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_Reactor_Wake(struct HTTPClient_ReactorRun *Run)
+{
+    uint64_t One;
+
+    One=1;
+    if(write(Run->WakeFD,&One,sizeof(One))<0)
+    {
+        /* Already signaled */
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_FreeRun
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_Reactor_FreeRun(struct HTTPClient_ReactorRun *Run);
+ *
+ * PARAMETERS:
+ *    Run [I] -- The reactor run to free.  It's thread must not be running.
+ *
+ * FUNCTION:
+ *    This function closes the fd's for a reactor run and frees it.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_Reactor_FreeRun(struct HTTPClient_ReactorRun *Run)
+{
+    if(Run->WakeFD>=0)
+        close(Run->WakeFD);
+    if(Run->EPollFD>=0)
+        close(Run->EPollFD);
+    delete Run;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_Reactor_Thread
+ *
+ * SYNOPSIS:
+ *    static void *HTTPClient_Reactor_Thread(void *arg);
+ *
+ * PARAMETERS:
+ *    arg [I] -- The 'struct HTTPClient_ReactorRun' for this thread
+ *
+ * FUNCTION:
+ *    This is the reactor thread.  It waits (forever) for any of the fd's to
+ *    have events and calls their callbacks.
+ *
+ * RETURNS:
+ *    NULL
+ ******************************************************************************/
+static void *HTTPClient_Reactor_Thread(void *arg)
+{
+    struct HTTPClient_ReactorRun *Run=(struct HTTPClient_ReactorRun *)arg;
+    struct epoll_event Events[HTTPCLIENT_REACTOR_MAX_EVENTS];
+    struct HTTPClient_ReactorWatch *Watch;
+    uint64_t Count;
+    int Ready;
+    int r;
+
+    while(!Run->Quit)
+    {
+        Ready=epoll_wait(Run->EPollFD,Events,
+                HTTPCLIENT_REACTOR_MAX_EVENTS,-1);
+
+        for(r=0;r<Ready;r++)
+        {
+            Watch=(struct HTTPClient_ReactorWatch *)Events[r].data.ptr;
+            if(Watch==NULL)
+            {
+                if(read(Run->WakeFD,&Count,sizeof(Count))<0)
+                {
+                    /* Someone else already cleared it */
+                }
+                continue;
+            }
+
+            /* It may have been removed since epoll_wait() returned */
+            if(Watch->Active)
+                Watch->Callback(Watch,Events[r].events);
+        }
+
+        /* Let anyone in HTTPClient_Reactor_Remove() know we are done with
+           the events from this pass */
+        pthread_mutex_lock(&m_HC_ReactorLock);
+        m_HC_ReactorPass++;
+        pthread_cond_broadcast(&m_HC_ReactorCond);
+        pthread_mutex_unlock(&m_HC_ReactorLock);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * FILENAME: HTTPClient_OS_Reactor.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is the .h file for the one epoll thread that watches all the
+ *    HTTP client sockets.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __HTTPCLIENT_OS_REACTOR_H_
+#define __HTTPCLIENT_OS_REACTOR_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <atomic>
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+/* Something the reactor is watching.  Put this in your own struct and
+   cast back to it in 'Callback'. */
+struct HTTPClient_ReactorWatch
+{
+    int FD;
+    /* Called on the reactor thread with the epoll events */
+    void (*Callback)(struct HTTPClient_ReactorWatch *Watch,uint32_t Events);
+    std::atomic<bool> Active;   // Private to the reactor
+};
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+bool HTTPClient_Reactor_Start(void);
+void HTTPClient_Reactor_Stop(void);
+bool HTTPClient_Reactor_Add(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events);
+void HTTPClient_Reactor_Remove(struct HTTPClient_ReactorWatch *Watch);
+void HTTPClient_Reactor_Rearm(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events);
+
+#endif
@@ -32,33 +32,130 @@
 #include "../HTTPClient_Socket.h"
 #include "../../HTTPClient_Main.h"
 #include "../../HTTPClient_HTTP.h"
+#include "HTTPClient_OS_Connect.h"
+#include "HTTPClient_OS_Reactor.h"
 #include <sys/socket.h>
-#include <arpa/inet.h>
-#include <netdb.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
 #include <pthread.h>
+#include <string>
+
+using namespace std;
 
 /*** DEFINES                  ***/
+#define HTTPCLIENT_RX_RING_SIZE             65536   // Must be a power of 2
+/* What we watch the socket for.  EPOLLOUT is always on (it's edge
+   triggered so it only comes in when a full socket gets room) */
+#define HTTPCLIENT_SOCKET_EVENTS            (EPOLLIN|EPOLLOUT|EPOLLRDHUP)
 
 /*** MACROS                   ***/
 
 /*** TYPE DEFINITIONS         ***/
+/* Where we are in telling the IO system about data */
+typedef enum
+{
+    e_HCDataEvent_Idle,             // Nothing sent, waiting for the socket
+    e_HCDataEvent_Sent,             // Sent, waiting for Read() to drain it
+    e_HCDataEvent_SentMoreArrived,  // Sent, and more came in since
+} e_HCDataEventType;
+
+/* Why we are connecting (what HTTPClient_OS_FinishConnect() does next) */
+typedef enum
+{
+    e_HCConnectFor_Open,            // Send the request, tell the IO system
+    e_HCConnectFor_Poll,            // Server closed between polls, the timer sends
+    e_HCConnectFor_SSEResume,       // Send the resume request
+} e_HCConnectForType;
+
+struct HTTPClient_OurData;
+
+/* A timer that belongs to a connection (polling, SSE reconnect) */
+struct HTTPClient_Timer
+{
+    struct HTTPClient_ReactorWatch Watch;   // Must be first
+    struct HTTPClient_OurData *OurData;
+};
+
 struct HTTPClient_OurData
 {
+    struct HTTPClient_ReactorWatch Watch;   // Must be first
     struct HTTPData HTTPState;
     t_IOSystemHandle *IOHandle;
     int SockFD;
-    struct sockaddr_in serv_addr;
-    pthread_t ThreadInfo;
-    volatile bool RequestThreadQuit;
-    volatile bool ThreadHasQuit;
+    std::atomic<int> DataEvent;             // e_HCDataEventType
     volatile bool Opened;
+
+    /* What the reactor has read from the socket (see
+       HTTPClient_OS_FillRxRing()).  The reactor moves 'RxHead', Read()
+       moves 'RxTail', they only ever count up. */
+    std::atomic<uint32_t> RxHead;
+    std::atomic<uint32_t> RxTail;
+    std::atomic<int> RxStatus;              // 0 or the RETERROR_* after the data
+    std::atomic<bool> RxStalled;            // Ring was full, socket not drained
+    uint8_t RxRing[HTTPCLIENT_RX_RING_SIZE];
+
+    /* What send() didn't take yet (see HTTPClient_OS_Send()).  The
+       reactor sends it when the socket has room. */
+    pthread_mutex_t TxLock;
+    string TxPending;
+    std::atomic<bool> TxWaiting;            // 'TxPending' isn't empty
+
+    /* WS driver (the same connection with WebSocket frames on it) */
+    bool WebSocket;
+    struct WSData WS;
+
+    /* Where we connected (for reconnecting) */
+    string Address;
+    uint16_t Port;
+    unsigned int ConnectTimeout;
+
+    /* We connect in the background (see HTTPClient_OS_BeginConnect()) */
+    t_HCConnectType *Connecting;            // NULL when not connecting
+    e_HCConnectForType ConnectFor;
+    std::atomic<bool> ConnectDone;          // Read() should finish it
+
+    /* Polling (keep-alive) */
+    unsigned int PollInterval;              // ms, 0 = one request only
+    struct HTTPClient_Timer PollTimer;
+    std::atomic<bool> AwaitingResponse;     // The request is out
+
+    /* Event streams (reconnect when the stream ends) */
+    struct HTTPClient_Timer RetryTimer;
+    bool WaitingToRetry;                    // Socket closed, timer running
+    std::atomic<bool> RetryDue;             // The timer went off
 };
 
 /*** FUNCTION PROTOTYPES      ***/
-static void *HTTPClient_OS_PollThread(void *arg);
+static void HTTPClient_OS_SocketEvent(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events);
+static void HTTPClient_OS_DataEvent(struct HTTPClient_OurData *OurData);
+static void HTTPClient_OS_Drained(struct HTTPClient_OurData *OurData);
+static int HTTPClient_OS_Send(struct HTTPClient_OurData *OurData,
+        const uint8_t *Data,int Bytes);
+static void HTTPClient_OS_SendPending(struct HTTPClient_OurData *OurData);
+static bool HTTPClient_OS_FillRxRing(struct HTTPClient_OurData *OurData);
+static int HTTPClient_OS_ReadRxRing(struct HTTPClient_OurData *OurData,
+        uint8_t *Data,int MaxBytes);
+static bool HTTPClient_OS_WatchSocket(struct HTTPClient_OurData *OurData,
+        int fd);
+static bool HTTPClient_OS_BeginConnect(struct HTTPClient_OurData *OurData,
+        e_HCConnectForType For);
+static void HTTPClient_OS_ConnectDone(void *UserData);
+static bool HTTPClient_OS_FinishConnect(struct HTTPClient_OurData *OurData);
+static void HTTPClient_OS_CloseSocket(struct HTTPClient_OurData *OurData);
+static bool HTTPClient_OS_Reconnect(struct HTTPClient_OurData *OurData);
+static void HTTPClient_OS_PollTimerEvent(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events);
+static void HTTPClient_OS_SSEWait(struct HTTPClient_OurData *OurData);
+static bool HTTPClient_OS_SSEResume(struct HTTPClient_OurData *OurData);
+static void HTTPClient_OS_RetryTimerEvent(
+        struct HTTPClient_ReactorWatch *Watch,uint32_t Events);
+static int HTTPClient_OS_WSRead(struct HTTPClient_OurData *OurData,
+        uint8_t *Data,int MaxBytes);
 
 /*** VARIABLE DEFINITIONS     ***/
 
@@ -116,30 +213,90 @@ t_DriverIOHandleType *HTTPClient_AllocateHandle(const char *DeviceUniqueID,
     try
     {
         NewData=new struct HTTPClient_OurData;
+        pthread_mutex_init(&NewData->TxLock,NULL);
+        NewData->TxWaiting=false;
         NewData->IOHandle=IOHandle;
         NewData->SockFD=-1;
-        NewData->RequestThreadQuit=false;
-        NewData->ThreadHasQuit=false;
+        NewData->Watch.FD=-1;
+        NewData->Watch.Callback=HTTPClient_OS_SocketEvent;
+        NewData->Watch.Active=false;
+        NewData->DataEvent=e_HCDataEvent_Idle;
         NewData->Opened=false;
+        NewData->WebSocket=false;
+        NewData->PollInterval=0;
+        NewData->PollTimer.Watch.FD=-1;
+        NewData->PollTimer.Watch.Callback=HTTPClient_OS_PollTimerEvent;
+        NewData->PollTimer.Watch.Active=false;
+        NewData->PollTimer.OurData=NewData;
+        NewData->AwaitingResponse=false;
+        NewData->RetryTimer.Watch.FD=-1;
+        NewData->RetryTimer.Watch.Callback=HTTPClient_OS_RetryTimerEvent;
+        NewData->RetryTimer.Watch.Active=false;
+        NewData->RetryTimer.OurData=NewData;
+        NewData->WaitingToRetry=false;
+        NewData->RetryDue=false;
+        NewData->Connecting=NULL;
+        NewData->ConnectFor=e_HCConnectFor_Open;
+        NewData->ConnectDone=false;
+        HTTPClient_InitHTTPData(&NewData->HTTPState);
 
-        /* Startup the thread for polling if we have data available */
-        if(pthread_create(&NewData->ThreadInfo,NULL,HTTPClient_OS_PollThread,
-                NewData)<0)
-        {
+        /* All the connections share one thread to watch for data */
+        if(!HTTPClient_Reactor_Start())
             throw(0);
-        }
-
+        HTTPClient_OS_ConnectAddUser();
     }
     catch(...)
     {
         if(NewData!=NULL)
+        {
+            pthread_mutex_destroy(&NewData->TxLock);
             delete NewData;
+        }
         return NULL;
     }
 
     return (t_DriverIOHandleType *)NewData;
 }
 
+/*******************************************************************************
+ * NAME:
+ *    WSClient_AllocateHandle
+ *
+ * SYNOPSIS:
+ *    t_DriverIOHandleType *WSClient_AllocateHandle(const char *DeviceUniqueID,
+ *          t_IOSystemHandle *IOHandle);
+ *
+ * PARAMETERS:
+ *    DeviceUniqueID [I] -- This is the unique ID for the device we are working
+ *                          on.
+ *    IOHandle [I] -- A handle to the IO system.
+ *
+ * FUNCTION:
+ *    This function allocates a connection for the WS driver.  It's the same
+ *    as a HTTP connection, Open() asks for a WebSocket upgrade and
+ *    Read() / Write() work with WebSocket messages.
+ *
+ * RETURNS:
+ *    Newly allocated data for this connection or NULL on error.
+ *
+ * SEE ALSO:
+ *    HTTPClient_AllocateHandle()
+ ******************************************************************************/
+t_DriverIOHandleType *WSClient_AllocateHandle(const char *DeviceUniqueID,
+        t_IOSystemHandle *IOHandle)
+{
+    struct HTTPClient_OurData *NewData;
+
+    NewData=(struct HTTPClient_OurData *)
+            HTTPClient_AllocateHandle(DeviceUniqueID,IOHandle);
+    if(NewData==NULL)
+        return NULL;
+
+    NewData->WebSocket=true;
+
+    return (t_DriverIOHandleType *)NewData;
+}
+
 /*******************************************************************************
  * NAME:
  *    HTTPClient_FreeHandle
@@ -163,16 +320,14 @@ void HTTPClient_FreeHandle(t_DriverIOHandleType *DriverIO)
 {
     struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
 
-    /* Tell thread to quit */
-    OurData->RequestThreadQuit=true;
+    HTTPClient_OS_CloseSocket(OurData);
 
-    /* Wait for the thread to exit */
-    while(!OurData->ThreadHasQuit)
-        usleep(1000);   // Wait 1 ms
+    HTTPClient_Reactor_Stop();
+    HTTPClient_OS_ConnectRemoveUser();
 
-    if(OurData->SockFD>=0)
-        close(OurData->SockFD);
+    HTTPClient_FreeHTTPData(&OurData->HTTPState);
 
+    pthread_mutex_destroy(&OurData->TxLock);
     delete OurData;
 }
 
@@ -190,6 +345,12 @@ void HTTPClient_FreeHandle(t_DriverIOHandleType *DriverIO)
  * FUNCTION:
  *    This function opens the OS device.
  *
+ *    We don't wait to connect.  The request is built here and the connect
+ *    is started in the background (on the reactor, see
+ *    HTTPClient_OS_ConnectStart()).  When it's done we send a data event
+ *    and Read() sends the request (see HTTPClient_OS_FinishConnect()).
+ *    Until then Write() returns RETERROR_BUSY.
+ *
  * RETURNS:
  *    true -- Things worked out
  *    false -- There was an error.
@@ -201,58 +362,93 @@ void HTTPClient_FreeHandle(t_DriverIOHandleType *DriverIO)
 PG_BOOL HTTPClient_Open(t_DriverIOHandleType *DriverIO,const t_PIKVList *Options)
 {
     struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
-    struct hostent *host;
-//    int flags;
     const char *AddressStr;
     const char *PortStr;
-    uint16_t Port;
+    const char *TimeoutStr;
+    const char *PollStr;
+    const char *BinaryStr;
+    struct itimerspec Interval;
 
     AddressStr=g_HC_System->KVGetItem(Options,"Address");
     PortStr=g_HC_System->KVGetItem(Options,"Port");
+    TimeoutStr=g_HC_System->KVGetItem(Options,"ConnectTimeout");
+    PollStr=g_HC_System->KVGetItem(Options,"PollInterval");
     if(AddressStr==NULL || PortStr==NULL)
         return false;
 
-    Port=strtoul(PortStr,NULL,10);
-
-    host=gethostbyname(AddressStr);
-    if(host==NULL)
+    try
+    {
+        OurData->Address=AddressStr;
+    }
+    catch(...)
     {
         return false;
     }
+    OurData->Port=strtoul(PortStr,NULL,10);
 
-    if((OurData->SockFD=socket(AF_INET,SOCK_STREAM,0))<0)
-        return false;
+    OurData->ConnectTimeout=HTTPCLIENT_DEFAULT_CONNECT_TIMEOUT;
+    if(TimeoutStr!=NULL && *TimeoutStr!=0)
+        OurData->ConnectTimeout=strtoul(TimeoutStr,NULL,10);
+
+    OurData->PollInterval=0;
+    if(PollStr!=NULL)
+        OurData->PollInterval=strtoul(PollStr,NULL,10);
 
-//    /* Switch to nonblocking */
-//    flags=fcntl(OurData->SockFD,F_GETFL,0);
-//    if(flags<0)
-//        flags=0;
-//    flags|=O_NONBLOCK;
-//    fcntl(OurData->SockFD,F_SETFL,flags);
-
-    memset(&OurData->serv_addr,'0',sizeof(OurData->serv_addr));
-    OurData->serv_addr.sin_family = AF_INET;
-    OurData->serv_addr.sin_port = htons(Port);
-    OurData->serv_addr.sin_addr.s_addr = *(long *)(host->h_addr);
-    memset(&(OurData->serv_addr.sin_zero), 0, 8);
-
-    if(connect(OurData->SockFD,(struct sockaddr *)&OurData->serv_addr,
-            sizeof(struct sockaddr)) == -1)
+    if(OurData->WebSocket)
+    {
+        BinaryStr=g_HC_System->KVGetItem(Options,"Binary");
+        HTTPClient_WS_Init(&OurData->WS,BinaryStr!=NULL && atoi(BinaryStr)!=0);
+    }
+
+    if(!HTTPClient_BuildHTTPRequest(Options,&OurData->HTTPState,
+            OurData->WebSocket?&OurData->WS:NULL))
     {
-        close(OurData->SockFD);
-        OurData->SockFD=-1;
         return false;
     }
 
+    if(!HTTPClient_OS_BeginConnect(OurData,e_HCConnectFor_Open))
+        return false;
+
     OurData->Opened=true;
+    OurData->AwaitingResponse=true;
 
-    if(!HTTPClient_StartHTTPHandShake(DriverIO,Options,&OurData->HTTPState))
+    if(HTTPClient_SSEMode(&OurData->HTTPState))
     {
-        HTTPClient_Close(DriverIO);
-        return false;
+        /* An event stream doesn't poll, it reconnects when the stream ends
+           (the timer is set by HTTPClient_OS_SSEWait()) */
+        OurData->PollInterval=0;
+        OurData->RetryTimer.Watch.FD=timerfd_create(CLOCK_MONOTONIC,
+                TFD_NONBLOCK|TFD_CLOEXEC);
+        if(OurData->RetryTimer.Watch.FD<0 ||
+                !HTTPClient_Reactor_Add(&OurData->RetryTimer.Watch,EPOLLIN))
+        {
+            HTTPClient_Close(DriverIO);
+            return false;
+        }
     }
 
-    g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,e_DataEventCode_Connected);
+    if(OurData->PollInterval>0)
+    {
+        /* The timer ticks every 'PollInterval' and sends the request again
+           (if the last response is done) */
+        OurData->PollTimer.Watch.FD=timerfd_create(CLOCK_MONOTONIC,
+                TFD_NONBLOCK|TFD_CLOEXEC);
+        if(OurData->PollTimer.Watch.FD<0)
+        {
+            HTTPClient_Close(DriverIO);
+            return false;
+        }
+
+        Interval.it_interval.tv_sec=OurData->PollInterval/1000;
+        Interval.it_interval.tv_nsec=(OurData->PollInterval%1000)*1000000;
+        Interval.it_value=Interval.it_interval;
+        if(timerfd_settime(OurData->PollTimer.Watch.FD,0,&Interval,NULL)<0 ||
+                !HTTPClient_Reactor_Add(&OurData->PollTimer.Watch,EPOLLIN))
+        {
+            HTTPClient_Close(DriverIO);
+            return false;
+        }
+    }
 
     return true;
 }
@@ -280,12 +476,13 @@ void HTTPClient_Close(t_DriverIOHandleType *DriverIO)
 {
     struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
 
-    if(OurData->SockFD>=0)
-        close(OurData->SockFD);
-    OurData->SockFD=-1;
-
     OurData->Opened=false;
 
+    if(OurData->WebSocket && OurData->SockFD>=0)
+        HTTPClient_WS_SendClose(DriverIO,&OurData->WS,1000);
+
+    HTTPClient_OS_CloseSocket(OurData);
+
     g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,
             e_DataEventCode_Disconnected);
 }
@@ -303,7 +500,31 @@ void HTTPClient_Close(t_DriverIOHandleType *DriverIO)
  *    Bytes [I] -- The max number of bytes that can be stored in 'Data'
  *
  * FUNCTION:
- *    This function reads data from the device and stores it in 'Data'
+ *    This function reads data from the device and stores it in 'Data'.
+ *
+ *    Only the body of the response is returned (see
+ *    HTTPClient_ProcessHTTPResponse()), inflated if it was compressed.
+ *    When the whole response has been read the connection is closed,
+ *    unless we are polling.  Then we wait for the poll timer to send the
+ *    next request.  If the server closed we connect again first, in the
+ *    background like Open() (see HTTPClient_OS_Reconnect()).
+ *
+ *    For the WS driver the WebSocket frames are taken out and just the
+ *    message payload is returned (see HTTPClient_OS_WSRead()).
+ *
+ *    For event streams (the "SSE" option) each event is returned as one
+ *    line.  When the stream ends we close the socket (without telling the
+ *    IO system) and the retry timer brings us back here to connect again
+ *    and ask for the events after the last one we got.
+ *
+ *    While a background connect is going we return RETERROR_NOBYTES.  When
+ *    it's done we pick up from it (see HTTPClient_OS_FinishConnect()).
+ *
+ *    The socket itself is read on the reactor thread into a ring buffer
+ *    (see HTTPClient_OS_FillRxRing()), here we just copy out of the ring.
+ *    Once the ring has been emptied (we took less than 'MaxBytes' or
+ *    return no bytes) we are ready for the next data event (see
+ *    HTTPClient_OS_SocketEvent()).
  *
  * RETURNS:
  *    The number of bytes that was read or:
@@ -318,53 +539,195 @@ void HTTPClient_Close(t_DriverIOHandleType *DriverIO)
 int HTTPClient_Read(t_DriverIOHandleType *DriverIO,uint8_t *Data,int MaxBytes)
 {
     struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
+    struct HTTPData *HTTPState;
+    uint8_t *ReadBuff;
+    int Space;
     int Byte2Ret;
-    int BytesLeft;
-    struct timeval tv;
-    fd_set fds;
+    int BytesRead;
+    int BodyBytes;
+    bool Drained;
+    bool KeepAlive;
+
+    if(OurData->Connecting!=NULL)
+    {
+        HTTPClient_OS_Drained(OurData);
+        if(!OurData->ConnectDone)
+            return RETERROR_NOBYTES;
+        if(!HTTPClient_OS_FinishConnect(OurData))
+        {
+            /* An event stream just waits and tries again */
+            if(OurData->ConnectFor==e_HCConnectFor_SSEResume)
+            {
+                HTTPClient_OS_SSEWait(OurData);
+                return RETERROR_NOBYTES;
+            }
+            HTTPClient_Close(DriverIO);
+            return RETERROR_DISCONNECT;
+        }
+    }
 
     if(OurData->SockFD<0)
-        return RETERROR_IOERROR;
+    {
+        if(!OurData->WaitingToRetry)
+            return RETERROR_DISCONNECT;
+
+        /* Waiting to reconnect an event stream */
+        HTTPClient_OS_Drained(OurData);
+        if(!OurData->RetryDue)
+            return RETERROR_NOBYTES;
+        OurData->RetryDue=false;
+        if(!HTTPClient_OS_SSEResume(OurData))
+            HTTPClient_OS_SSEWait(OurData);
+        return RETERROR_NOBYTES;
+    }
 
-    FD_ZERO(&fds);
-    FD_SET(OurData->SockFD,&fds);
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
+    if(OurData->WebSocket)
+        return HTTPClient_OS_WSRead(OurData,Data,MaxBytes);
 
-    Byte2Ret=RETERROR_NOBYTES;
+    HTTPState=&OurData->HTTPState;
+    Byte2Ret=0;
+    Drained=false;
 
-    /* Make sure we have at least 1 byte waiting */
-    if(select(OurData->SockFD+1,&fds,NULL,NULL,&tv)!=0)
+    /* The headers and chunk framing are taken out of what we read, so keep
+       reading until we have a full buffer of body (or the socket is
+       empty).  If we returned less than 'MaxBytes' with more still on the
+       socket we would never hear about it again. */
+    while(Byte2Ret<MaxBytes)
     {
-        if(FD_ISSET(OurData->SockFD,&fds))
+        /* Use up what we have already read before reading more */
+        if(HTTPClient_DecodePending(HTTPState))
         {
-            Byte2Ret=read(OurData->SockFD,Data,MaxBytes);
-            if(Byte2Ret<0)
-                return RETERROR_IOERROR;
-            if(Byte2Ret==0)
+            BodyBytes=HTTPClient_Decode(HTTPState,&Data[Byte2Ret],
+                    MaxBytes-Byte2Ret);
+            if(BodyBytes<0)
             {
-                /* 0=connection closed (because we where already told there
-                   was data) */
-                if(OurData->SockFD>=0)
-                    close(OurData->SockFD);
-                OurData->SockFD=-1;
-                OurData->Opened=false;
-                g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,
-                        e_DataEventCode_Disconnected);
+                /* Bad compressed data */
+                HTTPClient_Close(DriverIO);
+                if(Byte2Ret>0)
+                    return Byte2Ret;
                 return RETERROR_DISCONNECT;
             }
-            else
+            Byte2Ret+=BodyBytes;
+            continue;
+        }
+
+        if(HTTPClient_ResponseDone(HTTPState))
+        {
+            if(HTTPClient_SSECanRetry(HTTPState))
+            {
+                /* The event stream ended, connect again later */
+                HTTPClient_OS_SSEWait(OurData);
+                break;
+            }
+
+            if(OurData->PollInterval==0)
             {
-                BytesLeft=HTTPClient_ProcessHTTPHeaders(DriverIO,
-                        &OurData->HTTPState,Data,Byte2Ret);
-                if(BytesLeft!=Byte2Ret && BytesLeft!=0)
-                {
-                    /* Ok, we need to move the extra bytes down in the buffer
-                       and return that number */
-                    memcpy(Data,&Data[Byte2Ret-BytesLeft],BytesLeft);
-                }
-                Byte2Ret=BytesLeft;
+                /* That's the whole page */
+                HTTPClient_Close(DriverIO);
+                break;
+            }
+
+            /* Polling, get ready for the next response (the timer sends
+               the request) */
+            KeepAlive=HTTPState->KeepAlive;
+            HTTPClient_NextResponse(HTTPState);
+            if(!KeepAlive)
+            {
+                /* The server is closing, we'll be back when we have
+                   connected again */
+                if(!HTTPClient_OS_Reconnect(OurData))
+                    HTTPClient_Close(DriverIO);
+                break;
+            }
+            OurData->AwaitingResponse=false;
+            continue;
+        }
+
+        if(Drained)
+            break;
+
+        if(HTTPClient_UseDecodeWindow(HTTPState))
+        {
+            ReadBuff=HTTPState->Window;
+            Space=sizeof(HTTPState->Window);
+            if(Space>MaxBytes-Byte2Ret)
+                Space=MaxBytes-Byte2Ret;
+        }
+        else
+        {
+            ReadBuff=&Data[Byte2Ret];
+            Space=MaxBytes-Byte2Ret;
+        }
+
+        BytesRead=HTTPClient_OS_ReadRxRing(OurData,ReadBuff,Space);
+        if(BytesRead==RETERROR_NOBYTES)
+        {
+            /* Nothing more for now */
+            HTTPClient_OS_Drained(OurData);
+            break;
+        }
+        if(BytesRead==RETERROR_IOERROR)
+        {
+            HTTPClient_OS_Drained(OurData);
+            if(HTTPClient_SSECanRetry(HTTPState))
+            {
+                HTTPClient_OS_SSEWait(OurData);
+                break;
+            }
+            if(Byte2Ret>0)
+                break;
+            return RETERROR_IOERROR;
+        }
+        if(BytesRead==RETERROR_DISCONNECT)
+        {
+            /* The connection was closed.  When polling the server is
+               allowed to close between (or to end) responses, we just
+               connect again (and are back when that's done). */
+            if(OurData->PollInterval>0 && HTTPClient_OS_Reconnect(OurData))
+            {
+                HTTPClient_NextResponse(HTTPState);
+                break;
+            }
+            if(HTTPClient_SSECanRetry(HTTPState))
+            {
+                HTTPClient_OS_SSEWait(OurData);
+                break;
             }
+            HTTPClient_Close(DriverIO);
+            if(Byte2Ret>0)
+                return Byte2Ret;
+            return RETERROR_DISCONNECT;
+        }
+
+        /* Short read means the ring is empty */
+        if(BytesRead<Space)
+        {
+            HTTPClient_OS_Drained(OurData);
+            Drained=true;
+        }
+
+        BodyBytes=HTTPClient_ProcessHTTPResponse(DriverIO,HTTPState,ReadBuff,
+                BytesRead);
+        if(BodyBytes<0)
+        {
+            /* Not HTTP */
+            HTTPClient_Close(DriverIO);
+            return RETERROR_DISCONNECT;
+        }
+
+        if(ReadBuff==&Data[Byte2Ret])
+        {
+            Byte2Ret+=BodyBytes;
+        }
+        else if(HTTPClient_BodyNeedsDecode(HTTPState))
+        {
+            HTTPClient_DecodeInput(HTTPState,BodyBytes);
+        }
+        else
+        {
+            /* We asked for compression / events but didn't get it */
+            memcpy(&Data[Byte2Ret],ReadBuff,BodyBytes);
+            Byte2Ret+=BodyBytes;
         }
     }
 
@@ -384,7 +747,11 @@ int HTTPClient_Read(t_DriverIOHandleType *DriverIO,uint8_t *Data,int MaxBytes)
  *    Bytes [I] -- The number of bytes to write.
  *
  * FUNCTION:
- *    This function writes (sends) data to the device.
+ *    This function writes (sends) data to the device.  For the WS driver
+ *    each write is sent as one WebSocket message.
+ *
+ *    If the socket hasn't taken all of the last write yet we return
+ *    RETERROR_BUSY (see HTTPClient_OS_Send()).
  *
  * RETURNS:
  *    The number of bytes written or:
@@ -394,51 +761,61 @@ int HTTPClient_Read(t_DriverIOHandleType *DriverIO,uint8_t *Data,int MaxBytes)
  *      RETERROR_BUSY -- The device is currently busy.  Try again later
  *
  * SEE ALSO:
- *    HTTPClient_Open(), HTTPClient_Read()
+ *    HTTPClient_Open(), HTTPClient_Read(), HTTPClient_SendBytes()
  ******************************************************************************/
 int HTTPClient_Write(t_DriverIOHandleType *DriverIO,const uint8_t *Data,int Bytes)
 {
     struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
-    int retVal;
-    int BytesSent;
-    const uint8_t *OutputPos;
+
+    if(OurData->TxWaiting)
+        return RETERROR_BUSY;
+
+    if(OurData->WebSocket)
+        return HTTPClient_WS_SendMessage(DriverIO,&OurData->WS,Data,Bytes);
+
+    return HTTPClient_SendBytes(DriverIO,Data,Bytes);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SendBytes
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_SendBytes(t_DriverIOHandleType *DriverIO,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection
+ *    Data [I] -- The data to send
+ *    Bytes [I] -- The number of bytes to send.
+ *
+ * FUNCTION:
+ *    This function sends bytes on the socket as is (the HTTP request,
+ *    WebSocket frames).  Anything the socket can't take right now is kept
+ *    and sent when it has room (see HTTPClient_OS_Send()), so a request or
+ *    frame never goes out part way.
+ *
+ * RETURNS:
+ *    'Bytes' (they were all sent or kept to send) or:
+ *      RETERROR_DISCONNECT -- This device is no longer open.
+ *      RETERROR_IOERROR -- There was an IO error.
+ *      RETERROR_BUSY -- We are still connecting.  Try again later
+ *
+ * SEE ALSO:
+ *    HTTPClient_Open(), HTTPClient_Read()
+ ******************************************************************************/
+int HTTPClient_SendBytes(t_DriverIOHandleType *DriverIO,const uint8_t *Data,
+        int Bytes)
+{
+    struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
+
+    if(OurData->Connecting!=NULL)
+        return RETERROR_BUSY;
 
     if(OurData->SockFD<0)
         return RETERROR_IOERROR;
 
-    BytesSent=0;
-    OutputPos=Data;
-    while(BytesSent<Bytes)
-    {
-        /* Interestingly write might only take SOME of the data, so we loop */
-        retVal=write(OurData->SockFD,OutputPos,Bytes-BytesSent);
-        if(retVal<0)
-        {
-            switch(errno)
-            {
-                case EAGAIN:
-                case ENOBUFS:
-                    return RETERROR_BUSY;
-                case EBADF:
-                case EBADFD:
-                case ECONNABORTED:
-                case ECONNREFUSED:
-                case ECONNRESET:
-                case EHOSTDOWN:
-                case EHOSTUNREACH:
-                case ENETDOWN:
-                case ENETRESET:
-                case ENETUNREACH:
-                    return RETERROR_DISCONNECT;
-                default:
-                    return RETERROR_IOERROR;
-            }
-        }
-        BytesSent+=retVal;
-        OutputPos+=retVal;
-    }
-
-    return BytesSent;
+    return HTTPClient_OS_Send(OurData,Data,Bytes);
 }
 
 /*******************************************************************************
@@ -469,55 +846,1014 @@ PG_BOOL HTTPClient_ChangeOptions(t_DriverIOHandleType *DriverIO,
     struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)DriverIO;
 
     /* If we are already open then we need to close and reopen */
-    if(OurData->SockFD>=0)
+    if(OurData->SockFD>=0 || OurData->WaitingToRetry ||
+            OurData->Connecting!=NULL)
+    {
         HTTPClient_Close(DriverIO);
+    }
 
     return HTTPClient_Open(DriverIO,Options);
 }
 
-static void *HTTPClient_OS_PollThread(void *arg)
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_SocketEvent
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_SocketEvent(
+ *          struct HTTPClient_ReactorWatch *Watch,uint32_t Events);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- The connection's reactor watch
+ *    Events [I] -- The epoll events
+ *
+ * FUNCTION:
+ *    This is called on the reactor thread when the socket has new data (or
+ *    was closed).  We read everything that's there into the ring (see
+ *    HTTPClient_OS_FillRxRing()) and tell the IO system.
+ *
+ *    If it has room to send we send anything that's waiting (see
+ *    HTTPClient_OS_SendPending()).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_SocketEvent(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events)
+{
+    struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)Watch;
+
+    if(Events&EPOLLOUT)
+        HTTPClient_OS_SendPending(OurData);
+
+    if(HTTPClient_OS_FillRxRing(OurData))
+        HTTPClient_OS_DataEvent(OurData);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_DataEvent
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_DataEvent(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection that has something for Read()
+ *
+ * FUNCTION:
+ *    This function tells the IO system there is something to read.  We only
+ *    send one data event until Read() has emptied the ring.  Anything that
+ *    comes in while we are waiting for Read() is noted so
+ *    HTTPClient_OS_Drained() can send the next event.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_DataEvent(struct HTTPClient_OurData *OurData)
 {
-    struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)arg;
-    fd_set rfds;
-    struct timeval tv;
-    int retval;
+    int State;
 
-    while(!OurData->RequestThreadQuit)
+    State=e_HCDataEvent_Idle;
+    if(OurData->DataEvent.compare_exchange_strong(State,e_HCDataEvent_Sent))
     {
-        if(!OurData->Opened)
-        {
-            usleep(100000);   // Wait 100ms
-            continue;
-        }
+        g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,
+                e_DataEventCode_BytesAvailable);
+        return;
+    }
 
-        FD_ZERO(&rfds);
-        FD_SET(OurData->SockFD,&rfds);
+    /* Already told them, just note there is more */
+    State=e_HCDataEvent_Sent;
+    OurData->DataEvent.compare_exchange_strong(State,
+            e_HCDataEvent_SentMoreArrived);
+}
 
-        /* 1ms timeout */
-        tv.tv_sec=0;
-        tv.tv_usec=100000;
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_Drained
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_Drained(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection that has been read out
+ *
+ * FUNCTION:
+ *    This function is called from Read() when it has read everything that
+ *    was waiting in the ring.  If more data came in while the IO system
+ *    was reading we send another data event right away, otherwise we wait
+ *    for the reactor to see new data.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_Drained(struct HTTPClient_OurData *OurData)
+{
+    int State;
 
-        retval=select(OurData->SockFD+1,&rfds,NULL,NULL,&tv);
-        if(retval==0)
-        {
-            /* Timeout */
-        }
-        else if(retval==-1)
-        {
-            /* Error */
-        }
-        else
-        {
-            /* Data available */
-            g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,
-                    e_DataEventCode_BytesAvailable);
+    State=e_HCDataEvent_Sent;
+    if(OurData->DataEvent.compare_exchange_strong(State,e_HCDataEvent_Idle))
+        return;
 
-            /* Give the main thead some time to read out all the bytes */
-            usleep(100000);   // Wait 100ms
-        }
+    State=e_HCDataEvent_SentMoreArrived;
+    if(OurData->DataEvent.compare_exchange_strong(State,e_HCDataEvent_Sent))
+    {
+        g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,
+                e_DataEventCode_BytesAvailable);
     }
+}
 
-    OurData->ThreadHasQuit=true;
-
-    return 0;
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_Send
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_OS_Send(struct HTTPClient_OurData *OurData,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection to send on
+ *    Data [I] -- The bytes to send
+ *    Bytes [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function sends bytes on the socket.  The socket is non blocking
+ *    and this is the one place that handles send() saying EAGAIN.  What
+ *    send() doesn't take (the socket is full) is added to 'TxPending' and
+ *    the reactor sends it when the socket has room (see
+ *    HTTPClient_OS_SendPending()).  If there are bytes waiting already we
+ *    add these after them so nothing goes out of order.
+ *
+ *    This is called from Read() / Write() and from the poll timer on the
+ *    reactor thread, so 'TxPending' is locked.
+ *
+ * RETURNS:
+ *    'Bytes' (they were all sent or kept to send) or:
+ *      RETERROR_DISCONNECT -- The connection has closed
+ *      RETERROR_IOERROR -- There was an IO error.
+ *
+ * SEE ALSO:
+ *    HTTPClient_SendBytes()
+ ******************************************************************************/
+static int HTTPClient_OS_Send(struct HTTPClient_OurData *OurData,
+        const uint8_t *Data,int Bytes)
+{
+    ssize_t Sent;
+    int Pos;
+    int RetValue;
+
+    RetValue=Bytes;
+    pthread_mutex_lock(&OurData->TxLock);
+    try
+    {
+        Pos=0;
+        while(Pos<Bytes && OurData->TxPending.empty())
+        {
+            /* MSG_NOSIGNAL so a closed connection is an error not a
+               SIGPIPE */
+            Sent=send(OurData->SockFD,&Data[Pos],Bytes-Pos,MSG_NOSIGNAL);
+            if(Sent<0)
+            {
+                if(errno==EINTR)
+                    continue;
+                if(errno==EAGAIN || errno==EWOULDBLOCK || errno==ENOBUFS)
+                    break;
+
+                switch(errno)
+                {
+                    case EBADF:
+                    case EBADFD:
+                    case ECONNABORTED:
+                    case ECONNREFUSED:
+                    case ECONNRESET:
+                    case EPIPE:
+                    case EHOSTDOWN:
+                    case EHOSTUNREACH:
+                    case ENETDOWN:
+                    case ENETRESET:
+                    case ENETUNREACH:
+                        RetValue=RETERROR_DISCONNECT;
+                    break;
+                    default:
+                        RetValue=RETERROR_IOERROR;
+                    break;
+                }
+                throw(0);
+            }
+            Pos+=Sent;
+        }
+
+        if(Pos<Bytes)
+        {
+            OurData->TxPending.append((const char *)&Data[Pos],Bytes-Pos);
+            OurData->TxWaiting=true;
+        }
+    }
+    catch(...)
+    {
+        if(RetValue>=0)
+            RetValue=RETERROR_IOERROR;
+    }
+    pthread_mutex_unlock(&OurData->TxLock);
+
+    return RetValue;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_SendPending
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_SendPending(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection that has room to send
+ *
+ * FUNCTION:
+ *    This function is called on the reactor thread when the socket has
+ *    room.  It sends what HTTPClient_OS_Send() couldn't.
+ *
+ *    If the send fails we shut the socket down so the reactor reads the
+ *    close and Read() handles it like any other (when polling it connects
+ *    again).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_SendPending(struct HTTPClient_OurData *OurData)
+{
+    ssize_t Sent;
+    size_t Pos;
+
+    pthread_mutex_lock(&OurData->TxLock);
+    Pos=0;
+    while(Pos<OurData->TxPending.length())
+    {
+        Sent=send(OurData->SockFD,OurData->TxPending.data()+Pos,
+                OurData->TxPending.length()-Pos,MSG_NOSIGNAL);
+        if(Sent<0)
+        {
+            if(errno==EINTR)
+                continue;
+            if(errno==EAGAIN || errno==EWOULDBLOCK || errno==ENOBUFS)
+                break;
+
+            /* We can't send the rest */
+            shutdown(OurData->SockFD,SHUT_RDWR);
+            Pos=OurData->TxPending.length();
+            break;
+        }
+        Pos+=Sent;
+    }
+    OurData->TxPending.erase(0,Pos);
+    OurData->TxWaiting=!OurData->TxPending.empty();
+    pthread_mutex_unlock(&OurData->TxLock);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_WatchSocket
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_WatchSocket(struct HTTPClient_OurData *OurData,
+ *          int fd);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection
+ *    fd [I] -- The socket we connected.  This is closed if we fail.
+ *
+ * FUNCTION:
+ *    This function makes 'fd' the connection's socket and starts watching
+ *    it.
+ *
+ * RETURNS:
+ *    true -- Things worked
+ *    false -- We couldn't watch the socket
+ ******************************************************************************/
+static bool HTTPClient_OS_WatchSocket(struct HTTPClient_OurData *OurData,
+        int fd)
+{
+    OurData->SockFD=fd;
+
+    /* Nothing is watching the socket yet so the ring is ours */
+    OurData->DataEvent=e_HCDataEvent_Idle;
+    OurData->RxHead=0;
+    OurData->RxTail=0;
+    OurData->RxStatus=0;
+    OurData->RxStalled=false;
+
+    /* Anything left over was for the last socket */
+    pthread_mutex_lock(&OurData->TxLock);
+    OurData->TxPending.clear();
+    OurData->TxWaiting=false;
+    pthread_mutex_unlock(&OurData->TxLock);
+
+    OurData->Watch.FD=OurData->SockFD;
+    if(!HTTPClient_Reactor_Add(&OurData->Watch,HTTPCLIENT_SOCKET_EVENTS))
+    {
+        close(OurData->SockFD);
+        OurData->SockFD=-1;
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_CloseSocket
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_CloseSocket(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection to close
+ *
+ * FUNCTION:
+ *    This function stops the poll and retry timers, any connect that's
+ *    still going, and closes the socket.  The IO system isn't told.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_WatchSocket()
+ ******************************************************************************/
+static void HTTPClient_OS_CloseSocket(struct HTTPClient_OurData *OurData)
+{
+    int fd;
+
+    if(OurData->Connecting!=NULL)
+    {
+        fd=HTTPClient_OS_ConnectEnd(OurData->Connecting);
+        if(fd>=0)
+            close(fd);
+        OurData->Connecting=NULL;
+        OurData->ConnectDone=false;
+    }
+
+    if(OurData->PollTimer.Watch.FD>=0)
+    {
+        HTTPClient_Reactor_Remove(&OurData->PollTimer.Watch);
+        close(OurData->PollTimer.Watch.FD);
+        OurData->PollTimer.Watch.FD=-1;
+    }
+
+    if(OurData->RetryTimer.Watch.FD>=0)
+    {
+        HTTPClient_Reactor_Remove(&OurData->RetryTimer.Watch);
+        close(OurData->RetryTimer.Watch.FD);
+        OurData->RetryTimer.Watch.FD=-1;
+    }
+    OurData->WaitingToRetry=false;
+    OurData->RetryDue=false;
+
+    if(OurData->SockFD>=0)
+    {
+        HTTPClient_Reactor_Remove(&OurData->Watch);
+        close(OurData->SockFD);
+    }
+    OurData->SockFD=-1;
+
+    pthread_mutex_lock(&OurData->TxLock);
+    OurData->TxPending.clear();
+    OurData->TxWaiting=false;
+    pthread_mutex_unlock(&OurData->TxLock);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_BeginConnect
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_BeginConnect(struct HTTPClient_OurData *OurData,
+ *          e_HCConnectForType For);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection.  It must not have a socket.
+ *    For [I] -- Why we are connecting (what to do when we have)
+ *
+ * FUNCTION:
+ *    This function starts connecting to 'OurData->Address' /
+ *    'OurData->Port' in the background (see HTTPClient_OS_ConnectStart()).
+ *    We send a data event when it's done and Read() picks it up (see
+ *    HTTPClient_OS_FinishConnect()).
+ *
+ * RETURNS:
+ *    true -- The connect has started
+ *    false -- We couldn't start it
+ ******************************************************************************/
+static bool HTTPClient_OS_BeginConnect(struct HTTPClient_OurData *OurData,
+        e_HCConnectForType For)
+{
+    /* The socket isn't being watched, so the data event we send when the
+       connect is done is the next one */
+    OurData->ConnectFor=For;
+    OurData->ConnectDone=false;
+    OurData->DataEvent=e_HCDataEvent_Idle;
+    OurData->Connecting=HTTPClient_OS_ConnectStart(OurData->Address.c_str(),
+            OurData->Port,OurData->ConnectTimeout,HTTPClient_OS_ConnectDone,
+            OurData);
+
+    return OurData->Connecting!=NULL;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ConnectDone
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_ConnectDone(void *UserData);
+ *
+ * PARAMETERS:
+ *    UserData [I] -- The connection ('struct HTTPClient_OurData')
+ *
+ * FUNCTION:
+ *    This is called on the reactor thread when a background connect is
+ *    done (worked or not).  We let Read() know so it can finish it (see
+ *    HTTPClient_OS_FinishConnect()).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_ConnectDone(void *UserData)
+{
+    struct HTTPClient_OurData *OurData=(struct HTTPClient_OurData *)UserData;
+
+    OurData->ConnectDone=true;
+    HTTPClient_OS_DataEvent(OurData);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_FinishConnect
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_FinishConnect(
+ *          struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection
+ *
+ * FUNCTION:
+ *    This function is called from Read() when a background connect is
+ *    done.  It starts watching the socket and then:
+ *      e_HCConnectFor_Open -- Sends the request that Open() built and
+ *                             tells the IO system we are connected.
+ *      e_HCConnectFor_Poll -- Puts the poll timer back (it sends the
+ *                             request on the next tick).
+ *      e_HCConnectFor_SSEResume -- Sends the resume request (with the last
+ *                             event ID) and stops waiting to retry.
+ *
+ * RETURNS:
+ *    true -- We are connected
+ *    false -- We couldn't connect (the caller should close)
+ ******************************************************************************/
+static bool HTTPClient_OS_FinishConnect(struct HTTPClient_OurData *OurData)
+{
+    const string *Request;
+    int fd;
+
+    fd=HTTPClient_OS_ConnectEnd(OurData->Connecting);
+    OurData->Connecting=NULL;
+    OurData->ConnectDone=false;
+    if(fd<0)
+        return false;
+
+    if(!HTTPClient_OS_WatchSocket(OurData,fd))
+        return false;
+
+    switch(OurData->ConnectFor)
+    {
+        case e_HCConnectFor_SSEResume:
+            OurData->WaitingToRetry=false;
+            Request=&OurData->HTTPState.Request;
+            if(HTTPClient_SendBytes((t_DriverIOHandleType *)OurData,
+                    (uint8_t *)Request->c_str(),Request->length())!=
+                    (int)Request->length())
+            {
+                return false;
+            }
+        break;
+        case e_HCConnectFor_Open:
+            Request=&OurData->HTTPState.Request;
+            if(HTTPClient_SendBytes((t_DriverIOHandleType *)OurData,
+                    (uint8_t *)Request->c_str(),Request->length())!=
+                    (int)Request->length())
+            {
+                return false;
+            }
+            g_HC_IOSystem->DrvDataEvent(OurData->IOHandle,
+                    e_DataEventCode_Connected);
+        break;
+        case e_HCConnectFor_Poll:
+            OurData->AwaitingResponse=false;
+            if(OurData->PollTimer.Watch.FD>=0 &&
+                    !HTTPClient_Reactor_Add(&OurData->PollTimer.Watch,EPOLLIN))
+            {
+                return false;
+            }
+        break;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_Reconnect
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_Reconnect(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection to reconnect
+ *
+ * FUNCTION:
+ *    This function is used when polling and the server closed the
+ *    connection.  It connects again without telling the IO system (to the
+ *    user it's still the same connection).
+ *
+ *    This is called from Read() so we don't wait for the connect (a dead
+ *    server would hang the UI for the connect timeout), it's done in the
+ *    background.  When it's done HTTPClient_OS_FinishConnect() puts the
+ *    poll timer back and the next tick sends the request on the new
+ *    socket.  The timer is off the reactor until then so it can't send on
+ *    a socket we don't have.
+ *
+ * RETURNS:
+ *    true -- We are connecting again
+ *    false -- We couldn't start (the caller should close)
+ ******************************************************************************/
+static bool HTTPClient_OS_Reconnect(struct HTTPClient_OurData *OurData)
+{
+    if(OurData->PollTimer.Watch.FD>=0)
+        HTTPClient_Reactor_Remove(&OurData->PollTimer.Watch);
+
+    if(OurData->SockFD>=0)
+    {
+        HTTPClient_Reactor_Remove(&OurData->Watch);
+        close(OurData->SockFD);
+        OurData->SockFD=-1;
+    }
+
+    OurData->AwaitingResponse=true;
+
+    return HTTPClient_OS_BeginConnect(OurData,e_HCConnectFor_Poll);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_PollTimerEvent
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_PollTimerEvent(
+ *          struct HTTPClient_ReactorWatch *Watch,uint32_t Events);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- The poll timer's reactor watch
+ *    Events [I] -- The epoll events
+ *
+ * FUNCTION:
+ *    This is called on the reactor thread every poll interval.  If the
+ *    last response is done we send the request again on the same
+ *    connection (the request was built once in Open(), see
+ *    HTTPClient_BuildHTTPRequest()).  If it isn't done we skip this tick.
+ *
+ *    If the socket can't take the whole request the rest is sent when it
+ *    has room (see HTTPClient_OS_Send()).  If the send fails we shut the
+ *    socket down so Read() sees it close and connects again, otherwise
+ *    we would wait for a response to a request that never went out.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_PollTimerEvent(struct HTTPClient_ReactorWatch *Watch,
+        uint32_t Events)
+{
+    struct HTTPClient_OurData *OurData=
+            ((struct HTTPClient_Timer *)Watch)->OurData;
+    const string *Request;
+    uint64_t Ticks;
+
+    if(read(Watch->FD,&Ticks,sizeof(Ticks))<0)
+    {
+        /* Nothing to clear */
+    }
+
+    if(OurData->AwaitingResponse)
+        return;
+
+    OurData->AwaitingResponse=true;
+    Request=&OurData->HTTPState.Request;
+    if(HTTPClient_OS_Send(OurData,(const uint8_t *)Request->c_str(),
+            Request->length())<0)
+    {
+        shutdown(OurData->SockFD,SHUT_RDWR);
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_SSEWait
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_SSEWait(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection
+ *
+ * FUNCTION:
+ *    This function is used when an event stream ends (or we couldn't
+ *    connect again).  It closes the socket without telling the IO system
+ *    (to the user it's still the same connection) and starts the retry
+ *    timer with the time the server asked for.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_SSEResume(), HTTPClient_OS_RetryTimerEvent()
+ ******************************************************************************/
+static void HTTPClient_OS_SSEWait(struct HTTPClient_OurData *OurData)
+{
+    struct itimerspec Wait;
+    unsigned int RetryMS;
+
+    if(OurData->SockFD>=0)
+    {
+        HTTPClient_Reactor_Remove(&OurData->Watch);
+        close(OurData->SockFD);
+        OurData->SockFD=-1;
+    }
+
+    /* A 0 time would turn the timer off */
+    RetryMS=HTTPClient_SSERetryTime(&OurData->HTTPState);
+    if(RetryMS==0)
+        RetryMS=1;
+
+    Wait.it_interval.tv_sec=0;
+    Wait.it_interval.tv_nsec=0;
+    Wait.it_value.tv_sec=RetryMS/1000;
+    Wait.it_value.tv_nsec=(RetryMS%1000)*1000000;
+
+    OurData->RetryDue=false;
+    OurData->WaitingToRetry=true;
+    if(timerfd_settime(OurData->RetryTimer.Watch.FD,0,&Wait,NULL)<0)
+    {
+        /* Without the timer we will never come back, try right away */
+        OurData->RetryDue=true;
+    }
+
+    /* The socket is gone, get ready for the timer's data event */
+    HTTPClient_OS_Drained(OurData);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_SSEResume
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_SSEResume(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection
+ *
+ * FUNCTION:
+ *    This function connects an event stream again (from Read(), after the
+ *    retry timer went off).  Like Open() the connect is done in the
+ *    background, when it's done HTTPClient_OS_FinishConnect() sends the
+ *    request with the last event ID we got.  We keep waiting to retry
+ *    until then.
+ *
+ * RETURNS:
+ *    true -- We are connecting
+ *    false -- It didn't work, the caller should wait and try again
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_SSEWait(), HTTPClient_SSEResumeRequest()
+ ******************************************************************************/
+static bool HTTPClient_OS_SSEResume(struct HTTPClient_OurData *OurData)
+{
+    if(!HTTPClient_SSEResumeRequest(&OurData->HTTPState))
+        return false;
+
+    return HTTPClient_OS_BeginConnect(OurData,e_HCConnectFor_SSEResume);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_RetryTimerEvent
+ *
+ * SYNOPSIS:
+ *    static void HTTPClient_OS_RetryTimerEvent(
+ *          struct HTTPClient_ReactorWatch *Watch,uint32_t Events);
+ *
+ * PARAMETERS:
+ *    Watch [I] -- The retry timer's reactor watch
+ *    Events [I] -- The epoll events
+ *
+ * FUNCTION:
+ *    This is called on the reactor thread when it's time to reconnect an
+ *    event stream.  Connecting can take a while so it isn't done here, we
+ *    send a data event and Read() does it.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void HTTPClient_OS_RetryTimerEvent(
+        struct HTTPClient_ReactorWatch *Watch,uint32_t Events)
+{
+    struct HTTPClient_OurData *OurData=
+            ((struct HTTPClient_Timer *)Watch)->OurData;
+    uint64_t Ticks;
+
+    if(read(Watch->FD,&Ticks,sizeof(Ticks))<0)
+    {
+        /* Nothing to clear */
+    }
+
+    OurData->RetryDue=true;
+    HTTPClient_OS_DataEvent(OurData);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_FillRxRing
+ *
+ * SYNOPSIS:
+ *    static bool HTTPClient_OS_FillRxRing(struct HTTPClient_OurData *OurData);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection to read
+ *
+ * FUNCTION:
+ *    This function is called on the reactor thread to read everything on
+ *    the socket into the receive ring.  It keeps going until the socket
+ *    says EAGAIN, so a big burst is taken in one event.  Each read fills
+ *    the free space in the ring, both sides of the wrap, with one
+ *    recvmsg().
+ *
+ *    When the socket closes (or has an error) 'RxStatus' is set.  Read()
+ *    returns it after the data in the ring.
+ *
+ *    If the ring fills up we stop and mark it stalled.  The socket still
+ *    has data but, being edge triggered, won't tell us again, so
+ *    HTTPClient_OS_ReadRxRing() rearms the watch when it makes room.
+ *
+ * RETURNS:
+ *    true -- We read something (or the socket closed), Read() should be
+ *            told
+ *    false -- Nothing new
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_ReadRxRing()
+ ******************************************************************************/
+static bool HTTPClient_OS_FillRxRing(struct HTTPClient_OurData *OurData)
+{
+    struct msghdr Msg;
+    struct iovec IOV[2];
+    uint32_t Head;
+    uint32_t Free;
+    uint32_t Pos;
+    ssize_t BytesRead;
+    bool GotSomething;
+
+    if(OurData->RxStatus!=0)
+        return false;
+
+    GotSomething=false;
+    Head=OurData->RxHead.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        Free=HTTPCLIENT_RX_RING_SIZE-(Head-OurData->RxTail.load());
+        if(Free==0)
+        {
+            /* Full, we'll be rearmed when Read() makes room.  Check again
+               after marking it in case Read() just did. */
+            OurData->RxStalled=true;
+            if(Head!=OurData->RxTail.load()+HTTPCLIENT_RX_RING_SIZE &&
+                    OurData->RxStalled.exchange(false))
+            {
+                continue;
+            }
+            break;
+        }
+
+        Pos=Head&(HTTPCLIENT_RX_RING_SIZE-1);
+        IOV[0].iov_base=&OurData->RxRing[Pos];
+        IOV[0].iov_len=HTTPCLIENT_RX_RING_SIZE-Pos;
+        if(IOV[0].iov_len>Free)
+            IOV[0].iov_len=Free;
+        IOV[1].iov_base=OurData->RxRing;
+        IOV[1].iov_len=Free-IOV[0].iov_len;
+
+        memset(&Msg,0x00,sizeof(Msg));
+        Msg.msg_iov=IOV;
+        Msg.msg_iovlen=IOV[1].iov_len>0?2:1;
+
+        BytesRead=recvmsg(OurData->SockFD,&Msg,0);
+        if(BytesRead<0)
+        {
+            if(errno==EINTR)
+                continue;
+            if(errno==EAGAIN || errno==EWOULDBLOCK)
+                break;
+            OurData->RxStatus=RETERROR_IOERROR;
+            return true;
+        }
+        if(BytesRead==0)
+        {
+            OurData->RxStatus=RETERROR_DISCONNECT;
+            return true;
+        }
+
+        Head+=BytesRead;
+        OurData->RxHead.store(Head,std::memory_order_release);
+        GotSomething=true;
+    }
+
+    return GotSomething;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_ReadRxRing
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_OS_ReadRxRing(struct HTTPClient_OurData *OurData,
+ *          uint8_t *Data,int MaxBytes);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection to read
+ *    Data [O] -- Where to copy the bytes to
+ *    MaxBytes [I] -- The max number of bytes to copy
+ *
+ * FUNCTION:
+ *    This function takes bytes out of the receive ring (filled by
+ *    HTTPClient_OS_FillRxRing() on the reactor thread).  If the reactor
+ *    stopped because the ring was full we rearm the socket so it reads
+ *    the rest.
+ *
+ * RETURNS:
+ *    The number of bytes copied or:
+ *      RETERROR_NOBYTES -- The ring is empty
+ *      RETERROR_DISCONNECT -- The ring is empty and the socket was closed
+ *      RETERROR_IOERROR -- The ring is empty and the socket had an error
+ *
+ * SEE ALSO:
+ *    HTTPClient_OS_FillRxRing()
+ ******************************************************************************/
+static int HTTPClient_OS_ReadRxRing(struct HTTPClient_OurData *OurData,
+        uint8_t *Data,int MaxBytes)
+{
+    uint32_t Head;
+    uint32_t Tail;
+    uint32_t Bytes;
+    uint32_t Pos;
+    uint32_t First;
+    int Status;
+
+    /* The status is set after the last data, so get it first */
+    Status=OurData->RxStatus.load(std::memory_order_acquire);
+    Head=OurData->RxHead.load(std::memory_order_acquire);
+    Tail=OurData->RxTail.load(std::memory_order_relaxed);
+
+    Bytes=Head-Tail;
+    if(Bytes==0)
+        return Status;
+    if(Bytes>(uint32_t)MaxBytes)
+        Bytes=MaxBytes;
+
+    Pos=Tail&(HTTPCLIENT_RX_RING_SIZE-1);
+    First=HTTPCLIENT_RX_RING_SIZE-Pos;
+    if(First>Bytes)
+        First=Bytes;
+    memcpy(Data,&OurData->RxRing[Pos],First);
+    memcpy(&Data[First],OurData->RxRing,Bytes-First);
+
+    OurData->RxTail.store(Tail+Bytes);
+
+    if(OurData->RxStalled.exchange(false))
+        HTTPClient_Reactor_Rearm(&OurData->Watch,HTTPCLIENT_SOCKET_EVENTS);
+
+    return Bytes;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_OS_WSRead
+ *
+ * SYNOPSIS:
+ *    static int HTTPClient_OS_WSRead(struct HTTPClient_OurData *OurData,
+ *          uint8_t *Data,int MaxBytes);
+ *
+ * PARAMETERS:
+ *    OurData [I] -- The connection
+ *    Data [I] -- A buffer to store the data that was read.
+ *    MaxBytes [I] -- The max number of bytes that can be stored in 'Data'
+ *
+ * FUNCTION:
+ *    This is Read() for the WS driver.  Until the upgrade is done the
+ *    response goes through the HTTP parser, after that everything is run
+ *    through the frame parser in place in 'Data' (see
+ *    HTTPClient_WS_ProcessFrames()).
+ *
+ *    Like the HTTP Read() we keep going until 'Data' is full or the ring
+ *    is empty.
+ *
+ * RETURNS:
+ *    The number of bytes that was read or one of the RETERROR_* values.
+ ******************************************************************************/
+static int HTTPClient_OS_WSRead(struct HTTPClient_OurData *OurData,
+        uint8_t *Data,int MaxBytes)
+{
+    t_DriverIOHandleType *DriverIO=(t_DriverIOHandleType *)OurData;
+    struct HTTPData *HTTPState;
+    int Space;
+    int Byte2Ret;
+    int BytesRead;
+    int Bytes;
+    bool Drained;
+
+    HTTPState=&OurData->HTTPState;
+    Byte2Ret=0;
+    Drained=false;
+    while(Byte2Ret<MaxBytes && !Drained)
+    {
+        Space=MaxBytes-Byte2Ret;
+        BytesRead=HTTPClient_OS_ReadRxRing(OurData,&Data[Byte2Ret],Space);
+        if(BytesRead==RETERROR_NOBYTES)
+        {
+            HTTPClient_OS_Drained(OurData);
+            break;
+        }
+        if(BytesRead==RETERROR_IOERROR)
+        {
+            HTTPClient_OS_Drained(OurData);
+            if(Byte2Ret>0)
+                break;
+            return RETERROR_IOERROR;
+        }
+        if(BytesRead==RETERROR_DISCONNECT)
+        {
+            HTTPClient_Close(DriverIO);
+            if(Byte2Ret>0)
+                return Byte2Ret;
+            return RETERROR_DISCONNECT;
+        }
+
+        /* Short read means the ring is empty */
+        if(BytesRead<Space)
+        {
+            HTTPClient_OS_Drained(OurData);
+            Drained=true;
+        }
+
+        Bytes=BytesRead;
+        if(!OurData->WS.Open)
+        {
+            /* Still in the HTTP upgrade */
+            Bytes=HTTPClient_ProcessHTTPResponse(DriverIO,HTTPState,
+                    &Data[Byte2Ret],BytesRead);
+            if(Bytes<0)
+            {
+                HTTPClient_Close(DriverIO);
+                return RETERROR_DISCONNECT;
+            }
+            if(HTTPClient_GotHeaders(HTTPState))
+            {
+                if(!HTTPClient_WebSocketUpgraded(HTTPState))
+                {
+                    /* The server said no */
+                    HTTPClient_Close(DriverIO);
+                    return RETERROR_DISCONNECT;
+                }
+                OurData->WS.Open=true;
+            }
+        }
+
+        if(OurData->WS.Open)
+        {
+            Bytes=HTTPClient_WS_ProcessFrames(DriverIO,&OurData->WS,
+                    &Data[Byte2Ret],Bytes);
+            if(Bytes<0)
+            {
+                /* Protocol error (1002) */
+                HTTPClient_WS_SendClose(DriverIO,&OurData->WS,1002);
+                HTTPClient_Close(DriverIO);
+                if(Byte2Ret>0)
+                    return Byte2Ret;
+                return RETERROR_DISCONNECT;
+            }
+            Byte2Ret+=Bytes;
+
+            if(OurData->WS.CloseReceived)
+            {
+                HTTPClient_Close(DriverIO);
+                break;
+            }
+        }
+    }
+
+    return Byte2Ret;
 }
@@ -94,6 +94,34 @@ t_DriverIOHandleType *HTTPClient_AllocateHandle(const char *DeviceUniqueID,
     return NULL;
 }
 
+/*******************************************************************************
+ * NAME:
+ *    WSClient_AllocateHandle
+ *
+ * SYNOPSIS:
+ *    t_DriverIOHandleType *WSClient_AllocateHandle(const char *DeviceUniqueID,
+ *          t_IOSystemHandle *IOHandle);
+ *
+ * PARAMETERS:
+ *    DeviceUniqueID [I] -- This is the unique ID for the device we are working
+ *                          on.
+ *    IOHandle [I] -- A handle to the IO system.
+ *
+ * FUNCTION:
+ *    This function allocates a connection for the WS driver.
+ *
+ * RETURNS:
+ *    Newly allocated data for this connection or NULL on error.
+ *
+ * SEE ALSO:
+ *    HTTPClient_AllocateHandle()
+ ******************************************************************************/
+t_DriverIOHandleType *WSClient_AllocateHandle(const char *DeviceUniqueID,
+        t_IOSystemHandle *IOHandle)
+{
+    return NULL;
+}
+
 /*******************************************************************************
  * NAME:
  *    HTTPClient_FreeHandle
@@ -227,6 +255,39 @@ int HTTPClient_Write(t_DriverIOHandleType *DriverIO,const uint8_t *Data,int Byte
     return RETERROR_IOERROR;
 }
 
+/*******************************************************************************
+ * NAME:
+ *    HTTPClient_SendBytes
+ *
+ * SYNOPSIS:
+ *    int HTTPClient_SendBytes(t_DriverIOHandleType *DriverIO,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *    DriverIO [I] -- The handle to this connection
+ *    Data [I] -- The data to send
+ *    Bytes [I] -- The number of bytes to send.
+ *
+ * FUNCTION:
+ *    This function sends bytes on the socket as is (the HTTP request,
+ *    WebSocket frames).
+ *
+ * RETURNS:
+ *    The number of bytes written or:
+ *      RETERROR_NOBYTES -- No bytes was written (0)
+ *      RETERROR_DISCONNECT -- This device is no longer open.
+ *      RETERROR_IOERROR -- There was an IO error.
+ *      RETERROR_BUSY -- The device is currently busy.  Try again later
+ *
+ * SEE ALSO:
+ *    HTTPClient_Write()
+ ******************************************************************************/
+int HTTPClient_SendBytes(t_DriverIOHandleType *DriverIO,const uint8_t *Data,
+        int Bytes)
+{
+    return RETERROR_IOERROR;
+}
+
 /*******************************************************************************
  * NAME:
  *    HTTPClient_ChangeOptions
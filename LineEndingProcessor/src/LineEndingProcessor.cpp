@@ -0,0 +1,853 @@
+/*******************************************************************************
+ * FILENAME: LineEndingProcessor.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the line ending processor in it.  It makes the line endings
+ *    in the incoming stream (LF, CR, CRLF, or LFCR) always move the cursor
+ *    to the start of a new line.  It can also work out which line ending
+ *    is being used by looking at the first few lines.
+ *
+ *    This replaces having to use the NewLineProcessor and
+ *    NewLineProcessor_CR (and stacking them, which doubles up "\r\n").
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "LineEndingProcessor.h"
+#include "PluginSDK/Plugin.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/*** DEFINES                  ***/
+#define REGISTER_PLUGIN_FUNCTION_PRIV_NAME      LineEndingProcessor // The name to append on the RegisterPlugin() function for built in version
+#define NEEDED_MIN_API_VERSION                  0x01000000
+#define LEP_DEFAULT_AUTO_LOCK_COUNT             8       // How many line endings auto detect looks at
+#define LEP_MAX_AUTO_LOCK_COUNT                 1000
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+typedef enum
+{
+    e_LEPMode_Auto=0,
+    e_LEPMode_LF,
+    e_LEPMode_CR,
+    e_LEPMode_CRLF,
+    e_LEPMode_LFCR,
+    e_LEPModeMAX
+} e_LEPModeType;
+
+/* The last line ending char we have seen (that we don't know the full
+   line ending for yet) */
+typedef enum
+{
+    e_LEPLast_None,
+    e_LEPLast_CR,
+    e_LEPLast_LF,
+} e_LEPLastType;
+
+struct LineEndingProcessorData
+{
+    e_LEPModeType Mode;             // The mode from the settings
+    e_LEPModeType ActiveMode;       // What we are doing (Auto until locked in)
+    bool FixLF;                     // Add a return on '\n'
+    bool FixCR;                     // Add a new line after a '\r'
+    e_LEPLastType Last;
+    bool CRDidNewLine;              // The pending '\r' already did a new line
+
+    /* Auto detect */
+    unsigned int AutoLockCount;
+    unsigned int SeenTotal;
+    unsigned int SeenCount[e_LEPModeMAX];
+};
+
+struct LineEndingProcessor_SettingsWidgets
+{
+    t_WidgetSysHandle *WidgetHandle;
+    struct PI_ComboBox *Mode;
+    struct PI_NumberInput *AutoLockCount;
+    struct PI_TextBox *HelpText;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+const struct DataProcessorInfo *LineEndingProcessor_GetProcessorInfo(
+        unsigned int *SizeOfInfo);
+void LineEndingProcessor_ProcessByte(t_DataProcessorHandleType *DataHandle,
+        const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,
+        PG_BOOL *Consumed);
+uint32_t LineEndingProcessor_ProcessBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
+static t_DataProSettingsWidgetsType *LineEndingProcessor_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
+static void LineEndingProcessor_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
+static void LineEndingProcessor_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings);
+static void LineEndingProcessor_ApplySettings(t_DataProcessorHandleType *DataHandle,
+        t_PIKVList *Settings);
+static t_DataProcessorHandleType *LineEndingProcessor_AllocateData(void);
+static void LineEndingProcessor_FreeData(t_DataProcessorHandleType *DataHandle);
+static void LineEndingProcessor_SetActiveMode(struct LineEndingProcessorData *Data,
+        e_LEPModeType Mode);
+static void LineEndingProcessor_SeenLineEnding(struct LineEndingProcessorData *Data,
+        e_LEPModeType Ending);
+static bool LineEndingProcessor_HandleChar(struct LineEndingProcessorData *Data,
+        uint8_t c);
+static uint32_t LineEndingProcessor_FindLineEndChar(const uint8_t *Start,
+        uint32_t Len);
+static void LineEndingProcessor_GetSettings(t_PIKVList *Settings,
+        e_LEPModeType *Mode,unsigned int *AutoLockCount);
+
+/*** VARIABLE DEFINITIONS     ***/
+struct DataProcessorAPI m_LineEndingProcessorCBs=
+{
+    LineEndingProcessor_AllocateData,
+    LineEndingProcessor_FreeData,
+    LineEndingProcessor_GetProcessorInfo,           // GetProcessorInfo
+    NULL,                                           // ProcessKeyPress
+    LineEndingProcessor_ProcessByte,                // ProcessIncomingTextByte
+    NULL,                                           // ProcessIncomingBinaryByte
+    /* V2 */
+    NULL,                                           // ProcessOutGoingData
+    LineEndingProcessor_AllocSettingsWidgets,
+    LineEndingProcessor_FreeSettingsWidgets,
+    LineEndingProcessor_SetSettingsFromWidgets,
+    LineEndingProcessor_ApplySettings,
+    /* V4 */
+    LineEndingProcessor_ProcessBlock,               // ProcessIncomingTextBlock
+};
+struct DataProcessorInfo m_LineEndingProcessor_Info=
+{
+    "Line Ending Processor",
+    "Starts a new line on LF, CR, CRLF, or LFCR",
+    "Makes the line endings in the incoming text always start a new line.  "
+    "The line ending (LF, CR, CRLF, or LFCR) can be picked in the settings "
+    "or auto detected from the first few lines.",
+    e_DataProcessorType_Text,
+    e_TextDataProcessorClass_Other
+};
+
+static const struct PI_SystemAPI *m_LEP_SysAPI;
+static const struct DPS_API *m_LEP_DPS;
+static const struct PI_UIAPI *m_LEP_UIAPI;
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_RegisterPlugin
+ *
+ * SYNOPSIS:
+ *    unsigned int LineEndingProcessor_RegisterPlugin(const struct PI_SystemAPI *SysAPI,
+ *          unsigned int Version);
+ *
+ * PARAMETERS:
+ *    SysAPI [I] -- The main API to WhippyTerm
+ *    Version [I] -- What version of WhippyTerm is running.  This is used
+ *                   to make sure we are compatible.  This is in the
+ *                   Major<<24 | Minor<<16 | Rev<<8 | Patch format
+ *
+ * FUNCTION:
+ *    This function registers this plugin with the system.
+ *
+ * RETURNS:
+ *    0 if we support this version of WhippyTerm, and the minimum version
+ *    we need if we are not.
+ *
+ * NOTES:
+ *    This function is normally is called from the RegisterPlugin() when
+ *    it is being used as a normal plugin.  As a std plugin it is called
+ *    from RegisterStdPlugins() instead.
+ *
+ * SEE ALSO:
+ *
+ ******************************************************************************/
+/* This needs to be extern "C" because it is the main entry point for the
+   plugin system */
+extern "C"
+{
+    unsigned int REGISTER_PLUGIN_FUNCTION(const struct PI_SystemAPI *SysAPI,
+            unsigned int Version)
+    {
+        if(Version<NEEDED_MIN_API_VERSION)
+            return NEEDED_MIN_API_VERSION;
+
+        m_LEP_SysAPI=SysAPI;
+        m_LEP_DPS=SysAPI->GetAPI_DataProcessors();
+        m_LEP_UIAPI=m_LEP_DPS->GetAPI_UI();
+
+        /* If we are have the correct experimental API */
+        if(SysAPI->GetExperimentalID()>0 &&
+                SysAPI->GetExperimentalID()<1)
+        {
+            return 0xFFFFFFFF;
+        }
+
+        m_LEP_DPS->RegisterDataProcessor("LineEndingProcessor",
+                &m_LineEndingProcessorCBs,sizeof(m_LineEndingProcessorCBs));
+
+        return 0;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    AllocateData
+ *
+ * SYNOPSIS:
+ *    t_DataProcessorHandleType *AllocateData(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function allocates any needed data for this data processor.
+ *
+ * NOTES:
+ *    You can not use most of the API 'DPS_API' because there is no connection
+ *    when AllocateData() is called.
+ *
+ * RETURNS:
+ *   A pointer to the data, NULL if there was an error.
+ ******************************************************************************/
+static t_DataProcessorHandleType *LineEndingProcessor_AllocateData(void)
+{
+    struct LineEndingProcessorData *Data;
+
+    Data=NULL;
+    try
+    {
+        Data=new struct LineEndingProcessorData;
+
+        Data->Mode=e_LEPMode_Auto;
+        Data->AutoLockCount=LEP_DEFAULT_AUTO_LOCK_COUNT;
+        LineEndingProcessor_SetActiveMode(Data,Data->Mode);
+    }
+    catch(...)
+    {
+        if(Data!=NULL)
+        {
+            delete Data;
+        }
+        return NULL;
+    }
+
+    return (t_DataProcessorHandleType *)Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    FreeData
+ *
+ * SYNOPSIS:
+ *    void FreeData(t_DataProcessorHandleType *DataHandle);
+ *
+ * PARAMETERS:
+ *    DataHandle [I] -- The data handle to free.  This will need to be
+ *                      case to your internal data type before you use it.
+ *
+ * FUNCTION:
+ *    This function frees the memory allocated with AllocateData().
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void LineEndingProcessor_FreeData(t_DataProcessorHandleType *DataHandle)
+{
+    struct LineEndingProcessorData *Data=(struct LineEndingProcessorData *)DataHandle;
+
+    delete Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_GetProcessorInfo
+ *
+ * SYNOPSIS:
+ *    const struct DataProcessorInfo *LineEndingProcessor_GetProcessorInfo(
+ *              unsigned int *SizeOfInfo);
+ *
+ * PARAMETERS:
+ *    SizeOfInfo [O] -- The size of 'struct DataProcessorInfo'.  This is used
+ *                        for forward / backward compatibility.
+ *
+ * FUNCTION:
+ *    This function gets info about the plugin.
+ *
+ * RETURNS:
+ *    The info about this plugin.
+ *
+ * SEE ALSO:
+ *
+ ******************************************************************************/
+const struct DataProcessorInfo *LineEndingProcessor_GetProcessorInfo(
+        unsigned int *SizeOfInfo)
+{
+    *SizeOfInfo=sizeof(struct DataProcessorInfo);
+    return &m_LineEndingProcessor_Info;
+}
+
+/*******************************************************************************
+ *  NAME:
+ *    LineEndingProcessor_ProcessByte
+ *
+ *  SYNOPSIS:
+ *    void LineEndingProcessor_ProcessByte(t_DataProcessorHandleType *DataHandle,
+ *          const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,
+ *          PG_BOOL *Consumed);
+ *
+ *  PARAMETERS:
+ *    DataHandle [I] -- The data handle to work on
+ *    RawByte [I] -- The raw byte to process.  This is the byte that came in.
+ *    ProcessedChar [I/O] -- This is a unicode char that has already been
+ *                         processed by some of the other input filters.
+ *    CharLen [I/O] -- This number of bytes in 'ProcessedChar'
+ *    Consumed [I/O] -- This tells the system (and other filters) if the
+ *                      char has been used up and will not be added to the
+ *                      screen.
+ *
+ *  FUNCTION:
+ *    This function is called for each byte that comes in (if the system
+ *    doesn't support ProcessIncomingTextBlock()).
+ *
+ *  RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    LineEndingProcessor_ProcessBlock()
+ ******************************************************************************/
+void LineEndingProcessor_ProcessByte(t_DataProcessorHandleType *DataHandle,
+        const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,
+        PG_BOOL *Consumed)
+{
+    struct LineEndingProcessorData *Data=(struct LineEndingProcessorData *)DataHandle;
+
+    if(!Data->FixLF && !Data->FixCR)
+        return;
+
+    if(LineEndingProcessor_HandleChar(Data,RawByte))
+        *Consumed=true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_ProcessBlock
+ *
+ * SYNOPSIS:
+ *    uint32_t LineEndingProcessor_ProcessBlock(
+ *          t_DataProcessorHandleType *DataHandle,const uint8_t *Data,
+ *          uint32_t Len,PG_BOOL *Consumed);
+ *
+ * PARAMETERS:
+ *    DataHandle [I] -- The data handle to work on
+ *    Data [I] -- The block of bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Consumed [I/O] -- This tells the system (and other filters) if the
+ *                      bytes have been used up (we only do this for the
+ *                      '\n' of a "\r\n" when the '\r' did the new line)
+ *
+ * FUNCTION:
+ *    This is the block version of LineEndingProcessor_ProcessByte().  The
+ *    first byte goes though the state machine and then everything up to
+ *    the next line ending char is passed in one go.
+ *
+ *    When the terminal handles the line ending on it's own (CRLF and LFCR)
+ *    the whole block is passed.
+ *
+ * RETURNS:
+ *    The number of bytes from the start of 'Data' we handled.
+ *
+ * SEE ALSO:
+ *    LineEndingProcessor_ProcessByte()
+ ******************************************************************************/
+uint32_t LineEndingProcessor_ProcessBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed)
+{
+    struct LineEndingProcessorData *LData=(struct LineEndingProcessorData *)DataHandle;
+
+    if(!LData->FixLF && !LData->FixCR)
+        return Len;
+
+    if(LineEndingProcessor_HandleChar(LData,Data[0]))
+        *Consumed=true;
+
+    /* The byte after a line ending char has to go though the state machine
+       as well */
+    if(Data[0]=='\r' || Data[0]=='\n' || Len==1)
+        return 1;
+
+    return 1+LineEndingProcessor_FindLineEndChar(&Data[1],Len-1);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    AllocSettingsWidgets
+ *
+ * SYNOPSIS:
+ *    t_DataProSettingsWidgetsType *AllocSettingsWidgets(
+ *              t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
+ *
+ * PARAMETERS:
+ *    WidgetHandle [I] -- The handle to add new widgets to
+ *    Settings [I] -- The current settings.  This is a standard key/value
+ *                    list.
+ *
+ * FUNCTION:
+ *    This function is called when the user presses the "Settings" button
+ *    to change any settings for this plugin (in the settings dialog).
+ *
+ * RETURNS:
+ *    The private settings data or NULL if there was an error.
+ *
+ * SEE ALSO:
+ *    FreeSettingsWidgets()
+ ******************************************************************************/
+t_DataProSettingsWidgetsType *LineEndingProcessor_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings)
+{
+    struct LineEndingProcessor_SettingsWidgets *WData;
+    e_LEPModeType Mode;
+    unsigned int AutoLockCount;
+
+    WData=NULL;
+    try
+    {
+        WData=new LineEndingProcessor_SettingsWidgets;
+
+        /* Zero everything */
+        WData->WidgetHandle=WidgetHandle;
+        WData->Mode=NULL;
+        WData->AutoLockCount=NULL;
+        WData->HelpText=NULL;
+
+        m_LEP_DPS->SetCurrentSettingsTabName("Line Ending");
+
+        WData->Mode=m_LEP_UIAPI->AddComboBox(WidgetHandle,false,
+                "Line Ending",NULL,NULL);
+        if(WData->Mode==NULL)
+            throw(0);
+        m_LEP_UIAPI->AddItem2ComboBox(WidgetHandle,WData->Mode->Ctrl,
+                "Auto detect",e_LEPMode_Auto);
+        m_LEP_UIAPI->AddItem2ComboBox(WidgetHandle,WData->Mode->Ctrl,
+                "LF (\\n)",e_LEPMode_LF);
+        m_LEP_UIAPI->AddItem2ComboBox(WidgetHandle,WData->Mode->Ctrl,
+                "CR (\\r)",e_LEPMode_CR);
+        m_LEP_UIAPI->AddItem2ComboBox(WidgetHandle,WData->Mode->Ctrl,
+                "CRLF (\\r\\n)",e_LEPMode_CRLF);
+        m_LEP_UIAPI->AddItem2ComboBox(WidgetHandle,WData->Mode->Ctrl,
+                "LFCR (\\n\\r)",e_LEPMode_LFCR);
+
+        WData->AutoLockCount=m_LEP_UIAPI->AddNumberInput(WidgetHandle,
+                "Auto detect line count",NULL,NULL);
+        if(WData->AutoLockCount==NULL)
+            throw(0);
+        m_LEP_UIAPI->SetNumberInputMinMax(WidgetHandle,
+                WData->AutoLockCount->Ctrl,1,LEP_MAX_AUTO_LOCK_COUNT);
+
+        WData->HelpText=m_LEP_UIAPI->AddTextBox(WidgetHandle,"Help",
+                "Line Ending is the end of line the other end sends:\n\n"
+                "LF -- A '\\n' ends a line (a return is added)\n"
+                "CR -- A '\\r' ends a line (a new line is added)\n"
+                "CRLF / LFCR -- Both are sent (nothing is added)\n"
+                "\n"
+                "Auto detect adds what is needed for any of them, and after\n"
+                "'Auto detect line count' line endings it locks in to the\n"
+                "one it saw the most.");
+        if(WData->HelpText==NULL)
+            throw(0);
+
+        /* Set widgets to stored settings */
+        LineEndingProcessor_GetSettings(Settings,&Mode,&AutoLockCount);
+
+        m_LEP_UIAPI->SetComboBoxSelectedEntry(WidgetHandle,WData->Mode->Ctrl,
+                Mode);
+        m_LEP_UIAPI->SetNumberInputValue(WidgetHandle,
+                WData->AutoLockCount->Ctrl,AutoLockCount);
+    }
+    catch(...)
+    {
+        if(WData!=NULL)
+        {
+            LineEndingProcessor_FreeSettingsWidgets(
+                    (t_DataProSettingsWidgetsType *)WData);
+        }
+        return NULL;
+    }
+
+    return (t_DataProSettingsWidgetsType *)WData;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    FreeSettingsWidgets
+ *
+ * SYNOPSIS:
+ *    void FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
+ *
+ * PARAMETERS:
+ *    PrivData [I] -- The private data to free
+ *
+ * FUNCTION:
+ *      This function is called when the system frees the settings widets.
+ *      It should free any private data you allocated in AllocSettingsWidgets().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    AllocSettingsWidgets()
+ ******************************************************************************/
+void LineEndingProcessor_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData)
+{
+    struct LineEndingProcessor_SettingsWidgets *WData=(struct LineEndingProcessor_SettingsWidgets *)PrivData;
+    t_WidgetSysHandle *WidgetHandle=WData->WidgetHandle;
+
+    /* Free everything in reverse order */
+    if(WData->HelpText!=NULL)
+        m_LEP_UIAPI->FreeTextBox(WidgetHandle,WData->HelpText);
+    if(WData->AutoLockCount!=NULL)
+        m_LEP_UIAPI->FreeNumberInput(WidgetHandle,WData->AutoLockCount);
+    if(WData->Mode!=NULL)
+        m_LEP_UIAPI->FreeComboBox(WidgetHandle,WData->Mode);
+
+    delete WData;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    SetSettingsFromWidgets
+ *
+ * SYNOPSIS:
+ *    void SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,
+ *              t_PIKVList *Settings);
+ *
+ * PARAMETERS:
+ *    PrivData [I] -- Your private data allocated in AllocSettingsWidgets()
+ *    Settings [O] -- This is where you store the settings.
+ *
+ * FUNCTION:
+ *    This function takes the widgets added with AllocSettingsWidgets() and
+ *    stores them is a key/value pair list in 'Settings'.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    AllocSettingsWidgets()
+ ******************************************************************************/
+void LineEndingProcessor_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings)
+{
+    struct LineEndingProcessor_SettingsWidgets *WData=(struct LineEndingProcessor_SettingsWidgets *)PrivData;
+    t_WidgetSysHandle *WidgetHandle=WData->WidgetHandle;
+    char buff[21];
+    unsigned int Value;
+
+    Value=m_LEP_UIAPI->GetComboBoxSelectedEntry(WidgetHandle,
+            WData->Mode->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_LEP_SysAPI->KVAddItem(Settings,"Mode",buff);
+
+    Value=m_LEP_UIAPI->GetNumberInputValue(WidgetHandle,
+            WData->AutoLockCount->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_LEP_SysAPI->KVAddItem(Settings,"AutoLockCount",buff);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ApplySettings
+ *
+ * SYNOPSIS:
+ *    void ApplySettings(t_DataProcessorHandleType *DataHandle,
+ *              t_PIKVList *Settings);
+ *
+ * PARAMETERS:
+ *    DataHandle [I] -- The data handle to work on.  This is your internal
+ *                      data.
+ *    Settings [I] -- This is where you get your settings from.
+ *
+ * FUNCTION:
+ *    This function takes the settings from 'Settings' and setups the
+ *    plugin to use them when new bytes come in or out.  Auto detect starts
+ *    over when the settings are applied.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *
+ ******************************************************************************/
+static void LineEndingProcessor_ApplySettings(t_DataProcessorHandleType *DataHandle,
+        t_PIKVList *Settings)
+{
+    struct LineEndingProcessorData *Data=(struct LineEndingProcessorData *)DataHandle;
+
+    LineEndingProcessor_GetSettings(Settings,&Data->Mode,&Data->AutoLockCount);
+    LineEndingProcessor_SetActiveMode(Data,Data->Mode);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_GetSettings
+ *
+ * SYNOPSIS:
+ *    static void LineEndingProcessor_GetSettings(t_PIKVList *Settings,
+ *          e_LEPModeType *Mode,unsigned int *AutoLockCount);
+ *
+ * PARAMETERS:
+ *    Settings [I] -- The settings to read
+ *    Mode [O] -- The line ending mode
+ *    AutoLockCount [O] -- The number of line endings auto detect looks at
+ *
+ * FUNCTION:
+ *    This function reads our settings (with defaults for anything missing
+ *    or out of range).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void LineEndingProcessor_GetSettings(t_PIKVList *Settings,
+        e_LEPModeType *Mode,unsigned int *AutoLockCount)
+{
+    const char *Str;
+    int Num;
+
+    Str=m_LEP_SysAPI->KVGetItem(Settings,"Mode");
+    Num=e_LEPMode_Auto;
+    if(Str!=NULL)
+        Num=strtol(Str,NULL,10);
+    if(Num<0 || Num>=e_LEPModeMAX)
+        Num=e_LEPMode_Auto;
+    *Mode=(e_LEPModeType)Num;
+
+    Str=m_LEP_SysAPI->KVGetItem(Settings,"AutoLockCount");
+    Num=LEP_DEFAULT_AUTO_LOCK_COUNT;
+    if(Str!=NULL)
+        Num=strtol(Str,NULL,10);
+    if(Num<1 || Num>LEP_MAX_AUTO_LOCK_COUNT)
+        Num=LEP_DEFAULT_AUTO_LOCK_COUNT;
+    *AutoLockCount=Num;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_SetActiveMode
+ *
+ * SYNOPSIS:
+ *    static void LineEndingProcessor_SetActiveMode(
+ *          struct LineEndingProcessorData *Data,e_LEPModeType Mode);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The data for this connection
+ *    Mode [I] -- The mode to switch to
+ *
+ * FUNCTION:
+ *    This function sets what we add for the line endings.  For auto we add
+ *    what is needed for all of them (and start counting again).
+ *
+ *    CRLF and LFCR don't need anything, the terminal already does a return
+ *    and a new line for them.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void LineEndingProcessor_SetActiveMode(struct LineEndingProcessorData *Data,
+        e_LEPModeType Mode)
+{
+    int r;
+
+    Data->ActiveMode=Mode;
+    Data->FixLF=(Mode==e_LEPMode_Auto || Mode==e_LEPMode_LF);
+    Data->FixCR=(Mode==e_LEPMode_Auto || Mode==e_LEPMode_CR);
+
+    if(Mode==e_LEPMode_Auto)
+    {
+        Data->Last=e_LEPLast_None;
+        Data->CRDidNewLine=false;
+        Data->SeenTotal=0;
+        for(r=0;r<e_LEPModeMAX;r++)
+            Data->SeenCount[r]=0;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_SeenLineEnding
+ *
+ * SYNOPSIS:
+ *    static void LineEndingProcessor_SeenLineEnding(
+ *          struct LineEndingProcessorData *Data,e_LEPModeType Ending);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The data for this connection
+ *    Ending [I] -- The line ending we just finished seeing
+ *
+ * FUNCTION:
+ *    This function counts the line endings for auto detect.  When we have
+ *    seen enough we lock in to the one we saw the most.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void LineEndingProcessor_SeenLineEnding(struct LineEndingProcessorData *Data,
+        e_LEPModeType Ending)
+{
+    int r;
+    e_LEPModeType Best;
+
+    if(Data->ActiveMode!=e_LEPMode_Auto)
+        return;
+
+    Data->SeenCount[Ending]++;
+    Data->SeenTotal++;
+    if(Data->SeenTotal<Data->AutoLockCount)
+        return;
+
+    Best=e_LEPMode_LF;
+    for(r=e_LEPMode_LF;r<e_LEPModeMAX;r++)
+        if(Data->SeenCount[r]>Data->SeenCount[Best])
+            Best=(e_LEPModeType)r;
+
+    LineEndingProcessor_SetActiveMode(Data,Best);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_HandleChar
+ *
+ * SYNOPSIS:
+ *    static bool LineEndingProcessor_HandleChar(
+ *          struct LineEndingProcessorData *Data,uint8_t c);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The data for this connection
+ *    c [I] -- The char that is about to be added to the screen
+ *
+ * FUNCTION:
+ *    This is the line ending state machine.  It is called before 'c' is
+ *    added to the screen.
+ *
+ *    A '\n' gets a return added (unless it's the end of a "\r\n", the '\r'
+ *    already did the return).
+ *
+ *    A '\r' does the new line right away (so a '\r' at the end of the data
+ *    doesn't have to wait for more bytes).  Every '\r' is it's own line
+ *    ending so "\r\r" is a blank line.  If a '\n' comes after a '\r' that
+ *    did a new line we eat the '\n'.  This is what stops "\r\n" from being
+ *    doubled up.
+ *
+ *    We still don't know what line ending a '\r' was until we see the next
+ *    char, so auto detect counts it then.
+ *
+ * RETURNS:
+ *    true -- 'c' should not be added to the screen (it's consumed)
+ *    false -- Add 'c' like normal
+ ******************************************************************************/
+static bool LineEndingProcessor_HandleChar(struct LineEndingProcessorData *Data,
+        uint8_t c)
+{
+    bool Consume;
+
+    Consume=false;
+    switch(c)
+    {
+        case '\n':
+            if(Data->Last==e_LEPLast_CR)
+            {
+                Consume=Data->CRDidNewLine;
+                LineEndingProcessor_SeenLineEnding(Data,e_LEPMode_CRLF);
+                Data->Last=e_LEPLast_None;
+                break;
+            }
+            if(Data->Last==e_LEPLast_LF)
+                LineEndingProcessor_SeenLineEnding(Data,e_LEPMode_LF);
+            if(Data->FixLF)
+                m_LEP_DPS->DoReturn();
+            Data->Last=e_LEPLast_LF;
+        break;
+        case '\r':
+            if(Data->Last==e_LEPLast_LF)
+            {
+                LineEndingProcessor_SeenLineEnding(Data,e_LEPMode_LFCR);
+                Data->Last=e_LEPLast_None;
+                break;
+            }
+            if(Data->Last==e_LEPLast_CR)
+                LineEndingProcessor_SeenLineEnding(Data,e_LEPMode_CR);
+            Data->CRDidNewLine=Data->FixCR;
+            if(Data->FixCR)
+                m_LEP_DPS->DoNewLine();
+            Data->Last=e_LEPLast_CR;
+        break;
+        default:
+            if(Data->Last==e_LEPLast_LF)
+            {
+                LineEndingProcessor_SeenLineEnding(Data,e_LEPMode_LF);
+            }
+            else if(Data->Last==e_LEPLast_CR)
+            {
+                LineEndingProcessor_SeenLineEnding(Data,e_LEPMode_CR);
+            }
+            Data->Last=e_LEPLast_None;
+        break;
+    }
+    return Consume;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LineEndingProcessor_FindLineEndChar
+ *
+ * SYNOPSIS:
+ *    static uint32_t LineEndingProcessor_FindLineEndChar(
+ *          const uint8_t *Start,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Start [I] -- The bytes to search
+ *    Len [I] -- The number of bytes in 'Start'
+ *
+ * FUNCTION:
+ *    This function finds the next char the state machine needs to see.
+ *    This uses memchr() (which the C lib vectorizes).  For '\r' we only
+ *    search up to the '\n' we found so we don't scan past it twice.
+ *
+ * RETURNS:
+ *    The offset of the next '\r' / '\n' or 'Len' if there isn't one.
+ ******************************************************************************/
+static uint32_t LineEndingProcessor_FindLineEndChar(const uint8_t *Start,
+        uint32_t Len)
+{
+    const uint8_t *Pos;
+    uint32_t End;
+
+    Pos=(const uint8_t *)memchr(Start,'\n',Len);
+    End=Len;
+    if(Pos!=NULL)
+        End=Pos-Start;
+
+    if(End>0)
+    {
+        Pos=(const uint8_t *)memchr(Start,'\r',End);
+        if(Pos!=NULL)
+            End=Pos-Start;
+    }
+
+    return End;
+}
@@ -48,6 +48,8 @@ const struct DataProcessorInfo *NewLineProcessor_GetProcessorInfo(
 void NewLineProcessor_ProcessByte(t_DataProcessorHandleType *DataHandle,
         const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,
         PG_BOOL *Consumed);
+uint32_t NewLineProcessor_ProcessBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
 
 /*** VARIABLE DEFINITIONS     ***/
 struct DataProcessorAPI m_NewLineProcessorCBs=
@@ -57,6 +59,16 @@ struct DataProcessorAPI m_NewLineProcessorCBs=
     NewLineProcessor_GetProcessorInfo,
     NULL,
     NewLineProcessor_ProcessByte,
+    NULL,
+    /* V2 */
+    NULL,
+    /* V3 */
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    /* V4 */
+    NewLineProcessor_ProcessBlock,
 };
 struct DataProcessorInfo m_NewLineProcessor_Info=
 {
@@ -222,3 +234,44 @@ void NewLineProcessor_ProcessByte(t_DataProcessorHandleType *DataHandle,
     if(RawByte=='\n')
         m_NLP_DPS->DoReturn();
 }
+
+/*******************************************************************************
+ * NAME:
+ *    NewLineProcessor_ProcessBlock
+ *
+ * SYNOPSIS:
+ *    uint32_t NewLineProcessor_ProcessBlock(t_DataProcessorHandleType *DataHandle,
+ *          const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
+ *
+ * PARAMETERS:
+ *    DataHandle [I] -- The data handle to work on (not used)
+ *    Data [I] -- The block of bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Consumed [I/O] -- This tells the system (and other filters) if the
+ *                      bytes have been used up (we never do)
+ *
+ * FUNCTION:
+ *    This is the block version of NewLineProcessor_ProcessByte().  Everything
+ *    up to the next new line is passed though in one go.  When the block
+ *    starts with a new line we do the cartridge return and just take that one char.
+ *
+ * RETURNS:
+ *    The number of bytes from the start of 'Data' we handled.
+ *
+ * SEE ALSO:
+ *    NewLineProcessor_ProcessByte()
+ ******************************************************************************/
+uint32_t NewLineProcessor_ProcessBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed)
+{
+    const uint8_t *Pos;
+
+    Pos=(const uint8_t *)memchr(Data,'\n',Len);
+    if(Pos==NULL)
+        return Len;
+    if(Pos!=Data)
+        return Pos-Data;
+
+    m_NLP_DPS->DoReturn();
+    return 1;
+}
@@ -42,12 +42,18 @@
 #define DATA_PROCESSORS_API_VERSION_1       1
 #define DATA_PROCESSORS_API_VERSION_2       2
 #define DATA_PROCESSORS_API_VERSION_3       3
+#define DATA_PROCESSORS_API_VERSION_4       4
 
 /* Versions of struct DPS_API */
 #define DPS_API_VERSION_1                   1
 #define DPS_API_VERSION_2                   2
 #define DPS_API_VERSION_3                   3
 
+/* The block calls at the end of struct DPS_API are not in a released
+   DPS_API_VERSION.  A host only has them if it's GetExperimentalID()
+   returns this, with any other ID they must not be looked at. */
+#define DPS_API_EXPERIMENTAL_BLOCK_CALLS    0x44505301  // "DPS" 1
+
 #define TXT_ATTRIB_UNDERLINE                0x0001
 #define TXT_ATTRIB_UNDERLINE_DOUBLE         0x0002
 #define TXT_ATTRIB_UNDERLINE_DOTTED         0x0004
@@ -175,6 +181,23 @@ struct DataProcessorAPI
     void (*SetSettingsFromWidgets)(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings);
     void (*ApplySettings)(t_DataProcessorHandleType *DataHandle,t_PIKVList *Settings);
     /********* End of DATA_PROCESSORS_API_VERSION_3 *********/
+    /********* Start of DATA_PROCESSORS_API_VERSION_4 *********/
+    /* ProcessIncomingTextBlock() is used in place of ProcessIncomingTextByte()
+       when it's not NULL.  It returns how many bytes from the start of 'Data'
+       it handled (1 to 'Len').  These bytes are added to the screen (or
+       dropped if '*Consumed' is set) and then it is called again with the
+       rest of the block.  Returning less than 'Len' splits the block, for
+       example returning the offset of a '\n' means you will be called again
+       with the '\n' at the start of the block.  The bytes can not be changed
+       (use ProcessIncomingTextByte() for that). */
+    uint32_t (*ProcessIncomingTextBlock)(t_DataProcessorHandleType *DataHandle,
+            const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
+    /* ProcessIncomingBinaryBlock() is used in place of
+       ProcessIncomingBinaryByte() when it's not NULL.  It is called with
+       each block of bytes as it comes in (in order, nothing is skipped). */
+    void (*ProcessIncomingBinaryBlock)(t_DataProcessorHandleType *DataHandle,
+            const uint8_t *Data,int Bytes);
+    /********* End of DATA_PROCESSORS_API_VERSION_4 *********/
 };
 
 /* !!!! You can only add to this.  Changing it will break the plugins !!!! */
@@ -226,12 +249,17 @@ struct DPS_API
     void (*RemoveAttribFromMark)(t_DataProMark *Mark,uint32_t Attrib,uint32_t Offset,uint32_t Len);
     void (*ApplyFGColor2Mark)(t_DataProMark *Mark,uint32_t FGColor,uint32_t Offset,uint32_t Len);
     void (*ApplyBGColor2Mark)(t_DataProMark *Mark,uint32_t BGColor,uint32_t Offset,uint32_t Len);
-    const char *(*GetMarkText)(t_DataProMark *Mark);
-    uint32_t (*GetMarkTextLen)(t_DataProMark *Mark);
+    void (*MoveMark)(t_DataProMark *Mark,int Amount);
+    const uint8_t *(*GetMarkString)(t_DataProMark *Mark,uint32_t *Size,uint32_t Offset,uint32_t Len);
     void (*FreezeStream)(void);
     void (*ClearFrozenStream)(void);
     void (*ReleaseFrozenStream)(void);
+    const uint8_t *(*GetFrozenString)(uint32_t *Size);
     /********* End of DPS_API_VERSION_2 *********/
+    /********* Start of DPS_API_EXPERIMENTAL_BLOCK_CALLS *********/
+    void (*InsertStyledString)(const uint8_t *Str,uint32_t Len,uint32_t FGColor,uint32_t BGColor,uint32_t ULineColor,uint32_t Attribs);
+    void (*BinaryAddHexBlock)(const uint8_t *Data,uint32_t Len);
+    /********* End of DPS_API_EXPERIMENTAL_BLOCK_CALLS *********/
 };
 
 /***  CLASS DEFINITIONS                ***/
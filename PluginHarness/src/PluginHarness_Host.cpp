@@ -0,0 +1,1129 @@
+/*******************************************************************************
+ * FILENAME: PluginHarness_Host.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file is a stand in for the WhippyTerm side of the plugin API.  It
+ *    has the PI_SystemAPI, DPS_API, IOS_API, and FTPS_API that a plugin
+ *    gets when it registers.
+ *
+ *    There isn't a real screen.  What the processors add is kept in a line
+ *    buffer (so marks and frozen streams work) and can be written to a
+ *    file.  Every call the plugin makes in to the host is counted.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "PluginHarness_Host.h"
+#include "PluginHarness_UI.h"
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+
+/*** DEFINES                  ***/
+#define PH_SCREEN_ROWS                          25
+#define PH_SCREEN_COLUMNS                       80
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+struct PH_KVList
+{
+    std::map<std::string,std::string> Items;
+};
+
+struct PH_Mark
+{
+    uint64_t Line;          // The line the mark is on
+    uint32_t Offset;        // Where in the line
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static const struct IOS_API *PH_GetAPI_IO(void);
+static const struct DPS_API *PH_GetAPI_DataProcessors(void);
+static const struct FTPS_API *PH_GetAPI_FileTransfersProtocol(void);
+static void PH_KVClear(t_PIKVList *Handle);
+static PG_BOOL PH_KVAddItem(t_PIKVList *Handle,const char *Key,const char *Value);
+static const char *PH_KVGetItem(const t_PIKVList *Handle,const char *Key);
+static uint32_t PH_GetExperimentalID(void);
+
+static PG_BOOL PH_RegisterDataProcessor(const char *ProID,const struct DataProcessorAPI *ProAPI,int SizeOfProAPI);
+static const struct PI_UIAPI *PH_GetAPI_UI(void);
+static void PH_WriteData(const uint8_t *Data,int Bytes);
+static uint32_t PH_GetSysColor(uint32_t SysColShade,uint32_t SysColor);
+static uint32_t PH_GetSysDefaultColor(uint32_t DefaultColor);
+static void PH_SetFGColor(uint32_t FGColor);
+static uint32_t PH_GetFGColor(void);
+static void PH_SetBGColor(uint32_t BGColor);
+static uint32_t PH_GetBGColor(void);
+static void PH_SetULineColor(uint32_t ULineColor);
+static uint32_t PH_GetULineColor(void);
+static void PH_SetAttribs(uint32_t Attribs);
+static uint32_t PH_GetAttribs(void);
+static void PH_SetTitle(const char *Title);
+static void PH_DoNewLine(void);
+static void PH_DoReturn(void);
+static void PH_DoBackspace(void);
+static void PH_DoClearScreen(void);
+static void PH_DoClearArea(uint32_t X1,uint32_t Y1,uint32_t X2,uint32_t Y2);
+static void PH_DoTab(void);
+static void PH_DoPrevTab(void);
+static void PH_DoSystemBell(int VisualOnly);
+static void PH_DoScrollArea(uint32_t X1,uint32_t Y1,uint32_t X2,uint32_t Y2,int32_t DeltaX,int32_t DeltaY);
+static void PH_DoClearScreenAndBackBuffer(void);
+static void PH_GetCursorXY(int32_t *RetCursorX,int32_t *RetCursorY);
+static void PH_SetCursorXY(uint32_t X,uint32_t Y);
+static void PH_GetScreenSize(int32_t *RetRows,int32_t *RetColumns);
+static void PH_NoteNonPrintable(const char *CodeStr);
+static void PH_SendBackspace(void);
+static void PH_SendEnter(void);
+static void PH_BinaryAddText(const char *Str);
+static void PH_BinaryAddHex(uint8_t Byte);
+static void PH_InsertString(uint8_t *Str,uint32_t Len);
+static void PH_SetCurrentSettingsTabName(const char *Name);
+static t_WidgetSysHandle *PH_AddNewSettingsTab(const char *Name);
+static t_DataProMark *PH_AllocateMark(void);
+static void PH_FreeMark(t_DataProMark *Mark);
+static PG_BOOL PH_IsMarkValid(t_DataProMark *Mark);
+static void PH_SetMark2CursorPos(t_DataProMark *Mark);
+static void PH_ApplyAttrib2Mark(t_DataProMark *Mark,uint32_t Attrib,uint32_t Offset,uint32_t Len);
+static void PH_RemoveAttribFromMark(t_DataProMark *Mark,uint32_t Attrib,uint32_t Offset,uint32_t Len);
+static void PH_ApplyFGColor2Mark(t_DataProMark *Mark,uint32_t FGColor,uint32_t Offset,uint32_t Len);
+static void PH_ApplyBGColor2Mark(t_DataProMark *Mark,uint32_t BGColor,uint32_t Offset,uint32_t Len);
+static void PH_MoveMark(t_DataProMark *Mark,int Amount);
+static const uint8_t *PH_GetMarkString(t_DataProMark *Mark,uint32_t *Size,uint32_t Offset,uint32_t Len);
+static void PH_FreezeStream(void);
+static void PH_ClearFrozenStream(void);
+static void PH_ReleaseFrozenStream(void);
+static const uint8_t *PH_GetFrozenString(uint32_t *Size);
+static void PH_InsertStyledString(const uint8_t *Str,uint32_t Len,uint32_t FGColor,uint32_t BGColor,uint32_t ULineColor,uint32_t Attribs);
+static void PH_BinaryAddHexBlock(const uint8_t *Data,uint32_t Len);
+
+static PG_BOOL PH_RegisterDriver(const char *DriverName,const char *BaseURI,const struct IODriverAPI *DriverAPI,int SizeOfDriverAPI);
+static void PH_DrvDataEvent(t_IOSystemHandle *IOHandle,int Code);
+
+static PG_BOOL PH_RegisterFileTransferProtocol(const struct FTPHandlerInfo *Info);
+static void PH_SetTimeout(t_FTPSystemData *SysHandle,uint32_t MSec);
+static void PH_RestartTimeout(t_FTPSystemData *SysHandle);
+static void PH_ULProgress(t_FTPSystemData *SysHandle,uint64_t BytesTransfered);
+static void PH_ULFinish(t_FTPSystemData *SysHandle,PG_BOOL Aborted);
+static int PH_ULSendData(t_FTPSystemData *SysHandle,void *Data,uint32_t Bytes);
+static void PH_DLProgress(t_FTPSystemData *SysHandle,uint64_t BytesTransfered);
+static void PH_DLFinish(t_FTPSystemData *SysHandle,PG_BOOL Aborted);
+static int PH_DLSendData(t_FTPSystemData *SysHandle,void *Data,uint32_t Bytes);
+static const char *PH_GetDownloadFilename(t_FTPSystemData *SysHandle,const char *FileNameHint);
+
+static void PluginHarness_StartNewLine(void);
+
+/*** VARIABLE DEFINITIONS     ***/
+struct PH_RegisteredProcessor g_PH_Processors[PH_MAX_REGISTERED];
+unsigned int g_PH_ProcessorCount;
+struct PH_RegisteredDriver g_PH_Drivers[PH_MAX_REGISTERED];
+unsigned int g_PH_DriverCount;
+
+static const struct PI_SystemAPI m_PH_SystemAPI=
+{
+    PH_GetAPI_IO,
+    PH_GetAPI_DataProcessors,
+    PH_GetAPI_FileTransfersProtocol,
+    PH_KVClear,
+    PH_KVAddItem,
+    PH_KVGetItem,
+    PH_GetExperimentalID,
+};
+
+static const struct DPS_API m_PH_DPSAPI=
+{
+    PH_RegisterDataProcessor,
+    PH_GetAPI_UI,
+    PH_WriteData,
+    PH_GetSysColor,
+    PH_GetSysDefaultColor,
+    PH_SetFGColor,
+    PH_GetFGColor,
+    PH_SetBGColor,
+    PH_GetBGColor,
+    PH_SetULineColor,
+    PH_GetULineColor,
+    PH_SetAttribs,
+    PH_GetAttribs,
+    PH_SetTitle,
+    PH_DoNewLine,
+    PH_DoReturn,
+    PH_DoBackspace,
+    PH_DoClearScreen,
+    PH_DoClearArea,
+    PH_DoTab,
+    PH_DoPrevTab,
+    PH_DoSystemBell,
+    PH_DoScrollArea,
+    PH_DoClearScreenAndBackBuffer,
+    PH_GetCursorXY,
+    PH_SetCursorXY,
+    PH_GetScreenSize,
+    PH_NoteNonPrintable,
+    PH_SendBackspace,
+    PH_SendEnter,
+    PH_BinaryAddText,
+    PH_BinaryAddHex,
+    PH_InsertString,
+    /* V2 */
+    PH_SetCurrentSettingsTabName,
+    PH_AddNewSettingsTab,
+    PH_AllocateMark,
+    PH_FreeMark,
+    PH_IsMarkValid,
+    PH_SetMark2CursorPos,
+    PH_ApplyAttrib2Mark,
+    PH_RemoveAttribFromMark,
+    PH_ApplyFGColor2Mark,
+    PH_ApplyBGColor2Mark,
+    PH_MoveMark,
+    PH_GetMarkString,
+    PH_FreezeStream,
+    PH_ClearFrozenStream,
+    PH_ReleaseFrozenStream,
+    PH_GetFrozenString,
+    /* DPS_API_EXPERIMENTAL_BLOCK_CALLS */
+    PH_InsertStyledString,
+    PH_BinaryAddHexBlock,
+};
+
+static const struct IOS_API m_PH_IOSAPI=
+{
+    PH_RegisterDriver,
+    PH_GetAPI_UI,
+    PH_DrvDataEvent,
+};
+
+static const struct FTPS_API m_PH_FTPSAPI=
+{
+    PH_RegisterFileTransferProtocol,
+    PH_GetAPI_UI,
+    PH_SetTimeout,
+    PH_RestartTimeout,
+    PH_ULProgress,
+    PH_ULFinish,
+    PH_ULSendData,
+    PH_DLProgress,
+    PH_DLFinish,
+    PH_DLSendData,
+    PH_GetDownloadFilename,
+};
+
+static const char *m_PH_CallNames[e_PHCallMAX]=
+{
+    "KVClear",
+    "KVAddItem",
+    "KVGetItem",
+    "WriteData",
+    "GetSysColor",
+    "GetSysDefaultColor",
+    "SetFGColor",
+    "GetFGColor",
+    "SetBGColor",
+    "GetBGColor",
+    "SetULineColor",
+    "GetULineColor",
+    "SetAttribs",
+    "GetAttribs",
+    "SetTitle",
+    "DoNewLine",
+    "DoReturn",
+    "DoBackspace",
+    "DoClearScreen",
+    "DoClearArea",
+    "DoTab",
+    "DoPrevTab",
+    "DoSystemBell",
+    "DoScrollArea",
+    "DoClearScreenAndBackBuffer",
+    "GetCursorXY",
+    "SetCursorXY",
+    "GetScreenSize",
+    "NoteNonPrintable",
+    "SendBackspace",
+    "SendEnter",
+    "BinaryAddText",
+    "BinaryAddHex",
+    "InsertString",
+    "SetCurrentSettingsTabName",
+    "AddNewSettingsTab",
+    "AllocateMark",
+    "FreeMark",
+    "IsMarkValid",
+    "SetMark2CursorPos",
+    "ApplyAttrib2Mark",
+    "RemoveAttribFromMark",
+    "ApplyFGColor2Mark",
+    "ApplyBGColor2Mark",
+    "MoveMark",
+    "GetMarkString",
+    "FreezeStream",
+    "ClearFrozenStream",
+    "ReleaseFrozenStream",
+    "GetFrozenString",
+    "InsertStyledString",
+    "BinaryAddHexBlock",
+    "DrvDataEvent",
+    "FTPS (all)",
+    "UI (all)",
+};
+
+/* Driver threads can call in to us so the counters are atomic */
+static std::atomic<uint64_t> m_PH_CallCounts[e_PHCallMAX];
+
+/* The "screen" */
+static std::string m_PH_Line;           // The line the cursor is on
+static uint64_t m_PH_LineNumber;
+static bool m_PH_Frozen;
+static std::string m_PH_FrozenBuff;
+static FILE *m_PH_ScreenOut;            // Where to record the screen (NULL = don't)
+static uint32_t m_PH_FGColor;
+static uint32_t m_PH_BGColor;
+static uint32_t m_PH_ULineColor;
+static uint32_t m_PH_Attribs;
+
+/* What GetExperimentalID() returns */
+static uint32_t m_PH_ExperimentalID;
+
+/* IO driver events */
+static std::mutex m_PH_EventMutex;
+static std::condition_variable m_PH_EventCond;
+static unsigned int m_PH_PendingEvents;
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_GetSystemAPI
+ *
+ * SYNOPSIS:
+ *    const struct PI_SystemAPI *PluginHarness_GetSystemAPI(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function gets the system API to hand to the plugin's
+ *    RegisterPlugin().
+ *
+ * RETURNS:
+ *    A pointer to the system API.
+ ******************************************************************************/
+const struct PI_SystemAPI *PluginHarness_GetSystemAPI(void)
+{
+    return &m_PH_SystemAPI;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_SetExperimentalID
+ *
+ * SYNOPSIS:
+ *    void PluginHarness_SetExperimentalID(uint32_t ID);
+ *
+ * PARAMETERS:
+ *    ID [I] -- The ID for GetExperimentalID() to return
+ *
+ * FUNCTION:
+ *    This function sets the experimental API we claim to have.  With
+ *    DPS_API_EXPERIMENTAL_BLOCK_CALLS the plugins can use the block calls
+ *    at the end of the DPS struct, with 0 we look like a released
+ *    WhippyTerm.  This must be set before the plugin is registered.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void PluginHarness_SetExperimentalID(uint32_t ID)
+{
+    m_PH_ExperimentalID=ID;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_AllocKVList
+ *
+ * SYNOPSIS:
+ *    t_PIKVList *PluginHarness_AllocKVList(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function allocates an empty key/value list (like the settings or
+ *    connection options).
+ *
+ * RETURNS:
+ *    The new list.  Free with PluginHarness_FreeKVList().
+ ******************************************************************************/
+t_PIKVList *PluginHarness_AllocKVList(void)
+{
+    return (t_PIKVList *)new struct PH_KVList;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_FreeKVList
+ *
+ * SYNOPSIS:
+ *    void PluginHarness_FreeKVList(t_PIKVList *List);
+ *
+ * PARAMETERS:
+ *    List [I] -- The list to free
+ *
+ * FUNCTION:
+ *    This function frees a list allocated with PluginHarness_AllocKVList().
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void PluginHarness_FreeKVList(t_PIKVList *List)
+{
+    delete (struct PH_KVList *)List;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_RecordScreen
+ *
+ * SYNOPSIS:
+ *    void PluginHarness_RecordScreen(FILE *Out);
+ *
+ * PARAMETERS:
+ *    Out [I] -- The file to write what is added to the screen to.  NULL to
+ *               stop recording.
+ *
+ * FUNCTION:
+ *    This function sets where the screen output goes.  The text is written
+ *    as is, BinaryAddHex() bytes are written as "XX ", DoNewLine() is
+ *    written as "\n" and DoReturn() as "\r".
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void PluginHarness_RecordScreen(FILE *Out)
+{
+    m_PH_ScreenOut=Out;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_AddToScreen
+ *
+ * SYNOPSIS:
+ *    void PluginHarness_AddToScreen(const uint8_t *Bytes,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Bytes [I] -- The bytes to add
+ *    Len [I] -- The number of bytes
+ *
+ * FUNCTION:
+ *    This function adds bytes to the screen (or the frozen stream if it's
+ *    frozen).  This is also what the harness uses for the chars a text
+ *    processor didn't consume.  A '\n' starts a new line.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void PluginHarness_AddToScreen(const uint8_t *Bytes,uint32_t Len)
+{
+    const uint8_t *NewLine;
+    uint32_t Part;
+
+    if(m_PH_Frozen)
+    {
+        m_PH_FrozenBuff.append((const char *)Bytes,Len);
+        return;
+    }
+
+    if(m_PH_ScreenOut!=NULL)
+        fwrite(Bytes,1,Len,m_PH_ScreenOut);
+
+    while(Len>0)
+    {
+        NewLine=(const uint8_t *)memchr(Bytes,'\n',Len);
+        if(NewLine==NULL)
+        {
+            m_PH_Line.append((const char *)Bytes,Len);
+            break;
+        }
+        Part=NewLine-Bytes;
+        m_PH_Line.append((const char *)Bytes,Part);
+        PluginHarness_StartNewLine();
+        Bytes+=Part+1;
+        Len-=Part+1;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_GetCallCount
+ *
+ * SYNOPSIS:
+ *    uint64_t PluginHarness_GetCallCount(e_PHCallType Call);
+ *
+ * PARAMETERS:
+ *    Call [I] -- The host function to get the count for
+ *
+ * FUNCTION:
+ *    This function gets how many times the plugin has called a host
+ *    function (since the last PluginHarness_ResetCallCounts()).
+ *
+ * RETURNS:
+ *    The number of calls.
+ ******************************************************************************/
+uint64_t PluginHarness_GetCallCount(e_PHCallType Call)
+{
+    return m_PH_CallCounts[Call].load(std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_GetCallName
+ *
+ * SYNOPSIS:
+ *    const char *PluginHarness_GetCallName(e_PHCallType Call);
+ *
+ * PARAMETERS:
+ *    Call [I] -- The host function to get the name of
+ *
+ * FUNCTION:
+ *    This function gets the name of a host function for the report.
+ *
+ * RETURNS:
+ *    The name.
+ ******************************************************************************/
+const char *PluginHarness_GetCallName(e_PHCallType Call)
+{
+    return m_PH_CallNames[Call];
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_ResetCallCounts
+ *
+ * SYNOPSIS:
+ *    void PluginHarness_ResetCallCounts(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function zeros all the host call counters.  This is done after
+ *    setup so the report only has the calls made while the data went by.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void PluginHarness_ResetCallCounts(void)
+{
+    unsigned int r;
+
+    for(r=0;r<e_PHCallMAX;r++)
+        m_PH_CallCounts[r].store(0,std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_WaitForDataEvent
+ *
+ * SYNOPSIS:
+ *    bool PluginHarness_WaitForDataEvent(unsigned int TimeoutMS);
+ *
+ * PARAMETERS:
+ *    TimeoutMS [I] -- How long to wait
+ *
+ * FUNCTION:
+ *    This function waits for an IO driver to call DrvDataEvent().
+ *
+ * RETURNS:
+ *    true -- There was an event
+ *    false -- We timed out
+ ******************************************************************************/
+bool PluginHarness_WaitForDataEvent(unsigned int TimeoutMS)
+{
+    std::unique_lock<std::mutex> Lock(m_PH_EventMutex);
+
+    if(!m_PH_EventCond.wait_for(Lock,std::chrono::milliseconds(TimeoutMS),
+            []{return m_PH_PendingEvents>0;}))
+    {
+        return false;
+    }
+    m_PH_PendingEvents=0;
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_CountCall
+ *
+ * SYNOPSIS:
+ *    void PluginHarness_CountCall(e_PHCallType Call);
+ *
+ * PARAMETERS:
+ *    Call [I] -- The host function that was called
+ *
+ * FUNCTION:
+ *    This function counts a call from the plugin.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void PluginHarness_CountCall(e_PHCallType Call)
+{
+    m_PH_CallCounts[Call].fetch_add(1,std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_StartNewLine
+ *
+ * SYNOPSIS:
+ *    static void PluginHarness_StartNewLine(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function moves the cursor to a new (empty) line.  Any marks on
+ *    the old line are no longer valid.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void PluginHarness_StartNewLine(void)
+{
+    m_PH_Line.clear();
+    m_PH_LineNumber++;
+}
+
+/* PI_SystemAPI */
+static const struct IOS_API *PH_GetAPI_IO(void)
+{
+    return &m_PH_IOSAPI;
+}
+
+static const struct DPS_API *PH_GetAPI_DataProcessors(void)
+{
+    return &m_PH_DPSAPI;
+}
+
+static const struct FTPS_API *PH_GetAPI_FileTransfersProtocol(void)
+{
+    return &m_PH_FTPSAPI;
+}
+
+static void PH_KVClear(t_PIKVList *Handle)
+{
+    PluginHarness_CountCall(e_PHCall_KVClear);
+    ((struct PH_KVList *)Handle)->Items.clear();
+}
+
+static PG_BOOL PH_KVAddItem(t_PIKVList *Handle,const char *Key,const char *Value)
+{
+    PluginHarness_CountCall(e_PHCall_KVAddItem);
+    ((struct PH_KVList *)Handle)->Items[Key]=Value;
+    return true;
+}
+
+static const char *PH_KVGetItem(const t_PIKVList *Handle,const char *Key)
+{
+    const struct PH_KVList *List=(const struct PH_KVList *)Handle;
+    std::map<std::string,std::string>::const_iterator i;
+
+    PluginHarness_CountCall(e_PHCall_KVGetItem);
+    i=List->Items.find(Key);
+    if(i==List->Items.end())
+        return NULL;
+    return i->second.c_str();
+}
+
+static uint32_t PH_GetExperimentalID(void)
+{
+    return m_PH_ExperimentalID;
+}
+
+/* DPS_API */
+static PG_BOOL PH_RegisterDataProcessor(const char *ProID,
+        const struct DataProcessorAPI *ProAPI,int SizeOfProAPI)
+{
+    struct PH_RegisteredProcessor *Pro;
+
+    if(g_PH_ProcessorCount>=PH_MAX_REGISTERED)
+        return false;
+
+    /* Only copy what the plugin knows about, the rest stays NULL */
+    Pro=&g_PH_Processors[g_PH_ProcessorCount++];
+    Pro->ProID=ProID;
+    memset(&Pro->API,0,sizeof(Pro->API));
+    if(SizeOfProAPI>(int)sizeof(Pro->API))
+        SizeOfProAPI=sizeof(Pro->API);
+    memcpy(&Pro->API,ProAPI,SizeOfProAPI);
+
+    return true;
+}
+
+static const struct PI_UIAPI *PH_GetAPI_UI(void)
+{
+    return PluginHarness_GetUIAPI();
+}
+
+static void PH_WriteData(const uint8_t *Data,int Bytes)
+{
+    PluginHarness_CountCall(e_PHCall_WriteData);
+}
+
+static uint32_t PH_GetSysColor(uint32_t SysColShade,uint32_t SysColor)
+{
+    static const uint32_t Colors[e_SysColMAX]=
+    {
+        0x000000,0xCD0000,0x00CD00,0xCDCD00,0x0000EE,0xCD00CD,0x00CDCD,0xE5E5E5
+    };
+
+    PluginHarness_CountCall(e_PHCall_GetSysColor);
+    if(SysColor>=e_SysColMAX)
+        return 0;
+    return Colors[SysColor];
+}
+
+static uint32_t PH_GetSysDefaultColor(uint32_t DefaultColor)
+{
+    PluginHarness_CountCall(e_PHCall_GetSysDefaultColor);
+    return DefaultColor==e_DefaultColors_BG?0x000000:0xFFFFFF;
+}
+
+static void PH_SetFGColor(uint32_t FGColor)
+{
+    PluginHarness_CountCall(e_PHCall_SetFGColor);
+    m_PH_FGColor=FGColor;
+}
+
+static uint32_t PH_GetFGColor(void)
+{
+    PluginHarness_CountCall(e_PHCall_GetFGColor);
+    return m_PH_FGColor;
+}
+
+static void PH_SetBGColor(uint32_t BGColor)
+{
+    PluginHarness_CountCall(e_PHCall_SetBGColor);
+    m_PH_BGColor=BGColor;
+}
+
+static uint32_t PH_GetBGColor(void)
+{
+    PluginHarness_CountCall(e_PHCall_GetBGColor);
+    return m_PH_BGColor;
+}
+
+static void PH_SetULineColor(uint32_t ULineColor)
+{
+    PluginHarness_CountCall(e_PHCall_SetULineColor);
+    m_PH_ULineColor=ULineColor;
+}
+
+static uint32_t PH_GetULineColor(void)
+{
+    PluginHarness_CountCall(e_PHCall_GetULineColor);
+    return m_PH_ULineColor;
+}
+
+static void PH_SetAttribs(uint32_t Attribs)
+{
+    PluginHarness_CountCall(e_PHCall_SetAttribs);
+    m_PH_Attribs=Attribs;
+}
+
+static uint32_t PH_GetAttribs(void)
+{
+    PluginHarness_CountCall(e_PHCall_GetAttribs);
+    return m_PH_Attribs;
+}
+
+static void PH_SetTitle(const char *Title)
+{
+    PluginHarness_CountCall(e_PHCall_SetTitle);
+}
+
+static void PH_DoNewLine(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoNewLine);
+    if(m_PH_ScreenOut!=NULL)
+        fputc('\n',m_PH_ScreenOut);
+    PluginHarness_StartNewLine();
+}
+
+static void PH_DoReturn(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoReturn);
+    if(m_PH_ScreenOut!=NULL)
+        fputc('\r',m_PH_ScreenOut);
+}
+
+static void PH_DoBackspace(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoBackspace);
+    if(!m_PH_Line.empty())
+        m_PH_Line.erase(m_PH_Line.size()-1);
+}
+
+static void PH_DoClearScreen(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoClearScreen);
+}
+
+static void PH_DoClearArea(uint32_t X1,uint32_t Y1,uint32_t X2,uint32_t Y2)
+{
+    PluginHarness_CountCall(e_PHCall_DoClearArea);
+}
+
+static void PH_DoTab(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoTab);
+}
+
+static void PH_DoPrevTab(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoPrevTab);
+}
+
+static void PH_DoSystemBell(int VisualOnly)
+{
+    PluginHarness_CountCall(e_PHCall_DoSystemBell);
+}
+
+static void PH_DoScrollArea(uint32_t X1,uint32_t Y1,uint32_t X2,uint32_t Y2,
+        int32_t DeltaX,int32_t DeltaY)
+{
+    PluginHarness_CountCall(e_PHCall_DoScrollArea);
+}
+
+static void PH_DoClearScreenAndBackBuffer(void)
+{
+    PluginHarness_CountCall(e_PHCall_DoClearScreenAndBackBuffer);
+}
+
+static void PH_GetCursorXY(int32_t *RetCursorX,int32_t *RetCursorY)
+{
+    PluginHarness_CountCall(e_PHCall_GetCursorXY);
+    *RetCursorX=m_PH_Line.size();
+    *RetCursorY=PH_SCREEN_ROWS-1;
+}
+
+static void PH_SetCursorXY(uint32_t X,uint32_t Y)
+{
+    PluginHarness_CountCall(e_PHCall_SetCursorXY);
+}
+
+static void PH_GetScreenSize(int32_t *RetRows,int32_t *RetColumns)
+{
+    PluginHarness_CountCall(e_PHCall_GetScreenSize);
+    *RetRows=PH_SCREEN_ROWS;
+    *RetColumns=PH_SCREEN_COLUMNS;
+}
+
+static void PH_NoteNonPrintable(const char *CodeStr)
+{
+    PluginHarness_CountCall(e_PHCall_NoteNonPrintable);
+}
+
+static void PH_SendBackspace(void)
+{
+    PluginHarness_CountCall(e_PHCall_SendBackspace);
+}
+
+static void PH_SendEnter(void)
+{
+    PluginHarness_CountCall(e_PHCall_SendEnter);
+}
+
+static void PH_BinaryAddText(const char *Str)
+{
+    PluginHarness_CountCall(e_PHCall_BinaryAddText);
+    PluginHarness_AddToScreen((const uint8_t *)Str,strlen(Str));
+}
+
+static void PH_BinaryAddHex(uint8_t Byte)
+{
+    char buff[4];
+
+    PluginHarness_CountCall(e_PHCall_BinaryAddHex);
+    sprintf(buff,"%02X ",Byte);
+    PluginHarness_AddToScreen((const uint8_t *)buff,3);
+}
+
+static void PH_InsertString(uint8_t *Str,uint32_t Len)
+{
+    PluginHarness_CountCall(e_PHCall_InsertString);
+    PluginHarness_AddToScreen(Str,Len);
+}
+
+static void PH_SetCurrentSettingsTabName(const char *Name)
+{
+    PluginHarness_CountCall(e_PHCall_SetCurrentSettingsTabName);
+}
+
+static t_WidgetSysHandle *PH_AddNewSettingsTab(const char *Name)
+{
+    PluginHarness_CountCall(e_PHCall_AddNewSettingsTab);
+    return PluginHarness_GetWidgetHandle();
+}
+
+static t_DataProMark *PH_AllocateMark(void)
+{
+    struct PH_Mark *Mark;
+
+    PluginHarness_CountCall(e_PHCall_AllocateMark);
+    Mark=new struct PH_Mark;
+    Mark->Line=m_PH_LineNumber;
+    Mark->Offset=m_PH_Line.size();
+    return (t_DataProMark *)Mark;
+}
+
+static void PH_FreeMark(t_DataProMark *Mark)
+{
+    PluginHarness_CountCall(e_PHCall_FreeMark);
+    delete (struct PH_Mark *)Mark;
+}
+
+static PG_BOOL PH_IsMarkValid(t_DataProMark *Mark)
+{
+    PluginHarness_CountCall(e_PHCall_IsMarkValid);
+    return ((struct PH_Mark *)Mark)->Line==m_PH_LineNumber;
+}
+
+static void PH_SetMark2CursorPos(t_DataProMark *Mark)
+{
+    struct PH_Mark *PMark=(struct PH_Mark *)Mark;
+
+    PluginHarness_CountCall(e_PHCall_SetMark2CursorPos);
+    PMark->Line=m_PH_LineNumber;
+    PMark->Offset=m_PH_Line.size();
+}
+
+static void PH_ApplyAttrib2Mark(t_DataProMark *Mark,uint32_t Attrib,
+        uint32_t Offset,uint32_t Len)
+{
+    PluginHarness_CountCall(e_PHCall_ApplyAttrib2Mark);
+}
+
+static void PH_RemoveAttribFromMark(t_DataProMark *Mark,uint32_t Attrib,
+        uint32_t Offset,uint32_t Len)
+{
+    PluginHarness_CountCall(e_PHCall_RemoveAttribFromMark);
+}
+
+static void PH_ApplyFGColor2Mark(t_DataProMark *Mark,uint32_t FGColor,
+        uint32_t Offset,uint32_t Len)
+{
+    PluginHarness_CountCall(e_PHCall_ApplyFGColor2Mark);
+}
+
+static void PH_ApplyBGColor2Mark(t_DataProMark *Mark,uint32_t BGColor,
+        uint32_t Offset,uint32_t Len)
+{
+    PluginHarness_CountCall(e_PHCall_ApplyBGColor2Mark);
+}
+
+static void PH_MoveMark(t_DataProMark *Mark,int Amount)
+{
+    struct PH_Mark *PMark=(struct PH_Mark *)Mark;
+
+    PluginHarness_CountCall(e_PHCall_MoveMark);
+    if(Amount<0 && (uint32_t)-Amount>PMark->Offset)
+        PMark->Offset=0;
+    else
+        PMark->Offset+=Amount;
+}
+
+static const uint8_t *PH_GetMarkString(t_DataProMark *Mark,uint32_t *Size,
+        uint32_t Offset,uint32_t Len)
+{
+    struct PH_Mark *PMark=(struct PH_Mark *)Mark;
+    uint32_t Start;
+
+    PluginHarness_CountCall(e_PHCall_GetMarkString);
+
+    *Size=0;
+    if(PMark->Line!=m_PH_LineNumber)
+        return NULL;
+
+    Start=PMark->Offset+Offset;
+    if(Start>m_PH_Line.size())
+        return NULL;
+
+    /* Len of 0 means to the end of the line */
+    *Size=m_PH_Line.size()-Start;
+    if(Len!=0 && Len<*Size)
+        *Size=Len;
+
+    return (const uint8_t *)m_PH_Line.c_str()+Start;
+}
+
+static void PH_FreezeStream(void)
+{
+    PluginHarness_CountCall(e_PHCall_FreezeStream);
+    m_PH_Frozen=true;
+}
+
+static void PH_ClearFrozenStream(void)
+{
+    PluginHarness_CountCall(e_PHCall_ClearFrozenStream);
+    m_PH_FrozenBuff.clear();
+}
+
+static void PH_ReleaseFrozenStream(void)
+{
+    PluginHarness_CountCall(e_PHCall_ReleaseFrozenStream);
+    m_PH_Frozen=false;
+    if(!m_PH_FrozenBuff.empty())
+    {
+        PluginHarness_AddToScreen((const uint8_t *)m_PH_FrozenBuff.c_str(),
+                m_PH_FrozenBuff.size());
+        m_PH_FrozenBuff.clear();
+    }
+}
+
+static const uint8_t *PH_GetFrozenString(uint32_t *Size)
+{
+    PluginHarness_CountCall(e_PHCall_GetFrozenString);
+    *Size=m_PH_FrozenBuff.size();
+    return (const uint8_t *)m_PH_FrozenBuff.c_str();
+}
+
+static void PH_InsertStyledString(const uint8_t *Str,uint32_t Len,
+        uint32_t FGColor,uint32_t BGColor,uint32_t ULineColor,uint32_t Attribs)
+{
+    PluginHarness_CountCall(e_PHCall_InsertStyledString);
+    PluginHarness_AddToScreen(Str,Len);
+}
+
+static void PH_BinaryAddHexBlock(const uint8_t *Data,uint32_t Len)
+{
+    char buff[4];
+    uint32_t r;
+
+    PluginHarness_CountCall(e_PHCall_BinaryAddHexBlock);
+    for(r=0;r<Len;r++)
+    {
+        sprintf(buff,"%02X ",Data[r]);
+        PluginHarness_AddToScreen((const uint8_t *)buff,3);
+    }
+}
+
+/* IOS_API */
+static PG_BOOL PH_RegisterDriver(const char *DriverName,const char *BaseURI,
+        const struct IODriverAPI *DriverAPI,int SizeOfDriverAPI)
+{
+    struct PH_RegisteredDriver *Drv;
+
+    if(g_PH_DriverCount>=PH_MAX_REGISTERED)
+        return false;
+
+    Drv=&g_PH_Drivers[g_PH_DriverCount++];
+    Drv->DriverName=DriverName;
+    Drv->BaseURI=BaseURI;
+    memset(&Drv->API,0,sizeof(Drv->API));
+    if(SizeOfDriverAPI>(int)sizeof(Drv->API))
+        SizeOfDriverAPI=sizeof(Drv->API);
+    memcpy(&Drv->API,DriverAPI,SizeOfDriverAPI);
+
+    return true;
+}
+
+static void PH_DrvDataEvent(t_IOSystemHandle *IOHandle,int Code)
+{
+    PluginHarness_CountCall(e_PHCall_DrvDataEvent);
+
+    std::lock_guard<std::mutex> Lock(m_PH_EventMutex);
+    m_PH_PendingEvents++;
+    m_PH_EventCond.notify_one();
+}
+
+/* FTPS_API (file transfers aren't driven, these are just here so the
+   plugin has something to call) */
+static PG_BOOL PH_RegisterFileTransferProtocol(const struct FTPHandlerInfo *Info)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+    return true;
+}
+
+static void PH_SetTimeout(t_FTPSystemData *SysHandle,uint32_t MSec)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+}
+
+static void PH_RestartTimeout(t_FTPSystemData *SysHandle)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+}
+
+static void PH_ULProgress(t_FTPSystemData *SysHandle,uint64_t BytesTransfered)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+}
+
+static void PH_ULFinish(t_FTPSystemData *SysHandle,PG_BOOL Aborted)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+}
+
+static int PH_ULSendData(t_FTPSystemData *SysHandle,void *Data,uint32_t Bytes)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+    return e_FTPS_SendDataRet_Success;
+}
+
+static void PH_DLProgress(t_FTPSystemData *SysHandle,uint64_t BytesTransfered)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+}
+
+static void PH_DLFinish(t_FTPSystemData *SysHandle,PG_BOOL Aborted)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+}
+
+static int PH_DLSendData(t_FTPSystemData *SysHandle,void *Data,uint32_t Bytes)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+    return e_FTPS_SendDataRet_Success;
+}
+
+static const char *PH_GetDownloadFilename(t_FTPSystemData *SysHandle,
+        const char *FileNameHint)
+{
+    PluginHarness_CountCall(e_PHCall_FTPS);
+    return FileNameHint;
+}
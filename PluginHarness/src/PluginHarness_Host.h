@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * FILENAME: PluginHarness_Host.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the stand in for the WhippyTerm side of the plugin API in it.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __PLUGINHARNESS_HOST_H_
+#define __PLUGINHARNESS_HOST_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include "PluginSDK/Plugin.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/***  DEFINES                          ***/
+#define PH_MAX_REGISTERED               20      // Max processors / drivers one plugin can register
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+/* Every host function a plugin can call (the UI ones are counted as one) */
+typedef enum
+{
+    /* PI_SystemAPI */
+    e_PHCall_KVClear,
+    e_PHCall_KVAddItem,
+    e_PHCall_KVGetItem,
+    /* DPS_API */
+    e_PHCall_WriteData,
+    e_PHCall_GetSysColor,
+    e_PHCall_GetSysDefaultColor,
+    e_PHCall_SetFGColor,
+    e_PHCall_GetFGColor,
+    e_PHCall_SetBGColor,
+    e_PHCall_GetBGColor,
+    e_PHCall_SetULineColor,
+    e_PHCall_GetULineColor,
+    e_PHCall_SetAttribs,
+    e_PHCall_GetAttribs,
+    e_PHCall_SetTitle,
+    e_PHCall_DoNewLine,
+    e_PHCall_DoReturn,
+    e_PHCall_DoBackspace,
+    e_PHCall_DoClearScreen,
+    e_PHCall_DoClearArea,
+    e_PHCall_DoTab,
+    e_PHCall_DoPrevTab,
+    e_PHCall_DoSystemBell,
+    e_PHCall_DoScrollArea,
+    e_PHCall_DoClearScreenAndBackBuffer,
+    e_PHCall_GetCursorXY,
+    e_PHCall_SetCursorXY,
+    e_PHCall_GetScreenSize,
+    e_PHCall_NoteNonPrintable,
+    e_PHCall_SendBackspace,
+    e_PHCall_SendEnter,
+    e_PHCall_BinaryAddText,
+    e_PHCall_BinaryAddHex,
+    e_PHCall_InsertString,
+    e_PHCall_SetCurrentSettingsTabName,
+    e_PHCall_AddNewSettingsTab,
+    e_PHCall_AllocateMark,
+    e_PHCall_FreeMark,
+    e_PHCall_IsMarkValid,
+    e_PHCall_SetMark2CursorPos,
+    e_PHCall_ApplyAttrib2Mark,
+    e_PHCall_RemoveAttribFromMark,
+    e_PHCall_ApplyFGColor2Mark,
+    e_PHCall_ApplyBGColor2Mark,
+    e_PHCall_MoveMark,
+    e_PHCall_GetMarkString,
+    e_PHCall_FreezeStream,
+    e_PHCall_ClearFrozenStream,
+    e_PHCall_ReleaseFrozenStream,
+    e_PHCall_GetFrozenString,
+    e_PHCall_InsertStyledString,
+    e_PHCall_BinaryAddHexBlock,
+    /* IOS_API */
+    e_PHCall_DrvDataEvent,
+    /* FTPS_API */
+    e_PHCall_FTPS,
+    /* PI_UIAPI */
+    e_PHCall_UI,
+    e_PHCallMAX
+} e_PHCallType;
+
+struct PH_RegisteredProcessor
+{
+    const char *ProID;
+    struct DataProcessorAPI API;        // Zeroed past what the plugin gave us
+};
+
+struct PH_RegisteredDriver
+{
+    const char *DriverName;
+    const char *BaseURI;
+    struct IODriverAPI API;             // Zeroed past what the plugin gave us
+};
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+extern struct PH_RegisteredProcessor g_PH_Processors[PH_MAX_REGISTERED];
+extern unsigned int g_PH_ProcessorCount;
+extern struct PH_RegisteredDriver g_PH_Drivers[PH_MAX_REGISTERED];
+extern unsigned int g_PH_DriverCount;
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+const struct PI_SystemAPI *PluginHarness_GetSystemAPI(void);
+void PluginHarness_SetExperimentalID(uint32_t ID);
+t_PIKVList *PluginHarness_AllocKVList(void);
+void PluginHarness_FreeKVList(t_PIKVList *List);
+void PluginHarness_AddToScreen(const uint8_t *Bytes,uint32_t Len);
+void PluginHarness_RecordScreen(FILE *Out);
+void PluginHarness_CountCall(e_PHCallType Call);
+uint64_t PluginHarness_GetCallCount(e_PHCallType Call);
+const char *PluginHarness_GetCallName(e_PHCallType Call);
+void PluginHarness_ResetCallCounts(void);
+bool PluginHarness_WaitForDataEvent(unsigned int TimeoutMS);
+
+#endif
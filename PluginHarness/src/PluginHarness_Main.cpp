@@ -0,0 +1,1072 @@
+/*******************************************************************************
+ * FILENAME: PluginHarness_Main.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is a small command line program that loads a plugin .so, registers
+ *    it against a stand in for WhippyTerm and pushes a recorded byte stream
+ *    through it.  It then reports how fast it went and how many times the
+ *    plugin called back in to the host (per function and per byte).
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "PluginHarness_Host.h"
+#include "PluginHarness_UI.h"
+#include <algorithm>
+#include <chrono>
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/*** DEFINES                  ***/
+#define PH_DEFAULT_CHUNK_SIZE               4096
+#define PH_DEFAULT_VERSION                  0x02000000
+#define PH_DEFAULT_WAIT_MS                  1000
+#define PH_MAX_PROCESSED_CHAR               32      // Room for what ProcessIncomingTextByte() can hand back
+#define PH_MAX_DEVICE_ID                    256
+#define PH_READ_BUFFER_SIZE                 65536
+#define PH_BUSY_MIN_WAIT_MS                 1
+#define PH_BUSY_MAX_WAIT_MS                 100
+#define PH_BUSY_TIMEOUT_MS                  10000   // Give up if the driver stays busy this long
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+typedef std::chrono::steady_clock t_PHClock;
+
+struct PH_Options
+{
+    const char *PluginFile;
+    const char *CorpusFile;
+    const char *Name;
+    const char *URI;
+    const char *RecordFile;
+    std::vector<std::string> Settings;
+    uint32_t ChunkSize;
+    unsigned int Repeats;
+    unsigned int WaitMS;
+    unsigned int Version;
+    uint32_t ExperimentalID;
+    bool ForceByte;
+    bool Outgoing;
+    bool Latency;
+    bool Widgets;
+};
+
+/* What we measured while feeding the plugin */
+struct PH_Results
+{
+    uint64_t Bytes;
+    uint64_t PluginCalls;
+    double Seconds;
+    std::vector<uint32_t> Latency;      // In ns, one per plugin call (only with -l)
+};
+
+/* What we have seen from an IO driver so far */
+struct PH_DriverCounts
+{
+    uint64_t RxBytes;
+    uint64_t PluginCalls;
+    t_PHClock::time_point LastRx;
+    std::vector<uint32_t> Latency;      // In ns, one per plugin call (only with -l)
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static void PH_Usage(const char *ProgName);
+static bool PH_ParseOptions(int argc,char *argv[],struct PH_Options *Opts);
+static bool PH_LoadCorpus(const char *Filename,std::vector<uint8_t> &Corpus);
+static bool PH_AddSettings(t_PIKVList *List,const struct PH_Options *Opts);
+static int PH_RunProcessor(struct PH_RegisteredProcessor *Pro,const struct PH_Options *Opts,const std::vector<uint8_t> &Corpus);
+static void PH_FeedProcessor(struct PH_RegisteredProcessor *Pro,t_DataProcessorHandleType *Data,e_DataProcessorTypeType ProType,const struct PH_Options *Opts,const uint8_t *Bytes,uint32_t Len,struct PH_Results *Results);
+static int PH_RunDriver(struct PH_RegisteredDriver *Drv,const struct PH_Options *Opts,const std::vector<uint8_t> &Corpus);
+static int PH_ReadDriver(struct PH_RegisteredDriver *Drv,t_DriverIOHandleType *Handle,const struct PH_Options *Opts,std::vector<uint8_t> &ReadBuff,struct PH_DriverCounts *Counts);
+static void PH_ReportHostCalls(uint64_t Bytes);
+static void PH_ReportLatency(std::vector<uint32_t> &Latency);
+
+/*** VARIABLE DEFINITIONS     ***/
+/* The driver only needs a unique pointer for the IOHandle */
+static int m_PH_IOHandle;
+
+int main(int argc,char *argv[])
+{
+    struct PH_Options Opts;
+    std::vector<uint8_t> Corpus;
+    unsigned int (*RegisterPlugin)(const struct PI_SystemAPI *SysAPI,
+            unsigned int Version);
+    void *Lib;
+    unsigned int Needed;
+    unsigned int r;
+
+    if(!PH_ParseOptions(argc,argv,&Opts))
+    {
+        PH_Usage(argv[0]);
+        return 1;
+    }
+
+    if(!PH_LoadCorpus(Opts.CorpusFile,Corpus))
+        return 1;
+
+    Lib=dlopen(Opts.PluginFile,RTLD_NOW|RTLD_LOCAL);
+    if(Lib==NULL)
+    {
+        fprintf(stderr,"Failed to load plugin: %s\n",dlerror());
+        return 1;
+    }
+
+    RegisterPlugin=(unsigned int (*)(const struct PI_SystemAPI *,unsigned int))
+            dlsym(Lib,"RegisterPlugin");
+    if(RegisterPlugin==NULL)
+    {
+        fprintf(stderr,"Plugin doesn't have a RegisterPlugin()\n");
+        dlclose(Lib);
+        return 1;
+    }
+
+    PluginHarness_SetExperimentalID(Opts.ExperimentalID);
+    Needed=RegisterPlugin(PluginHarness_GetSystemAPI(),Opts.Version);
+    if(Needed!=0)
+    {
+        if(Needed==0xFFFFFFFF)
+            fprintf(stderr,"RegisterPlugin() failed\n");
+        else
+            fprintf(stderr,"Plugin needs version 0x%08X (use -V)\n",Needed);
+        dlclose(Lib);
+        return 1;
+    }
+
+    for(r=0;r<g_PH_ProcessorCount;r++)
+    {
+        if(Opts.Name==NULL || strcmp(Opts.Name,g_PH_Processors[r].ProID)==0)
+            return PH_RunProcessor(&g_PH_Processors[r],&Opts,Corpus);
+    }
+
+    for(r=0;r<g_PH_DriverCount;r++)
+    {
+        if(Opts.Name==NULL || strcmp(Opts.Name,g_PH_Drivers[r].DriverName)==0)
+            return PH_RunDriver(&g_PH_Drivers[r],&Opts,Corpus);
+    }
+
+    fprintf(stderr,"No data processor or IO driver%s%s was registered\n",
+            Opts.Name!=NULL?" named ":"",Opts.Name!=NULL?Opts.Name:"");
+
+    /* We leave the plugin loaded, the same as WhippyTerm does */
+    return 1;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_Usage
+ *
+ * SYNOPSIS:
+ *    static void PH_Usage(const char *ProgName);
+ *
+ * PARAMETERS:
+ *    ProgName [I] -- The name we where run as
+ *
+ * FUNCTION:
+ *    This function prints the command line help.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void PH_Usage(const char *ProgName)
+{
+    fprintf(stderr,"Usage: %s [options] plugin.so [corpus]\n",ProgName);
+    fprintf(stderr,"Loads a plugin and feeds it 'corpus' (or stdin).\n");
+    fprintf(stderr,"\n");
+    fprintf(stderr,"  -n Name       Use the processor / driver with this ID\n");
+    fprintf(stderr,"                (default is the first one registered)\n");
+    fprintf(stderr,"  -s Key=Value  Add a setting / connection option\n");
+    fprintf(stderr,"                (can be given more than once)\n");
+    fprintf(stderr,"  -c Bytes      The size of the blocks to feed in (default %d)\n",
+            PH_DEFAULT_CHUNK_SIZE);
+    fprintf(stderr,"  -b            Use the byte API even if there is a block API\n");
+    fprintf(stderr,"  -t            Feed the data as outgoing (ProcessOutGoingData)\n");
+    fprintf(stderr,"  -r Count      Feed the corpus this many times (default 1)\n");
+    fprintf(stderr,"  -o File       Record what was added to the screen to 'File'\n");
+    fprintf(stderr,"  -l            Time every call in to the plugin\n");
+    fprintf(stderr,"  -W            Alloc / read / free the settings widgets first\n");
+    fprintf(stderr,"  -V Version    The WhippyTerm version to claim (default 0x%08X)\n",
+            PH_DEFAULT_VERSION);
+    fprintf(stderr,"  -X ID         The experimental API ID to claim (default 0x%08X,\n",
+            DPS_API_EXPERIMENTAL_BLOCK_CALLS);
+    fprintf(stderr,"                the DPS block calls).  0 is a released WhippyTerm\n");
+    fprintf(stderr,"  -u URI        The URI to open (IO drivers only)\n");
+    fprintf(stderr,"  -w MS         How long to wait for incoming data after the\n");
+    fprintf(stderr,"                write (IO drivers only, default %d)\n",
+            PH_DEFAULT_WAIT_MS);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_ParseOptions
+ *
+ * SYNOPSIS:
+ *    static bool PH_ParseOptions(int argc,char *argv[],
+ *          struct PH_Options *Opts);
+ *
+ * PARAMETERS:
+ *    argc [I] -- The arg count from main()
+ *    argv [I] -- The args from main()
+ *    Opts [O] -- The options we parsed
+ *
+ * FUNCTION:
+ *    This function parses the command line.
+ *
+ * RETURNS:
+ *    true -- Things are ok
+ *    false -- The command line was bad
+ ******************************************************************************/
+static bool PH_ParseOptions(int argc,char *argv[],struct PH_Options *Opts)
+{
+    int opt;
+
+    Opts->PluginFile=NULL;
+    Opts->CorpusFile=NULL;
+    Opts->Name=NULL;
+    Opts->URI=NULL;
+    Opts->RecordFile=NULL;
+    Opts->ChunkSize=PH_DEFAULT_CHUNK_SIZE;
+    Opts->Repeats=1;
+    Opts->WaitMS=PH_DEFAULT_WAIT_MS;
+    Opts->Version=PH_DEFAULT_VERSION;
+    Opts->ExperimentalID=DPS_API_EXPERIMENTAL_BLOCK_CALLS;
+    Opts->ForceByte=false;
+    Opts->Outgoing=false;
+    Opts->Latency=false;
+    Opts->Widgets=false;
+
+    while((opt=getopt(argc,argv,"n:s:c:btr:o:lWV:X:u:w:"))!=-1)
+    {
+        switch(opt)
+        {
+            case 'n':
+                Opts->Name=optarg;
+            break;
+            case 's':
+                if(strchr(optarg,'=')==NULL)
+                {
+                    fprintf(stderr,"Settings must be Key=Value\n");
+                    return false;
+                }
+                Opts->Settings.push_back(optarg);
+            break;
+            case 'c':
+                Opts->ChunkSize=strtoul(optarg,NULL,0);
+                if(Opts->ChunkSize<1)
+                    return false;
+            break;
+            case 'b':
+                Opts->ForceByte=true;
+            break;
+            case 't':
+                Opts->Outgoing=true;
+            break;
+            case 'r':
+                Opts->Repeats=strtoul(optarg,NULL,0);
+                if(Opts->Repeats<1)
+                    return false;
+            break;
+            case 'o':
+                Opts->RecordFile=optarg;
+            break;
+            case 'l':
+                Opts->Latency=true;
+            break;
+            case 'W':
+                Opts->Widgets=true;
+            break;
+            case 'V':
+                Opts->Version=strtoul(optarg,NULL,0);
+            break;
+            case 'X':
+                Opts->ExperimentalID=strtoul(optarg,NULL,0);
+            break;
+            case 'u':
+                Opts->URI=optarg;
+            break;
+            case 'w':
+                Opts->WaitMS=strtoul(optarg,NULL,0);
+            break;
+            default:
+                return false;
+        }
+    }
+
+    if(optind>=argc)
+        return false;
+    Opts->PluginFile=argv[optind++];
+
+    if(optind<argc)
+        Opts->CorpusFile=argv[optind++];
+
+    if(optind<argc)
+        return false;
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_LoadCorpus
+ *
+ * SYNOPSIS:
+ *    static bool PH_LoadCorpus(const char *Filename,
+ *          std::vector<uint8_t> &Corpus);
+ *
+ * PARAMETERS:
+ *    Filename [I] -- The file to load (NULL for stdin)
+ *    Corpus [O] -- The bytes from the file
+ *
+ * FUNCTION:
+ *    This function loads the whole corpus in to memory so reading it isn't
+ *    part of what we time.
+ *
+ * RETURNS:
+ *    true -- Things are ok
+ *    false -- There was an error (it has been printed)
+ ******************************************************************************/
+static bool PH_LoadCorpus(const char *Filename,std::vector<uint8_t> &Corpus)
+{
+    FILE *in;
+    uint8_t Buff[PH_READ_BUFFER_SIZE];
+    size_t Bytes;
+
+    if(Filename==NULL)
+    {
+        in=stdin;
+    }
+    else
+    {
+        in=fopen(Filename,"rb");
+        if(in==NULL)
+        {
+            fprintf(stderr,"Failed to open \"%s\"\n",Filename);
+            return false;
+        }
+    }
+
+    while((Bytes=fread(Buff,1,sizeof(Buff),in))>0)
+        Corpus.insert(Corpus.end(),Buff,Buff+Bytes);
+
+    if(in!=stdin)
+        fclose(in);
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_AddSettings
+ *
+ * SYNOPSIS:
+ *    static bool PH_AddSettings(t_PIKVList *List,
+ *          const struct PH_Options *Opts);
+ *
+ * PARAMETERS:
+ *    List [I] -- The settings / options list to add to
+ *    Opts [I] -- The command line options (we use the -s ones)
+ *
+ * FUNCTION:
+ *    This function adds the Key=Value pairs from the command line to a
+ *    key/value list.
+ *
+ * RETURNS:
+ *    true -- Things are ok
+ *    false -- We couldn't add them
+ ******************************************************************************/
+static bool PH_AddSettings(t_PIKVList *List,const struct PH_Options *Opts)
+{
+    const struct PI_SystemAPI *SysAPI;
+    std::string Key;
+    size_t Equ;
+    unsigned int r;
+
+    SysAPI=PluginHarness_GetSystemAPI();
+    for(r=0;r<Opts->Settings.size();r++)
+    {
+        Equ=Opts->Settings[r].find('=');
+        Key=Opts->Settings[r].substr(0,Equ);
+        if(!SysAPI->KVAddItem(List,Key.c_str(),
+                Opts->Settings[r].c_str()+Equ+1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_RunProcessor
+ *
+ * SYNOPSIS:
+ *    static int PH_RunProcessor(struct PH_RegisteredProcessor *Pro,
+ *          const struct PH_Options *Opts,const std::vector<uint8_t> &Corpus);
+ *
+ * PARAMETERS:
+ *    Pro [I] -- The data processor to run
+ *    Opts [I] -- The command line options
+ *    Corpus [I] -- The bytes to feed it
+ *
+ * FUNCTION:
+ *    This function sets up a data processor the way WhippyTerm does when a
+ *    connection is opened, feeds it the corpus in 'Opts->ChunkSize' blocks
+ *    and prints the report.
+ *
+ * RETURNS:
+ *    The exit code for main().
+ ******************************************************************************/
+static int PH_RunProcessor(struct PH_RegisteredProcessor *Pro,
+        const struct PH_Options *Opts,const std::vector<uint8_t> &Corpus)
+{
+    const struct DataProcessorInfo *Info;
+    unsigned int InfoSize;
+    t_PIKVList *Settings;
+    t_DataProSettingsWidgetsType *Widgets;
+    t_DataProcessorHandleType *Data;
+    struct PH_Results Results;
+    FILE *RecordOut;
+    uint32_t Pos;
+    uint32_t Len;
+    unsigned int r;
+    const char *Path;
+
+    Info=NULL;
+    if(Pro->API.GetProcessorInfo!=NULL)
+        Info=Pro->API.GetProcessorInfo(&InfoSize);
+    if(Info==NULL)
+    {
+        fprintf(stderr,"Processor \"%s\" has no info\n",Pro->ProID);
+        return 1;
+    }
+
+    RecordOut=NULL;
+    if(Opts->RecordFile!=NULL)
+    {
+        RecordOut=fopen(Opts->RecordFile,"wb");
+        if(RecordOut==NULL)
+        {
+            fprintf(stderr,"Failed to open \"%s\"\n",Opts->RecordFile);
+            return 1;
+        }
+    }
+
+    Settings=PluginHarness_AllocKVList();
+    if(!PH_AddSettings(Settings,Opts))
+    {
+        fprintf(stderr,"Failed to add the settings\n");
+        PluginHarness_FreeKVList(Settings);
+        if(RecordOut!=NULL)
+            fclose(RecordOut);
+        return 1;
+    }
+
+    if(Opts->Widgets && Pro->API.AllocSettingsWidgets!=NULL)
+    {
+        Widgets=Pro->API.AllocSettingsWidgets(PluginHarness_GetWidgetHandle(),
+                Settings);
+        if(Widgets!=NULL)
+        {
+            if(Pro->API.SetSettingsFromWidgets!=NULL)
+                Pro->API.SetSettingsFromWidgets(Widgets,Settings);
+            if(Pro->API.FreeSettingsWidgets!=NULL)
+                Pro->API.FreeSettingsWidgets(Widgets);
+        }
+    }
+
+    Data=NULL;
+    if(Pro->API.AllocateData!=NULL)
+        Data=Pro->API.AllocateData();
+
+    if(Pro->API.ApplySettings!=NULL)
+        Pro->API.ApplySettings(Data,Settings);
+
+    /* Only count what happens while the data goes by */
+    PluginHarness_ResetCallCounts();
+    PluginHarness_RecordScreen(RecordOut);
+
+    Results.Bytes=0;
+    Results.PluginCalls=0;
+    Results.Seconds=0;
+    if(Opts->Latency)
+        Results.Latency.reserve(Corpus.size()*Opts->Repeats);
+
+    for(r=0;r<Opts->Repeats;r++)
+    {
+        for(Pos=0;Pos<Corpus.size();Pos+=Len)
+        {
+            Len=std::min((uint32_t)(Corpus.size()-Pos),Opts->ChunkSize);
+            PH_FeedProcessor(Pro,Data,Info->ProType,Opts,&Corpus[Pos],Len,
+                    &Results);
+        }
+    }
+
+    PluginHarness_RecordScreen(NULL);
+
+    if(Opts->Outgoing)
+        Path="outgoing";
+    else if(Info->ProType==e_DataProcessorType_Text)
+        Path=(Pro->API.ProcessIncomingTextBlock!=NULL && !Opts->ForceByte)?
+                "text block":"text byte";
+    else
+        Path=(Pro->API.ProcessIncomingBinaryBlock!=NULL && !Opts->ForceByte)?
+                "binary block":"binary byte";
+
+    printf("Processor: %s (%s)\n",Pro->ProID,Info->DisplayName);
+    printf("Path: %s, %u byte chunks, %u repeat(s)\n",Path,Opts->ChunkSize,
+            Opts->Repeats);
+    printf("Bytes: %llu in %.3f ms",(unsigned long long)Results.Bytes,
+            Results.Seconds*1000.0);
+    if(Results.Seconds>0)
+        printf(" (%.2f MB/s)",Results.Bytes/Results.Seconds/1000000.0);
+    printf("\n");
+    printf("Plugin calls: %llu",(unsigned long long)Results.PluginCalls);
+    if(Results.Bytes>0)
+        printf(" (%.4f per byte)",(double)Results.PluginCalls/Results.Bytes);
+    printf("\n");
+    PH_ReportHostCalls(Results.Bytes);
+    if(Opts->Latency)
+        PH_ReportLatency(Results.Latency);
+
+    if(Pro->API.FreeData!=NULL)
+        Pro->API.FreeData(Data);
+    PluginHarness_FreeKVList(Settings);
+    if(RecordOut!=NULL)
+        fclose(RecordOut);
+
+    return 0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_FeedProcessor
+ *
+ * SYNOPSIS:
+ *    static void PH_FeedProcessor(struct PH_RegisteredProcessor *Pro,
+ *          t_DataProcessorHandleType *Data,e_DataProcessorTypeType ProType,
+ *          const struct PH_Options *Opts,const uint8_t *Bytes,uint32_t Len,
+ *          struct PH_Results *Results);
+ *
+ * PARAMETERS:
+ *    Pro [I] -- The data processor to feed
+ *    Data [I] -- The processor's data from AllocateData()
+ *    ProType [I] -- Is this a text or binary processor
+ *    Opts [I] -- The command line options
+ *    Bytes [I] -- The block of bytes that came in
+ *    Len [I] -- The number of bytes in 'Bytes'
+ *    Results [I/O] -- The counters and timings to add to
+ *
+ * FUNCTION:
+ *    This function hands one block to the processor the same way
+ *    WhippyTerm does.  Text processors get the block API if they have one
+ *    (with the bytes they don't consume going to the screen), otherwise
+ *    they are called once per byte.  Binary processors get the block API if
+ *    they have one otherwise they are called once per byte.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void PH_FeedProcessor(struct PH_RegisteredProcessor *Pro,
+        t_DataProcessorHandleType *Data,e_DataProcessorTypeType ProType,
+        const struct PH_Options *Opts,const uint8_t *Bytes,uint32_t Len,
+        struct PH_Results *Results)
+{
+    t_PHClock::time_point Start;
+    t_PHClock::time_point CallStart;
+    uint8_t ProcessedChar[PH_MAX_PROCESSED_CHAR];
+    int CharLen;
+    PG_BOOL Consumed;
+    uint32_t Pos;
+    uint32_t Done;
+    bool UseBlock;
+
+    Start=t_PHClock::now();
+    CallStart=Start;
+
+    if(Opts->Outgoing)
+    {
+        if(Pro->API.ProcessOutGoingData!=NULL)
+        {
+            Pro->API.ProcessOutGoingData(Data,Bytes,Len);
+            Results->PluginCalls++;
+            if(Opts->Latency)
+            {
+                Results->Latency.push_back(std::chrono::duration_cast<
+                        std::chrono::nanoseconds>(t_PHClock::now()-CallStart).
+                        count());
+            }
+        }
+    }
+    else if(ProType==e_DataProcessorType_Text)
+    {
+        UseBlock=Pro->API.ProcessIncomingTextBlock!=NULL && !Opts->ForceByte;
+        for(Pos=0;Pos<Len;Pos+=Done)
+        {
+            if(Opts->Latency)
+                CallStart=t_PHClock::now();
+
+            Consumed=false;
+            if(UseBlock)
+            {
+                Done=Pro->API.ProcessIncomingTextBlock(Data,&Bytes[Pos],
+                        Len-Pos,&Consumed);
+                if(Done<1 || Done>Len-Pos)
+                    Done=Len-Pos;
+                if(!Consumed)
+                    PluginHarness_AddToScreen(&Bytes[Pos],Done);
+            }
+            else
+            {
+                Done=1;
+                ProcessedChar[0]=Bytes[Pos];
+                CharLen=1;
+                if(Pro->API.ProcessIncomingTextByte!=NULL)
+                {
+                    Pro->API.ProcessIncomingTextByte(Data,Bytes[Pos],
+                            ProcessedChar,&CharLen,&Consumed);
+                }
+                if(!Consumed)
+                    PluginHarness_AddToScreen(ProcessedChar,CharLen);
+            }
+            Results->PluginCalls++;
+
+            if(Opts->Latency)
+            {
+                Results->Latency.push_back(std::chrono::duration_cast<
+                        std::chrono::nanoseconds>(t_PHClock::now()-CallStart).
+                        count());
+            }
+        }
+    }
+    else
+    {
+        if(Pro->API.ProcessIncomingBinaryBlock!=NULL && !Opts->ForceByte)
+        {
+            Pro->API.ProcessIncomingBinaryBlock(Data,Bytes,Len);
+            Results->PluginCalls++;
+            if(Opts->Latency)
+            {
+                Results->Latency.push_back(std::chrono::duration_cast<
+                        std::chrono::nanoseconds>(t_PHClock::now()-CallStart).
+                        count());
+            }
+        }
+        else if(Pro->API.ProcessIncomingBinaryByte!=NULL)
+        {
+            for(Pos=0;Pos<Len;Pos++)
+            {
+                if(Opts->Latency)
+                    CallStart=t_PHClock::now();
+
+                Pro->API.ProcessIncomingBinaryByte(Data,Bytes[Pos]);
+                Results->PluginCalls++;
+
+                if(Opts->Latency)
+                {
+                    Results->Latency.push_back(std::chrono::duration_cast<
+                            std::chrono::nanoseconds>(t_PHClock::now()-
+                            CallStart).count());
+                }
+            }
+        }
+    }
+
+    Results->Seconds+=std::chrono::duration<double>(t_PHClock::now()-Start).
+            count();
+    Results->Bytes+=Len;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_RunDriver
+ *
+ * SYNOPSIS:
+ *    static int PH_RunDriver(struct PH_RegisteredDriver *Drv,
+ *          const struct PH_Options *Opts,const std::vector<uint8_t> &Corpus);
+ *
+ * PARAMETERS:
+ *    Drv [I] -- The IO driver to run
+ *    Opts [I] -- The command line options
+ *    Corpus [I] -- The bytes to write
+ *
+ * FUNCTION:
+ *    This function opens 'Opts->URI' with an IO driver, writes the corpus to
+ *    it, and then reads everything that comes back until no data event has
+ *    come in for 'Opts->WaitMS' (or it disconnects).  It then prints the
+ *    report.
+ *
+ *    If the driver says it's busy we read from it (some drivers, like
+ *    WebSockets, won't take writes until Read() has handled the handshake)
+ *    and try the write again, backing off each time.  If it stays busy for
+ *    PH_BUSY_TIMEOUT_MS the run fails.
+ *
+ * RETURNS:
+ *    The exit code for main().
+ ******************************************************************************/
+static int PH_RunDriver(struct PH_RegisteredDriver *Drv,
+        const struct PH_Options *Opts,const std::vector<uint8_t> &Corpus)
+{
+    t_PIKVList *Options;
+    char DeviceUniqueID[PH_MAX_DEVICE_ID];
+    t_DriverIOHandleType *Handle;
+    t_PHClock::time_point Start;
+    t_PHClock::time_point CallStart;
+    t_PHClock::time_point BusyStart;
+    struct PH_DriverCounts Counts;
+    std::vector<uint8_t> ReadBuff;
+    FILE *RecordOut;
+    uint64_t TxBytes;
+    double TxSeconds;
+    double Seconds;
+    uint32_t Pos;
+    uint32_t Len;
+    unsigned int BusyWaitMS;
+    unsigned int r;
+    bool Failed;
+    int Ret;
+    int RetCode;
+
+    if(Opts->URI==NULL)
+    {
+        fprintf(stderr,"IO driver \"%s\" needs a URI (-u)\n",Drv->DriverName);
+        return 1;
+    }
+
+    if(Drv->API.Init!=NULL && !Drv->API.Init())
+    {
+        fprintf(stderr,"IO driver \"%s\" failed to init\n",Drv->DriverName);
+        return 1;
+    }
+
+    RetCode=1;
+    Handle=NULL;
+    RecordOut=NULL;
+    Options=PluginHarness_AllocKVList();
+    try
+    {
+        if(Drv->API.Convert_URI_To_Options==NULL ||
+                !Drv->API.Convert_URI_To_Options(Opts->URI,Options,
+                DeviceUniqueID,sizeof(DeviceUniqueID),false))
+        {
+            fprintf(stderr,"Failed to convert URI \"%s\"\n",Opts->URI);
+            throw(0);
+        }
+
+        /* -s overrides what came from the URI */
+        if(!PH_AddSettings(Options,Opts))
+        {
+            fprintf(stderr,"Failed to add the options\n");
+            throw(0);
+        }
+
+        if(Opts->RecordFile!=NULL)
+        {
+            RecordOut=fopen(Opts->RecordFile,"wb");
+            if(RecordOut==NULL)
+            {
+                fprintf(stderr,"Failed to open \"%s\"\n",Opts->RecordFile);
+                throw(0);
+            }
+        }
+
+        Handle=Drv->API.AllocateHandle(DeviceUniqueID,
+                (t_IOSystemHandle *)&m_PH_IOHandle);
+        if(Handle==NULL)
+        {
+            fprintf(stderr,"Failed to allocate the driver handle\n");
+            throw(0);
+        }
+
+        if(!Drv->API.Open(Handle,Options))
+        {
+            fprintf(stderr,"Failed to open \"%s\"",Opts->URI);
+            if(Drv->API.GetLastErrorMessage!=NULL)
+                fprintf(stderr,": %s",Drv->API.GetLastErrorMessage(Handle));
+            fprintf(stderr,"\n");
+            throw(0);
+        }
+
+        PluginHarness_ResetCallCounts();
+        PluginHarness_RecordScreen(RecordOut);
+
+        TxBytes=0;
+        Counts.RxBytes=0;
+        Counts.PluginCalls=0;
+        ReadBuff.resize(PH_READ_BUFFER_SIZE);
+        Start=t_PHClock::now();
+        Counts.LastRx=Start;
+        BusyWaitMS=0;
+        Failed=false;
+
+        for(r=0;r<Opts->Repeats && !Failed;r++)
+        {
+            for(Pos=0;Pos<Corpus.size();Pos+=Len)
+            {
+                Len=std::min((uint32_t)(Corpus.size()-Pos),Opts->ChunkSize);
+                CallStart=t_PHClock::now();
+                Ret=Drv->API.Write(Handle,&Corpus[Pos],Len);
+                Counts.PluginCalls++;
+                if(Opts->Latency)
+                {
+                    Counts.Latency.push_back(std::chrono::duration_cast<
+                            std::chrono::nanoseconds>(t_PHClock::now()-
+                            CallStart).count());
+                }
+                if(Ret==RETERROR_BUSY || Ret==0)
+                {
+                    /* Let the driver run it's reads and try again */
+                    if(BusyWaitMS==0)
+                    {
+                        BusyStart=t_PHClock::now();
+                        BusyWaitMS=PH_BUSY_MIN_WAIT_MS;
+                    }
+                    else if(t_PHClock::now()-BusyStart>=
+                            std::chrono::milliseconds(PH_BUSY_TIMEOUT_MS))
+                    {
+                        fprintf(stderr,"Driver stayed busy for %d ms, "
+                                "giving up\n",PH_BUSY_TIMEOUT_MS);
+                        Failed=true;
+                        break;
+                    }
+
+                    PluginHarness_WaitForDataEvent(BusyWaitMS);
+                    Ret=PH_ReadDriver(Drv,Handle,Opts,ReadBuff,&Counts);
+                    if(Ret==RETERROR_DISCONNECT || Ret==RETERROR_IOERROR)
+                    {
+                        fprintf(stderr,"Read failed while waiting to write "
+                                "(%d)\n",Ret);
+                        Failed=true;
+                        break;
+                    }
+                    BusyWaitMS=std::min(BusyWaitMS*2,
+                            (unsigned int)PH_BUSY_MAX_WAIT_MS);
+                    Len=0;
+                    continue;
+                }
+                BusyWaitMS=0;
+                if(Ret<0)
+                {
+                    fprintf(stderr,"Write failed (%d)\n",Ret);
+                    break;
+                }
+                Len=Ret;
+                TxBytes+=Ret;
+            }
+        }
+        if(Failed)
+        {
+            PluginHarness_RecordScreen(NULL);
+            Drv->API.Close(Handle);
+            throw(0);
+        }
+        if(Drv->API.Transmit!=NULL)
+        {
+            Drv->API.Transmit(Handle);
+            Counts.PluginCalls++;
+        }
+        TxSeconds=std::chrono::duration<double>(t_PHClock::now()-Start).
+                count();
+
+        /* Read until things go quiet */
+        while(PluginHarness_WaitForDataEvent(Opts->WaitMS))
+        {
+            Ret=PH_ReadDriver(Drv,Handle,Opts,ReadBuff,&Counts);
+            if(Ret==RETERROR_DISCONNECT || Ret==RETERROR_IOERROR)
+                break;
+        }
+        Seconds=std::chrono::duration<double>(Counts.LastRx-Start).count();
+
+        PluginHarness_RecordScreen(NULL);
+        Drv->API.Close(Handle);
+
+        printf("Driver: %s (%s)\n",Drv->DriverName,Opts->URI);
+        printf("Tx: %llu bytes in %.3f ms",(unsigned long long)TxBytes,
+                TxSeconds*1000.0);
+        if(TxSeconds>0)
+            printf(" (%.2f MB/s)",TxBytes/TxSeconds/1000000.0);
+        printf("\n");
+        printf("Rx: %llu bytes, last one %.3f ms after the first write",
+                (unsigned long long)Counts.RxBytes,Seconds*1000.0);
+        if(Seconds>0)
+            printf(" (%.2f MB/s)",Counts.RxBytes/Seconds/1000000.0);
+        printf("\n");
+        printf("Plugin calls: %llu\n",
+                (unsigned long long)Counts.PluginCalls);
+        PH_ReportHostCalls(Counts.RxBytes);
+        if(Opts->Latency)
+            PH_ReportLatency(Counts.Latency);
+
+        RetCode=0;
+    }
+    catch(...)
+    {
+    }
+
+    if(Handle!=NULL)
+        Drv->API.FreeHandle(Handle);
+    if(RecordOut!=NULL)
+        fclose(RecordOut);
+    PluginHarness_FreeKVList(Options);
+
+    return RetCode;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_ReadDriver
+ *
+ * SYNOPSIS:
+ *    static int PH_ReadDriver(struct PH_RegisteredDriver *Drv,
+ *          t_DriverIOHandleType *Handle,const struct PH_Options *Opts,
+ *          std::vector<uint8_t> &ReadBuff,struct PH_DriverCounts *Counts);
+ *
+ * PARAMETERS:
+ *    Drv [I] -- The IO driver to read from
+ *    Handle [I] -- The open driver handle
+ *    Opts [I] -- The command line options
+ *    ReadBuff [I] -- The buffer to read in to
+ *    Counts [I/O] -- What we have seen so far.  Updated with this read.
+ *
+ * FUNCTION:
+ *    This function calls the driver's Read() until it has no more bytes for
+ *    us, adding what it hands back to the screen.
+ *
+ * RETURNS:
+ *    The last thing Read() returned (RETERROR_NOBYTES, RETERROR_BUSY,
+ *    RETERROR_DISCONNECT, or RETERROR_IOERROR).
+ ******************************************************************************/
+static int PH_ReadDriver(struct PH_RegisteredDriver *Drv,
+        t_DriverIOHandleType *Handle,const struct PH_Options *Opts,
+        std::vector<uint8_t> &ReadBuff,struct PH_DriverCounts *Counts)
+{
+    t_PHClock::time_point CallStart;
+    int Ret;
+
+    for(;;)
+    {
+        CallStart=t_PHClock::now();
+        Ret=Drv->API.Read(Handle,ReadBuff.data(),ReadBuff.size());
+        Counts->PluginCalls++;
+        if(Opts->Latency)
+        {
+            Counts->Latency.push_back(std::chrono::duration_cast<
+                    std::chrono::nanoseconds>(t_PHClock::now()-
+                    CallStart).count());
+        }
+        if(Ret<=0)
+            break;
+        PluginHarness_AddToScreen(ReadBuff.data(),Ret);
+        Counts->RxBytes+=Ret;
+        Counts->LastRx=t_PHClock::now();
+    }
+    return Ret;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_ReportHostCalls
+ *
+ * SYNOPSIS:
+ *    static void PH_ReportHostCalls(uint64_t Bytes);
+ *
+ * PARAMETERS:
+ *    Bytes [I] -- The number of bytes that went by (for the per byte column)
+ *
+ * FUNCTION:
+ *    This function prints every host function the plugin called, how many
+ *    times, and how many times per byte.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void PH_ReportHostCalls(uint64_t Bytes)
+{
+    uint64_t Total;
+    uint64_t Count;
+    unsigned int r;
+
+    Total=0;
+    for(r=0;r<e_PHCallMAX;r++)
+        Total+=PluginHarness_GetCallCount((e_PHCallType)r);
+
+    printf("Host calls: %llu",(unsigned long long)Total);
+    if(Bytes>0)
+        printf(" (%.4f per byte)",(double)Total/Bytes);
+    printf("\n");
+
+    for(r=0;r<e_PHCallMAX;r++)
+    {
+        Count=PluginHarness_GetCallCount((e_PHCallType)r);
+        if(Count==0)
+            continue;
+        printf("    %-28s %12llu",PluginHarness_GetCallName((e_PHCallType)r),
+                (unsigned long long)Count);
+        if(Bytes>0)
+            printf(" %10.4f/byte",(double)Count/Bytes);
+        printf("\n");
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_ReportLatency
+ *
+ * SYNOPSIS:
+ *    static void PH_ReportLatency(std::vector<uint32_t> &Latency);
+ *
+ * PARAMETERS:
+ *    Latency [I/O] -- The time each call took in ns.  This is sorted.
+ *
+ * FUNCTION:
+ *    This function prints the average, median, 99th percentile and worst
+ *    time of the calls in to the plugin.  The times include the host
+ *    functions the plugin called.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void PH_ReportLatency(std::vector<uint32_t> &Latency)
+{
+    uint64_t Total;
+    size_t r;
+
+    if(Latency.empty())
+        return;
+
+    Total=0;
+    for(r=0;r<Latency.size();r++)
+        Total+=Latency[r];
+
+    std::sort(Latency.begin(),Latency.end());
+
+    printf("Call latency (ns): avg %.1f, p50 %u, p99 %u, max %u\n",
+            (double)Total/Latency.size(),Latency[Latency.size()/2],
+            Latency[(Latency.size()*99)/100],Latency.back());
+}
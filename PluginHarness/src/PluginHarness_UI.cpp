@@ -0,0 +1,833 @@
+/*******************************************************************************
+ * FILENAME: PluginHarness_UI.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has a PI_UIAPI that doesn't show anything.  The widgets are
+ *    allocated and remember what was set in them, so a plugin's settings
+ *    widgets can be allocated, read back, and freed like the settings
+ *    dialog does.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "PluginHarness_UI.h"
+#include "PluginHarness_Host.h"
+#include <string>
+
+/*** DEFINES                  ***/
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+/* What every control is behind its Ctrl pointer */
+struct PH_UICtrl
+{
+    uintptr_t Selected;
+    int64_t Number;
+    double Double;
+    bool Checked;
+    uint32_t RGB;
+    std::string Text;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static struct PH_UICtrl *PH_UI_NewCtrl(void);
+static void PH_UI_FreeCtrl(void *Ctrl);
+
+static struct PI_ComboBox *PH_UI_AddComboBox(t_WidgetSysHandle *WidgetHandle,PG_BOOL UserEditable,const char *Label,void (*EventCB)(const struct PICBEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeComboBox(t_WidgetSysHandle *WidgetHandle,struct PI_ComboBox *UICtrl);
+static void PH_UI_ClearComboBox(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox);
+static void PH_UI_AddItem2ComboBox(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox,const char *Label,uintptr_t ID);
+static void PH_UI_SetComboBoxSelectedEntry(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox,uintptr_t ID);
+static uintptr_t PH_UI_GetComboBoxSelectedEntry(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox);
+static const char *PH_UI_GetComboBoxText(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox);
+static void PH_UI_SetComboBoxText(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox,const char *Txt);
+static void PH_UI_EnableComboBox(t_WidgetSysHandle *WidgetHandle,t_PIUIComboBoxCtrl *ComboBox,PG_BOOL Enabled);
+static struct PI_RadioBttnGroup *PH_UI_AllocRadioBttnGroup(t_WidgetSysHandle *WidgetHandle,const char *Label);
+static void PH_UI_FreeRadioBttnGroup(t_WidgetSysHandle *WidgetHandle,struct PI_RadioBttnGroup *UICtrl);
+static struct PI_RadioBttn *PH_UI_AddRadioBttn(t_WidgetSysHandle *WidgetHandle,struct PI_RadioBttnGroup *RBGroup,const char *Label,void (*EventCB)(const struct PIRBEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeRadioBttn(t_WidgetSysHandle *WidgetHandle,struct PI_RadioBttn *UICtrl);
+static PG_BOOL PH_UI_IsRadioBttnChecked(t_WidgetSysHandle *WidgetHandle,struct PI_RadioBttn *Bttn);
+static void PH_UI_SetRadioBttnChecked(t_WidgetSysHandle *WidgetHandle,struct PI_RadioBttn *Bttn,PG_BOOL Checked);
+static void PH_UI_EnableRadioBttn(t_WidgetSysHandle *WidgetHandle,struct PI_RadioBttn *Bttn,PG_BOOL Enabled);
+static struct PI_Checkbox *PH_UI_AddCheckbox(t_WidgetSysHandle *WidgetHandle,const char *Label,void (*EventCB)(const struct PICheckboxEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeCheckbox(t_WidgetSysHandle *WidgetHandle,struct PI_Checkbox *UICtrl);
+static PG_BOOL PH_UI_IsCheckboxChecked(t_WidgetSysHandle *WidgetHandle,t_PIUICheckboxCtrl *Bttn);
+static void PH_UI_SetCheckboxChecked(t_WidgetSysHandle *WidgetHandle,t_PIUICheckboxCtrl *Bttn,PG_BOOL Checked);
+static void PH_UI_EnableCheckbox(t_WidgetSysHandle *WidgetHandle,t_PIUICheckboxCtrl *Bttn,PG_BOOL Enabled);
+static struct PI_TextInput *PH_UI_AddTextInput(t_WidgetSysHandle *WidgetHandle,const char *Label,void (*EventCB)(const struct PICBEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeTextInput(t_WidgetSysHandle *WidgetHandle,struct PI_TextInput *UICtrl);
+static const char *PH_UI_GetTextInputText(t_WidgetSysHandle *WidgetHandle,t_PIUITextInputCtrl *TextInput);
+static void PH_UI_SetTextInputText(t_WidgetSysHandle *WidgetHandle,t_PIUITextInputCtrl *TextInput,const char *Txt);
+static void PH_UI_EnableTextInput(t_WidgetSysHandle *WidgetHandle,t_PIUITextInputCtrl *TextInput,PG_BOOL Enabled);
+static struct PI_NumberInput *PH_UI_AddNumberInput(t_WidgetSysHandle *WidgetHandle,const char *Label,void (*EventCB)(const struct PICBEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeNumberInput(t_WidgetSysHandle *WidgetHandle,struct PI_NumberInput *UICtrl);
+static uint64_t PH_UI_GetNumberInputValue(t_WidgetSysHandle *WidgetHandle,t_PIUINumberInputCtrl *NumberInput);
+static void PH_UI_SetNumberInputValue(t_WidgetSysHandle *WidgetHandle,t_PIUINumberInputCtrl *NumberInput,int64_t Value);
+static void PH_UI_SetNumberInputMinMax(t_WidgetSysHandle *WidgetHandle,t_PIUINumberInputCtrl *NumberInput,int64_t Min,int64_t Max);
+static void PH_UI_EnableNumberInput(t_WidgetSysHandle *WidgetHandle,t_PIUINumberInputCtrl *NumberInput,PG_BOOL Enabled);
+static struct PI_DoubleInput *PH_UI_AddDoubleInput(t_WidgetSysHandle *WidgetHandle,const char *Label,void (*EventCB)(const struct PICBEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeDoubleInput(t_WidgetSysHandle *WidgetHandle,struct PI_DoubleInput *UICtrl);
+static double PH_UI_GetDoubleInputValue(t_WidgetSysHandle *WidgetHandle,t_PIUIDoubleInputCtrl *DoubleInput);
+static void PH_UI_SetDoubleInputValue(t_WidgetSysHandle *WidgetHandle,t_PIUIDoubleInputCtrl *DoubleInput,double Value);
+static void PH_UI_SetDoubleInputMinMax(t_WidgetSysHandle *WidgetHandle,t_PIUIDoubleInputCtrl *DoubleInput,double Min,double Max);
+static void PH_UI_SetDoubleInputDecimals(t_WidgetSysHandle *WidgetHandle,t_PIUIDoubleInputCtrl *DoubleInput,int Points);
+static void PH_UI_EnableDoubleInput(t_WidgetSysHandle *WidgetHandle,t_PIUIDoubleInputCtrl *DoubleInput,PG_BOOL Enabled);
+static struct PI_ColumnViewInput *PH_UI_AddColumnViewInput(t_WidgetSysHandle *WidgetHandle,const char *Label,int Columns,const char *ColumnNames[],void (*EventCB)(const struct PICVEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeColumnViewInput(t_WidgetSysHandle *WidgetHandle,struct PI_ColumnViewInput *UICtrl);
+static void PH_UI_ColumnViewInputClear(t_WidgetSysHandle *WidgetHandle,t_PIUIColumnViewInputCtrl *UICtrl);
+static void PH_UI_ColumnViewInputRemoveRow(t_WidgetSysHandle *WidgetHandle,t_PIUIColumnViewInputCtrl *UICtrl,int Row);
+static int PH_UI_ColumnViewInputAddRow(t_WidgetSysHandle *WidgetHandle,t_PIUIColumnViewInputCtrl *UICtrl);
+static void PH_UI_ColumnViewInputSetColumnText(t_WidgetSysHandle *WidgetHandle,t_PIUIColumnViewInputCtrl *UICtrl,int Column,int Row,const char *Str);
+static void PH_UI_ColumnViewInputSelectRow(t_WidgetSysHandle *WidgetHandle,t_PIUIColumnViewInputCtrl *UICtrl,int Row);
+static void PH_UI_ColumnViewInputClearSelection(t_WidgetSysHandle *WidgetHandle,t_PIUIColumnViewInputCtrl *UICtrl);
+static struct PI_ButtonInput *PH_UI_AddButtonInput(t_WidgetSysHandle *WidgetHandle,const char *Label,void (*EventCB)(const struct PIButtonEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeButtonInput(t_WidgetSysHandle *WidgetHandle,struct PI_ButtonInput *UICtrl);
+static struct PI_Indicator *PH_UI_AddIndicator(t_WidgetSysHandle *WidgetHandle,const char *Label);
+static void PH_UI_FreeIndicator(t_WidgetSysHandle *WidgetHandle,struct PI_Indicator *UICtrl);
+static void PH_UI_SetIndicator(t_WidgetSysHandle *WidgetHandle,t_PIUIIndicatorCtrl *UICtrl,bool On);
+static int PH_UI_Ask(const char *Message,int Type);
+static PG_BOOL PH_UI_FileReq(e_FileReqTypeType Req,const char *Title,char **Path,char **Filename,const char *Filters,int SelectedFilter);
+static void PH_UI_FreeFileReqPathAndFile(char **Path,char **Filename);
+static struct PI_TextBox *PH_UI_AddTextBox(t_WidgetSysHandle *WidgetHandle,const char *Label,const char *Text);
+static void PH_UI_FreeTextBox(t_WidgetSysHandle *WidgetHandle,struct PI_TextBox *BoxHandle);
+static void PH_UI_SetTextBox(t_WidgetSysHandle *WidgetHandle,t_PIUITextBoxCtrl *UICtrl,const char *Text);
+static struct PI_GroupBox *PH_UI_AddGroupBox(t_WidgetSysHandle *WidgetHandle,const char *Label);
+static void PH_UI_FreeGroupBox(t_WidgetSysHandle *WidgetHandle,struct PI_GroupBox *BoxHandle);
+static void PH_UI_SetGroupBoxLabel(t_WidgetSysHandle *WidgetHandle,t_PIUIGroupBoxCtrl *UICtrl,const char *Label);
+static struct PI_ColorPick *PH_UI_AddColorPick(t_WidgetSysHandle *WidgetHandle,const char *Label,uint32_t RGB,void (*EventCB)(const struct PIColorPickEvent *Event,void *UserData),void *UserData);
+static void PH_UI_FreeColorPick(t_WidgetSysHandle *WidgetHandle,struct PI_ColorPick *Handle);
+static uint32_t PH_UI_GetColorPickValue(t_WidgetSysHandle *WidgetHandle,t_PIUIColorPickCtrl *UICtrl);
+static void PH_UI_SetColorPickValue(t_WidgetSysHandle *WidgetHandle,t_PIUIColorPickCtrl *UICtrl,uint32_t RGB);
+
+/*** VARIABLE DEFINITIONS     ***/
+static const struct PI_UIAPI m_PH_UIAPI=
+{
+    PH_UI_AddComboBox,
+    PH_UI_FreeComboBox,
+    PH_UI_ClearComboBox,
+    PH_UI_AddItem2ComboBox,
+    PH_UI_SetComboBoxSelectedEntry,
+    PH_UI_GetComboBoxSelectedEntry,
+    PH_UI_GetComboBoxText,
+    PH_UI_SetComboBoxText,
+    PH_UI_EnableComboBox,
+    PH_UI_AllocRadioBttnGroup,
+    PH_UI_FreeRadioBttnGroup,
+    PH_UI_AddRadioBttn,
+    PH_UI_FreeRadioBttn,
+    PH_UI_IsRadioBttnChecked,
+    PH_UI_SetRadioBttnChecked,
+    PH_UI_EnableRadioBttn,
+    PH_UI_AddCheckbox,
+    PH_UI_FreeCheckbox,
+    PH_UI_IsCheckboxChecked,
+    PH_UI_SetCheckboxChecked,
+    PH_UI_EnableCheckbox,
+    PH_UI_AddTextInput,
+    PH_UI_FreeTextInput,
+    PH_UI_GetTextInputText,
+    PH_UI_SetTextInputText,
+    PH_UI_EnableTextInput,
+    PH_UI_AddNumberInput,
+    PH_UI_FreeNumberInput,
+    PH_UI_GetNumberInputValue,
+    PH_UI_SetNumberInputValue,
+    PH_UI_SetNumberInputMinMax,
+    PH_UI_EnableNumberInput,
+    PH_UI_AddDoubleInput,
+    PH_UI_FreeDoubleInput,
+    PH_UI_GetDoubleInputValue,
+    PH_UI_SetDoubleInputValue,
+    PH_UI_SetDoubleInputMinMax,
+    PH_UI_SetDoubleInputDecimals,
+    PH_UI_EnableDoubleInput,
+    PH_UI_AddColumnViewInput,
+    PH_UI_FreeColumnViewInput,
+    PH_UI_ColumnViewInputClear,
+    PH_UI_ColumnViewInputRemoveRow,
+    PH_UI_ColumnViewInputAddRow,
+    PH_UI_ColumnViewInputSetColumnText,
+    PH_UI_ColumnViewInputSelectRow,
+    PH_UI_ColumnViewInputClearSelection,
+    PH_UI_AddButtonInput,
+    PH_UI_FreeButtonInput,
+    PH_UI_AddIndicator,
+    PH_UI_FreeIndicator,
+    PH_UI_SetIndicator,
+    PH_UI_Ask,
+    /* V2 */
+    PH_UI_FileReq,
+    PH_UI_FreeFileReqPathAndFile,
+    PH_UI_AddTextBox,
+    PH_UI_FreeTextBox,
+    PH_UI_SetTextBox,
+    PH_UI_AddGroupBox,
+    PH_UI_FreeGroupBox,
+    PH_UI_SetGroupBoxLabel,
+    PH_UI_AddColorPick,
+    PH_UI_FreeColorPick,
+    PH_UI_GetColorPickValue,
+    PH_UI_SetColorPickValue,
+};
+
+/* All the settings tabs are the same fake handle */
+static struct WidgetSysHandle m_PH_WidgetHandle;
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_GetUIAPI
+ *
+ * SYNOPSIS:
+ *    const struct PI_UIAPI *PluginHarness_GetUIAPI(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function gets the UI API we give to plugins.
+ *
+ * RETURNS:
+ *    A pointer to the UI API.
+ ******************************************************************************/
+const struct PI_UIAPI *PluginHarness_GetUIAPI(void)
+{
+    return &m_PH_UIAPI;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PluginHarness_GetWidgetHandle
+ *
+ * SYNOPSIS:
+ *    t_WidgetSysHandle *PluginHarness_GetWidgetHandle(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function gets the widget handle to give to the plugin for a
+ *    settings tab or the connection options.
+ *
+ * RETURNS:
+ *    The widget handle.
+ ******************************************************************************/
+t_WidgetSysHandle *PluginHarness_GetWidgetHandle(void)
+{
+    return &m_PH_WidgetHandle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************************
+ * NAME:
+ *    PH_UI_NewCtrl
+ *
+ * SYNOPSIS:
+ *    static struct PH_UICtrl *PH_UI_NewCtrl(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function allocates the storage behind a control and counts the
+ *    UI call.
+ *
+ * RETURNS:
+ *    The new control.
+ ******************************************************************************/
+static struct PH_UICtrl *PH_UI_NewCtrl(void)
+{
+    struct PH_UICtrl *Ctrl;
+
+    PluginHarness_CountCall(e_PHCall_UI);
+
+    Ctrl=new struct PH_UICtrl;
+    Ctrl->Selected=0;
+    Ctrl->Number=0;
+    Ctrl->Double=0;
+    Ctrl->Checked=false;
+    Ctrl->RGB=0;
+    return Ctrl;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    PH_UI_FreeCtrl
+ *
+ * SYNOPSIS:
+ *    static void PH_UI_FreeCtrl(void *Ctrl);
+ *
+ * PARAMETERS:
+ *    Ctrl [I] -- The control to free (the 'Ctrl' from the PI_xxx struct)
+ *
+ * FUNCTION:
+ *    This function frees a control allocated with PH_UI_NewCtrl().
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void PH_UI_FreeCtrl(void *Ctrl)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    delete (struct PH_UICtrl *)Ctrl;
+}
+
+/* Combobox */
+static struct PI_ComboBox *PH_UI_AddComboBox(t_WidgetSysHandle *WidgetHandle,
+        PG_BOOL UserEditable,const char *Label,
+        void (*EventCB)(const struct PICBEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_ComboBox *UICtrl;
+
+    UICtrl=new struct PI_ComboBox;
+    UICtrl->Ctrl=(t_PIUIComboBoxCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeComboBox(t_WidgetSysHandle *WidgetHandle,
+        struct PI_ComboBox *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static void PH_UI_ClearComboBox(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_AddItem2ComboBox(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox,const char *Label,uintptr_t ID)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_SetComboBoxSelectedEntry(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox,uintptr_t ID)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)ComboBox)->Selected=ID;
+}
+
+static uintptr_t PH_UI_GetComboBoxSelectedEntry(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)ComboBox)->Selected;
+}
+
+static const char *PH_UI_GetComboBoxText(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)ComboBox)->Text.c_str();
+}
+
+static void PH_UI_SetComboBoxText(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox,const char *Txt)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)ComboBox)->Text=Txt;
+}
+
+static void PH_UI_EnableComboBox(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIComboBoxCtrl *ComboBox,PG_BOOL Enabled)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Radio buttons */
+static struct PI_RadioBttnGroup *PH_UI_AllocRadioBttnGroup(
+        t_WidgetSysHandle *WidgetHandle,const char *Label)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return new struct PI_RadioBttnGroup;
+}
+
+static void PH_UI_FreeRadioBttnGroup(t_WidgetSysHandle *WidgetHandle,
+        struct PI_RadioBttnGroup *UICtrl)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    delete UICtrl;
+}
+
+static struct PI_RadioBttn *PH_UI_AddRadioBttn(t_WidgetSysHandle *WidgetHandle,
+        struct PI_RadioBttnGroup *RBGroup,const char *Label,
+        void (*EventCB)(const struct PIRBEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_RadioBttn *UICtrl;
+
+    UICtrl=new struct PI_RadioBttn;
+    UICtrl->Ctrl=(t_PIUIRadioBttnCtrl *)PH_UI_NewCtrl();
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeRadioBttn(t_WidgetSysHandle *WidgetHandle,
+        struct PI_RadioBttn *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static PG_BOOL PH_UI_IsRadioBttnChecked(t_WidgetSysHandle *WidgetHandle,
+        struct PI_RadioBttn *Bttn)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)Bttn->Ctrl)->Checked;
+}
+
+static void PH_UI_SetRadioBttnChecked(t_WidgetSysHandle *WidgetHandle,
+        struct PI_RadioBttn *Bttn,PG_BOOL Checked)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)Bttn->Ctrl)->Checked=Checked;
+}
+
+static void PH_UI_EnableRadioBttn(t_WidgetSysHandle *WidgetHandle,
+        struct PI_RadioBttn *Bttn,PG_BOOL Enabled)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Checkbox */
+static struct PI_Checkbox *PH_UI_AddCheckbox(t_WidgetSysHandle *WidgetHandle,
+        const char *Label,
+        void (*EventCB)(const struct PICheckboxEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_Checkbox *UICtrl;
+
+    UICtrl=new struct PI_Checkbox;
+    UICtrl->Ctrl=(t_PIUICheckboxCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeCheckbox(t_WidgetSysHandle *WidgetHandle,
+        struct PI_Checkbox *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static PG_BOOL PH_UI_IsCheckboxChecked(t_WidgetSysHandle *WidgetHandle,
+        t_PIUICheckboxCtrl *Bttn)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)Bttn)->Checked;
+}
+
+static void PH_UI_SetCheckboxChecked(t_WidgetSysHandle *WidgetHandle,
+        t_PIUICheckboxCtrl *Bttn,PG_BOOL Checked)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)Bttn)->Checked=Checked;
+}
+
+static void PH_UI_EnableCheckbox(t_WidgetSysHandle *WidgetHandle,
+        t_PIUICheckboxCtrl *Bttn,PG_BOOL Enabled)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Text input */
+static struct PI_TextInput *PH_UI_AddTextInput(t_WidgetSysHandle *WidgetHandle,
+        const char *Label,
+        void (*EventCB)(const struct PICBEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_TextInput *UICtrl;
+
+    UICtrl=new struct PI_TextInput;
+    UICtrl->Ctrl=(t_PIUITextInputCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeTextInput(t_WidgetSysHandle *WidgetHandle,
+        struct PI_TextInput *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static const char *PH_UI_GetTextInputText(t_WidgetSysHandle *WidgetHandle,
+        t_PIUITextInputCtrl *TextInput)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)TextInput)->Text.c_str();
+}
+
+static void PH_UI_SetTextInputText(t_WidgetSysHandle *WidgetHandle,
+        t_PIUITextInputCtrl *TextInput,const char *Txt)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)TextInput)->Text=Txt;
+}
+
+static void PH_UI_EnableTextInput(t_WidgetSysHandle *WidgetHandle,
+        t_PIUITextInputCtrl *TextInput,PG_BOOL Enabled)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Number input */
+static struct PI_NumberInput *PH_UI_AddNumberInput(
+        t_WidgetSysHandle *WidgetHandle,const char *Label,
+        void (*EventCB)(const struct PICBEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_NumberInput *UICtrl;
+
+    UICtrl=new struct PI_NumberInput;
+    UICtrl->Ctrl=(t_PIUINumberInputCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeNumberInput(t_WidgetSysHandle *WidgetHandle,
+        struct PI_NumberInput *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static uint64_t PH_UI_GetNumberInputValue(t_WidgetSysHandle *WidgetHandle,
+        t_PIUINumberInputCtrl *NumberInput)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)NumberInput)->Number;
+}
+
+static void PH_UI_SetNumberInputValue(t_WidgetSysHandle *WidgetHandle,
+        t_PIUINumberInputCtrl *NumberInput,int64_t Value)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)NumberInput)->Number=Value;
+}
+
+static void PH_UI_SetNumberInputMinMax(t_WidgetSysHandle *WidgetHandle,
+        t_PIUINumberInputCtrl *NumberInput,int64_t Min,int64_t Max)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_EnableNumberInput(t_WidgetSysHandle *WidgetHandle,
+        t_PIUINumberInputCtrl *NumberInput,PG_BOOL Enabled)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Double input */
+static struct PI_DoubleInput *PH_UI_AddDoubleInput(
+        t_WidgetSysHandle *WidgetHandle,const char *Label,
+        void (*EventCB)(const struct PICBEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_DoubleInput *UICtrl;
+
+    UICtrl=new struct PI_DoubleInput;
+    UICtrl->Ctrl=(t_PIUIDoubleInputCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeDoubleInput(t_WidgetSysHandle *WidgetHandle,
+        struct PI_DoubleInput *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static double PH_UI_GetDoubleInputValue(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIDoubleInputCtrl *DoubleInput)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)DoubleInput)->Double;
+}
+
+static void PH_UI_SetDoubleInputValue(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIDoubleInputCtrl *DoubleInput,double Value)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)DoubleInput)->Double=Value;
+}
+
+static void PH_UI_SetDoubleInputMinMax(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIDoubleInputCtrl *DoubleInput,double Min,double Max)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_SetDoubleInputDecimals(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIDoubleInputCtrl *DoubleInput,int Points)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_EnableDoubleInput(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIDoubleInputCtrl *DoubleInput,PG_BOOL Enabled)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Column view */
+static struct PI_ColumnViewInput *PH_UI_AddColumnViewInput(
+        t_WidgetSysHandle *WidgetHandle,const char *Label,int Columns,
+        const char *ColumnNames[],
+        void (*EventCB)(const struct PICVEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_ColumnViewInput *UICtrl;
+
+    UICtrl=new struct PI_ColumnViewInput;
+    UICtrl->Ctrl=(t_PIUIColumnViewInputCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeColumnViewInput(t_WidgetSysHandle *WidgetHandle,
+        struct PI_ColumnViewInput *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static void PH_UI_ColumnViewInputClear(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColumnViewInputCtrl *UICtrl)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)UICtrl)->Number=0;
+}
+
+static void PH_UI_ColumnViewInputRemoveRow(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColumnViewInputCtrl *UICtrl,int Row)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    if(((struct PH_UICtrl *)UICtrl)->Number>0)
+        ((struct PH_UICtrl *)UICtrl)->Number--;
+}
+
+static int PH_UI_ColumnViewInputAddRow(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColumnViewInputCtrl *UICtrl)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)UICtrl)->Number++;
+}
+
+static void PH_UI_ColumnViewInputSetColumnText(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColumnViewInputCtrl *UICtrl,int Column,int Row,const char *Str)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_ColumnViewInputSelectRow(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColumnViewInputCtrl *UICtrl,int Row)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+static void PH_UI_ColumnViewInputClearSelection(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColumnViewInputCtrl *UICtrl)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Button */
+static struct PI_ButtonInput *PH_UI_AddButtonInput(
+        t_WidgetSysHandle *WidgetHandle,const char *Label,
+        void (*EventCB)(const struct PIButtonEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_ButtonInput *UICtrl;
+
+    UICtrl=new struct PI_ButtonInput;
+    UICtrl->Ctrl=(t_PIUIButtonInputCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeButtonInput(t_WidgetSysHandle *WidgetHandle,
+        struct PI_ButtonInput *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+/* Indicator */
+static struct PI_Indicator *PH_UI_AddIndicator(t_WidgetSysHandle *WidgetHandle,
+        const char *Label)
+{
+    struct PI_Indicator *UICtrl;
+
+    UICtrl=new struct PI_Indicator;
+    UICtrl->Ctrl=(t_PIUIIndicatorCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeIndicator(t_WidgetSysHandle *WidgetHandle,
+        struct PI_Indicator *UICtrl)
+{
+    PH_UI_FreeCtrl(UICtrl->Ctrl);
+    delete UICtrl;
+}
+
+static void PH_UI_SetIndicator(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIIndicatorCtrl *UICtrl,bool On)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)UICtrl)->Checked=On;
+}
+
+/* Ask (there is no one to ask, so it's always the first button) */
+static int PH_UI_Ask(const char *Message,int Type)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return 0;
+}
+
+/* File requester (always canceled) */
+static PG_BOOL PH_UI_FileReq(e_FileReqTypeType Req,const char *Title,
+        char **Path,char **Filename,const char *Filters,int SelectedFilter)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    *Path=NULL;
+    *Filename=NULL;
+    return false;
+}
+
+static void PH_UI_FreeFileReqPathAndFile(char **Path,char **Filename)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Text box */
+static struct PI_TextBox *PH_UI_AddTextBox(t_WidgetSysHandle *WidgetHandle,
+        const char *Label,const char *Text)
+{
+    struct PI_TextBox *UICtrl;
+
+    UICtrl=new struct PI_TextBox;
+    UICtrl->Ctrl=(t_PIUITextBoxCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeTextBox(t_WidgetSysHandle *WidgetHandle,
+        struct PI_TextBox *BoxHandle)
+{
+    PH_UI_FreeCtrl(BoxHandle->Ctrl);
+    delete BoxHandle;
+}
+
+static void PH_UI_SetTextBox(t_WidgetSysHandle *WidgetHandle,
+        t_PIUITextBoxCtrl *UICtrl,const char *Text)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Group box */
+static struct PI_GroupBox *PH_UI_AddGroupBox(t_WidgetSysHandle *WidgetHandle,
+        const char *Label)
+{
+    struct PI_GroupBox *UICtrl;
+
+    UICtrl=new struct PI_GroupBox;
+    UICtrl->Ctrl=(t_PIUIGroupBoxCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->GroupWidgetHandle=&m_PH_WidgetHandle;
+    UICtrl->UIData=NULL;
+    return UICtrl;
+}
+
+static void PH_UI_FreeGroupBox(t_WidgetSysHandle *WidgetHandle,
+        struct PI_GroupBox *BoxHandle)
+{
+    PH_UI_FreeCtrl(BoxHandle->Ctrl);
+    delete BoxHandle;
+}
+
+static void PH_UI_SetGroupBoxLabel(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIGroupBoxCtrl *UICtrl,const char *Label)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+}
+
+/* Color pick */
+static struct PI_ColorPick *PH_UI_AddColorPick(t_WidgetSysHandle *WidgetHandle,
+        const char *Label,uint32_t RGB,
+        void (*EventCB)(const struct PIColorPickEvent *Event,void *UserData),
+        void *UserData)
+{
+    struct PI_ColorPick *UICtrl;
+
+    UICtrl=new struct PI_ColorPick;
+    UICtrl->Ctrl=(t_PIUIColorPickCtrl *)PH_UI_NewCtrl();
+    UICtrl->Label=NULL;
+    UICtrl->UIData=NULL;
+    ((struct PH_UICtrl *)UICtrl->Ctrl)->RGB=RGB;
+    return UICtrl;
+}
+
+static void PH_UI_FreeColorPick(t_WidgetSysHandle *WidgetHandle,
+        struct PI_ColorPick *Handle)
+{
+    PH_UI_FreeCtrl(Handle->Ctrl);
+    delete Handle;
+}
+
+static uint32_t PH_UI_GetColorPickValue(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColorPickCtrl *UICtrl)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    return ((struct PH_UICtrl *)UICtrl)->RGB;
+}
+
+static void PH_UI_SetColorPickValue(t_WidgetSysHandle *WidgetHandle,
+        t_PIUIColorPickCtrl *UICtrl,uint32_t RGB)
+{
+    PluginHarness_CountCall(e_PHCall_UI);
+    ((struct PH_UICtrl *)UICtrl)->RGB=RGB;
+}
@@ -31,6 +31,9 @@
 
 /*** HEADER FILES TO INCLUDE  ***/
 #include "RxTxBinaryDisplay.h"
+#include "RxTxBinaryDisplay_Decoder.h"
+#include "RxTxBinaryDisplay_Stats.h"
+#include "RxTxBinaryDisplay_Capture.h"
 #include "PluginSDK/Plugin.h"
 #include <string.h>
 #include <stdlib.h>
@@ -40,9 +43,22 @@
 #define REGISTER_PLUGIN_FUNCTION_PRIV_NAME      RxTxBinaryDisplay // The name to append on the RegisterPlugin() function for built in version
 #define NEEDED_MIN_API_VERSION                  0x01010000
 
+#define RTBD_COLLAPSE_MAX_PATTERN               4       // Longest repeating pattern we look for
+#define RTBD_COLLAPSE_MIN_MIN_RUN               (RTBD_COLLAPSE_MAX_PATTERN*2)
+#define RTBD_COLLAPSE_MAX_MIN_RUN               1024
+#define RTBD_COLLAPSE_DEFAULT_MIN_RUN           16
+
 /*** MACROS                   ***/
 
 /*** TYPE DEFINITIONS         ***/
+typedef enum
+{
+    e_RTBD_Dir_None,            // We don't know what style is set
+    e_RTBD_Dir_Rx,
+    e_RTBD_Dir_Tx,
+    e_RTBD_DirMAX
+} e_RTBD_DirType;
+
 struct RxTxBinaryDisplay_TextStyle
 {
     uint32_t FGColor;
@@ -50,10 +66,36 @@ struct RxTxBinaryDisplay_TextStyle
     uint32_t Attribs;
 };
 
+struct RxTxBinaryDisplay_Collapse
+{
+    e_RTBD_DirType Dir;         // The direction the held bytes / run are for
+    uint32_t MinRun;            // Runs have to be this long to be collapsed
+    uint8_t Pattern[RTBD_COLLAPSE_MAX_PATTERN];
+    unsigned int PatternLen;    // 0 if we are not in a run
+    unsigned int Phase;         // Where in 'Pattern' the next byte should be
+    uint32_t RunLen;            // Bytes in the run so far
+    bool NoteShown;             // The start of the run's note is on the screen
+    /* The length of the end of 'Held' that repeats every [x] bytes */
+    uint32_t Periodic[RTBD_COLLAPSE_MAX_PATTERN+1];
+    uint32_t HeldLen;
+    uint32_t ShownLen;          // The first bytes in 'Held' have been shown
+    /* Bytes that haven't been sent to the screen yet (and the last few
+       shown bytes so a run can be found even if it comes in one byte at a
+       time) */
+    uint8_t Held[RTBD_COLLAPSE_MAX_MIN_RUN+RTBD_COLLAPSE_MAX_PATTERN];
+};
+
 struct RxTxBinaryDisplayData
 {
     struct RxTxBinaryDisplay_TextStyle RxStyle;
     struct RxTxBinaryDisplay_TextStyle TxStyle;
+    e_RTBD_DirType CurrentDir;  // The style that was last sent
+    struct RxTxBinaryDisplayDecoder Decoder;    // Only used for Rx
+    bool CollapseRuns;
+    struct RxTxBinaryDisplay_Collapse Collapse;
+    t_RTBDCaptureType *Capture;
+    char *CaptureFilename;      // malloc()'ed, NULL if not capturing
+    t_RTBDStatsType *Stats;
 };
 
 struct SettingsStylingWidgetsSet
@@ -73,8 +115,27 @@ struct SettingsWidgets
     t_WidgetSysHandle *RxTabHandle;
     t_WidgetSysHandle *TxTabHandle;
 
+    t_WidgetSysHandle *DecoderTabHandle;
+    t_WidgetSysHandle *RepeatsTabHandle;
+    t_WidgetSysHandle *StatsTabHandle;
+    t_WidgetSysHandle *CaptureTabHandle;
+
     struct SettingsStylingWidgetsSet RxStyles;
     struct SettingsStylingWidgetsSet TxStyles;
+
+    struct PI_ComboBox *DecoderType;
+    struct PI_ComboBox *PrefixSize;
+    struct PI_Checkbox *PrefixBigEndian;
+
+    struct PI_Checkbox *CollapseRuns;
+    struct PI_NumberInput *CollapseMinRun;
+
+    struct PI_Indicator *RxActive;
+    struct PI_Indicator *TxActive;
+    struct PI_ColumnViewInput *StatsView;
+
+    struct PI_Checkbox *CaptureEnabled;
+    struct PI_TextInput *CaptureFilename;
 };
 
 /*** FUNCTION PROTOTYPES      ***/
@@ -82,6 +143,8 @@ const struct DataProcessorInfo *RxTxBinaryDisplay_GetProcessorInfo(
         unsigned int *SizeOfInfo);
 static void RxTxBinaryDisplay_ProcessIncomingBinaryByte(
         t_DataProcessorHandleType *DataHandle,const uint8_t Byte);
+static void RxTxBinaryDisplay_ProcessIncomingBinaryBlock(
+        t_DataProcessorHandleType *DataHandle,const uint8_t *RxData,int Bytes);
 static void RxTxBinaryDisplay_ProcessOutGoingData(t_DataProcessorHandleType *DataHandle,
         const uint8_t *Data,int Bytes);
 static t_DataProSettingsWidgetsType *RxTxBinaryDisplay_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
@@ -110,6 +173,26 @@ static void RxTxBinaryDisplay_FreeData(t_DataProcessorHandleType *DataHandle);
 static void RxTxBinaryDisplay_ApplySetting_SetData(t_PIKVList *Settings,
         struct RxTxBinaryDisplay_TextStyle *Style,const char *Prefix,
         uint32_t DefaultFG,uint32_t DefaultBG);
+static void RxTxBinaryDisplay_SelectStyle(struct RxTxBinaryDisplayData *Data,
+        e_RTBD_DirType Dir);
+static void RxTxBinaryDisplay_AddHexBlock(const uint8_t *Bytes,int Len);
+static void RxTxBinaryDisplay_DecodeRx(struct RxTxBinaryDisplayData *Data,
+        const uint8_t *RxData,uint32_t Bytes);
+static void RxTxBinaryDisplay_ShowFrame(struct RxTxBinaryDisplayData *Data,
+        const struct RxTxBinaryDisplayFrame *Frame);
+static void RxTxBinaryDisplay_ShowHex(struct RxTxBinaryDisplayData *Data,
+        e_RTBD_DirType Dir,const uint8_t *Bytes,uint32_t Len);
+static void RxTxBinaryDisplay_ResetCollapse(struct RxTxBinaryDisplayData *Data,
+        uint32_t MinRun);
+static void RxTxBinaryDisplay_CollapseAddByte(struct RxTxBinaryDisplayData *Data,
+        uint8_t Byte);
+static void RxTxBinaryDisplay_CollapseRelease(struct RxTxBinaryDisplayData *Data);
+static void RxTxBinaryDisplay_CollapseStartNote(struct RxTxBinaryDisplayData *Data);
+static void RxTxBinaryDisplay_CollapseEndRun(struct RxTxBinaryDisplayData *Data);
+static void RxTxBinaryDisplay_CollapseFlush(struct RxTxBinaryDisplayData *Data);
+static uint32_t RxTxBinaryDisplay_ClampMinRun(uint32_t MinRun);
+static void RxTxBinaryDisplay_FillStatsWidgets(struct SettingsWidgets *WData);
+static void RxTxBinaryDisplay_FormatRate(char *buff,double Rate);
 
 /*** VARIABLE DEFINITIONS     ***/
 struct DataProcessorAPI m_RxTxBinaryDisplayCBs=
@@ -126,6 +209,9 @@ struct DataProcessorAPI m_RxTxBinaryDisplayCBs=
     RxTxBinaryDisplay_FreeSettingsWidgets,
     RxTxBinaryDisplay_SetSettingsFromWidgets,
     RxTxBinaryDisplay_ApplySettings,
+    /* V4 */
+    NULL,                                   // ProcessIncomingTextBlock
+    RxTxBinaryDisplay_ProcessIncomingBinaryBlock,   // ProcessIncomingBinaryBlock
 };
 
 struct DataProcessorInfo m_RxTxBinaryDisplay_Info=
@@ -143,6 +229,51 @@ struct DataProcessorInfo m_RxTxBinaryDisplay_Info=
 static const struct PI_SystemAPI *m_RTBD_SysAPI;
 static const struct DPS_API *m_RTBD_DPS;
 static const struct PI_UIAPI *m_RTBD_UIAPI;
+static bool m_RTBD_HasBinaryAddHexBlock;
+
+static const char *m_RTBD_DecoderNames[e_RTBDDecoderMAX]=
+{
+    "None (raw hex)",
+    "SLIP",
+    "COBS",
+    "HDLC (CRC-16/CCITT)",
+    "Length prefixed",
+};
+
+static const char *m_RTBD_StatsColumns[]=
+{
+    "",
+    "Incoming (Rx)",
+    "Outgoing (Tx)",
+};
+
+static const char *m_RTBD_StatsRows[]=
+{
+    "Total bytes",
+    "Rate (1 sec)",
+    "Rate (10 sec)",
+    "Rate (60 sec)",
+    "Largest burst",
+    "Last gap between bursts",
+    "Shortest gap between bursts",
+    "Dropped from capture",
+};
+
+static const char *m_RTBD_CaptureStateNames[e_RTBDStatsCaptureMAX]=
+{
+    "",
+    " (capturing)",
+    " (capture FAILED)",
+};
+
+static const char *m_RTBD_FrameStatusNames[e_RTBDFrameStatusMAX]=
+{
+    "OK",
+    "BAD CRC",
+    "BAD ENCODING",
+    "SHORT",
+    "OVERFLOW",
+};
 
 /*******************************************************************************
  * NAME:
@@ -187,6 +318,16 @@ extern "C"
         m_RTBD_DPS=SysAPI->GetAPI_DataProcessors();
         m_RTBD_UIAPI=m_RTBD_DPS->GetAPI_UI();
 
+        /* BinaryAddHexBlock() isn't in a released DPS API, only look at it
+           if the host says it has it (other hosts' DPS struct stops before
+           it) */
+        m_RTBD_HasBinaryAddHexBlock=
+                (SysAPI->GetExperimentalID()==
+                DPS_API_EXPERIMENTAL_BLOCK_CALLS &&
+                m_RTBD_DPS->BinaryAddHexBlock!=NULL);
+
+        RxTxBinaryDisplay_InitDecoders();
+
         /* If we are have the correct experimental API */
         if(SysAPI->GetExperimentalID()>0 &&
                 SysAPI->GetExperimentalID()<1)
@@ -229,6 +370,13 @@ static t_DataProcessorHandleType *RxTxBinaryDisplay_AllocateData(void)
     if(Data==NULL)
         return NULL;
 
+    Data->Stats=RxTxBinaryDisplay_StatsAlloc();
+    if(Data->Stats==NULL)
+    {
+        free(Data);
+        return NULL;
+    }
+
     /* Set some defaults, these will be overriden by
        RxTxBinaryDisplay_ApplySettings() */
     Data->RxStyle.FGColor=0xFFFFFF;
@@ -239,6 +387,16 @@ static t_DataProcessorHandleType *RxTxBinaryDisplay_AllocateData(void)
     Data->TxStyle.BGColor=0xFF0000;
     Data->TxStyle.Attribs=0;
 
+    Data->CurrentDir=e_RTBD_Dir_None;
+
+    RxTxBinaryDisplay_ResetDecoder(&Data->Decoder,e_RTBDDecoder_None,2,true);
+
+    Data->CollapseRuns=false;
+    RxTxBinaryDisplay_ResetCollapse(Data,RTBD_COLLAPSE_DEFAULT_MIN_RUN);
+
+    Data->Capture=NULL;
+    Data->CaptureFilename=NULL;
+
     return (t_DataProcessorHandleType *)Data;
 }
 
@@ -263,6 +421,11 @@ static void RxTxBinaryDisplay_FreeData(t_DataProcessorHandleType *DataHandle)
 {
     struct RxTxBinaryDisplayData *Data=(struct RxTxBinaryDisplayData *)DataHandle;
 
+    if(Data->Capture!=NULL)
+        RxTxBinaryDisplay_CaptureClose(Data->Capture);
+    free(Data->CaptureFilename);
+    RxTxBinaryDisplay_StatsFree(Data->Stats);
+
     free(Data);
 }
 
@@ -352,14 +515,73 @@ static void RxTxBinaryDisplay_ProcessIncomingBinaryByte(
 {
     struct RxTxBinaryDisplayData *Data=(struct RxTxBinaryDisplayData *)DataHandle;
 
-    m_RTBD_DPS->SetFGColor(Data->RxStyle.FGColor);
-    m_RTBD_DPS->SetULineColor(Data->RxStyle.FGColor);
-    m_RTBD_DPS->SetBGColor(Data->RxStyle.BGColor);
-    m_RTBD_DPS->SetAttribs(Data->RxStyle.Attribs);
+    RxTxBinaryDisplay_StatsAdd(Data->Stats,e_RTBDStatsDir_Rx,1);
+    if(Data->Capture!=NULL)
+        RxTxBinaryDisplay_CaptureAddByte(Data->Capture,false,Byte);
+
+    if(Data->Decoder.Type!=e_RTBDDecoder_None)
+    {
+        RxTxBinaryDisplay_DecodeRx(Data,&Byte,1);
+        return;
+    }
+
+    if(Data->CollapseRuns)
+    {
+        RxTxBinaryDisplay_ShowHex(Data,e_RTBD_Dir_Rx,&Byte,1);
+        return;
+    }
+
+    RxTxBinaryDisplay_SelectStyle(Data,e_RTBD_Dir_Rx);
 
     m_RTBD_DPS->BinaryAddHex(Byte);
 }
 
+/*******************************************************************************
+ * NAME:
+ *    ProcessIncomingBinaryBlock
+ *
+ * SYNOPSIS:
+ *    void ProcessIncomingBinaryBlock(t_DataProcessorHandleType *DataHandle,
+ *          const uint8_t *Data,int Bytes);
+ *
+ * PARAMETERS:
+ *      DataHandle [I] -- The data handle to work on.  This is your internal
+ *                        data.
+ *      Data [I] -- This is the block of bytes that came in.
+ *      Bytes [I] -- The number of bytes in the 'Data' block.
+ *
+ * FUNCTION:
+ *      This function is called for each block of bytes that comes in if you
+ *      are a 'e_DataProcessorType_Binary' type of processor.  It is used in
+ *      place of ProcessIncomingBinaryByte() when the system supports it.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    ProcessIncomingBinaryByte(), BinaryAddHexBlock()
+ ******************************************************************************/
+static void RxTxBinaryDisplay_ProcessIncomingBinaryBlock(
+        t_DataProcessorHandleType *DataHandle,const uint8_t *RxData,int Bytes)
+{
+    struct RxTxBinaryDisplayData *Data=(struct RxTxBinaryDisplayData *)DataHandle;
+
+    if(Bytes<=0)
+        return;
+
+    RxTxBinaryDisplay_StatsAdd(Data->Stats,e_RTBDStatsDir_Rx,Bytes);
+    if(Data->Capture!=NULL)
+        RxTxBinaryDisplay_CaptureAdd(Data->Capture,false,RxData,Bytes);
+
+    if(Data->Decoder.Type!=e_RTBDDecoder_None)
+    {
+        RxTxBinaryDisplay_DecodeRx(Data,RxData,Bytes);
+        return;
+    }
+
+    RxTxBinaryDisplay_ShowHex(Data,e_RTBD_Dir_Rx,RxData,Bytes);
+}
+
 /*******************************************************************************
  * NAME:
  *    ProcessOutGoingData
@@ -393,15 +615,15 @@ static void RxTxBinaryDisplay_ProcessOutGoingData(t_DataProcessorHandleType *Dat
         const uint8_t *TxData,int Bytes)
 {
     struct RxTxBinaryDisplayData *Data=(struct RxTxBinaryDisplayData *)DataHandle;
-    int r;
 
-    m_RTBD_DPS->SetFGColor(Data->TxStyle.FGColor);
-    m_RTBD_DPS->SetULineColor(Data->TxStyle.FGColor);
-    m_RTBD_DPS->SetBGColor(Data->TxStyle.BGColor);
-    m_RTBD_DPS->SetAttribs(Data->TxStyle.Attribs);
+    if(Bytes<=0)
+        return;
+
+    RxTxBinaryDisplay_StatsAdd(Data->Stats,e_RTBDStatsDir_Tx,Bytes);
+    if(Data->Capture!=NULL)
+        RxTxBinaryDisplay_CaptureAdd(Data->Capture,true,TxData,Bytes);
 
-    for(r=0;r<Bytes;r++)
-        m_RTBD_DPS->BinaryAddHex(TxData[r]);
+    RxTxBinaryDisplay_ShowHex(Data,e_RTBD_Dir_Tx,TxData,Bytes);
 }
 
 /*******************************************************************************
@@ -442,10 +664,14 @@ static void RxTxBinaryDisplay_ProcessOutGoingData(t_DataProcessorHandleType *Dat
 t_DataProSettingsWidgetsType *RxTxBinaryDisplay_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings)
 {
     struct SettingsWidgets *WData;
+    unsigned int r;
+    const char *Str;
 
+    WData=NULL;
     try
     {
         WData=new SettingsWidgets;
+        memset(WData,0x00,sizeof(struct SettingsWidgets));
 
         m_RTBD_DPS->SetCurrentSettingsTabName("Incoming (Rx)");
         WData->RxTabHandle=WidgetHandle;
@@ -458,6 +684,92 @@ t_DataProSettingsWidgetsType *RxTxBinaryDisplay_AllocSettingsWidgets(t_WidgetSys
         RxTxBinaryDisplay_AddSettingStyleWidgets(&WData->TxStyles,
                 WData->TxTabHandle);
 
+        WData->DecoderTabHandle=m_RTBD_DPS->AddNewSettingsTab("Decoder");
+        if(WData->DecoderTabHandle==NULL)
+            throw(0);
+
+        WData->DecoderType=m_RTBD_UIAPI->AddComboBox(WData->DecoderTabHandle,
+                false,"Frame decoder (Rx)",NULL,NULL);
+        if(WData->DecoderType==NULL)
+            throw(0);
+        for(r=0;r<e_RTBDDecoderMAX;r++)
+        {
+            m_RTBD_UIAPI->AddItem2ComboBox(WData->DecoderTabHandle,
+                    WData->DecoderType->Ctrl,m_RTBD_DecoderNames[r],r);
+        }
+
+        WData->PrefixSize=m_RTBD_UIAPI->AddComboBox(WData->DecoderTabHandle,
+                false,"Length prefix size",NULL,NULL);
+        if(WData->PrefixSize==NULL)
+            throw(0);
+        m_RTBD_UIAPI->AddItem2ComboBox(WData->DecoderTabHandle,
+                WData->PrefixSize->Ctrl,"1 byte",1);
+        m_RTBD_UIAPI->AddItem2ComboBox(WData->DecoderTabHandle,
+                WData->PrefixSize->Ctrl,"2 bytes",2);
+        m_RTBD_UIAPI->AddItem2ComboBox(WData->DecoderTabHandle,
+                WData->PrefixSize->Ctrl,"4 bytes",4);
+
+        WData->PrefixBigEndian=m_RTBD_UIAPI->AddCheckbox(
+                WData->DecoderTabHandle,"Length prefix is big endian",NULL,NULL);
+        if(WData->PrefixBigEndian==NULL)
+            throw(0);
+
+        WData->RepeatsTabHandle=m_RTBD_DPS->AddNewSettingsTab("Repeats");
+        if(WData->RepeatsTabHandle==NULL)
+            throw(0);
+
+        WData->CollapseRuns=m_RTBD_UIAPI->AddCheckbox(WData->RepeatsTabHandle,
+                "Collapse runs of repeated bytes",NULL,NULL);
+        if(WData->CollapseRuns==NULL)
+            throw(0);
+
+        WData->CollapseMinRun=m_RTBD_UIAPI->AddNumberInput(
+                WData->RepeatsTabHandle,"Shortest run to collapse (bytes)",
+                NULL,NULL);
+        if(WData->CollapseMinRun==NULL)
+            throw(0);
+        m_RTBD_UIAPI->SetNumberInputMinMax(WData->RepeatsTabHandle,
+                WData->CollapseMinRun->Ctrl,RTBD_COLLAPSE_MIN_MIN_RUN,
+                RTBD_COLLAPSE_MAX_MIN_RUN);
+
+        WData->StatsTabHandle=m_RTBD_DPS->AddNewSettingsTab("Statistics");
+        if(WData->StatsTabHandle==NULL)
+            throw(0);
+
+        WData->RxActive=m_RTBD_UIAPI->AddIndicator(WData->StatsTabHandle,
+                "Rx in the last second");
+        if(WData->RxActive==NULL)
+            throw(0);
+
+        WData->TxActive=m_RTBD_UIAPI->AddIndicator(WData->StatsTabHandle,
+                "Tx in the last second");
+        if(WData->TxActive==NULL)
+            throw(0);
+
+        WData->StatsView=m_RTBD_UIAPI->AddColumnViewInput(
+                WData->StatsTabHandle,"Traffic (by connection)",
+                sizeof(m_RTBD_StatsColumns)/sizeof(m_RTBD_StatsColumns[0]),
+                m_RTBD_StatsColumns,NULL,NULL);
+        if(WData->StatsView==NULL)
+            throw(0);
+
+        RxTxBinaryDisplay_FillStatsWidgets(WData);
+
+        WData->CaptureTabHandle=m_RTBD_DPS->AddNewSettingsTab("Capture");
+        if(WData->CaptureTabHandle==NULL)
+            throw(0);
+
+        WData->CaptureEnabled=m_RTBD_UIAPI->AddCheckbox(
+                WData->CaptureTabHandle,"Capture Rx / Tx to a pcapng file",
+                NULL,NULL);
+        if(WData->CaptureEnabled==NULL)
+            throw(0);
+
+        WData->CaptureFilename=m_RTBD_UIAPI->AddTextInput(
+                WData->CaptureTabHandle,"Capture Filename",NULL,NULL);
+        if(WData->CaptureFilename==NULL)
+            throw(0);
+
         /* Set UI to settings values */
         RxTxBinaryDisplay_SetSettingStyleWidgets(Settings,&WData->RxStyles,
                 WData->RxTabHandle,"Rx",
@@ -467,6 +779,32 @@ t_DataProSettingsWidgetsType *RxTxBinaryDisplay_AllocSettingsWidgets(t_WidgetSys
                 WData->TxTabHandle,"Tx",
                 m_RTBD_DPS->GetSysDefaultColor(e_DefaultColors_FG),
                 m_RTBD_DPS->GetSysColor(e_SysColShade_Normal,e_SysCol_Red));
+
+        m_RTBD_UIAPI->SetComboBoxSelectedEntry(WData->DecoderTabHandle,
+                WData->DecoderType->Ctrl,RxTxBinaryDisplay_GrabSettingKV(
+                Settings,"Decoder","Type",e_RTBDDecoder_None,10));
+        m_RTBD_UIAPI->SetComboBoxSelectedEntry(WData->DecoderTabHandle,
+                WData->PrefixSize->Ctrl,RxTxBinaryDisplay_GrabSettingKV(
+                Settings,"Decoder","PrefixSize",2,10));
+        m_RTBD_UIAPI->SetCheckboxChecked(WData->DecoderTabHandle,
+                WData->PrefixBigEndian->Ctrl,RxTxBinaryDisplay_GrabSettingKV(
+                Settings,"Decoder","PrefixBigEndian",1,10));
+
+        m_RTBD_UIAPI->SetCheckboxChecked(WData->RepeatsTabHandle,
+                WData->CollapseRuns->Ctrl,RxTxBinaryDisplay_GrabSettingKV(
+                Settings,"Collapse","Enabled",0,10));
+        m_RTBD_UIAPI->SetNumberInputValue(WData->RepeatsTabHandle,
+                WData->CollapseMinRun->Ctrl,RxTxBinaryDisplay_GrabSettingKV(
+                Settings,"Collapse","MinRun",RTBD_COLLAPSE_DEFAULT_MIN_RUN,10));
+
+        m_RTBD_UIAPI->SetCheckboxChecked(WData->CaptureTabHandle,
+                WData->CaptureEnabled->Ctrl,RxTxBinaryDisplay_GrabSettingKV(
+                Settings,"Capture","Enabled",0,10));
+        Str=m_RTBD_SysAPI->KVGetItem(Settings,"Capture_Filename");
+        if(Str==NULL)
+            Str="";
+        m_RTBD_UIAPI->SetTextInputText(WData->CaptureTabHandle,
+                WData->CaptureFilename->Ctrl,Str);
     }
     catch(...)
     {
@@ -508,6 +846,45 @@ void RxTxBinaryDisplay_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivDat
     RxTxBinaryDisplay_FreeSettingStyleWidgets(&WData->RxStyles,WData->RxTabHandle);
     RxTxBinaryDisplay_FreeSettingStyleWidgets(&WData->TxStyles,WData->TxTabHandle);
 
+    if(WData->CaptureFilename!=NULL)
+    {
+        m_RTBD_UIAPI->FreeTextInput(WData->CaptureTabHandle,
+                WData->CaptureFilename);
+    }
+    if(WData->CaptureEnabled!=NULL)
+    {
+        m_RTBD_UIAPI->FreeCheckbox(WData->CaptureTabHandle,
+                WData->CaptureEnabled);
+    }
+
+    if(WData->StatsView!=NULL)
+    {
+        m_RTBD_UIAPI->FreeColumnViewInput(WData->StatsTabHandle,
+                WData->StatsView);
+    }
+    if(WData->TxActive!=NULL)
+        m_RTBD_UIAPI->FreeIndicator(WData->StatsTabHandle,WData->TxActive);
+    if(WData->RxActive!=NULL)
+        m_RTBD_UIAPI->FreeIndicator(WData->StatsTabHandle,WData->RxActive);
+
+    if(WData->CollapseMinRun!=NULL)
+    {
+        m_RTBD_UIAPI->FreeNumberInput(WData->RepeatsTabHandle,
+                WData->CollapseMinRun);
+    }
+    if(WData->CollapseRuns!=NULL)
+        m_RTBD_UIAPI->FreeCheckbox(WData->RepeatsTabHandle,WData->CollapseRuns);
+
+    if(WData->PrefixBigEndian!=NULL)
+    {
+        m_RTBD_UIAPI->FreeCheckbox(WData->DecoderTabHandle,
+                WData->PrefixBigEndian);
+    }
+    if(WData->PrefixSize!=NULL)
+        m_RTBD_UIAPI->FreeComboBox(WData->DecoderTabHandle,WData->PrefixSize);
+    if(WData->DecoderType!=NULL)
+        m_RTBD_UIAPI->FreeComboBox(WData->DecoderTabHandle,WData->DecoderType);
+
     delete WData;
 }
 
@@ -541,6 +918,30 @@ void RxTxBinaryDisplay_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *Priv
         &WData->RxStyles,WData->RxTabHandle,"Rx");
     RxTxBinaryDisplay_UpdateSettingFromStyleWidgets(Settings,
         &WData->TxStyles,WData->TxTabHandle,"Tx");
+
+    RxTxBinaryDisplay_SetSettingKV(Settings,"Decoder","Type",
+            m_RTBD_UIAPI->GetComboBoxSelectedEntry(WData->DecoderTabHandle,
+            WData->DecoderType->Ctrl),10);
+    RxTxBinaryDisplay_SetSettingKV(Settings,"Decoder","PrefixSize",
+            m_RTBD_UIAPI->GetComboBoxSelectedEntry(WData->DecoderTabHandle,
+            WData->PrefixSize->Ctrl),10);
+    RxTxBinaryDisplay_SetSettingKV(Settings,"Decoder","PrefixBigEndian",
+            m_RTBD_UIAPI->IsCheckboxChecked(WData->DecoderTabHandle,
+            WData->PrefixBigEndian->Ctrl),10);
+
+    RxTxBinaryDisplay_SetSettingKV(Settings,"Collapse","Enabled",
+            m_RTBD_UIAPI->IsCheckboxChecked(WData->RepeatsTabHandle,
+            WData->CollapseRuns->Ctrl),10);
+    RxTxBinaryDisplay_SetSettingKV(Settings,"Collapse","MinRun",
+            m_RTBD_UIAPI->GetNumberInputValue(WData->RepeatsTabHandle,
+            WData->CollapseMinRun->Ctrl),10);
+
+    RxTxBinaryDisplay_SetSettingKV(Settings,"Capture","Enabled",
+            m_RTBD_UIAPI->IsCheckboxChecked(WData->CaptureTabHandle,
+            WData->CaptureEnabled->Ctrl),10);
+    m_RTBD_SysAPI->KVAddItem(Settings,"Capture_Filename",
+            m_RTBD_UIAPI->GetTextInputText(WData->CaptureTabHandle,
+            WData->CaptureFilename->Ctrl));
 }
 
 /*******************************************************************************
@@ -571,6 +972,23 @@ static void RxTxBinaryDisplay_ApplySettings(t_DataProcessorHandleType *DataHandl
         t_PIKVList *Settings)
 {
     struct RxTxBinaryDisplayData *Data=(struct RxTxBinaryDisplayData *)DataHandle;
+    uint32_t DecoderType;
+    bool CollapseRuns;
+    uint32_t MinRun;
+    const char *Str;
+
+    /* Only restart collapsing if it's settings changed, and show what it was
+       holding first (in the old style) so no bytes are lost */
+    CollapseRuns=RxTxBinaryDisplay_GrabSettingKV(Settings,"Collapse",
+            "Enabled",0,10);
+    MinRun=RxTxBinaryDisplay_ClampMinRun(RxTxBinaryDisplay_GrabSettingKV(
+            Settings,"Collapse","MinRun",RTBD_COLLAPSE_DEFAULT_MIN_RUN,10));
+    if(CollapseRuns!=Data->CollapseRuns || MinRun!=Data->Collapse.MinRun)
+    {
+        RxTxBinaryDisplay_CollapseFlush(Data);
+        Data->CollapseRuns=CollapseRuns;
+        RxTxBinaryDisplay_ResetCollapse(Data,MinRun);
+    }
 
     RxTxBinaryDisplay_ApplySetting_SetData(Settings,&Data->RxStyle,"Rx",
             m_RTBD_DPS->GetSysDefaultColor(e_DefaultColors_FG),
@@ -578,6 +996,48 @@ static void RxTxBinaryDisplay_ApplySettings(t_DataProcessorHandleType *DataHandl
     RxTxBinaryDisplay_ApplySetting_SetData(Settings,&Data->TxStyle,"Tx",
             m_RTBD_DPS->GetSysDefaultColor(e_DefaultColors_FG),
             m_RTBD_DPS->GetSysColor(e_SysColShade_Normal,e_SysCol_Red));
+
+    /* The styles may have changed, send them again on the next byte */
+    Data->CurrentDir=e_RTBD_Dir_None;
+
+    DecoderType=RxTxBinaryDisplay_GrabSettingKV(Settings,"Decoder","Type",
+            e_RTBDDecoder_None,10);
+    if(DecoderType>=e_RTBDDecoderMAX)
+        DecoderType=e_RTBDDecoder_None;
+    RxTxBinaryDisplay_ChangeDecoder(&Data->Decoder,
+            (e_RTBDDecoderType)DecoderType,
+            RxTxBinaryDisplay_GrabSettingKV(Settings,"Decoder","PrefixSize",2,10),
+            RxTxBinaryDisplay_GrabSettingKV(Settings,"Decoder","PrefixBigEndian",
+            1,10));
+
+    /* Capture file */
+    Str=m_RTBD_SysAPI->KVGetItem(Settings,"Capture_Filename");
+    if(Str==NULL ||
+            !RxTxBinaryDisplay_GrabSettingKV(Settings,"Capture","Enabled",0,10))
+    {
+        Str="";
+    }
+
+    if(Data->Capture!=NULL && (Data->CaptureFilename==NULL ||
+            strcmp(Data->CaptureFilename,Str)!=0))
+    {
+        RxTxBinaryDisplay_CaptureClose(Data->Capture);
+        Data->Capture=NULL;
+        free(Data->CaptureFilename);
+        Data->CaptureFilename=NULL;
+    }
+    if(*Str==0)
+    {
+        RxTxBinaryDisplay_StatsSetCapture(Data->Stats,e_RTBDStatsCapture_Off);
+    }
+    else if(Data->Capture==NULL)
+    {
+        /* If we can't make the file we just don't capture (the stats show
+           it failed) */
+        Data->Capture=RxTxBinaryDisplay_CaptureOpen(Str,Data->Stats);
+        if(Data->Capture!=NULL)
+            Data->CaptureFilename=strdup(Str);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -977,3 +1437,677 @@ static void RxTxBinaryDisplay_ApplySetting_SetData(t_PIKVList *Settings,
     if(RxTxBinaryDisplay_GrabSettingKV(Settings,Prefix,"AttribOutLine",0,10))
         Style->Attribs|=TXT_ATTRIB_OUTLINE;
 }
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_SelectStyle
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_SelectStyle(
+ *          struct RxTxBinaryDisplayData *Data,e_RTBD_DirType Dir);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *    Dir [I] -- The direction we are about to add bytes for
+ *
+ * FUNCTION:
+ *    This function sets the style for Rx or Tx bytes.  The style is only sent
+ *    when the direction changes (it is the same for every byte until then).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_SelectStyle(struct RxTxBinaryDisplayData *Data,
+        e_RTBD_DirType Dir)
+{
+    struct RxTxBinaryDisplay_TextStyle *Style;
+
+    if(Dir==Data->CurrentDir)
+        return;
+
+    if(Dir==e_RTBD_Dir_Tx)
+        Style=&Data->TxStyle;
+    else
+        Style=&Data->RxStyle;
+
+    m_RTBD_DPS->SetFGColor(Style->FGColor);
+    m_RTBD_DPS->SetULineColor(Style->FGColor);
+    m_RTBD_DPS->SetBGColor(Style->BGColor);
+    m_RTBD_DPS->SetAttribs(Style->Attribs);
+
+    Data->CurrentDir=Dir;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_AddHexBlock
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_AddHexBlock(const uint8_t *Bytes,int Len);
+ *
+ * PARAMETERS:
+ *    Bytes [I] -- The bytes to add
+ *    Len [I] -- The number of bytes in 'Bytes'
+ *
+ * FUNCTION:
+ *    This function adds a block of bytes to the hex display.  If the system
+ *    has BinaryAddHexBlock() then it's one call, if not we fall back to
+ *    BinaryAddHex() for each byte.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_AddHexBlock(const uint8_t *Bytes,int Len)
+{
+    int r;
+
+    if(m_RTBD_HasBinaryAddHexBlock)
+    {
+        m_RTBD_DPS->BinaryAddHexBlock(Bytes,Len);
+    }
+    else
+    {
+        for(r=0;r<Len;r++)
+            m_RTBD_DPS->BinaryAddHex(Bytes[r]);
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_DecodeRx
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_DecodeRx(struct RxTxBinaryDisplayData *Data,
+ *          const uint8_t *RxData,uint32_t Bytes);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *    RxData [I] -- The bytes that came in
+ *    Bytes [I] -- The number of bytes in 'RxData'
+ *
+ * FUNCTION:
+ *    This function runs incoming bytes though the frame decoder and shows
+ *    each frame as it is finished.  Bytes that are part of a frame that
+ *    hasn't finished yet are held in the decoder until it does.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_DecodeRx(struct RxTxBinaryDisplayData *Data,
+        const uint8_t *RxData,uint32_t Bytes)
+{
+    struct RxTxBinaryDisplayFrame Frame;
+    uint32_t Used;
+    bool GotFrame;
+
+    /* Anything still held for collapsing has to be shown first */
+    RxTxBinaryDisplay_CollapseFlush(Data);
+
+    while(Bytes>0)
+    {
+        Used=RxTxBinaryDisplay_Decode(&Data->Decoder,RxData,Bytes,&Frame,
+                &GotFrame);
+        if(GotFrame)
+            RxTxBinaryDisplay_ShowFrame(Data,&Frame);
+        RxData+=Used;
+        Bytes-=Used;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_ShowFrame
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_ShowFrame(struct RxTxBinaryDisplayData *Data,
+ *          const struct RxTxBinaryDisplayFrame *Frame);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *    Frame [I] -- The frame to show
+ *
+ * FUNCTION:
+ *    This function adds a decoded frame to the display on it's own line.  The
+ *    line starts with where the frame started in the stream, how long it is,
+ *    and if it was good (and the CRC if it had one), then the payload in hex.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_ShowFrame(struct RxTxBinaryDisplayData *Data,
+        const struct RxTxBinaryDisplayFrame *Frame)
+{
+    char buff[100];
+
+    RxTxBinaryDisplay_SelectStyle(Data,e_RTBD_Dir_Rx);
+
+    if(Frame->HasCRC)
+    {
+        sprintf(buff,"@%08llX len %u CRC %04X %s: ",
+                (unsigned long long)Frame->Offset,Frame->FullLen,Frame->CRC,
+                m_RTBD_FrameStatusNames[Frame->Status]);
+    }
+    else
+    {
+        sprintf(buff,"@%08llX len %u %s: ",(unsigned long long)Frame->Offset,
+                Frame->FullLen,m_RTBD_FrameStatusNames[Frame->Status]);
+    }
+    m_RTBD_DPS->BinaryAddText(buff);
+
+    if(Frame->Len>0)
+        RxTxBinaryDisplay_AddHexBlock(Frame->Data,Frame->Len);
+
+    m_RTBD_DPS->BinaryAddText("\n");
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_ShowHex
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_ShowHex(struct RxTxBinaryDisplayData *Data,
+ *          e_RTBD_DirType Dir,const uint8_t *Bytes,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *    Dir [I] -- The direction these bytes went
+ *    Bytes [I] -- The bytes to show
+ *    Len [I] -- The number of bytes in 'Bytes'
+ *
+ * FUNCTION:
+ *    This function shows bytes as hex.  If collapsing runs is turned on
+ *    then once the same byte (or a short pattern of up to
+ *    RTBD_COLLAPSE_MAX_PATTERN bytes) has repeated for 'MinRun' bytes the
+ *    repeats after that are shown as one "[FF x4096]" note instead.
+ *
+ *    The 'MinRun' bytes that show it's a run are shown as normal bytes and
+ *    nothing is held past the end of the call.  This way what is shown
+ *    only depends on the bytes, not on how they were split up in to
+ *    blocks (or if they came in one at a time).  The start of the note
+ *    ("[FF x") is shown with the first repeat so a run that is still going
+ *    is on the screen, the count is added when the run ends (a different
+ *    byte comes in, the direction changes, or the settings change).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_ShowHex(struct RxTxBinaryDisplayData *Data,
+        e_RTBD_DirType Dir,const uint8_t *Bytes,uint32_t Len)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+    uint32_t r;
+
+    if(!Data->CollapseRuns)
+    {
+        RxTxBinaryDisplay_SelectStyle(Data,Dir);
+        RxTxBinaryDisplay_AddHexBlock(Bytes,Len);
+        return;
+    }
+
+    if(Col->Dir!=Dir)
+    {
+        RxTxBinaryDisplay_CollapseFlush(Data);
+        Col->Dir=Dir;
+    }
+
+    r=0;
+    while(r<Len)
+    {
+        if(Col->PatternLen>0)
+        {
+            /* Skip over everything that keeps the run going */
+            while(r<Len && Bytes[r]==Col->Pattern[Col->Phase])
+            {
+                r++;
+                Col->RunLen++;
+                Col->Phase++;
+                if(Col->Phase==Col->PatternLen)
+                    Col->Phase=0;
+            }
+            if(!Col->NoteShown && Col->RunLen>=Col->PatternLen)
+                RxTxBinaryDisplay_CollapseStartNote(Data);
+            if(r==Len)
+                break;
+            RxTxBinaryDisplay_CollapseEndRun(Data);
+        }
+        RxTxBinaryDisplay_CollapseAddByte(Data,Bytes[r++]);
+    }
+
+    /* Show everything that isn't in a run before we return */
+    RxTxBinaryDisplay_CollapseRelease(Data);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_ResetCollapse
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_ResetCollapse(
+ *          struct RxTxBinaryDisplayData *Data,uint32_t MinRun);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *    MinRun [I] -- The shortest run (in bytes) that will be collapsed
+ *
+ * FUNCTION:
+ *    This function resets the run collapsing.  Any held bytes are dropped.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_ResetCollapse(struct RxTxBinaryDisplayData *Data,
+        uint32_t MinRun)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+
+    Col->Dir=e_RTBD_Dir_None;
+    Col->MinRun=RxTxBinaryDisplay_ClampMinRun(MinRun);
+    Col->PatternLen=0;
+    Col->Phase=0;
+    Col->RunLen=0;
+    Col->NoteShown=false;
+    Col->HeldLen=0;
+    Col->ShownLen=0;
+    memset(Col->Periodic,0x00,sizeof(Col->Periodic));
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_ClampMinRun
+ *
+ * SYNOPSIS:
+ *    static uint32_t RxTxBinaryDisplay_ClampMinRun(uint32_t MinRun);
+ *
+ * PARAMETERS:
+ *    MinRun [I] -- The shortest run (in bytes) from the settings
+ *
+ * FUNCTION:
+ *    This function limits the shortest run to what we support.
+ *
+ * RETURNS:
+ *    The shortest run to use
+ ******************************************************************************/
+static uint32_t RxTxBinaryDisplay_ClampMinRun(uint32_t MinRun)
+{
+    if(MinRun<RTBD_COLLAPSE_MIN_MIN_RUN)
+        MinRun=RTBD_COLLAPSE_MIN_MIN_RUN;
+    if(MinRun>RTBD_COLLAPSE_MAX_MIN_RUN)
+        MinRun=RTBD_COLLAPSE_MAX_MIN_RUN;
+    return MinRun;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CollapseAddByte
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CollapseAddByte(
+ *          struct RxTxBinaryDisplayData *Data,uint8_t Byte);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *    Byte [I] -- The byte to add
+ *
+ * FUNCTION:
+ *    This function adds a byte to the held bytes (when we are not in a run).
+ *    For each pattern length it keeps track of how many bytes at the end of
+ *    the held bytes repeat with that length.  When one of them gets to
+ *    'MinRun' the held bytes are shown and a run is started with the last
+ *    pattern (the bytes after this one that keep repeating it are the run).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CollapseAddByte(struct RxTxBinaryDisplayData *Data,
+        uint8_t Byte)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+    unsigned int p;
+    uint32_t Held;
+
+    if(Col->HeldLen==sizeof(Col->Held))
+        RxTxBinaryDisplay_CollapseRelease(Data);
+
+    Held=Col->HeldLen;
+    Col->Held[Held]=Byte;
+    Col->HeldLen++;
+
+    for(p=1;p<=RTBD_COLLAPSE_MAX_PATTERN;p++)
+    {
+        if(Held>=p && Byte==Col->Held[Held-p])
+            Col->Periodic[p]++;
+        else
+            Col->Periodic[p]=Col->HeldLen<p?Col->HeldLen:p;
+    }
+
+    for(p=1;p<=RTBD_COLLAPSE_MAX_PATTERN;p++)
+    {
+        if(Col->Periodic[p]>=Col->MinRun)
+        {
+            /* This leaves at least RTBD_COLLAPSE_MAX_PATTERN bytes held */
+            RxTxBinaryDisplay_CollapseRelease(Data);
+
+            memcpy(Col->Pattern,&Col->Held[Col->HeldLen-p],p);
+            Col->PatternLen=p;
+            Col->Phase=0;
+            Col->RunLen=0;
+            Col->NoteShown=false;
+
+            Col->HeldLen=0;
+            Col->ShownLen=0;
+            memset(Col->Periodic,0x00,sizeof(Col->Periodic));
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CollapseRelease
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CollapseRelease(
+ *          struct RxTxBinaryDisplayData *Data);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *
+ * FUNCTION:
+ *    This function shows all the held bytes.  The last
+ *    RTBD_COLLAPSE_MAX_PATTERN bytes are kept (but not shown again) so we
+ *    can still see a run starting.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CollapseRelease(struct RxTxBinaryDisplayData *Data)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+    uint32_t Drop;
+
+    if(Col->HeldLen>Col->ShownLen)
+    {
+        RxTxBinaryDisplay_SelectStyle(Data,Col->Dir);
+        RxTxBinaryDisplay_AddHexBlock(&Col->Held[Col->ShownLen],
+                Col->HeldLen-Col->ShownLen);
+        Col->ShownLen=Col->HeldLen;
+    }
+
+    if(Col->ShownLen<=RTBD_COLLAPSE_MAX_PATTERN)
+        return;
+
+    Drop=Col->ShownLen-RTBD_COLLAPSE_MAX_PATTERN;
+    memmove(Col->Held,&Col->Held[Drop],Col->HeldLen-Drop);
+    Col->HeldLen-=Drop;
+    Col->ShownLen-=Drop;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CollapseStartNote
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CollapseStartNote(
+ *          struct RxTxBinaryDisplayData *Data);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *
+ * FUNCTION:
+ *    This function shows the start of the note for the current run (the
+ *    pattern).  RxTxBinaryDisplay_CollapseEndRun() finishes it off with the
+ *    count.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CollapseStartNote(struct RxTxBinaryDisplayData *Data)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+    unsigned int r;
+    char buff[100];
+    char *Pos;
+
+    Pos=buff;
+    *Pos++='[';
+    for(r=0;r<Col->PatternLen;r++)
+        Pos+=sprintf(Pos,r==0?"%02X":" %02X",Col->Pattern[r]);
+    strcpy(Pos," \xC3\x97");
+
+    RxTxBinaryDisplay_SelectStyle(Data,Col->Dir);
+    m_RTBD_DPS->BinaryAddText(buff);
+
+    Col->NoteShown=true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CollapseEndRun
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CollapseEndRun(
+ *          struct RxTxBinaryDisplayData *Data);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *
+ * FUNCTION:
+ *    This function ends the current run and finishes it's note with the
+ *    number of times the pattern repeated.  If the run ended part way
+ *    though the pattern the left over bytes are added back as normal bytes.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CollapseEndRun(struct RxTxBinaryDisplayData *Data)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+    uint8_t Pattern[RTBD_COLLAPSE_MAX_PATTERN];
+    unsigned int Extra;
+    unsigned int r;
+    char buff[100];
+
+    memcpy(Pattern,Col->Pattern,Col->PatternLen);
+    Extra=Col->Phase;
+
+    if(Col->NoteShown)
+    {
+        sprintf(buff,"%u]",Col->RunLen/Col->PatternLen);
+        RxTxBinaryDisplay_SelectStyle(Data,Col->Dir);
+        m_RTBD_DPS->BinaryAddText(buff);
+    }
+
+    Col->PatternLen=0;
+    Col->Phase=0;
+    Col->RunLen=0;
+    Col->NoteShown=false;
+
+    for(r=0;r<Extra;r++)
+        RxTxBinaryDisplay_CollapseAddByte(Data,Pattern[r]);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CollapseFlush
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CollapseFlush(
+ *          struct RxTxBinaryDisplayData *Data);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- Our data
+ *
+ * FUNCTION:
+ *    This function ends any run and shows all the held bytes.  This is done
+ *    when the direction changes so the Rx and Tx bytes stay in order.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CollapseFlush(struct RxTxBinaryDisplayData *Data)
+{
+    struct RxTxBinaryDisplay_Collapse *Col=&Data->Collapse;
+
+    if(Col->PatternLen>0)
+        RxTxBinaryDisplay_CollapseEndRun(Data);
+
+    RxTxBinaryDisplay_CollapseRelease(Data);
+    Col->HeldLen=0;
+    Col->ShownLen=0;
+    memset(Col->Periodic,0x00,sizeof(Col->Periodic));
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_FillStatsWidgets
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_FillStatsWidgets(
+ *          struct SettingsWidgets *WData);
+ *
+ * PARAMETERS:
+ *    WData [I] -- The settings widgets
+ *
+ * FUNCTION:
+ *    This function fills in the statistics tab with the Rx / Tx counters as
+ *    they are right now.  Settings aren't tied to one connection so every
+ *    connection that uses this processor is listed (each under a
+ *    "Connection x" row).  The active lights are on if any of them are
+ *    moving data.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_FillStatsWidgets(struct SettingsWidgets *WData)
+{
+    struct RxTxBinaryDisplayConStats List[RTBD_STATS_MAX_CONNECTIONS];
+    struct RxTxBinaryDisplayStats *Stats;
+    unsigned int Count;
+    unsigned int c;
+    bool RxActive;
+    bool TxActive;
+    char buff[100];
+    unsigned int r;
+    int Row;
+    int Col;
+    int d;
+
+    Count=RxTxBinaryDisplay_StatsGetAll(List,RTBD_STATS_MAX_CONNECTIONS);
+
+    RxActive=false;
+    TxActive=false;
+    for(c=0;c<Count;c++)
+    {
+        if(List[c].Dir[e_RTBDStatsDir_Rx].Rate1s>0)
+            RxActive=true;
+        if(List[c].Dir[e_RTBDStatsDir_Tx].Rate1s>0)
+            TxActive=true;
+    }
+    m_RTBD_UIAPI->SetIndicator(WData->StatsTabHandle,WData->RxActive->Ctrl,
+            RxActive);
+    m_RTBD_UIAPI->SetIndicator(WData->StatsTabHandle,WData->TxActive->Ctrl,
+            TxActive);
+
+    m_RTBD_UIAPI->ColumnViewInputClear(WData->StatsTabHandle,
+            WData->StatsView->Ctrl);
+
+    for(c=0;c<Count;c++)
+    {
+        Stats=List[c].Dir;
+
+        Row=m_RTBD_UIAPI->ColumnViewInputAddRow(WData->StatsTabHandle,
+                WData->StatsView->Ctrl);
+        if(Row<0)
+            return;
+        sprintf(buff,"Connection %u%s",List[c].ID,
+                m_RTBD_CaptureStateNames[List[c].Capture]);
+        m_RTBD_UIAPI->ColumnViewInputSetColumnText(WData->StatsTabHandle,
+                WData->StatsView->Ctrl,0,Row,buff);
+
+        for(r=0;r<sizeof(m_RTBD_StatsRows)/sizeof(m_RTBD_StatsRows[0]);r++)
+        {
+            Row=m_RTBD_UIAPI->ColumnViewInputAddRow(WData->StatsTabHandle,
+                    WData->StatsView->Ctrl);
+            if(Row<0)
+                return;
+            m_RTBD_UIAPI->ColumnViewInputSetColumnText(WData->StatsTabHandle,
+                    WData->StatsView->Ctrl,0,Row,m_RTBD_StatsRows[r]);
+
+            for(d=0;d<e_RTBDStatsDirMAX;d++)
+            {
+                Col=d+1;
+                switch(r)
+                {
+                    case 0:
+                        sprintf(buff,"%llu",
+                                (unsigned long long)Stats[d].TotalBytes);
+                    break;
+                    case 1:
+                        RxTxBinaryDisplay_FormatRate(buff,Stats[d].Rate1s);
+                    break;
+                    case 2:
+                        RxTxBinaryDisplay_FormatRate(buff,Stats[d].Rate10s);
+                    break;
+                    case 3:
+                        RxTxBinaryDisplay_FormatRate(buff,Stats[d].Rate60s);
+                    break;
+                    case 4:
+                        sprintf(buff,"%llu bytes",
+                                (unsigned long long)Stats[d].LargestBurst);
+                    break;
+                    case 5:
+                    case 6:
+                        if(!Stats[d].HasGap)
+                        {
+                            strcpy(buff,"-");
+                            break;
+                        }
+                        sprintf(buff,"%llu ms",(unsigned long long)(r==5?
+                                Stats[d].LastGapMS:Stats[d].ShortestGapMS));
+                    break;
+                    case 7:
+                        if(List[c].Capture==e_RTBDStatsCapture_Off)
+                        {
+                            strcpy(buff,"-");
+                            break;
+                        }
+                        sprintf(buff,"%llu chunks",
+                                (unsigned long long)Stats[d].CaptureDropped);
+                    break;
+                    default:
+                        buff[0]=0;
+                    break;
+                }
+                m_RTBD_UIAPI->ColumnViewInputSetColumnText(WData->StatsTabHandle,
+                        WData->StatsView->Ctrl,Col,Row,buff);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_FormatRate
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_FormatRate(char *buff,double Rate);
+ *
+ * PARAMETERS:
+ *    buff [O] -- Where to put the string (at least 30 chars)
+ *    Rate [I] -- The rate in bytes per second
+ *
+ * FUNCTION:
+ *    This function makes a rate into a string using B/s, KB/s, or MB/s.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_FormatRate(char *buff,double Rate)
+{
+    if(Rate>=1024.0*1024.0)
+        sprintf(buff,"%.2f MB/s",Rate/(1024.0*1024.0));
+    else if(Rate>=1024.0)
+        sprintf(buff,"%.2f KB/s",Rate/1024.0);
+    else
+        sprintf(buff,"%.0f B/s",Rate);
+}
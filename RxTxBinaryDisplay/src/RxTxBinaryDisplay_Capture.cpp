@@ -0,0 +1,650 @@
+/*******************************************************************************
+ * FILENAME: RxTxBinaryDisplay_Capture.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file writes the Rx / Tx bytes to a pcapng file.  Each chunk of
+ *    bytes is one Enhanced Packet Block with a ns time stamp and the
+ *    inbound / outbound direction flag set.  Chunks bigger than
+ *    RTBD_CAPTURE_SNAPLEN are split over more than one packet.  Bytes that
+ *    are added one at a time are gathered up and saved as one packet for
+ *    each run of bytes (until the direction changes or they stop coming
+ *    for RTBD_CAPTURE_RUN_GAP_MS).
+ *
+ *    The blocks are built in one of two buffers.  When that buffer is full
+ *    (or once a second) it is handed to a writer thread and we start
+ *    filling the other one, so writing to the disk never holds up the
+ *    incoming data.  If the writer thread is still busy with the other
+ *    buffer when we need it the chunk is dropped (and counted) instead of
+ *    waiting.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "RxTxBinaryDisplay_Capture.h"
+#include <string.h>
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*** DEFINES                  ***/
+#define RTBD_CAPTURE_BUFFER_SIZE            (1024*1024)
+#define RTBD_CAPTURE_SNAPLEN                65535   // Longest chunk we save
+#define RTBD_CAPTURE_FLUSH_MS               1000    // Write at least this often
+#define RTBD_CAPTURE_RUN_GAP_MS             10      // A gap this long ends a run of bytes
+#define NS_PER_MS                           1000000ULL
+
+#define PCAPNG_BLOCK_SHB                    0x0A0D0D0A
+#define PCAPNG_BLOCK_IDB                    0x00000001
+#define PCAPNG_BLOCK_EPB                    0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC             0x1A2B3C4D
+#define PCAPNG_OPT_ENDOFOPT                 0
+#define PCAPNG_OPT_IF_TSRESOL               9
+#define PCAPNG_OPT_EPB_FLAGS                2
+#define PCAPNG_EPB_FLAGS_INBOUND            0x00000001
+#define PCAPNG_EPB_FLAGS_OUTBOUND           0x00000002
+#define LINKTYPE_USER0                      147     // No link layer, raw bytes
+
+/* Block type, length, interface, ts high, ts low, cap len, orig len, flags
+   option (8), end of options (4), block length */
+#define PCAPNG_EPB_OVERHEAD                 (7*4+8+4+4)
+
+/*** MACROS                   ***/
+#define PCAPNG_PAD(x)                       (((x)+3)&~3)
+
+/*** TYPE DEFINITIONS         ***/
+struct RxTxBinaryDisplayCaptureData
+{
+    FILE *File;
+    std::thread Thread;
+    std::mutex Lock;
+    std::condition_variable Wake;
+
+    uint8_t *Buffers[2];
+    int Active;                 // The buffer we are filling
+    uint32_t Fill;              // Bytes in the active buffer
+    bool WritePending;          // The other buffer is waiting to be written
+    uint32_t WriteLen;
+    bool Quit;
+    bool WriteFailed;
+    t_RTBDStatsType *Stats;     // Where we report dropped chunks / failures
+
+    /* The run of bytes from RxTxBinaryDisplay_CaptureAddByte() */
+    uint8_t *Run;
+    uint32_t RunLen;
+    bool RunTx;
+    uint64_t RunStartNS;
+    uint64_t RunLastNS;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static void RxTxBinaryDisplay_CaptureThread(
+        struct RxTxBinaryDisplayCaptureData *Cap);
+static bool RxTxBinaryDisplay_CaptureSwap(
+        struct RxTxBinaryDisplayCaptureData *Cap);
+static void RxTxBinaryDisplay_CaptureAddEPB(
+        struct RxTxBinaryDisplayCaptureData *Cap,bool Tx,uint64_t TimeNS,
+        const uint8_t *Data,uint32_t Len);
+static void RxTxBinaryDisplay_CaptureEndRun(
+        struct RxTxBinaryDisplayCaptureData *Cap);
+static uint64_t RxTxBinaryDisplay_CaptureNow(void);
+static uint8_t *RxTxBinaryDisplay_Put32(uint8_t *Pos,uint32_t Value);
+static uint8_t *RxTxBinaryDisplay_Put16(uint8_t *Pos,uint16_t Value);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureOpen
+ *
+ * SYNOPSIS:
+ *    t_RTBDCaptureType *RxTxBinaryDisplay_CaptureOpen(const char *Filename,
+ *          t_RTBDStatsType *Stats);
+ *
+ * PARAMETERS:
+ *    Filename [I] -- The file to write.  If it exists it is replaced.
+ *    Stats [I] -- The connection's stats.  The capture state and any chunks
+ *                 we have to drop are reported here.  This must stay
+ *                 around until the capture is closed.
+ *
+ * FUNCTION:
+ *    This function makes a new capture file, writes the pcapng section and
+ *    interface headers, and starts the writer thread.
+ *
+ * RETURNS:
+ *    A handle to the capture or NULL if there was an error.
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_CaptureAdd(), RxTxBinaryDisplay_CaptureClose()
+ ******************************************************************************/
+t_RTBDCaptureType *RxTxBinaryDisplay_CaptureOpen(const char *Filename,
+        t_RTBDStatsType *Stats)
+{
+    struct RxTxBinaryDisplayCaptureData *Cap;
+    uint8_t Header[28+32];
+    uint8_t *Pos;
+
+    Cap=NULL;
+    try
+    {
+        Cap=new struct RxTxBinaryDisplayCaptureData;
+        Cap->File=NULL;
+        Cap->Buffers[0]=NULL;
+        Cap->Buffers[1]=NULL;
+        Cap->Active=0;
+        Cap->Fill=0;
+        Cap->WritePending=false;
+        Cap->WriteLen=0;
+        Cap->Quit=false;
+        Cap->WriteFailed=false;
+        Cap->Stats=Stats;
+        Cap->Run=NULL;
+        Cap->RunLen=0;
+
+        Cap->Buffers[0]=new uint8_t[RTBD_CAPTURE_BUFFER_SIZE];
+        Cap->Buffers[1]=new uint8_t[RTBD_CAPTURE_BUFFER_SIZE];
+        Cap->Run=new uint8_t[RTBD_CAPTURE_SNAPLEN];
+
+        Cap->File=fopen(Filename,"wb");
+        if(Cap->File==NULL)
+            throw(0);
+
+        /* Section Header Block */
+        Pos=Header;
+        Pos=RxTxBinaryDisplay_Put32(Pos,PCAPNG_BLOCK_SHB);
+        Pos=RxTxBinaryDisplay_Put32(Pos,28);
+        Pos=RxTxBinaryDisplay_Put32(Pos,PCAPNG_BYTE_ORDER_MAGIC);
+        Pos=RxTxBinaryDisplay_Put16(Pos,1);         // Major
+        Pos=RxTxBinaryDisplay_Put16(Pos,0);         // Minor
+        Pos=RxTxBinaryDisplay_Put32(Pos,0xFFFFFFFF);    // Section length
+        Pos=RxTxBinaryDisplay_Put32(Pos,0xFFFFFFFF);    //  (not known)
+        Pos=RxTxBinaryDisplay_Put32(Pos,28);
+
+        /* Interface Description Block (with ns time stamps) */
+        Pos=RxTxBinaryDisplay_Put32(Pos,PCAPNG_BLOCK_IDB);
+        Pos=RxTxBinaryDisplay_Put32(Pos,32);
+        Pos=RxTxBinaryDisplay_Put16(Pos,LINKTYPE_USER0);
+        Pos=RxTxBinaryDisplay_Put16(Pos,0);
+        Pos=RxTxBinaryDisplay_Put32(Pos,RTBD_CAPTURE_SNAPLEN);
+        Pos=RxTxBinaryDisplay_Put16(Pos,PCAPNG_OPT_IF_TSRESOL);
+        Pos=RxTxBinaryDisplay_Put16(Pos,1);
+        *Pos++=9;                                   // 10^-9
+        memset(Pos,0x00,3);                         // Padding
+        Pos+=3;
+        Pos=RxTxBinaryDisplay_Put32(Pos,PCAPNG_OPT_ENDOFOPT);
+        Pos=RxTxBinaryDisplay_Put32(Pos,32);
+
+        if(fwrite(Header,Pos-Header,1,Cap->File)!=1)
+            throw(0);
+
+        Cap->Thread=std::thread(RxTxBinaryDisplay_CaptureThread,Cap);
+    }
+    catch(...)
+    {
+        RxTxBinaryDisplay_StatsSetCapture(Stats,e_RTBDStatsCapture_Failed);
+        if(Cap!=NULL)
+        {
+            if(Cap->File!=NULL)
+                fclose(Cap->File);
+            delete[] Cap->Buffers[0];
+            delete[] Cap->Buffers[1];
+            delete[] Cap->Run;
+            delete Cap;
+        }
+        return NULL;
+    }
+
+    RxTxBinaryDisplay_StatsSetCapture(Stats,e_RTBDStatsCapture_On);
+
+    return (t_RTBDCaptureType *)Cap;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureClose
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_CaptureClose(t_RTBDCaptureType *Capture);
+ *
+ * PARAMETERS:
+ *    Capture [I] -- The capture to close
+ *
+ * FUNCTION:
+ *    This function ends the current run of bytes, stops the writer thread,
+ *    writes anything that is left and closes the file.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_CaptureOpen()
+ ******************************************************************************/
+void RxTxBinaryDisplay_CaptureClose(t_RTBDCaptureType *Capture)
+{
+    struct RxTxBinaryDisplayCaptureData *Cap=
+            (struct RxTxBinaryDisplayCaptureData *)Capture;
+
+    {
+        std::lock_guard<std::mutex> Guard(Cap->Lock);
+        RxTxBinaryDisplay_CaptureEndRun(Cap);
+        Cap->Quit=true;
+    }
+    Cap->Wake.notify_one();
+    Cap->Thread.join();
+
+    /* The thread has written the other buffer, write what we have left */
+    if(Cap->Fill>0 && !Cap->WriteFailed)
+        fwrite(Cap->Buffers[Cap->Active],Cap->Fill,1,Cap->File);
+
+    fclose(Cap->File);
+    delete[] Cap->Buffers[0];
+    delete[] Cap->Buffers[1];
+    delete[] Cap->Run;
+    delete Cap;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureAdd
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_CaptureAdd(t_RTBDCaptureType *Capture,bool Tx,
+ *          const uint8_t *Data,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Capture [I] -- The capture to add to
+ *    Tx [I] -- true if these bytes were sent, false if they came in
+ *    Data [I] -- The bytes
+ *    Len [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function adds a chunk of bytes to the capture.  It's one packet
+ *    unless it's bigger than RTBD_CAPTURE_SNAPLEN, then it's split in to as
+ *    many packets as it takes (all with the same time stamp).
+ *
+ *    This never waits on the disk.  If both buffers are full the packet is
+ *    dropped.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_CaptureOpen(), RxTxBinaryDisplay_CaptureAddByte()
+ ******************************************************************************/
+void RxTxBinaryDisplay_CaptureAdd(t_RTBDCaptureType *Capture,bool Tx,
+        const uint8_t *Data,uint32_t Len)
+{
+    struct RxTxBinaryDisplayCaptureData *Cap=
+            (struct RxTxBinaryDisplayCaptureData *)Capture;
+    uint64_t TimeNS;
+    uint32_t CapLen;
+
+    TimeNS=RxTxBinaryDisplay_CaptureNow();
+
+    std::lock_guard<std::mutex> Guard(Cap->Lock);
+
+    /* Keep things in order */
+    RxTxBinaryDisplay_CaptureEndRun(Cap);
+
+    while(Len>0)
+    {
+        CapLen=Len;
+        if(CapLen>RTBD_CAPTURE_SNAPLEN)
+            CapLen=RTBD_CAPTURE_SNAPLEN;
+        RxTxBinaryDisplay_CaptureAddEPB(Cap,Tx,TimeNS,Data,CapLen);
+        Data+=CapLen;
+        Len-=CapLen;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureAddByte
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_CaptureAddByte(t_RTBDCaptureType *Capture,
+ *          bool Tx,uint8_t Byte);
+ *
+ * PARAMETERS:
+ *    Capture [I] -- The capture to add to
+ *    Tx [I] -- true if this byte was sent, false if it came in
+ *    Byte [I] -- The byte
+ *
+ * FUNCTION:
+ *    This function adds one byte to the capture.  The bytes are gathered in
+ *    to a run and the run is saved as one packet (with the time of the
+ *    first byte) when the direction changes, it gets to
+ *    RTBD_CAPTURE_SNAPLEN bytes, or no bytes come for
+ *    RTBD_CAPTURE_RUN_GAP_MS.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_CaptureAdd()
+ ******************************************************************************/
+void RxTxBinaryDisplay_CaptureAddByte(t_RTBDCaptureType *Capture,bool Tx,
+        uint8_t Byte)
+{
+    struct RxTxBinaryDisplayCaptureData *Cap=
+            (struct RxTxBinaryDisplayCaptureData *)Capture;
+    uint64_t TimeNS;
+
+    TimeNS=RxTxBinaryDisplay_CaptureNow();
+
+    std::lock_guard<std::mutex> Guard(Cap->Lock);
+
+    if(Cap->RunLen>0 && (Cap->RunTx!=Tx ||
+            TimeNS-Cap->RunLastNS>RTBD_CAPTURE_RUN_GAP_MS*NS_PER_MS))
+    {
+        RxTxBinaryDisplay_CaptureEndRun(Cap);
+    }
+
+    if(Cap->RunLen==0)
+    {
+        Cap->RunTx=Tx;
+        Cap->RunStartNS=TimeNS;
+    }
+    Cap->Run[Cap->RunLen++]=Byte;
+    Cap->RunLastNS=TimeNS;
+
+    if(Cap->RunLen==RTBD_CAPTURE_SNAPLEN)
+        RxTxBinaryDisplay_CaptureEndRun(Cap);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureEndRun
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CaptureEndRun(
+ *          struct RxTxBinaryDisplayCaptureData *Cap);
+ *
+ * PARAMETERS:
+ *    Cap [I] -- The capture
+ *
+ * FUNCTION:
+ *    This function saves the run of bytes from
+ *    RxTxBinaryDisplay_CaptureAddByte() as a packet (if there is one).
+ *    'Cap->Lock' must be held.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CaptureEndRun(
+        struct RxTxBinaryDisplayCaptureData *Cap)
+{
+    if(Cap->RunLen==0)
+        return;
+
+    RxTxBinaryDisplay_CaptureAddEPB(Cap,Cap->RunTx,Cap->RunStartNS,Cap->Run,
+            Cap->RunLen);
+    Cap->RunLen=0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureAddEPB
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CaptureAddEPB(
+ *          struct RxTxBinaryDisplayCaptureData *Cap,bool Tx,uint64_t TimeNS,
+ *          const uint8_t *Data,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Cap [I] -- The capture
+ *    Tx [I] -- true if these bytes were sent, false if they came in
+ *    TimeNS [I] -- The time stamp for the packet
+ *    Data [I] -- The bytes
+ *    Len [I] -- The number of bytes in 'Data' (RTBD_CAPTURE_SNAPLEN max)
+ *
+ * FUNCTION:
+ *    This function adds one Enhanced Packet Block to the active buffer.  If
+ *    it doesn't fit the buffers are swapped, if the writer is still busy
+ *    the packet is dropped.  'Cap->Lock' must be held.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CaptureAddEPB(
+        struct RxTxBinaryDisplayCaptureData *Cap,bool Tx,uint64_t TimeNS,
+        const uint8_t *Data,uint32_t Len)
+{
+    uint32_t BlockLen;
+    uint8_t *Start;
+    uint8_t *Pos;
+
+    BlockLen=PCAPNG_EPB_OVERHEAD+PCAPNG_PAD(Len);
+
+    if(Cap->Fill+BlockLen>RTBD_CAPTURE_BUFFER_SIZE)
+    {
+        if(!RxTxBinaryDisplay_CaptureSwap(Cap))
+        {
+            RxTxBinaryDisplay_StatsCaptureDropped(Cap->Stats,
+                    Tx?e_RTBDStatsDir_Tx:e_RTBDStatsDir_Rx);
+            return;
+        }
+        Cap->Wake.notify_one();
+    }
+
+    Start=&Cap->Buffers[Cap->Active][Cap->Fill];
+    Pos=Start;
+    Pos=RxTxBinaryDisplay_Put32(Pos,PCAPNG_BLOCK_EPB);
+    Pos=RxTxBinaryDisplay_Put32(Pos,BlockLen);
+    Pos=RxTxBinaryDisplay_Put32(Pos,0);             // Interface
+    Pos=RxTxBinaryDisplay_Put32(Pos,TimeNS>>32);
+    Pos=RxTxBinaryDisplay_Put32(Pos,TimeNS&0xFFFFFFFF);
+    Pos=RxTxBinaryDisplay_Put32(Pos,Len);           // Captured length
+    Pos=RxTxBinaryDisplay_Put32(Pos,Len);           // Original length
+    memcpy(Pos,Data,Len);
+    memset(Pos+Len,0x00,PCAPNG_PAD(Len)-Len);
+    Pos+=PCAPNG_PAD(Len);
+    Pos=RxTxBinaryDisplay_Put16(Pos,PCAPNG_OPT_EPB_FLAGS);
+    Pos=RxTxBinaryDisplay_Put16(Pos,4);
+    Pos=RxTxBinaryDisplay_Put32(Pos,Tx?PCAPNG_EPB_FLAGS_OUTBOUND:
+            PCAPNG_EPB_FLAGS_INBOUND);
+    Pos=RxTxBinaryDisplay_Put32(Pos,PCAPNG_OPT_ENDOFOPT);
+    Pos=RxTxBinaryDisplay_Put32(Pos,BlockLen);
+
+    Cap->Fill+=Pos-Start;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureSwap
+ *
+ * SYNOPSIS:
+ *    static bool RxTxBinaryDisplay_CaptureSwap(
+ *          struct RxTxBinaryDisplayCaptureData *Cap);
+ *
+ * PARAMETERS:
+ *    Cap [I] -- The capture
+ *
+ * FUNCTION:
+ *    This function hands the active buffer to the writer thread and starts
+ *    filling the other one.  'Cap->Lock' must be held.
+ *
+ * RETURNS:
+ *    true -- The buffers where swapped
+ *    false -- The writer is still busy with the other buffer
+ ******************************************************************************/
+static bool RxTxBinaryDisplay_CaptureSwap(
+        struct RxTxBinaryDisplayCaptureData *Cap)
+{
+    if(Cap->WritePending)
+        return false;
+
+    Cap->WritePending=true;
+    Cap->WriteLen=Cap->Fill;
+    Cap->Active^=1;
+    Cap->Fill=0;
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureThread
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_CaptureThread(
+ *          struct RxTxBinaryDisplayCaptureData *Cap);
+ *
+ * PARAMETERS:
+ *    Cap [I] -- The capture
+ *
+ * FUNCTION:
+ *    This is the writer thread.  It waits for a full buffer (or for
+ *    RTBD_CAPTURE_FLUSH_MS to go by, then it takes what there is) and writes
+ *    it without holding the lock.  A run of bytes that has stopped is
+ *    ended first so the last bytes don't sit there until more come in.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_CaptureThread(
+        struct RxTxBinaryDisplayCaptureData *Cap)
+{
+    std::unique_lock<std::mutex> Guard(Cap->Lock);
+    const uint8_t *Buffer;
+    uint32_t Len;
+    bool Quit;
+
+    for(;;)
+    {
+        Cap->Wake.wait_for(Guard,
+                std::chrono::milliseconds(RTBD_CAPTURE_FLUSH_MS),
+                [Cap]{return Cap->WritePending || Cap->Quit;});
+
+        if(!Cap->WritePending && !Cap->Quit)
+        {
+            if(Cap->RunLen>0 && RxTxBinaryDisplay_CaptureNow()-
+                    Cap->RunLastNS>RTBD_CAPTURE_RUN_GAP_MS*NS_PER_MS)
+            {
+                RxTxBinaryDisplay_CaptureEndRun(Cap);
+            }
+            if(Cap->Fill>0)
+                RxTxBinaryDisplay_CaptureSwap(Cap);
+        }
+
+        Quit=Cap->Quit;
+        if(Cap->WritePending)
+        {
+            Buffer=Cap->Buffers[Cap->Active^1];
+            Len=Cap->WriteLen;
+
+            Guard.unlock();
+            if(!Cap->WriteFailed)
+            {
+                if(fwrite(Buffer,Len,1,Cap->File)!=1)
+                {
+                    Cap->WriteFailed=true;
+                    RxTxBinaryDisplay_StatsSetCapture(Cap->Stats,
+                            e_RTBDStatsCapture_Failed);
+                }
+                fflush(Cap->File);
+            }
+            Guard.lock();
+
+            Cap->WritePending=false;
+        }
+
+        if(Quit)
+            break;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_Put32
+ *
+ * SYNOPSIS:
+ *    static uint8_t *RxTxBinaryDisplay_Put32(uint8_t *Pos,uint32_t Value);
+ *
+ * PARAMETERS:
+ *    Pos [I] -- Where to put the value
+ *    Value [I] -- The value to put
+ *
+ * FUNCTION:
+ *    This function puts a 32 bit value into a block.  pcapng files are
+ *    written in the host byte order (the reader uses the byte order magic).
+ *
+ * RETURNS:
+ *    The position after the value.
+ ******************************************************************************/
+static uint8_t *RxTxBinaryDisplay_Put32(uint8_t *Pos,uint32_t Value)
+{
+    memcpy(Pos,&Value,sizeof(Value));
+    return Pos+sizeof(Value);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_Put16
+ *
+ * SYNOPSIS:
+ *    static uint8_t *RxTxBinaryDisplay_Put16(uint8_t *Pos,uint16_t Value);
+ *
+ * PARAMETERS:
+ *    Pos [I] -- Where to put the value
+ *    Value [I] -- The value to put
+ *
+ * FUNCTION:
+ *    This function puts a 16 bit value into a block.
+ *
+ * RETURNS:
+ *    The position after the value.
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_Put32()
+ ******************************************************************************/
+static uint8_t *RxTxBinaryDisplay_Put16(uint8_t *Pos,uint16_t Value)
+{
+    memcpy(Pos,&Value,sizeof(Value));
+    return Pos+sizeof(Value);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CaptureNow
+ *
+ * SYNOPSIS:
+ *    static uint64_t RxTxBinaryDisplay_CaptureNow(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function gets the time for the packet time stamps.
+ *
+ * RETURNS:
+ *    The time in ns since the epoch.
+ ******************************************************************************/
+static uint64_t RxTxBinaryDisplay_CaptureNow(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
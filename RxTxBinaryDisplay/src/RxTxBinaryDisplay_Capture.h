@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * FILENAME: RxTxBinaryDisplay_Capture.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the pcapng capture file writer in it.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __RXTXBINARYDISPLAY_CAPTURE_H_
+#define __RXTXBINARYDISPLAY_CAPTURE_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include "RxTxBinaryDisplay_Stats.h"
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+struct RTBDCapture {int PrivateDataHere;};
+typedef struct RTBDCapture t_RTBDCaptureType;
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+t_RTBDCaptureType *RxTxBinaryDisplay_CaptureOpen(const char *Filename,
+        t_RTBDStatsType *Stats);
+void RxTxBinaryDisplay_CaptureAdd(t_RTBDCaptureType *Capture,bool Tx,
+        const uint8_t *Data,uint32_t Len);
+void RxTxBinaryDisplay_CaptureAddByte(t_RTBDCaptureType *Capture,bool Tx,
+        uint8_t Byte);
+void RxTxBinaryDisplay_CaptureClose(t_RTBDCaptureType *Capture);
+
+#endif
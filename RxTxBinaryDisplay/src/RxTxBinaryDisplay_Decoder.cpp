@@ -0,0 +1,666 @@
+/*******************************************************************************
+ * FILENAME: RxTxBinaryDisplay_Decoder.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the frame decoders in it.  Bytes are fed in with
+ *    RxTxBinaryDisplay_Decode() and it stops each time it finishes a frame
+ *    so the caller can show it before the buffer is used again.
+ *
+ *    The HDLC FCS is CRC-16/CCITT (the X.25 version, reflected 0x1021).  It
+ *    is worked out over the whole frame when the frame ends using slice by 8
+ *    tables (8 bytes per step).
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "RxTxBinaryDisplay_Decoder.h"
+#include <string.h>
+
+/*** DEFINES                  ***/
+#define SLIP_END                            0xC0
+#define SLIP_ESC                            0xDB
+#define SLIP_ESC_END                        0xDC
+#define SLIP_ESC_ESC                        0xDD
+
+#define HDLC_FLAG                           0x7E
+#define HDLC_ESC                            0x7D
+#define HDLC_ESC_XOR                        0x20
+
+#define CRC16_POLY                          0x8408  // 0x1021 reflected
+#define CRC16_INIT                          0xFFFF
+#define CRC16_XOROUT                        0xFFFF
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+
+/*** FUNCTION PROTOTYPES      ***/
+static uint32_t RxTxBinaryDisplay_DecodeEscaped(
+        struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,uint32_t Len,
+        uint8_t Flag,uint8_t Esc,bool *GotFrame);
+static uint32_t RxTxBinaryDisplay_DecodeCOBSBytes(
+        struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,uint32_t Len,
+        bool *GotFrame);
+static uint32_t RxTxBinaryDisplay_DecodeLengthPrefix(
+        struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,uint32_t Len,
+        bool *GotFrame);
+static void RxTxBinaryDisplay_AddFrameBytes(struct RxTxBinaryDisplayDecoder *Dec,
+        const uint8_t *Data,uint32_t Len);
+static void RxTxBinaryDisplay_FinishFrame(struct RxTxBinaryDisplayDecoder *Dec,
+        struct RxTxBinaryDisplayFrame *Frame);
+static void RxTxBinaryDisplay_StartFrame(struct RxTxBinaryDisplayDecoder *Dec);
+
+/*** VARIABLE DEFINITIONS     ***/
+static uint16_t m_RTBD_CRCTable[8][256];
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_InitDecoders
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_InitDecoders(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function builds the CRC tables.  It must be called before any of
+ *    the other decoder functions.
+ *
+ *    Table 0 is the normal byte at a time table, table n is the CRC of a
+ *    byte followed by n zero bytes.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void RxTxBinaryDisplay_InitDecoders(void)
+{
+    unsigned int r;
+    unsigned int b;
+    unsigned int t;
+    uint16_t CRC;
+
+    for(r=0;r<256;r++)
+    {
+        CRC=r;
+        for(b=0;b<8;b++)
+            CRC=(CRC&1)?(CRC>>1)^CRC16_POLY:CRC>>1;
+        m_RTBD_CRCTable[0][r]=CRC;
+    }
+
+    for(t=1;t<8;t++)
+    {
+        for(r=0;r<256;r++)
+        {
+            CRC=m_RTBD_CRCTable[t-1][r];
+            m_RTBD_CRCTable[t][r]=(CRC>>8)^m_RTBD_CRCTable[0][CRC&0xFF];
+        }
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_CRC16
+ *
+ * SYNOPSIS:
+ *    uint16_t RxTxBinaryDisplay_CRC16(const uint8_t *Data,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Data [I] -- The bytes to work out the CRC for
+ *    Len [I] -- The number of bytes in 'Data'
+ *
+ * FUNCTION:
+ *    This function works out the CRC-16/CCITT (X.25) of a block of bytes.
+ *    This is the FCS that HDLC uses.  It does 8 bytes at a time and then
+ *    finishes off the last few bytes one at a time.
+ *
+ * RETURNS:
+ *    The CRC (already inverted, the way it's sent)
+ ******************************************************************************/
+uint16_t RxTxBinaryDisplay_CRC16(const uint8_t *Data,uint32_t Len)
+{
+    uint16_t CRC;
+
+    CRC=CRC16_INIT;
+    while(Len>=8)
+    {
+        CRC^=Data[0]|(Data[1]<<8);
+        CRC=m_RTBD_CRCTable[7][CRC&0xFF]^m_RTBD_CRCTable[6][CRC>>8]^
+                m_RTBD_CRCTable[5][Data[2]]^m_RTBD_CRCTable[4][Data[3]]^
+                m_RTBD_CRCTable[3][Data[4]]^m_RTBD_CRCTable[2][Data[5]]^
+                m_RTBD_CRCTable[1][Data[6]]^m_RTBD_CRCTable[0][Data[7]];
+        Data+=8;
+        Len-=8;
+    }
+    while(Len>0)
+    {
+        CRC=(CRC>>8)^m_RTBD_CRCTable[0][(CRC^*Data)&0xFF];
+        Data++;
+        Len--;
+    }
+
+    return CRC^CRC16_XOROUT;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_ResetDecoder
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_ResetDecoder(struct RxTxBinaryDisplayDecoder *Dec,
+ *          e_RTBDDecoderType Type,unsigned int PrefixSize,
+ *          bool PrefixBigEndian);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to reset
+ *    Type [I] -- The type of frames to decode
+ *    PrefixSize [I] -- The number of bytes in the length (for
+ *                      e_RTBDDecoder_LengthPrefix).  1, 2, or 4.
+ *    PrefixBigEndian [I] -- Is the length sent MSB first
+ *
+ * FUNCTION:
+ *    This function sets up a decoder.  Anything that was part way though
+ *    being decoded is thrown away.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void RxTxBinaryDisplay_ResetDecoder(struct RxTxBinaryDisplayDecoder *Dec,
+        e_RTBDDecoderType Type,unsigned int PrefixSize,bool PrefixBigEndian)
+{
+    if(PrefixSize!=1 && PrefixSize!=2 && PrefixSize!=4)
+        PrefixSize=2;
+
+    Dec->Type=Type;
+    Dec->PrefixSize=PrefixSize;
+    Dec->PrefixBigEndian=PrefixBigEndian;
+    Dec->StreamOffset=0;
+    RxTxBinaryDisplay_StartFrame(Dec);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_ChangeDecoder
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_ChangeDecoder(struct RxTxBinaryDisplayDecoder *Dec,
+ *          e_RTBDDecoderType Type,unsigned int PrefixSize,
+ *          bool PrefixBigEndian);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to change
+ *    Type [I] -- The type of frames to decode
+ *    PrefixSize [I] -- The number of bytes in the length (for
+ *                      e_RTBDDecoder_LengthPrefix).  1, 2, or 4.
+ *    PrefixBigEndian [I] -- Is the length sent MSB first
+ *
+ * FUNCTION:
+ *    This function is like RxTxBinaryDisplay_ResetDecoder() but only resets
+ *    the decoder if the settings are different.  This way applying the
+ *    settings doesn't throw away a frame that is part way though.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_ResetDecoder()
+ ******************************************************************************/
+void RxTxBinaryDisplay_ChangeDecoder(struct RxTxBinaryDisplayDecoder *Dec,
+        e_RTBDDecoderType Type,unsigned int PrefixSize,bool PrefixBigEndian)
+{
+    if(PrefixSize!=1 && PrefixSize!=2 && PrefixSize!=4)
+        PrefixSize=2;
+
+    if(Dec->Type==Type && Dec->PrefixSize==PrefixSize &&
+            Dec->PrefixBigEndian==PrefixBigEndian)
+    {
+        return;
+    }
+
+    RxTxBinaryDisplay_ResetDecoder(Dec,Type,PrefixSize,PrefixBigEndian);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_Decode
+ *
+ * SYNOPSIS:
+ *    uint32_t RxTxBinaryDisplay_Decode(struct RxTxBinaryDisplayDecoder *Dec,
+ *          const uint8_t *Data,uint32_t Len,
+ *          struct RxTxBinaryDisplayFrame *Frame,bool *GotFrame);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to use
+ *    Data [I] -- The bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Frame [O] -- The frame that was finished (if 'GotFrame' is set)
+ *    GotFrame [O] -- Set to true if a frame was finished, false if more
+ *                    bytes are needed.
+ *
+ * FUNCTION:
+ *    This function feeds bytes into the decoder.  It stops after the byte
+ *    that finishes a frame, so call it again with the rest of the bytes
+ *    after you are done with 'Frame'.
+ *
+ * RETURNS:
+ *    The number of bytes from 'Data' that were used.
+ ******************************************************************************/
+uint32_t RxTxBinaryDisplay_Decode(struct RxTxBinaryDisplayDecoder *Dec,
+        const uint8_t *Data,uint32_t Len,struct RxTxBinaryDisplayFrame *Frame,
+        bool *GotFrame)
+{
+    uint32_t Used;
+
+    *GotFrame=false;
+    switch(Dec->Type)
+    {
+        case e_RTBDDecoder_SLIP:
+            Used=RxTxBinaryDisplay_DecodeEscaped(Dec,Data,Len,SLIP_END,
+                    SLIP_ESC,GotFrame);
+        break;
+        case e_RTBDDecoder_HDLC:
+            Used=RxTxBinaryDisplay_DecodeEscaped(Dec,Data,Len,HDLC_FLAG,
+                    HDLC_ESC,GotFrame);
+        break;
+        case e_RTBDDecoder_COBS:
+            Used=RxTxBinaryDisplay_DecodeCOBSBytes(Dec,Data,Len,GotFrame);
+        break;
+        case e_RTBDDecoder_LengthPrefix:
+            Used=RxTxBinaryDisplay_DecodeLengthPrefix(Dec,Data,Len,GotFrame);
+        break;
+        case e_RTBDDecoder_None:
+        case e_RTBDDecoderMAX:
+        default:
+            Used=Len;
+        break;
+    }
+    Dec->StreamOffset+=Used;
+
+    if(*GotFrame)
+        RxTxBinaryDisplay_FinishFrame(Dec,Frame);
+
+    return Used;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_DecodeEscaped
+ *
+ * SYNOPSIS:
+ *    static uint32_t RxTxBinaryDisplay_DecodeEscaped(
+ *          struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,
+ *          uint32_t Len,uint8_t Flag,uint8_t Esc,bool *GotFrame);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to use
+ *    Data [I] -- The bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Flag [I] -- The byte that ends a frame
+ *    Esc [I] -- The escape byte
+ *    GotFrame [O] -- Set to true if a frame was finished
+ *
+ * FUNCTION:
+ *    This function decodes SLIP and HDLC frames (they only differ in the
+ *    bytes they use and how the escaped byte is sent).  Runs of plain bytes
+ *    are copied into the frame buffer in one go.  Empty frames (back to
+ *    back flags) are skipped.
+ *
+ * RETURNS:
+ *    The number of bytes from 'Data' that were used.
+ ******************************************************************************/
+static uint32_t RxTxBinaryDisplay_DecodeEscaped(
+        struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,uint32_t Len,
+        uint8_t Flag,uint8_t Esc,bool *GotFrame)
+{
+    uint32_t Pos;
+    uint32_t Start;
+    uint8_t c;
+
+    Pos=0;
+    while(Pos<Len)
+    {
+        if(Dec->Escape)
+        {
+            c=Data[Pos++];
+            Dec->Escape=false;
+            if(c==Flag)
+            {
+                /* An escape then the end of the frame (aborted frame) */
+                Dec->BadEncoding=true;
+                *GotFrame=true;
+                return Pos;
+            }
+            if(Flag==HDLC_FLAG)
+            {
+                c^=HDLC_ESC_XOR;
+            }
+            else
+            {
+                if(c==SLIP_ESC_END)
+                {
+                    c=SLIP_END;
+                }
+                else if(c==SLIP_ESC_ESC)
+                {
+                    c=SLIP_ESC;
+                }
+                else
+                {
+                    /* Not a valid escape, keep the byte as is */
+                    Dec->BadEncoding=true;
+                }
+            }
+            RxTxBinaryDisplay_AddFrameBytes(Dec,&c,1);
+            continue;
+        }
+
+        /* Copy the run of plain bytes */
+        Start=Pos;
+        while(Pos<Len && Data[Pos]!=Flag && Data[Pos]!=Esc)
+            Pos++;
+        if(Pos!=Start)
+            RxTxBinaryDisplay_AddFrameBytes(Dec,&Data[Start],Pos-Start);
+        if(Pos>=Len)
+            break;
+
+        c=Data[Pos++];
+        if(c==Esc)
+        {
+            Dec->Escape=true;
+            continue;
+        }
+
+        /* End of frame */
+        if(Dec->FullLen==0 && !Dec->BadEncoding)
+        {
+            /* Empty frame, the next one starts after this flag */
+            Dec->FrameStart=Dec->StreamOffset+Pos;
+            continue;
+        }
+        *GotFrame=true;
+        return Pos;
+    }
+
+    return Pos;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_DecodeCOBSBytes
+ *
+ * SYNOPSIS:
+ *    static uint32_t RxTxBinaryDisplay_DecodeCOBSBytes(
+ *          struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,
+ *          uint32_t Len,bool *GotFrame);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to use
+ *    Data [I] -- The bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    GotFrame [O] -- Set to true if a frame was finished
+ *
+ * FUNCTION:
+ *    This function collects COBS frames.  The encoded bytes are copied
+ *    until the 0x00 that ends the frame, then the frame is decoded in place
+ *    (decoding never makes the frame bigger).
+ *
+ * RETURNS:
+ *    The number of bytes from 'Data' that were used.
+ ******************************************************************************/
+static uint32_t RxTxBinaryDisplay_DecodeCOBSBytes(
+        struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,uint32_t Len,
+        bool *GotFrame)
+{
+    const uint8_t *End;
+    uint32_t Run;
+    uint32_t In;
+    uint32_t Out;
+    uint8_t Code;
+    unsigned int r;
+
+    End=(const uint8_t *)memchr(Data,0x00,Len);
+    if(End==NULL)
+    {
+        RxTxBinaryDisplay_AddFrameBytes(Dec,Data,Len);
+        return Len;
+    }
+
+    Run=End-Data;
+    RxTxBinaryDisplay_AddFrameBytes(Dec,Data,Run);
+
+    if(Dec->FullLen==0)
+    {
+        /* Empty frame */
+        Dec->FrameStart=Dec->StreamOffset+Run+1;
+        return Run+1;
+    }
+
+    /* Decode in place.  A code of n is followed by n-1 data bytes and then
+       a 0x00 (unless it's 0xFF or the last code) */
+    In=0;
+    Out=0;
+    while(In<Dec->FrameLen)
+    {
+        Code=Dec->Buffer[In++];
+        if(Code==0 || In+Code-1>Dec->FrameLen)
+        {
+            Dec->BadEncoding=true;
+            break;
+        }
+        for(r=1;r<Code;r++)
+            Dec->Buffer[Out++]=Dec->Buffer[In++];
+        if(Code!=0xFF && In<Dec->FrameLen)
+            Dec->Buffer[Out++]=0x00;
+    }
+    Dec->FrameLen=Out;
+    if(Dec->FullLen<=RTBD_MAX_FRAME_SIZE)
+        Dec->FullLen=Out;
+
+    *GotFrame=true;
+    return Run+1;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_DecodeLengthPrefix
+ *
+ * SYNOPSIS:
+ *    static uint32_t RxTxBinaryDisplay_DecodeLengthPrefix(
+ *          struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,
+ *          uint32_t Len,bool *GotFrame);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to use
+ *    Data [I] -- The bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    GotFrame [O] -- Set to true if a frame was finished
+ *
+ * FUNCTION:
+ *    This function decodes frames that start with a 1, 2, or 4 byte length
+ *    (of the payload only).  The payload is copied in as big a block as we
+ *    have.
+ *
+ * RETURNS:
+ *    The number of bytes from 'Data' that were used.
+ ******************************************************************************/
+static uint32_t RxTxBinaryDisplay_DecodeLengthPrefix(
+        struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,uint32_t Len,
+        bool *GotFrame)
+{
+    uint32_t Pos;
+    uint32_t Need;
+    uint32_t Take;
+
+    Pos=0;
+    while(Dec->PrefixGot<Dec->PrefixSize)
+    {
+        if(Pos>=Len)
+            return Pos;
+        if(Dec->PrefixBigEndian)
+            Dec->PayloadLen=(Dec->PayloadLen<<8)|Data[Pos];
+        else
+            Dec->PayloadLen|=(uint32_t)Data[Pos]<<(8*Dec->PrefixGot);
+        Dec->PrefixGot++;
+        Pos++;
+    }
+
+    Need=Dec->PayloadLen-Dec->FullLen;
+    Take=Len-Pos;
+    if(Take>Need)
+        Take=Need;
+    RxTxBinaryDisplay_AddFrameBytes(Dec,&Data[Pos],Take);
+    Pos+=Take;
+
+    if(Dec->FullLen==Dec->PayloadLen)
+        *GotFrame=true;
+
+    return Pos;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_AddFrameBytes
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_AddFrameBytes(
+ *          struct RxTxBinaryDisplayDecoder *Dec,const uint8_t *Data,
+ *          uint32_t Len);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to add to
+ *    Data [I] -- The bytes to add
+ *    Len [I] -- The number of bytes to add
+ *
+ * FUNCTION:
+ *    This function adds bytes to the frame buffer.  Anything that doesn't
+ *    fit is dropped (but still counted in 'FullLen').
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_AddFrameBytes(struct RxTxBinaryDisplayDecoder *Dec,
+        const uint8_t *Data,uint32_t Len)
+{
+    uint32_t Room;
+
+    Dec->FullLen+=Len;
+
+    Room=RTBD_MAX_FRAME_SIZE-Dec->FrameLen;
+    if(Len>Room)
+        Len=Room;
+    memcpy(&Dec->Buffer[Dec->FrameLen],Data,Len);
+    Dec->FrameLen+=Len;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_FinishFrame
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_FinishFrame(
+ *          struct RxTxBinaryDisplayDecoder *Dec,
+ *          struct RxTxBinaryDisplayFrame *Frame);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder that finished a frame
+ *    Frame [O] -- The info about the frame
+ *
+ * FUNCTION:
+ *    This function fills in 'Frame' (checking the CRC for HDLC) and gets
+ *    the decoder ready for the next frame.  The frame data stays in the
+ *    buffer until the next bytes are decoded.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_FinishFrame(struct RxTxBinaryDisplayDecoder *Dec,
+        struct RxTxBinaryDisplayFrame *Frame)
+{
+    Frame->Offset=Dec->FrameStart;
+    Frame->Data=Dec->Buffer;
+    Frame->Len=Dec->FrameLen;
+    Frame->FullLen=Dec->FullLen;
+    Frame->Status=e_RTBDFrameStatus_OK;
+    Frame->HasCRC=false;
+    Frame->CRC=0;
+
+    if(Dec->BadEncoding)
+    {
+        Frame->Status=e_RTBDFrameStatus_BadEncoding;
+    }
+    else if(Dec->FullLen>RTBD_MAX_FRAME_SIZE)
+    {
+        Frame->Status=e_RTBDFrameStatus_Overflow;
+    }
+    else if(Dec->Type==e_RTBDDecoder_HDLC)
+    {
+        if(Dec->FrameLen<2)
+        {
+            Frame->Status=e_RTBDFrameStatus_Short;
+        }
+        else
+        {
+            /* The FCS is sent LSB first */
+            Frame->Len=Dec->FrameLen-2;
+            Frame->FullLen=Frame->Len;
+            Frame->HasCRC=true;
+            Frame->CRC=Dec->Buffer[Frame->Len]|
+                    (Dec->Buffer[Frame->Len+1]<<8);
+            if(RxTxBinaryDisplay_CRC16(Frame->Data,Frame->Len)!=Frame->CRC)
+                Frame->Status=e_RTBDFrameStatus_BadCRC;
+        }
+    }
+
+    RxTxBinaryDisplay_StartFrame(Dec);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StartFrame
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_StartFrame(
+ *          struct RxTxBinaryDisplayDecoder *Dec);
+ *
+ * PARAMETERS:
+ *    Dec [I] -- The decoder to reset
+ *
+ * FUNCTION:
+ *    This function throws away any part of a frame and starts a new one at
+ *    the current stream offset.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_StartFrame(struct RxTxBinaryDisplayDecoder *Dec)
+{
+    Dec->FrameStart=Dec->StreamOffset;
+    Dec->FrameLen=0;
+    Dec->FullLen=0;
+    Dec->Escape=false;
+    Dec->BadEncoding=false;
+    Dec->PrefixGot=0;
+    Dec->PayloadLen=0;
+}
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * FILENAME: RxTxBinaryDisplay_Decoder.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the frame decoders (SLIP, COBS, HDLC, and length prefixed) in
+ *    it.  The decoders work on a stream of bytes and pull out the frames.
+ *    All the memory a decoder needs is in 'struct RxTxBinaryDisplayDecoder'
+ *    so nothing is allocated while decoding.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __RXTXBINARYDISPLAY_DECODER_H_
+#define __RXTXBINARYDISPLAY_DECODER_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+#define RTBD_MAX_FRAME_SIZE                 65536   // Bigger frames are cut off
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+typedef enum
+{
+    e_RTBDDecoder_None=0,       // No decoding, just hex
+    e_RTBDDecoder_SLIP,
+    e_RTBDDecoder_COBS,
+    e_RTBDDecoder_HDLC,
+    e_RTBDDecoder_LengthPrefix,
+    e_RTBDDecoderMAX
+} e_RTBDDecoderType;
+
+typedef enum
+{
+    e_RTBDFrameStatus_OK,
+    e_RTBDFrameStatus_BadCRC,
+    e_RTBDFrameStatus_BadEncoding,  // Bad escape / COBS code
+    e_RTBDFrameStatus_Short,        // Too short to have a CRC
+    e_RTBDFrameStatus_Overflow,     // Bigger than RTBD_MAX_FRAME_SIZE
+    e_RTBDFrameStatusMAX
+} e_RTBDFrameStatusType;
+
+struct RxTxBinaryDisplayFrame
+{
+    uint64_t Offset;            // Where the frame started in the stream
+    const uint8_t *Data;        // Only good until the next decode call
+    uint32_t Len;               // Bytes in 'Data' (without the CRC)
+    uint32_t FullLen;           // The size of the frame before it was cut off
+    e_RTBDFrameStatusType Status;
+    bool HasCRC;
+    uint16_t CRC;               // The CRC from the frame (if 'HasCRC')
+};
+
+struct RxTxBinaryDisplayDecoder
+{
+    e_RTBDDecoderType Type;
+    unsigned int PrefixSize;    // 1, 2, or 4
+    bool PrefixBigEndian;
+
+    uint64_t StreamOffset;
+    uint64_t FrameStart;
+    uint32_t FrameLen;          // Bytes in 'Buffer'
+    uint32_t FullLen;           // Bytes in the frame (even if we dropped them)
+    bool Escape;
+    bool BadEncoding;
+
+    /* Length prefix */
+    unsigned int PrefixGot;
+    uint32_t PayloadLen;
+
+    uint8_t Buffer[RTBD_MAX_FRAME_SIZE];
+};
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+void RxTxBinaryDisplay_InitDecoders(void);
+void RxTxBinaryDisplay_ResetDecoder(struct RxTxBinaryDisplayDecoder *Dec,
+        e_RTBDDecoderType Type,unsigned int PrefixSize,bool PrefixBigEndian);
+void RxTxBinaryDisplay_ChangeDecoder(struct RxTxBinaryDisplayDecoder *Dec,
+        e_RTBDDecoderType Type,unsigned int PrefixSize,bool PrefixBigEndian);
+uint32_t RxTxBinaryDisplay_Decode(struct RxTxBinaryDisplayDecoder *Dec,
+        const uint8_t *Data,uint32_t Len,struct RxTxBinaryDisplayFrame *Frame,
+        bool *GotFrame);
+uint16_t RxTxBinaryDisplay_CRC16(const uint8_t *Data,uint32_t Len);
+
+#endif
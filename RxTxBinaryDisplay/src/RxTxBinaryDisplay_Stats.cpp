@@ -0,0 +1,506 @@
+/*******************************************************************************
+ * FILENAME: RxTxBinaryDisplay_Stats.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file counts the Rx and Tx bytes so we can show how busy the link
+ *    is.  Bytes are counted per second in a ring of one second buckets
+ *    which gives the 1s / 10s / 60s rates.  Blocks that come in less than
+ *    RTBD_STATS_BURST_GAP_MS apart are counted as one burst.
+ *
+ *    Each connection has it's own counters.  Only the thread that processes
+ *    a connection's data adds to them so they are plain loads / stores of
+ *    atomics (no locks or locked adds).  The atomics are there so the
+ *    settings dialog can read them at any time.  The settings dialog isn't
+ *    tied to one connection so it gets all of them, the list of connections
+ *    is protected by a lock.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "RxTxBinaryDisplay_Stats.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+/*** DEFINES                  ***/
+#define RTBD_STATS_LONGEST_WINDOW           60      // Seconds
+#define RTBD_STATS_SECONDS                  (RTBD_STATS_LONGEST_WINDOW+1) // +1 for the current second
+#define RTBD_STATS_BURST_GAP_MS             10      // A gap this long ends a burst
+#define NS_PER_SEC                          1000000000ULL
+#define NS_PER_MS                           1000000ULL
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+struct RxTxBinaryDisplayDirStats
+{
+    std::atomic<uint64_t> TotalBytes;
+    std::atomic<uint64_t> Second;           // The newest second in 'Buckets'
+    std::atomic<uint64_t> Buckets[RTBD_STATS_SECONDS];
+    std::atomic<uint64_t> LastNS;           // When the last block came in
+    std::atomic<uint64_t> BurstBytes;
+    std::atomic<uint64_t> LargestBurst;
+    std::atomic<uint64_t> LastGapMS;
+    std::atomic<uint64_t> ShortestGapMS;
+    std::atomic<bool> HasGap;
+    std::atomic<uint64_t> CaptureDropped;
+};
+
+struct RxTxBinaryDisplayStatsData
+{
+    unsigned int ID;
+    std::atomic<e_RTBDStatsCaptureType> Capture;
+    struct RxTxBinaryDisplayDirStats Dir[e_RTBDStatsDirMAX];
+    struct RxTxBinaryDisplayStatsData *Next;
+    struct RxTxBinaryDisplayStatsData *Prev;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static uint64_t RxTxBinaryDisplay_StatsNow(void);
+static void RxTxBinaryDisplay_StatsGetDir(struct RxTxBinaryDisplayDirStats *S,
+        struct RxTxBinaryDisplayStats *Stats);
+static double RxTxBinaryDisplay_StatsRate(struct RxTxBinaryDisplayDirStats *S,
+        uint64_t NowSec,uint64_t NewestSec,unsigned int Seconds);
+
+/*** VARIABLE DEFINITIONS     ***/
+static std::mutex m_RTBD_StatsLock;        // Protects the list (not the counters)
+static struct RxTxBinaryDisplayStatsData *m_RTBD_StatsList;
+static unsigned int m_RTBD_StatsNextID=1;
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsAlloc
+ *
+ * SYNOPSIS:
+ *    t_RTBDStatsType *RxTxBinaryDisplay_StatsAlloc(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function makes a new set of counters for a connection and adds
+ *    it to the list RxTxBinaryDisplay_StatsGetAll() reads.
+ *
+ * RETURNS:
+ *    A handle to the counters or NULL if there was an error.
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_StatsFree()
+ ******************************************************************************/
+t_RTBDStatsType *RxTxBinaryDisplay_StatsAlloc(void)
+{
+    struct RxTxBinaryDisplayStatsData *Stats;
+    struct RxTxBinaryDisplayDirStats *S;
+    unsigned int d;
+    unsigned int s;
+
+    Stats=NULL;
+    try
+    {
+        Stats=new struct RxTxBinaryDisplayStatsData;
+        Stats->Capture.store(e_RTBDStatsCapture_Off,std::memory_order_relaxed);
+
+        for(d=0;d<e_RTBDStatsDirMAX;d++)
+        {
+            S=&Stats->Dir[d];
+            S->TotalBytes.store(0,std::memory_order_relaxed);
+            S->Second.store(0,std::memory_order_relaxed);
+            for(s=0;s<RTBD_STATS_SECONDS;s++)
+                S->Buckets[s].store(0,std::memory_order_relaxed);
+            S->LastNS.store(0,std::memory_order_relaxed);
+            S->BurstBytes.store(0,std::memory_order_relaxed);
+            S->LargestBurst.store(0,std::memory_order_relaxed);
+            S->LastGapMS.store(0,std::memory_order_relaxed);
+            S->ShortestGapMS.store(0,std::memory_order_relaxed);
+            S->HasGap.store(false,std::memory_order_relaxed);
+            S->CaptureDropped.store(0,std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> Lock(m_RTBD_StatsLock);
+        Stats->ID=m_RTBD_StatsNextID++;
+        Stats->Prev=NULL;
+        Stats->Next=m_RTBD_StatsList;
+        if(m_RTBD_StatsList!=NULL)
+            m_RTBD_StatsList->Prev=Stats;
+        m_RTBD_StatsList=Stats;
+    }
+    catch(...)
+    {
+        if(Stats!=NULL)
+            delete Stats;
+        return NULL;
+    }
+
+    return (t_RTBDStatsType *)Stats;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsFree
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_StatsFree(t_RTBDStatsType *Stats);
+ *
+ * PARAMETERS:
+ *    Stats [I] -- The counters to free
+ *
+ * FUNCTION:
+ *    This function removes a connection's counters from the list and frees
+ *    them.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    RxTxBinaryDisplay_StatsAlloc()
+ ******************************************************************************/
+void RxTxBinaryDisplay_StatsFree(t_RTBDStatsType *Stats)
+{
+    struct RxTxBinaryDisplayStatsData *SData=
+            (struct RxTxBinaryDisplayStatsData *)Stats;
+
+    {
+        std::lock_guard<std::mutex> Lock(m_RTBD_StatsLock);
+        if(SData->Prev!=NULL)
+            SData->Prev->Next=SData->Next;
+        else
+            m_RTBD_StatsList=SData->Next;
+        if(SData->Next!=NULL)
+            SData->Next->Prev=SData->Prev;
+    }
+
+    delete SData;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsAdd
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_StatsAdd(t_RTBDStatsType *Stats,
+ *          e_RTBDStatsDirType Dir,uint32_t Bytes);
+ *
+ * PARAMETERS:
+ *    Stats [I] -- The connection's counters
+ *    Dir [I] -- Are these Rx or Tx bytes
+ *    Bytes [I] -- The number of bytes that went by
+ *
+ * FUNCTION:
+ *    This function counts a block of bytes.  Call it once per block (not for
+ *    each byte).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void RxTxBinaryDisplay_StatsAdd(t_RTBDStatsType *Stats,e_RTBDStatsDirType Dir,
+        uint32_t Bytes)
+{
+    struct RxTxBinaryDisplayDirStats *S=
+            &((struct RxTxBinaryDisplayStatsData *)Stats)->Dir[Dir];
+    uint64_t Now;
+    uint64_t Sec;
+    uint64_t Cur;
+    uint64_t Last;
+    uint64_t Burst;
+    uint64_t Gap;
+    uint64_t s;
+
+    Now=RxTxBinaryDisplay_StatsNow();
+    Sec=Now/NS_PER_SEC;
+
+    Cur=S->Second.load(std::memory_order_relaxed);
+    if(Sec!=Cur)
+    {
+        /* Clear the seconds we skipped over */
+        if(Sec-Cur>=RTBD_STATS_SECONDS)
+        {
+            for(s=0;s<RTBD_STATS_SECONDS;s++)
+                S->Buckets[s].store(0,std::memory_order_relaxed);
+        }
+        else
+        {
+            for(s=Cur+1;s<=Sec;s++)
+            {
+                S->Buckets[s%RTBD_STATS_SECONDS].store(0,
+                        std::memory_order_relaxed);
+            }
+        }
+        S->Second.store(Sec,std::memory_order_release);
+    }
+
+    s=Sec%RTBD_STATS_SECONDS;
+    S->Buckets[s].store(S->Buckets[s].load(std::memory_order_relaxed)+Bytes,
+            std::memory_order_relaxed);
+    S->TotalBytes.store(S->TotalBytes.load(std::memory_order_relaxed)+Bytes,
+            std::memory_order_relaxed);
+
+    Last=S->LastNS.load(std::memory_order_relaxed);
+    if(Last==0 || Now-Last>RTBD_STATS_BURST_GAP_MS*NS_PER_MS)
+    {
+        /* This is the start of a new burst */
+        if(Last!=0)
+        {
+            Gap=(Now-Last)/NS_PER_MS;
+            S->LastGapMS.store(Gap,std::memory_order_relaxed);
+            if(!S->HasGap.load(std::memory_order_relaxed) ||
+                    Gap<S->ShortestGapMS.load(std::memory_order_relaxed))
+            {
+                S->ShortestGapMS.store(Gap,std::memory_order_relaxed);
+            }
+            S->HasGap.store(true,std::memory_order_relaxed);
+        }
+        Burst=Bytes;
+    }
+    else
+    {
+        Burst=S->BurstBytes.load(std::memory_order_relaxed)+Bytes;
+    }
+    S->BurstBytes.store(Burst,std::memory_order_relaxed);
+    if(Burst>S->LargestBurst.load(std::memory_order_relaxed))
+        S->LargestBurst.store(Burst,std::memory_order_relaxed);
+
+    S->LastNS.store(Now,std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsSetCapture
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_StatsSetCapture(t_RTBDStatsType *Stats,
+ *          e_RTBDStatsCaptureType State);
+ *
+ * PARAMETERS:
+ *    Stats [I] -- The connection's counters
+ *    State [I] -- What the capture file is doing now
+ *
+ * FUNCTION:
+ *    This function sets the capture state that is shown with the
+ *    connection's stats.  Turning the capture on clears the dropped
+ *    counts (they are for the current file).  This can be called from the
+ *    capture's writer thread.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void RxTxBinaryDisplay_StatsSetCapture(t_RTBDStatsType *Stats,
+        e_RTBDStatsCaptureType State)
+{
+    struct RxTxBinaryDisplayStatsData *SData=
+            (struct RxTxBinaryDisplayStatsData *)Stats;
+    unsigned int d;
+
+    if(State==e_RTBDStatsCapture_On)
+    {
+        for(d=0;d<e_RTBDStatsDirMAX;d++)
+            SData->Dir[d].CaptureDropped.store(0,std::memory_order_relaxed);
+    }
+    SData->Capture.store(State,std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsCaptureDropped
+ *
+ * SYNOPSIS:
+ *    void RxTxBinaryDisplay_StatsCaptureDropped(t_RTBDStatsType *Stats,
+ *          e_RTBDStatsDirType Dir);
+ *
+ * PARAMETERS:
+ *    Stats [I] -- The connection's counters
+ *    Dir [I] -- Was the chunk Rx or Tx
+ *
+ * FUNCTION:
+ *    This function counts a chunk that had to be left out of the capture
+ *    file (the writer couldn't keep up).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void RxTxBinaryDisplay_StatsCaptureDropped(t_RTBDStatsType *Stats,
+        e_RTBDStatsDirType Dir)
+{
+    struct RxTxBinaryDisplayDirStats *S=
+            &((struct RxTxBinaryDisplayStatsData *)Stats)->Dir[Dir];
+
+    S->CaptureDropped.store(S->CaptureDropped.load(
+            std::memory_order_relaxed)+1,std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsGetAll
+ *
+ * SYNOPSIS:
+ *    unsigned int RxTxBinaryDisplay_StatsGetAll(
+ *          struct RxTxBinaryDisplayConStats *List,unsigned int MaxCount);
+ *
+ * PARAMETERS:
+ *    List [O] -- Where to put the stats for each connection
+ *    MaxCount [I] -- The number of entries in 'List'
+ *
+ * FUNCTION:
+ *    This function reads the counters for every connection (oldest first).
+ *    If there are more than 'MaxCount' connections only the newest ones are
+ *    returned.
+ *
+ * RETURNS:
+ *    The number of entries filled in 'List'.
+ ******************************************************************************/
+unsigned int RxTxBinaryDisplay_StatsGetAll(
+        struct RxTxBinaryDisplayConStats *List,unsigned int MaxCount)
+{
+    struct RxTxBinaryDisplayStatsData *Stats;
+    unsigned int Count;
+    unsigned int d;
+
+    std::lock_guard<std::mutex> Lock(m_RTBD_StatsLock);
+
+    Count=0;
+    for(Stats=m_RTBD_StatsList;Stats!=NULL;Stats=Stats->Next)
+        Count++;
+    if(Count>MaxCount)
+        Count=MaxCount;
+
+    /* The newest is at the head of the list so fill from the end */
+    d=Count;
+    for(Stats=m_RTBD_StatsList;Stats!=NULL && d>0;Stats=Stats->Next)
+    {
+        d--;
+        List[d].ID=Stats->ID;
+        List[d].Capture=Stats->Capture.load(std::memory_order_relaxed);
+        RxTxBinaryDisplay_StatsGetDir(&Stats->Dir[e_RTBDStatsDir_Rx],
+                &List[d].Dir[e_RTBDStatsDir_Rx]);
+        RxTxBinaryDisplay_StatsGetDir(&Stats->Dir[e_RTBDStatsDir_Tx],
+                &List[d].Dir[e_RTBDStatsDir_Tx]);
+    }
+
+    return Count;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsGetDir
+ *
+ * SYNOPSIS:
+ *    static void RxTxBinaryDisplay_StatsGetDir(
+ *          struct RxTxBinaryDisplayDirStats *S,
+ *          struct RxTxBinaryDisplayStats *Stats);
+ *
+ * PARAMETERS:
+ *    S [I] -- The counters to read
+ *    Stats [O] -- The stats as they are right now
+ *
+ * FUNCTION:
+ *    This function reads the counters for one direction.  The rates only
+ *    use whole seconds (the current second isn't finished yet).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxTxBinaryDisplay_StatsGetDir(struct RxTxBinaryDisplayDirStats *S,
+        struct RxTxBinaryDisplayStats *Stats)
+{
+    uint64_t NowSec;
+    uint64_t NewestSec;
+
+    NowSec=RxTxBinaryDisplay_StatsNow()/NS_PER_SEC;
+    NewestSec=S->Second.load(std::memory_order_acquire);
+
+    Stats->TotalBytes=S->TotalBytes.load(std::memory_order_relaxed);
+    Stats->Rate1s=RxTxBinaryDisplay_StatsRate(S,NowSec,NewestSec,1);
+    Stats->Rate10s=RxTxBinaryDisplay_StatsRate(S,NowSec,NewestSec,10);
+    Stats->Rate60s=RxTxBinaryDisplay_StatsRate(S,NowSec,NewestSec,
+            RTBD_STATS_LONGEST_WINDOW);
+    Stats->LargestBurst=S->LargestBurst.load(std::memory_order_relaxed);
+    Stats->LastGapMS=S->LastGapMS.load(std::memory_order_relaxed);
+    Stats->ShortestGapMS=S->ShortestGapMS.load(std::memory_order_relaxed);
+    Stats->HasGap=S->HasGap.load(std::memory_order_relaxed);
+    Stats->CaptureDropped=S->CaptureDropped.load(std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsRate
+ *
+ * SYNOPSIS:
+ *    static double RxTxBinaryDisplay_StatsRate(
+ *          struct RxTxBinaryDisplayDirStats *S,uint64_t NowSec,
+ *          uint64_t NewestSec,unsigned int Seconds);
+ *
+ * PARAMETERS:
+ *    S [I] -- The counters to read
+ *    NowSec [I] -- The current second
+ *    NewestSec [I] -- The newest second that has been written to the buckets
+ *    Seconds [I] -- How many seconds to average over
+ *
+ * FUNCTION:
+ *    This function works out the bytes per second over the last 'Seconds'
+ *    whole seconds.  Buckets that haven't been written since they went out
+ *    of date count as 0.
+ *
+ * RETURNS:
+ *    The rate in bytes per second.
+ ******************************************************************************/
+static double RxTxBinaryDisplay_StatsRate(struct RxTxBinaryDisplayDirStats *S,
+        uint64_t NowSec,uint64_t NewestSec,unsigned int Seconds)
+{
+    uint64_t Total;
+    uint64_t s;
+    unsigned int r;
+
+    Total=0;
+    for(r=1;r<=Seconds;r++)
+    {
+        s=NowSec-r;
+        if(s>NewestSec || s+RTBD_STATS_SECONDS<=NewestSec)
+            continue;
+        Total+=S->Buckets[s%RTBD_STATS_SECONDS].load(std::memory_order_relaxed);
+    }
+
+    return (double)Total/Seconds;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxTxBinaryDisplay_StatsNow
+ *
+ * SYNOPSIS:
+ *    static uint64_t RxTxBinaryDisplay_StatsNow(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function gets a monotonic time stamp.
+ *
+ * RETURNS:
+ *    The time in ns (from some fixed point in the past).
+ ******************************************************************************/
+static uint64_t RxTxBinaryDisplay_StatsNow(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
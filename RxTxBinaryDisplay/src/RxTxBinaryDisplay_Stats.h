@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * FILENAME: RxTxBinaryDisplay_Stats.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the Rx / Tx throughput counters in it.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __RXTXBINARYDISPLAY_STATS_H_
+#define __RXTXBINARYDISPLAY_STATS_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+#define RTBD_STATS_MAX_CONNECTIONS          16      // Most we will show
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+typedef enum
+{
+    e_RTBDStatsDir_Rx,
+    e_RTBDStatsDir_Tx,
+    e_RTBDStatsDirMAX
+} e_RTBDStatsDirType;
+
+typedef enum
+{
+    e_RTBDStatsCapture_Off,
+    e_RTBDStatsCapture_On,
+    e_RTBDStatsCapture_Failed,      // Couldn't make or write the file
+    e_RTBDStatsCaptureMAX
+} e_RTBDStatsCaptureType;
+
+struct RxTxBinaryDisplayStats
+{
+    uint64_t TotalBytes;
+    double Rate1s;              // Bytes per second over the last second
+    double Rate10s;
+    double Rate60s;
+    uint64_t LargestBurst;      // Bytes
+    uint64_t LastGapMS;         // Time between the last 2 bursts
+    uint64_t ShortestGapMS;
+    bool HasGap;                // Have we seen 2 bursts yet
+    uint64_t CaptureDropped;    // Chunks left out of the capture file
+};
+
+struct RxTxBinaryDisplayConStats
+{
+    unsigned int ID;            // Connections are numbered in the order opened
+    e_RTBDStatsCaptureType Capture;
+    struct RxTxBinaryDisplayStats Dir[e_RTBDStatsDirMAX];
+};
+
+struct RTBDStats {int PrivateDataHere;};
+typedef struct RTBDStats t_RTBDStatsType;
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+t_RTBDStatsType *RxTxBinaryDisplay_StatsAlloc(void);
+void RxTxBinaryDisplay_StatsFree(t_RTBDStatsType *Stats);
+void RxTxBinaryDisplay_StatsAdd(t_RTBDStatsType *Stats,e_RTBDStatsDirType Dir,
+        uint32_t Bytes);
+void RxTxBinaryDisplay_StatsSetCapture(t_RTBDStatsType *Stats,
+        e_RTBDStatsCaptureType State);
+void RxTxBinaryDisplay_StatsCaptureDropped(t_RTBDStatsType *Stats,
+        e_RTBDStatsDirType Dir);
+unsigned int RxTxBinaryDisplay_StatsGetAll(
+        struct RxTxBinaryDisplayConStats *List,unsigned int MaxCount);
+
+#endif
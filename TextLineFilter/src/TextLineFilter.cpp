@@ -32,11 +32,11 @@
 /*** HEADER FILES TO INCLUDE  ***/
 #include "TextLineFilter.h"
 #include "PluginSDK/Plugin.h"
+#include "TextMatch.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string>
-#include <regex>
 
 using namespace std;
 
@@ -44,29 +44,18 @@ using namespace std;
 #define REGISTER_PLUGIN_FUNCTION_PRIV_NAME      TextLineFilter // The name to append on the RegisterPlugin() function for built in version
 #define NEEDED_MIN_API_VERSION                  0x02000000
 
-#define SEARCH_STRINGS_GROW_SIZE                100 // Add 100 strings every time we need more
 #define MAX_REGEX                               5
 
 /*** MACROS                   ***/
 
 /*** TYPE DEFINITIONS         ***/
-struct SimpleFilter
-{
-    char *PatternStr;
-    char **Patterns;
-    uint_fast32_t PatternsCount;
-};
-
 struct TextLineFilterData
 {
     bool FreezeStream;
 
-    struct SimpleFilter SimpleFilterStartsWithPat;
-    struct SimpleFilter SimpleFilterContainsPat;
-    struct SimpleFilter SimpleFilterEndsWithPat;
-
-    string RegexRemoveFilterStr[MAX_REGEX];
-    string RegexIncludeFilterStr[MAX_REGEX];
+    /* The simple filters and remove regex's all go in 'RemoveRules' */
+    t_TextMatchRulesType *RemoveRules;
+    t_TextMatchRulesType *IncludeRules;
 };
 
 struct TextLineFilter_SettingsWidgets
@@ -92,6 +81,7 @@ struct TextLineFilter_SettingsWidgets
 const struct DataProcessorInfo *TextLineFilter_GetProcessorInfo(
         unsigned int *SizeOfInfo);
 void TextLineFilter_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHandle,const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,PG_BOOL *Consumed);
+uint32_t TextLineFilter_ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
 static t_DataProSettingsWidgetsType *TextLineFilter_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
 static void TextLineFilter_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
 static void TextLineFilter_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings);
@@ -99,10 +89,8 @@ static void TextLineFilter_ApplySettings(t_DataProcessorHandleType *ConDataHandl
         t_PIKVList *Settings);
 static t_DataProcessorHandleType *TextLineFilter_AllocateData(void);
 static void TextLineFilter_FreeData(t_DataProcessorHandleType *DataHandle);
-static bool TextLineFilter_GrowSearchStringsIfNeeded(char **SearchStrings,uint_fast32_t *SearchStringsSize,uint_fast32_t Size);
-static bool TextLineFilter_ProcessSimpleFilter(const char *Filter,struct SimpleFilter &Result);
+static bool TextLineFilter_ProcessSimpleFilter(const char *Filter,t_TextMatchRulesType *Rules,e_TextMatchRuleType Type);
 static bool TextLineFilter_HandleLine(struct TextLineFilterData *Data);
-static void TextLineFilter_FreeSimpleFilter(struct SimpleFilter &Pat);
 
 /*** VARIABLE DEFINITIONS     ***/
 struct DataProcessorAPI m_TextLineFilterCBs=
@@ -119,6 +107,8 @@ struct DataProcessorAPI m_TextLineFilterCBs=
     TextLineFilter_FreeSettingsWidgets,
     TextLineFilter_SetSettingsFromWidgets,
     TextLineFilter_ApplySettings,
+    /* V4 */
+    TextLineFilter_ProcessIncomingTextBlock,    // ProcessIncomingTextBlock
 };
 
 struct DataProcessorInfo m_TextLineFilter_Info=
@@ -206,23 +196,25 @@ static t_DataProcessorHandleType *TextLineFilter_AllocateData(void)
             return NULL;
 
         Data->FreezeStream=true;
+        Data->RemoveRules=NULL;
+        Data->IncludeRules=NULL;
 
-        Data->SimpleFilterStartsWithPat.PatternStr=NULL;
-        Data->SimpleFilterStartsWithPat.Patterns=NULL;
-        Data->SimpleFilterStartsWithPat.PatternsCount=0;
-
-        Data->SimpleFilterContainsPat.PatternStr=NULL;
-        Data->SimpleFilterContainsPat.Patterns=NULL;
-        Data->SimpleFilterContainsPat.PatternsCount=0;
+        Data->RemoveRules=TextMatch_AllocRules();
+        if(Data->RemoveRules==NULL)
+            throw(0);
 
-        Data->SimpleFilterEndsWithPat.PatternStr=NULL;
-        Data->SimpleFilterEndsWithPat.Patterns=NULL;
-        Data->SimpleFilterEndsWithPat.PatternsCount=0;
+        Data->IncludeRules=TextMatch_AllocRules();
+        if(Data->IncludeRules==NULL)
+            throw(0);
     }
     catch(...)
     {
         if(Data!=NULL)
         {
+            if(Data->RemoveRules!=NULL)
+                TextMatch_FreeRules(Data->RemoveRules);
+            if(Data->IncludeRules!=NULL)
+                TextMatch_FreeRules(Data->IncludeRules);
             delete Data;
         }
         return NULL;
@@ -235,9 +227,8 @@ static void TextLineFilter_FreeData(t_DataProcessorHandleType *DataHandle)
 {
     struct TextLineFilterData *Data=(struct TextLineFilterData *)DataHandle;
 
-    TextLineFilter_FreeSimpleFilter(Data->SimpleFilterStartsWithPat);
-    TextLineFilter_FreeSimpleFilter(Data->SimpleFilterContainsPat);
-    TextLineFilter_FreeSimpleFilter(Data->SimpleFilterEndsWithPat);
+    TextMatch_FreeRules(Data->RemoveRules);
+    TextMatch_FreeRules(Data->IncludeRules);
 
     delete Data;
 }
@@ -354,6 +345,57 @@ void TextLineFilter_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHandl
     }
 }
 
+/*******************************************************************************
+ * NAME:
+ *   ProcessIncomingTextBlock
+ *
+ * SYNOPSIS:
+ *   uint32_t ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,
+ *       const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
+ *
+ * PARAMETERS:
+ *   DataHandle [I] -- The data handle to work on.  This is your internal
+ *                     data.
+ *   Data [I] -- The block of bytes that came in.
+ *   Len [I] -- The number of bytes in 'Data'
+ *   Consumed [I/O] -- This tells the system (and other filters) if the
+ *                     bytes have been used up and will not be added to the
+ *                     screen.
+ *
+ * FUNCTION:
+ *   This is the block version of ProcessIncomingTextByte().  We split the
+ *   block at each '\n'.  Everything before the '\n' is handed back in one
+ *   go, and when the block starts with a '\n' we take just that byte and
+ *   check the line that it ends.
+ *
+ * RETURNS:
+ *   The number of bytes from the start of 'Data' that we handled.
+ ******************************************************************************/
+uint32_t TextLineFilter_ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed)
+{
+    struct TextLineFilterData *FData=(struct TextLineFilterData *)DataHandle;
+    const uint8_t *Pos;
+
+    if(FData->FreezeStream)
+    {
+        m_TLF_DPS->FreezeStream();
+        FData->FreezeStream=false;
+    }
+
+    Pos=(const uint8_t *)memchr(Data,'\n',Len);
+    if(Pos==NULL)
+        return Len;
+    if(Pos!=Data)
+        return Pos-Data;
+
+    /* We are at the end of the line, see if it matches anything */
+    if(TextLineFilter_HandleLine(FData))
+        *Consumed=true;
+
+    return 1;
+}
+
 t_DataProSettingsWidgetsType *TextLineFilter_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings)
 {
     struct TextLineFilter_SettingsWidgets *WData;
@@ -658,18 +700,28 @@ static void TextLineFilter_ApplySettings(t_DataProcessorHandleType *DataHandle,
             RegexFilter_IncludeFilter[r]="";
     }
 
+    /* Build the rules once here instead of for every line */
+    TextMatch_ClearRules(Data->RemoveRules);
+    TextMatch_ClearRules(Data->IncludeRules);
+
     TextLineFilter_ProcessSimpleFilter(SimpleFilter_StartingWith,
-            Data->SimpleFilterStartsWithPat);
+            Data->RemoveRules,e_TextMatchRule_StartsWith);
     TextLineFilter_ProcessSimpleFilter(SimpleFilter_Contains,
-            Data->SimpleFilterContainsPat);
+            Data->RemoveRules,e_TextMatchRule_Contains);
     TextLineFilter_ProcessSimpleFilter(SimpleFilter_EndingWith,
-            Data->SimpleFilterEndsWithPat);
+            Data->RemoveRules,e_TextMatchRule_EndsWith);
 
+    /* Bad regex's are just ignored */
     for(r=0;r<MAX_REGEX;r++)
     {
-        Data->RegexRemoveFilterStr[r]=RegexFilter_RemoveFilter[r];
-        Data->RegexIncludeFilterStr[r]=RegexFilter_IncludeFilter[r];
+        TextMatch_AddRule(Data->RemoveRules,e_TextMatchRule_Regex,
+                RegexFilter_RemoveFilter[r],r);
+        TextMatch_AddRule(Data->IncludeRules,e_TextMatchRule_Regex,
+                RegexFilter_IncludeFilter[r],r);
     }
+
+    TextMatch_Compile(Data->RemoveRules);
+    TextMatch_Compile(Data->IncludeRules);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -680,49 +732,48 @@ static void TextLineFilter_ApplySettings(t_DataProcessorHandleType *DataHandle,
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool TextLineFilter_GrowSearchStringsIfNeeded(char **SearchStrings,uint_fast32_t *SearchStringsSize,uint_fast32_t Size)
-{
-    char **NewSearchStr;
-    if(Size>=*SearchStringsSize)
-    {
-        *SearchStringsSize+=SEARCH_STRINGS_GROW_SIZE;
-        NewSearchStr=(char **)realloc((void *)SearchStrings,
-                (*SearchStringsSize)*sizeof(char **));
-        if(NewSearchStr==NULL)
-            return false;
-    }
-    return true;
-}
-
+/*******************************************************************************
+ * NAME:
+ *    TextLineFilter_ProcessSimpleFilter
+ *
+ * SYNOPSIS:
+ *    static bool TextLineFilter_ProcessSimpleFilter(const char *Filter,
+ *          t_TextMatchRulesType *Rules,e_TextMatchRuleType Type);
+ *
+ * PARAMETERS:
+ *    Filter [I] -- The filter string the user typed in
+ *    Rules [I] -- The rule set to add the strings to
+ *    Type [I] -- What type of rule to add the strings as
+ *
+ * FUNCTION:
+ *    This function breaks a simple filter string up into the strings to
+ *    look for (split on spaces, with "" quotes and \ escapes) and adds each
+ *    one as a rule.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- There was an error (out of memory)
+ ******************************************************************************/
 static bool TextLineFilter_ProcessSimpleFilter(const char *Filter,
-        struct SimpleFilter &Result)
+        t_TextMatchRulesType *Rules,e_TextMatchRuleType Type)
 {
-    uint_fast32_t Len;
+    char *PatternStr;
+    char *Start;
     const char *s;
     char *d;
-    uint_fast32_t SearchStringsSize;
     bool DoingQuote;
     bool DoingEsc;
+    bool RetValue;
 
-    Len=strlen(Filter);
-
-    Result.PatternStr=(char *)malloc(Len+1);
-    if(Result.PatternStr==NULL)
+    PatternStr=(char *)malloc(strlen(Filter)+1);
+    if(PatternStr==NULL)
         return false;
 
-    SearchStringsSize=SEARCH_STRINGS_GROW_SIZE;
-    Result.Patterns=(char **)malloc((SearchStringsSize)*sizeof(char **));
-    if(Result.Patterns==NULL)
-    {
-        free(Result.PatternStr);
-        return false;
-    }
-
     /* Copy into our patterns buffer break it up as needed */
+    RetValue=true;
     s=Filter;
-    d=Result.PatternStr;
-    Result.PatternsCount=0;
-    Result.Patterns[Result.PatternsCount]=d;
+    d=PatternStr;
+    Start=d;
     DoingQuote=false;
     DoingEsc=false;
     while(*s!=0)
@@ -775,17 +826,12 @@ static bool TextLineFilter_ProcessSimpleFilter(const char *Filter,
                     else
                     {
                         /* If we don't have a blank string then add it */
-                        if(Result.Patterns[Result.PatternsCount]!=d)
+                        if(Start!=d)
                         {
                             *d++=0;
-                            if(!TextLineFilter_GrowSearchStringsIfNeeded(
-                                    Result.Patterns,
-                                    &SearchStringsSize,Result.PatternsCount+1))
-                            {
-                                return false;
-                            }
-                            Result.PatternsCount++;
-                            Result.Patterns[Result.PatternsCount]=d;
+                            if(!TextMatch_AddRule(Rules,Type,Start,0))
+                                RetValue=false;
+                            Start=d;
                         }
                     }
                 break;
@@ -801,30 +847,16 @@ static bool TextLineFilter_ProcessSimpleFilter(const char *Filter,
         }
         s++;
     }
-    if(Result.Patterns[Result.PatternsCount]!=d)
+    if(Start!=d)
     {
-        *d++=0;
-        if(!TextLineFilter_GrowSearchStringsIfNeeded(Result.Patterns,
-                &SearchStringsSize,Result.PatternsCount+1))
-        {
-            return false;
-        }
-        Result.PatternsCount++;
-        Result.Patterns[Result.PatternsCount]=d;
+        *d=0;
+        if(!TextMatch_AddRule(Rules,Type,Start,0))
+            RetValue=false;
     }
-    *d++=0; // End it as a string
 
-    return true;
-}
-
-static void TextLineFilter_FreeSimpleFilter(struct SimpleFilter &Pat)
-{
-    free(Pat.PatternStr);
-    free(Pat.Patterns);
+    free(PatternStr);
 
-    Pat.PatternStr=NULL;
-    Pat.Patterns=NULL;
-    Pat.PatternsCount=0;
+    return RetValue;
 }
 
 /*******************************************************************************
@@ -851,99 +883,25 @@ static void TextLineFilter_FreeSimpleFilter(struct SimpleFilter &Pat)
  ******************************************************************************/
 static bool TextLineFilter_HandleLine(struct TextLineFilterData *Data)
 {
-    const char *Line;
+    const uint8_t *Line;
     uint32_t Bytes;
-    uint_fast32_t r;
-    size_t Len;
-    size_t LineLen;
+    uint32_t Len;
     bool DeleteLine;
-    const char *Pat;
-    bool FoundMatch;
-    bool AllBlank;
 
-    Line=(const char *)m_TLF_DPS->GetFrozenString(&Bytes);
+    Line=m_TLF_DPS->GetFrozenString(&Bytes);
     if(Line==NULL)
         return false;
 
-    DeleteLine=false;
+    /* The frozen string is \0 terminated, don't look past that */
+    Len=strnlen((const char *)Line,Bytes);
 
-    /* Simple patterns */
-    for(r=0;r<Data->SimpleFilterStartsWithPat.PatternsCount;r++)
-    {
-        Pat=Data->SimpleFilterStartsWithPat.Patterns[r];
-        Len=strlen(Pat);
-        if(strncmp(Line,Pat,Len)==0)
-        {
-            DeleteLine=true;
-            break;  // No need to finish
-        }
-    }
+    /* Simple patterns and regex's that delete lines */
+    DeleteLine=TextMatch_MatchAny(Data->RemoveRules,Line,Len,NULL);
 
-    if(!DeleteLine)
+    /* If we have include regex's and none match then we delete the line */
+    if(!DeleteLine && !TextMatch_IsEmpty(Data->IncludeRules))
     {
-        for(r=0;r<Data->SimpleFilterContainsPat.PatternsCount;r++)
-        {
-            Pat=Data->SimpleFilterContainsPat.Patterns[r];
-            Len=strlen(Pat);
-            if(strstr(Line,Pat)!=NULL)
-            {
-                DeleteLine=true;
-                break;  // No need to finish
-            }
-        }
-    }
-
-    if(!DeleteLine)
-    {
-        for(r=0;r<Data->SimpleFilterEndsWithPat.PatternsCount;r++)
-        {
-            Pat=Data->SimpleFilterEndsWithPat.Patterns[r];
-            Len=strlen(Pat);
-            LineLen=strlen(Line);
-            if(LineLen>Len && strncmp(&Line[LineLen-Len],Pat,Len)==0)
-            {
-                DeleteLine=true;
-                break;  // No need to finish
-            }
-        }
-    }
-
-    /* Handle regex's that delete lines */
-    if(!DeleteLine)
-    {
-        for(r=0;r<MAX_REGEX;r++)
-        {
-            if(!Data->RegexRemoveFilterStr[r].empty())
-            {
-                regex RxPattern(Data->RegexRemoveFilterStr[r]);
-                if(regex_search((const char *)Line,RxPattern))
-                {
-                    DeleteLine=true;
-                    break;  // No need to finish
-                }
-            }
-        }
-    }
-
-    if(!DeleteLine)
-    {
-        FoundMatch=false;
-        AllBlank=true;
-        for(r=0;r<MAX_REGEX;r++)
-        {
-            if(!Data->RegexIncludeFilterStr[r].empty())
-            {
-                AllBlank=false;
-                regex RxPattern(Data->RegexIncludeFilterStr[r]);
-                if(regex_search((const char *)Line,RxPattern))
-                {
-                    FoundMatch=true;
-                    break;  // No need to finish
-                }
-            }
-        }
-        /* If we didn't find a match then we delete the line */
-        if(!AllBlank && !FoundMatch)
+        if(!TextMatch_MatchAny(Data->IncludeRules,Line,Len,NULL))
             DeleteLine=true;
     }
 
@@ -32,11 +32,11 @@
 /*** HEADER FILES TO INCLUDE  ***/
 #include "TextLineHighlighter.h"
 #include "PluginSDK/Plugin.h"
+#include "TextMatch.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string>
-#include <regex>
 
 using namespace std;
 
@@ -58,26 +58,11 @@ struct TextLineHighlighter_TextStyle
     uint32_t Attribs;
 };
 
-struct TextLineHighlighterSimpleData
-{
-    string StartsWith;
-    string Contains;
-    string EndsWith;
-    int StyleIndex;
-};
-
-struct TextLineHighlighterRegexData
-{
-    string Pattern;
-    int StyleIndex;
-};
-
 struct TextLineHighlighterData
 {
     t_DataProMark *StartOfLineMarker;
 
-    struct TextLineHighlighterSimpleData Simple[NUM_OF_SIMPLE];
-    struct TextLineHighlighterRegexData Regex[NUM_OF_REGEXS];
+    t_TextMatchRulesType *Rules;    // The rule ID is the style index
     struct TextLineHighlighter_TextStyle Styles[NUM_OF_STYLES];
 
     bool GrabNewMark;
@@ -128,6 +113,7 @@ struct TextLineHighlighter_SettingsWidgets
 const struct DataProcessorInfo *TextLineHighlighter_GetProcessorInfo(
         unsigned int *SizeOfInfo);
 void TextLineHighlighter_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHandle,const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,PG_BOOL *Consumed);
+uint32_t TextLineHighlighter_ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
 static t_DataProSettingsWidgetsType *TextLineHighlighter_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
 static void TextLineHighlighter_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
 static void TextLineHighlighter_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings);
@@ -157,6 +143,8 @@ static void TextLineHighlighter_ApplySetting_SetData(t_PIKVList *Settings,
 static void TextLineHighlighter_HandleLine(struct TextLineHighlighterData *Data);
 static void TextLineHighlighter_ApplyStyleSet2Marker(struct TextLineHighlighterData *Data,
         int StyleIndex);
+static bool TextLineHighlighter_LineMatchCB(void *UserData,int RuleID,
+        uint32_t Offset,uint32_t Len);
 
 /*** VARIABLE DEFINITIONS     ***/
 struct DataProcessorAPI m_TextLineHighlighterCBs=
@@ -173,6 +161,8 @@ struct DataProcessorAPI m_TextLineHighlighterCBs=
     TextLineHighlighter_FreeSettingsWidgets,
     TextLineHighlighter_SetSettingsFromWidgets,
     TextLineHighlighter_ApplySettings,
+    /* V4 */
+    TextLineHighlighter_ProcessIncomingTextBlock,       // ProcessIncomingTextBlock
 };
 
 
@@ -294,11 +284,18 @@ static t_DataProcessorHandleType *TextLineHighlighter_AllocateData(void)
 
         Data->StartOfLineMarker=NULL;
         Data->GrabNewMark=false;
+        Data->Rules=NULL;
+
+        Data->Rules=TextMatch_AllocRules();
+        if(Data->Rules==NULL)
+            throw(0);
     }
     catch(...)
     {
         if(Data!=NULL)
         {
+            if(Data->Rules!=NULL)
+                TextMatch_FreeRules(Data->Rules);
             delete Data;
         }
         return NULL;
@@ -331,6 +328,8 @@ static void TextLineHighlighter_FreeData(t_DataProcessorHandleType *DataHandle)
     if(Data->StartOfLineMarker!=NULL)
         m_TLF_DPS->FreeMark(Data->StartOfLineMarker);
 
+    TextMatch_FreeRules(Data->Rules);
+
     delete Data;
 }
 
@@ -453,6 +452,64 @@ void TextLineHighlighter_ProcessIncomingTextByte(t_DataProcessorHandleType *Data
     }
 }
 
+/*******************************************************************************
+ * NAME:
+ *   ProcessIncomingTextBlock
+ *
+ * SYNOPSIS:
+ *   uint32_t ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,
+ *       const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
+ *
+ * PARAMETERS:
+ *   DataHandle [I] -- The data handle to work on.  This is your internal
+ *                     data.
+ *   Data [I] -- The block of bytes that came in.
+ *   Len [I] -- The number of bytes in 'Data'
+ *   Consumed [I/O] -- This tells the system (and other filters) if the
+ *                     bytes have been used up and will not be added to the
+ *                     screen.
+ *
+ * FUNCTION:
+ *   This is the block version of ProcessIncomingTextByte().  We split the
+ *   block at each '\n'.  Everything before the '\n' is handed back in one
+ *   go, and when the block starts with a '\n' we take just that byte and
+ *   highlight the line that it ends.
+ *
+ * RETURNS:
+ *   The number of bytes from the start of 'Data' that we handled.
+ ******************************************************************************/
+uint32_t TextLineHighlighter_ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed)
+{
+    struct TextLineHighlighterData *HData=(struct TextLineHighlighterData *)DataHandle;
+    const uint8_t *Pos;
+
+    if(HData->StartOfLineMarker==NULL)
+    {
+        HData->StartOfLineMarker=m_TLF_DPS->AllocateMark();
+        if(HData->StartOfLineMarker==NULL)
+            return Len;
+        HData->GrabNewMark=true;
+    }
+
+    if(HData->GrabNewMark)
+    {
+        m_TLF_DPS->SetMark2CursorPos(HData->StartOfLineMarker);
+        HData->GrabNewMark=false;
+    }
+
+    Pos=(const uint8_t *)memchr(Data,'\n',Len);
+    if(Pos==NULL)
+        return Len;
+    if(Pos!=Data)
+        return Pos-Data;
+
+    /* We are at the end of the line, see if it matches anything */
+    TextLineHighlighter_HandleLine(HData);
+
+    return 1;
+}
+
 /*******************************************************************************
  * NAME:
  *    AllocSettingsWidgets
@@ -872,34 +929,41 @@ static void TextLineHighlighter_ApplySettings(t_DataProcessorHandleType *DataHan
 {
     struct TextLineHighlighterData *Data=(struct TextLineHighlighterData *)DataHandle;
     const char *Str;
+    const char *StartsWith;
+    const char *Contains;
+    const char *EndsWith;
+    const char *StyleStr;
+    int StyleIndex;
     int r;
     char buff[100];
 
+    /* The rules are compiled here once instead of for every line.  They
+       are added in the order they should be applied in (later styles win) */
+    TextMatch_ClearRules(Data->Rules);
+
     for(r=0;r<NUM_OF_SIMPLE;r++)
     {
         sprintf(buff,"SimpleStart%d",r);
-        Str=m_TLF_SysAPI->KVGetItem(Settings,buff);
-        if(Str==NULL)
-            Str="";
-        Data->Simple[r].StartsWith=Str;
+        StartsWith=m_TLF_SysAPI->KVGetItem(Settings,buff);
 
         sprintf(buff,"SimpleContains%d",r);
-        Str=m_TLF_SysAPI->KVGetItem(Settings,buff);
-        if(Str==NULL)
-            Str="";
-        Data->Simple[r].Contains=Str;
+        Contains=m_TLF_SysAPI->KVGetItem(Settings,buff);
 
         sprintf(buff,"SimpleEnd%d",r);
-        Str=m_TLF_SysAPI->KVGetItem(Settings,buff);
-        if(Str==NULL)
-            Str="";
-        Data->Simple[r].EndsWith=Str;
+        EndsWith=m_TLF_SysAPI->KVGetItem(Settings,buff);
 
         sprintf(buff,"SimpleStyle%d",r);
-        Str=m_TLF_SysAPI->KVGetItem(Settings,buff);
-        if(Str==NULL)
-            Str="0";
-        Data->Simple[r].StyleIndex=atoi(Str);
+        StyleStr=m_TLF_SysAPI->KVGetItem(Settings,buff);
+        if(StyleStr==NULL)
+            StyleStr="0";
+        StyleIndex=atoi(StyleStr);
+
+        TextMatch_AddRule(Data->Rules,e_TextMatchRule_StartsWith,StartsWith,
+                StyleIndex);
+        TextMatch_AddRule(Data->Rules,e_TextMatchRule_Contains,Contains,
+                StyleIndex);
+        TextMatch_AddRule(Data->Rules,e_TextMatchRule_EndsWith,EndsWith,
+                StyleIndex);
     }
 
     for(r=0;r<NUM_OF_REGEXS;r++)
@@ -910,15 +974,18 @@ static void TextLineHighlighter_ApplySettings(t_DataProcessorHandleType *DataHan
         if(Str==NULL)
             Str="";
 
-        Data->Regex[r].Pattern=Str;
-
         sprintf(buff,"RegexStyle%d",r);
-        Str=m_TLF_SysAPI->KVGetItem(Settings,buff);
-        if(Str==NULL)
-            Str="0";
-        Data->Regex[r].StyleIndex=atoi(Str);
+        StyleStr=m_TLF_SysAPI->KVGetItem(Settings,buff);
+        if(StyleStr==NULL)
+            StyleStr="0";
+        StyleIndex=atoi(StyleStr);
+
+        /* Bad regex's are just ignored */
+        TextMatch_AddRule(Data->Rules,e_TextMatchRule_Regex,Str,StyleIndex);
     }
 
+    TextMatch_Compile(Data->Rules);
+
     /* Styling tabs (colors) */
     for(r=0;r<NUM_OF_STYLES;r++)
     {
@@ -1388,8 +1455,7 @@ static void TextLineHighlighter_HandleLine(struct TextLineHighlighterData *Data)
 {
     const uint8_t *Line;
     uint32_t Bytes;
-    int r;
-    size_t Len;
+    uint32_t Len;
 
     if(Data->StartOfLineMarker==NULL)
         return;
@@ -1401,49 +1467,10 @@ static void TextLineHighlighter_HandleLine(struct TextLineHighlighterData *Data)
         return;
     }
 
-    for(r=0;r<NUM_OF_SIMPLE;r++)
-    {
-        if(!Data->Simple[r].StartsWith.empty())
-        {
-            Len=Data->Simple[r].StartsWith.length();
-            if(strncmp((char *)Line,Data->Simple[r].StartsWith.c_str(),Len)==0)
-            {
-                TextLineHighlighter_ApplyStyleSet2Marker(Data,
-                        Data->Simple[r].StyleIndex);
-            }
-        }
-        if(!Data->Simple[r].Contains.empty())
-        {
-            if(strstr((char *)Line,Data->Simple[r].Contains.c_str())!=NULL)
-            {
-                TextLineHighlighter_ApplyStyleSet2Marker(Data,
-                        Data->Simple[r].StyleIndex);
-            }
-        }
-        if(!Data->Simple[r].EndsWith.empty())
-        {
-            Len=Data->Simple[r].EndsWith.length();
-            if(Bytes>=Len && strcmp((char *)&Line[Bytes-Len],
-                    Data->Simple[r].EndsWith.c_str())==0)
-            {
-                TextLineHighlighter_ApplyStyleSet2Marker(Data,
-                        Data->Simple[r].StyleIndex);
-            }
-        }
-    }
-
-    for(r=0;r<NUM_OF_REGEXS;r++)
-    {
-        if(!Data->Regex[r].Pattern.empty())
-        {
-            regex RxPattern(Data->Regex[r].Pattern);
-            if(regex_search((const char *)Line,RxPattern))
-            {
-                TextLineHighlighter_ApplyStyleSet2Marker(Data,
-                    Data->Regex[r].StyleIndex);
-            }
-        }
-    }
+    /* Run all the rules over the line in one go */
+    Len=strnlen((const char *)Line,Bytes);
+    TextMatch_MatchAll(Data->Rules,Line,Len,TextLineHighlighter_LineMatchCB,
+            Data);
 
     /* Ok, reset the mark */
     Data->GrabNewMark=true;
@@ -1480,3 +1507,39 @@ static void TextLineHighlighter_ApplyStyleSet2Marker(struct TextLineHighlighterD
     m_TLF_DPS->ApplyBGColor2Mark(Data->StartOfLineMarker,
             Data->Styles[StyleIndex].BGColor,0,0);
 }
+
+/*******************************************************************************
+ * NAME:
+ *    TextLineHighlighter_LineMatchCB
+ *
+ * SYNOPSIS:
+ *    static bool TextLineHighlighter_LineMatchCB(void *UserData,int RuleID,
+ *          uint32_t Offset,uint32_t Len);
+ *
+ * PARAMETERS:
+ *    UserData [I] -- Our data
+ *    RuleID [I] -- The rule that matched.  This is the style index.
+ *    Offset [I] -- Where in the line the match was
+ *    Len [I] -- The length of the match
+ *
+ * FUNCTION:
+ *    This function is called from TextMatch_MatchAll() for each rule that
+ *    matched the line.  We style the whole line (not just the span that
+ *    matched).
+ *
+ * RETURNS:
+ *    true -- Keep going
+ *
+ * SEE ALSO:
+ *    TextLineHighlighter_HandleLine()
+ ******************************************************************************/
+static bool TextLineHighlighter_LineMatchCB(void *UserData,int RuleID,
+        uint32_t Offset,uint32_t Len)
+{
+    struct TextLineHighlighterData *Data=(struct TextLineHighlighterData *)UserData;
+
+    if(RuleID>=0 && RuleID<NUM_OF_STYLES)
+        TextLineHighlighter_ApplyStyleSet2Marker(Data,RuleID);
+
+    return true;
+}
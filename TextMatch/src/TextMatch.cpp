@@ -0,0 +1,799 @@
+/*******************************************************************************
+ * FILENAME: TextMatch.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is the shared line matching engine.  Rules are added to a rule
+ *    set and then compiled:
+ *       - All the "starts with" strings go into one trie that is walked from
+ *         the start of the line.
+ *       - All the "ends with" strings go into one trie of the reversed
+ *         strings that is walked backwards from the end of the line.
+ *       - All the "contains" strings go into one Aho-Corasick automaton so
+ *         the line is only scanned once no matter how many strings there are
+ *         (a single string just uses memchr()/memcmp()).
+ *       - Regex's that are really just plain strings are moved into the
+ *         automatons above, the rest are compiled once into a Pike VM
+ *         (see TextMatch_Regex.cpp).
+ *
+ *    The automatons are full DFA tables indexed by a byte class (only the
+ *    bytes that appear in the patterns get their own class) so each byte of
+ *    the line is one table lookup.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "TextMatch.h"
+#include "TextMatch_Regex.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*** DEFINES                  ***/
+#define LITERAL_DEAD_STATE          0
+#define LITERAL_ROOT_STATE          1
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+typedef enum
+{
+    e_LiteralSet_Anchored,      // Walk from the start, stop when we fall off
+    e_LiteralSet_Reversed,      // Walk from the end backwards
+    e_LiteralSet_Search,        // Aho-Corasick search over the whole line
+    e_LiteralSetMAX
+} e_LiteralSetType;
+
+struct LiteralSet
+{
+    e_LiteralSetType Type;
+    vector<string> Patterns;
+    vector<int> RuleIndex;          // The rule for each pattern
+
+    /* Compiled */
+    uint8_t ByteClass[256];
+    int ClassCount;
+    vector<int32_t> Next;           // States * ClassCount
+    vector<int32_t> OutStart;       // Index into 'OutList' for each state
+    vector<int32_t> OutList;        // Pattern indexes, -1 terminated
+    vector<uint8_t> IsOut;          // Does this state have any outputs
+};
+
+struct TextMatchRule
+{
+    e_TextMatchRuleType Type;
+    string Pattern;
+    int RuleID;
+    struct TextMatchRegex *Regex;
+};
+
+struct TextMatchRulesData
+{
+    vector<struct TextMatchRule> Rules;
+    struct LiteralSet StartsWith;
+    struct LiteralSet Contains;
+    struct LiteralSet EndsWith;
+    vector<int> RegexRules;         // Index into 'Rules'
+    bool Compiled;
+
+    /* Scratch used while matching */
+    vector<uint8_t> Matched;
+    vector<uint32_t> SpanStart;
+    vector<uint32_t> SpanLen;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    LiteralSet_Build
+ *
+ * SYNOPSIS:
+ *    static void LiteralSet_Build(struct LiteralSet *Set);
+ *
+ * PARAMETERS:
+ *    Set [I/O] -- The set of strings to build the automaton for
+ *
+ * FUNCTION:
+ *    This function builds the DFA table for a set of strings.  For anchored
+ *    and reversed sets this is just a trie (falling off it goes to the dead
+ *    state).  For search sets the failure links are followed to fill in the
+ *    whole table (Aho-Corasick) and the outputs of each state include the
+ *    outputs of its failure state.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void LiteralSet_Build(struct LiteralSet *Set)
+{
+    vector< vector<int32_t> > Outs;
+    vector<int32_t> Fail;
+    vector<int32_t> Queue;
+    unsigned int p;
+    unsigned int c;
+    unsigned int q;
+    int32_t State;
+    int32_t NextState;
+    int32_t States;
+    int32_t Cls;
+    int K;
+    int b;
+    uint8_t Byte;
+
+    Set->Next.clear();
+    Set->OutStart.clear();
+    Set->OutList.clear();
+    Set->IsOut.clear();
+
+    /* Work out the byte classes (class 0 is "not in any pattern") */
+    memset(Set->ByteClass,0x00,sizeof(Set->ByteClass));
+    for(p=0;p<Set->Patterns.size();p++)
+        for(c=0;c<Set->Patterns[p].length();c++)
+            Set->ByteClass[(uint8_t)Set->Patterns[p][c]]=1;
+    K=1;
+    for(b=0;b<256;b++)
+        if(Set->ByteClass[b])
+            Set->ByteClass[b]=K++;
+    Set->ClassCount=K;
+
+    /* State 0 is dead, state 1 is the root */
+    States=2;
+    Set->Next.resize(States*K,LITERAL_DEAD_STATE);
+    Outs.resize(States);
+
+    for(p=0;p<Set->Patterns.size();p++)
+    {
+        const string &Pat=Set->Patterns[p];
+        State=LITERAL_ROOT_STATE;
+        for(c=0;c<Pat.length();c++)
+        {
+            if(Set->Type==e_LiteralSet_Reversed)
+                Byte=Pat[Pat.length()-1-c];
+            else
+                Byte=Pat[c];
+            Cls=Set->ByteClass[Byte];
+            NextState=Set->Next[State*K+Cls];
+            if(NextState==LITERAL_DEAD_STATE)
+            {
+                NextState=States++;
+                Set->Next.resize(States*K,LITERAL_DEAD_STATE);
+                Outs.resize(States);
+                Set->Next[State*K+Cls]=NextState;
+            }
+            State=NextState;
+        }
+        Outs[State].push_back(p);
+    }
+
+    if(Set->Type==e_LiteralSet_Search)
+    {
+        /* Fill in the failure transitions breadth first */
+        Fail.resize(States,LITERAL_ROOT_STATE);
+        for(Cls=0;Cls<K;Cls++)
+        {
+            NextState=Set->Next[LITERAL_ROOT_STATE*K+Cls];
+            if(NextState==LITERAL_DEAD_STATE)
+            {
+                Set->Next[LITERAL_ROOT_STATE*K+Cls]=LITERAL_ROOT_STATE;
+            }
+            else
+            {
+                Fail[NextState]=LITERAL_ROOT_STATE;
+                Queue.push_back(NextState);
+            }
+        }
+        for(q=0;q<Queue.size();q++)
+        {
+            State=Queue[q];
+            Outs[State].insert(Outs[State].end(),Outs[Fail[State]].begin(),
+                    Outs[Fail[State]].end());
+            for(Cls=0;Cls<K;Cls++)
+            {
+                NextState=Set->Next[State*K+Cls];
+                if(NextState==LITERAL_DEAD_STATE)
+                {
+                    Set->Next[State*K+Cls]=Set->Next[Fail[State]*K+Cls];
+                }
+                else
+                {
+                    Fail[NextState]=Set->Next[Fail[State]*K+Cls];
+                    Queue.push_back(NextState);
+                }
+            }
+        }
+    }
+
+    Set->OutStart.resize(States,-1);
+    Set->IsOut.resize(States,0);
+    for(State=0;State<States;State++)
+    {
+        if(Outs[State].empty())
+            continue;
+        Set->IsOut[State]=1;
+        Set->OutStart[State]=Set->OutList.size();
+        Set->OutList.insert(Set->OutList.end(),Outs[State].begin(),
+                Outs[State].end());
+        Set->OutList.push_back(-1);
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_FindLiteral
+ *
+ * SYNOPSIS:
+ *    static const uint8_t *TextMatch_FindLiteral(const uint8_t *Line,
+ *          uint32_t Len,const string &Pat);
+ *
+ * PARAMETERS:
+ *    Line [I] -- The line to search
+ *    Len [I] -- The length of the line
+ *    Pat [I] -- The string to look for
+ *
+ * FUNCTION:
+ *    This function finds a string in a line.  It uses memchr() to jump to
+ *    the first byte of the string (which is vectorized in the C lib) and
+ *    then memcmp()'s the rest.  Used when there is only 1 contains string
+ *    (no point in running the full automaton).
+ *
+ * RETURNS:
+ *    A pointer to the first match or NULL if not found.
+ ******************************************************************************/
+static const uint8_t *TextMatch_FindLiteral(const uint8_t *Line,uint32_t Len,
+        const string &Pat)
+{
+    const uint8_t *Pos;
+    const uint8_t *Last;
+    uint32_t PatLen;
+
+    PatLen=Pat.length();
+    if(PatLen>Len)
+        return NULL;
+
+    Pos=Line;
+    Last=Line+Len-PatLen;
+    while(Pos<=Last)
+    {
+        Pos=(const uint8_t *)memchr(Pos,(uint8_t)Pat[0],Last-Pos+1);
+        if(Pos==NULL)
+            return NULL;
+        if(memcmp(Pos+1,Pat.c_str()+1,PatLen-1)==0)
+            return Pos;
+        Pos++;
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    LiteralSet_Match
+ *
+ * SYNOPSIS:
+ *    static bool LiteralSet_Match(struct TextMatchRulesData *Data,
+ *          struct LiteralSet *Set,const uint8_t *Line,uint32_t Len,
+ *          bool StopAtFirst,int *FirstRule);
+ *
+ * PARAMETERS:
+ *    Data [I/O] -- The rule set.  The 'Matched' / 'SpanStart' / 'SpanLen'
+ *                  scratch is filled in for each rule that matches.
+ *    Set [I] -- The literal set to run
+ *    Line [I] -- The line to check
+ *    Len [I] -- The length of the line
+ *    StopAtFirst [I] -- Stop as soon as anything matches
+ *    FirstRule [O] -- The rule index of the first match found
+ *
+ * FUNCTION:
+ *    This function runs one of the literal automatons over a line.
+ *
+ * RETURNS:
+ *    true -- Something matched
+ *    false -- Nothing matched
+ ******************************************************************************/
+static bool LiteralSet_Match(struct TextMatchRulesData *Data,
+        struct LiteralSet *Set,const uint8_t *Line,uint32_t Len,
+        bool StopAtFirst,int *FirstRule)
+{
+    const int32_t *Next;
+    const uint8_t *ByteClass;
+    const uint8_t *Found;
+    const int32_t *Out;
+    bool Hit;
+    int32_t State;
+    uint32_t Pos;
+    uint32_t PatLen;
+    uint32_t Start;
+    int Rule;
+    int K;
+
+    if(Set->Patterns.empty())
+        return false;
+
+    Hit=false;
+
+    if(Set->Type==e_LiteralSet_Search && Set->Patterns.size()==1)
+    {
+        Found=TextMatch_FindLiteral(Line,Len,Set->Patterns[0]);
+        if(Found==NULL)
+            return false;
+        Rule=Set->RuleIndex[0];
+        *FirstRule=Rule;
+        if(!Data->Matched[Rule])
+        {
+            Data->Matched[Rule]=1;
+            Data->SpanStart[Rule]=Found-Line;
+            Data->SpanLen[Rule]=Set->Patterns[0].length();
+        }
+        return true;
+    }
+
+    Next=Set->Next.data();
+    ByteClass=Set->ByteClass;
+    K=Set->ClassCount;
+    State=LITERAL_ROOT_STATE;
+    for(Pos=0;Pos<Len;Pos++)
+    {
+        if(Set->Type==e_LiteralSet_Reversed)
+            State=Next[State*K+ByteClass[Line[Len-1-Pos]]];
+        else
+            State=Next[State*K+ByteClass[Line[Pos]]];
+
+        if(State==LITERAL_DEAD_STATE)
+            break;
+
+        if(!Set->IsOut[State])
+            continue;
+
+        for(Out=&Set->OutList[Set->OutStart[State]];*Out>=0;Out++)
+        {
+            Rule=Set->RuleIndex[*Out];
+            PatLen=Set->Patterns[*Out].length();
+            if(!Hit)
+                *FirstRule=Rule;
+            Hit=true;
+            if(StopAtFirst)
+                return true;
+            if(Data->Matched[Rule])
+                continue;
+
+            switch(Set->Type)
+            {
+                case e_LiteralSet_Anchored:
+                    Start=0;
+                break;
+                case e_LiteralSet_Reversed:
+                    Start=Len-PatLen;
+                break;
+                case e_LiteralSet_Search:
+                case e_LiteralSetMAX:
+                default:
+                    Start=Pos+1-PatLen;
+                break;
+            }
+            Data->Matched[Rule]=1;
+            Data->SpanStart[Rule]=Start;
+            Data->SpanLen[Rule]=PatLen;
+        }
+    }
+    return Hit;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_AllocRules
+ *
+ * SYNOPSIS:
+ *    t_TextMatchRulesType *TextMatch_AllocRules(void);
+ *
+ * PARAMETERS:
+ *    NONE
+ *
+ * FUNCTION:
+ *    This function allocates a new empty rule set.
+ *
+ * RETURNS:
+ *    The new rule set or NULL if we are out of memory.
+ *
+ * SEE ALSO:
+ *    TextMatch_FreeRules(), TextMatch_AddRule(), TextMatch_Compile()
+ ******************************************************************************/
+t_TextMatchRulesType *TextMatch_AllocRules(void)
+{
+    struct TextMatchRulesData *Data;
+
+    try
+    {
+        Data=new struct TextMatchRulesData;
+        Data->StartsWith.Type=e_LiteralSet_Anchored;
+        Data->Contains.Type=e_LiteralSet_Search;
+        Data->EndsWith.Type=e_LiteralSet_Reversed;
+        Data->Compiled=false;
+    }
+    catch(...)
+    {
+        return NULL;
+    }
+    return (t_TextMatchRulesType *)Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_FreeRules
+ *
+ * SYNOPSIS:
+ *    void TextMatch_FreeRules(t_TextMatchRulesType *Rules);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The rule set to free
+ *
+ * FUNCTION:
+ *    This function frees a rule set allocated with TextMatch_AllocRules().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    TextMatch_AllocRules()
+ ******************************************************************************/
+void TextMatch_FreeRules(t_TextMatchRulesType *Rules)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+
+    if(Data==NULL)
+        return;
+
+    TextMatch_ClearRules(Rules);
+    delete Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_ClearRules
+ *
+ * SYNOPSIS:
+ *    void TextMatch_ClearRules(t_TextMatchRulesType *Rules);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The rule set to clear
+ *
+ * FUNCTION:
+ *    This function removes all the rules from a rule set.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void TextMatch_ClearRules(t_TextMatchRulesType *Rules)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+    unsigned int r;
+
+    for(r=0;r<Data->Rules.size();r++)
+        TextMatch_RegexFree(Data->Rules[r].Regex);
+
+    Data->Rules.clear();
+    Data->StartsWith.Patterns.clear();
+    Data->StartsWith.RuleIndex.clear();
+    Data->Contains.Patterns.clear();
+    Data->Contains.RuleIndex.clear();
+    Data->EndsWith.Patterns.clear();
+    Data->EndsWith.RuleIndex.clear();
+    Data->RegexRules.clear();
+    Data->Compiled=false;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_AddRule
+ *
+ * SYNOPSIS:
+ *    bool TextMatch_AddRule(t_TextMatchRulesType *Rules,
+ *          e_TextMatchRuleType Type,const char *Pattern,int RuleID);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The rule set to add to
+ *    Type [I] -- What type of rule this is:
+ *                   e_TextMatchRule_StartsWith -- The line starts with
+ *                   e_TextMatchRule_Contains -- The line has this in it
+ *                   e_TextMatchRule_EndsWith -- The line ends with this
+ *                   e_TextMatchRule_Regex -- regex_search() of the line
+ *    Pattern [I] -- The string / regex
+ *    RuleID [I] -- An ID that is handed back when this rule matches.  This
+ *                  doesn't have to be unique.
+ *
+ * FUNCTION:
+ *    This function adds a rule to a rule set.  Empty patterns are ignored.
+ *    You must call TextMatch_Compile() after adding rules.
+ *
+ * RETURNS:
+ *    true -- Rule added
+ *    false -- The rule could not be added (bad regex or out of memory)
+ *
+ * SEE ALSO:
+ *    TextMatch_Compile()
+ ******************************************************************************/
+bool TextMatch_AddRule(t_TextMatchRulesType *Rules,e_TextMatchRuleType Type,
+        const char *Pattern,int RuleID)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+    struct TextMatchRule NewRule;
+    struct LiteralSet *Set;
+    e_TextMatchRuleType LiteralType;
+    string Literal;
+
+    if(Pattern==NULL || *Pattern==0)
+        return true;
+
+    try
+    {
+        NewRule.Type=Type;
+        NewRule.Pattern=Pattern;
+        NewRule.RuleID=RuleID;
+        NewRule.Regex=NULL;
+
+        /* Plain string regex's go in with the literals */
+        if(Type==e_TextMatchRule_Regex &&
+                TextMatch_RegexAsLiteral(Pattern,Literal,LiteralType))
+        {
+            NewRule.Type=LiteralType;
+            NewRule.Pattern=Literal;
+        }
+
+        switch(NewRule.Type)
+        {
+            case e_TextMatchRule_StartsWith:
+                Set=&Data->StartsWith;
+            break;
+            case e_TextMatchRule_Contains:
+                Set=&Data->Contains;
+            break;
+            case e_TextMatchRule_EndsWith:
+                Set=&Data->EndsWith;
+            break;
+            case e_TextMatchRule_Regex:
+                Set=NULL;
+                NewRule.Regex=TextMatch_RegexCompile(Pattern);
+                if(NewRule.Regex==NULL)
+                    return false;
+            break;
+            case e_TextMatchRuleMAX:
+            default:
+                return false;
+        }
+
+        if(Set!=NULL)
+        {
+            Set->Patterns.push_back(NewRule.Pattern);
+            Set->RuleIndex.push_back(Data->Rules.size());
+        }
+        else
+        {
+            Data->RegexRules.push_back(Data->Rules.size());
+        }
+        Data->Rules.push_back(NewRule);
+        Data->Compiled=false;
+    }
+    catch(...)
+    {
+        TextMatch_RegexFree(NewRule.Regex);
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_Compile
+ *
+ * SYNOPSIS:
+ *    bool TextMatch_Compile(t_TextMatchRulesType *Rules);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The rule set to compile
+ *
+ * FUNCTION:
+ *    This function builds the automatons for all the rules that have been
+ *    added.  This should be done when the settings change, not per line.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- Out of memory
+ ******************************************************************************/
+bool TextMatch_Compile(t_TextMatchRulesType *Rules)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+
+    try
+    {
+        LiteralSet_Build(&Data->StartsWith);
+        LiteralSet_Build(&Data->Contains);
+        LiteralSet_Build(&Data->EndsWith);
+
+        Data->Matched.resize(Data->Rules.size());
+        Data->SpanStart.resize(Data->Rules.size());
+        Data->SpanLen.resize(Data->Rules.size());
+        Data->Compiled=true;
+    }
+    catch(...)
+    {
+        Data->Compiled=false;
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_IsEmpty
+ *
+ * SYNOPSIS:
+ *    bool TextMatch_IsEmpty(t_TextMatchRulesType *Rules);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The rule set to check
+ *
+ * FUNCTION:
+ *    This function checks if there are any rules in a rule set.
+ *
+ * RETURNS:
+ *    true -- There are no rules
+ *    false -- There are rules
+ ******************************************************************************/
+bool TextMatch_IsEmpty(t_TextMatchRulesType *Rules)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+
+    return Data->Rules.empty();
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_MatchAny
+ *
+ * SYNOPSIS:
+ *    bool TextMatch_MatchAny(t_TextMatchRulesType *Rules,const uint8_t *Line,
+ *          uint32_t Len,int *RetRuleID);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The compiled rule set
+ *    Line [I] -- The line to check (does not need to be \0 terminated)
+ *    Len [I] -- The number of bytes in 'Line'
+ *    RetRuleID [O] -- The ID of the rule that matched.  Can be NULL.
+ *
+ * FUNCTION:
+ *    This function checks if any of the rules match a line.  It stops as soon
+ *    as one matches.  The cheap checks (starts / ends with) are done first.
+ *
+ * RETURNS:
+ *    true -- A rule matched
+ *    false -- Nothing matched
+ *
+ * SEE ALSO:
+ *    TextMatch_MatchAll()
+ ******************************************************************************/
+bool TextMatch_MatchAny(t_TextMatchRulesType *Rules,const uint8_t *Line,
+        uint32_t Len,int *RetRuleID)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+    unsigned int r;
+    int Rule;
+
+    if(!Data->Compiled && !TextMatch_Compile(Rules))
+        return false;
+
+    if(LiteralSet_Match(Data,&Data->StartsWith,Line,Len,true,&Rule) ||
+            LiteralSet_Match(Data,&Data->EndsWith,Line,Len,true,&Rule) ||
+            LiteralSet_Match(Data,&Data->Contains,Line,Len,true,&Rule))
+    {
+        if(RetRuleID!=NULL)
+            *RetRuleID=Data->Rules[Rule].RuleID;
+        return true;
+    }
+
+    for(r=0;r<Data->RegexRules.size();r++)
+    {
+        Rule=Data->RegexRules[r];
+        if(TextMatch_RegexSearch(Data->Rules[Rule].Regex,Line,Len,NULL,NULL))
+        {
+            if(RetRuleID!=NULL)
+                *RetRuleID=Data->Rules[Rule].RuleID;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_MatchAll
+ *
+ * SYNOPSIS:
+ *    int TextMatch_MatchAll(t_TextMatchRulesType *Rules,const uint8_t *Line,
+ *          uint32_t Len,t_TextMatchSpanCB CB,void *UserData);
+ *
+ * PARAMETERS:
+ *    Rules [I] -- The compiled rule set
+ *    Line [I] -- The line to check (does not need to be \0 terminated)
+ *    Len [I] -- The number of bytes in 'Line'
+ *    CB [I] -- Called for each rule that matched (can be NULL).  The rules
+ *              are reported in the order they where added.
+ *    UserData [I] -- Passed to 'CB'
+ *
+ * FUNCTION:
+ *    This function checks a line against all the rules and reports the
+ *    span of the first match for each rule that matched.
+ *
+ * RETURNS:
+ *    The number of rules that matched.
+ *
+ * SEE ALSO:
+ *    TextMatch_MatchAny()
+ ******************************************************************************/
+int TextMatch_MatchAll(t_TextMatchRulesType *Rules,const uint8_t *Line,
+        uint32_t Len,t_TextMatchSpanCB CB,void *UserData)
+{
+    struct TextMatchRulesData *Data=(struct TextMatchRulesData *)Rules;
+    unsigned int r;
+    int Count;
+    int Rule;
+
+    if(!Data->Compiled && !TextMatch_Compile(Rules))
+        return 0;
+
+    if(Data->Rules.empty())
+        return 0;
+
+    memset(Data->Matched.data(),0x00,Data->Matched.size());
+
+    LiteralSet_Match(Data,&Data->StartsWith,Line,Len,false,&Rule);
+    LiteralSet_Match(Data,&Data->EndsWith,Line,Len,false,&Rule);
+    LiteralSet_Match(Data,&Data->Contains,Line,Len,false,&Rule);
+
+    for(r=0;r<Data->RegexRules.size();r++)
+    {
+        Rule=Data->RegexRules[r];
+        if(TextMatch_RegexSearch(Data->Rules[Rule].Regex,Line,Len,
+                &Data->SpanStart[Rule],&Data->SpanLen[Rule]))
+        {
+            Data->Matched[Rule]=1;
+        }
+    }
+
+    Count=0;
+    for(r=0;r<Data->Rules.size();r++)
+    {
+        if(!Data->Matched[r])
+            continue;
+        Count++;
+        if(CB!=NULL && !CB(UserData,Data->Rules[r].RuleID,Data->SpanStart[r],
+                Data->SpanLen[r]))
+        {
+            break;
+        }
+    }
+    return Count;
+}
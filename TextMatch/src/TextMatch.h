@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * FILENAME: TextMatch.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is the shared line matching engine used by the text line plugins
+ *    (filter / highlighter).  A set of rules (starts with / contains /
+ *    ends with / regex) is compiled once into automatons and then every
+ *    line is checked against all the rules in one pass.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __TEXTMATCH_H_
+#define __TEXTMATCH_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+typedef enum
+{
+    e_TextMatchRule_StartsWith,
+    e_TextMatchRule_Contains,
+    e_TextMatchRule_EndsWith,
+    e_TextMatchRule_Regex,
+    e_TextMatchRuleMAX
+} e_TextMatchRuleType;
+
+struct TextMatchRules {int PrivateDataHere;};
+typedef struct TextMatchRules t_TextMatchRulesType;
+
+/* Called for every rule that matched a line.  Offset/Len is the span of
+   the first match for that rule.  Return false to stop reporting. */
+typedef bool (*t_TextMatchSpanCB)(void *UserData,int RuleID,uint32_t Offset,
+        uint32_t Len);
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+t_TextMatchRulesType *TextMatch_AllocRules(void);
+void TextMatch_FreeRules(t_TextMatchRulesType *Rules);
+void TextMatch_ClearRules(t_TextMatchRulesType *Rules);
+bool TextMatch_AddRule(t_TextMatchRulesType *Rules,e_TextMatchRuleType Type,
+        const char *Pattern,int RuleID);
+bool TextMatch_Compile(t_TextMatchRulesType *Rules);
+bool TextMatch_IsEmpty(t_TextMatchRulesType *Rules);
+bool TextMatch_MatchAny(t_TextMatchRulesType *Rules,const uint8_t *Line,
+        uint32_t Len,int *RetRuleID);
+int TextMatch_MatchAll(t_TextMatchRulesType *Rules,const uint8_t *Line,
+        uint32_t Len,t_TextMatchSpanCB CB,void *UserData);
+
+#endif
@@ -0,0 +1,1439 @@
+/*******************************************************************************
+ * FILENAME: TextMatch_Regex.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has a small regex engine in it.  The pattern (ECMAScript
+ *    syntax, the same as std::regex's default) is parsed into a tree,
+ *    compiled into a program and then run as a Pike VM.  The VM walks the
+ *    string once keeping every possible thread in step so the time taken is
+ *    linear in the length of the line (std::regex backtracks and can blow
+ *    up on some patterns).
+ *
+ *    Anything the VM doesn't support (back references, look ahead, etc)
+ *    falls back to a std::regex that is compiled once.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "TextMatch_Regex.h"
+#include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*** DEFINES                  ***/
+#define REGEX_MAX_PROG_SIZE             20000   // Bigger than this and we let std::regex do it
+#define REGEX_MAX_REPEAT                1000
+#define REGEX_MAX_DEPTH                 200
+#define REGEX_INF                       -1
+
+/* Return values from RxParse_Escape() that are not bytes */
+#define RXESC_BAD                       -1
+#define RXESC_CLASS                     -2
+#define RXESC_WORDB                     -3
+#define RXESC_NOTWORDB                  -4
+
+/*** MACROS                   ***/
+#define RxClassHas(C,b)                 (((C)->Bits[(b)>>3]>>((b)&7))&1)
+#define RxClassSet(C,b)                 ((C)->Bits[(b)>>3]|=(uint8_t)(1<<((b)&7)))
+
+/*** TYPE DEFINITIONS         ***/
+typedef enum
+{
+    e_RxNode_Empty,
+    e_RxNode_Byte,
+    e_RxNode_Class,
+    e_RxNode_Any,
+    e_RxNode_Concat,
+    e_RxNode_Alt,
+    e_RxNode_Repeat,
+    e_RxNode_BOL,
+    e_RxNode_EOL,
+    e_RxNode_WordB,
+    e_RxNode_NotWordB,
+    e_RxNodeMAX
+} e_RxNodeType;
+
+typedef enum
+{
+    e_RxOp_Byte,
+    e_RxOp_Class,
+    e_RxOp_Any,
+    e_RxOp_Split,
+    e_RxOp_Jmp,
+    e_RxOp_Match,
+    e_RxOp_BOL,
+    e_RxOp_EOL,
+    e_RxOp_WordB,
+    e_RxOp_NotWordB,
+    e_RxOpMAX
+} e_RxOpType;
+
+struct RxClass
+{
+    uint8_t Bits[32];
+};
+
+struct RxNode
+{
+    e_RxNodeType Type;
+    uint8_t Byte;
+    int Class;
+    int Min;
+    int Max;
+    bool Greedy;
+    vector<int> Kids;
+};
+
+struct RxParser
+{
+    const char *p;
+    int Depth;
+    bool Unsupported;
+    vector<RxNode> Nodes;
+    vector<RxClass> Classes;
+};
+
+struct RxInst
+{
+    uint8_t Op;
+    uint8_t Byte;
+    int32_t X;      // Jump / preferred split / class index
+    int32_t Y;      // Other split
+};
+
+struct RxThread
+{
+    int32_t PC;
+    uint32_t Start;
+};
+
+struct RxThreadList
+{
+    RxThread *Threads;
+    int Count;
+    uint32_t Gen;
+};
+
+struct TextMatchRegex
+{
+    bool UseStdRegex;
+    regex *StdRx;
+
+    vector<RxInst> Prog;
+    vector<RxClass> Classes;
+    bool AnchoredStart;
+    bool UsePrefilter;
+    uint8_t FirstBytes[256];
+    int FirstByteCount;
+    uint8_t FirstByte;
+
+    /* Scratch space for the VM, sized when compiled */
+    vector<RxThread> ThreadMem;
+    vector<uint32_t> Visited;
+    vector<int32_t> Stack;
+    uint32_t Gen;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static int RxParse_Alt(struct RxParser *P);
+static bool RxCompileNode(struct TextMatchRegex *Rx,const struct RxParser *P,
+        int n);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+static inline bool RxIsWordByte(uint8_t c)
+{
+    return c<128 && (isalnum(c) || c=='_');
+}
+
+static inline bool RxIsWordAt(const uint8_t *Str,uint32_t Len,int64_t Pos)
+{
+    if(Pos<0 || Pos>=(int64_t)Len)
+        return false;
+    return RxIsWordByte(Str[Pos]);
+}
+
+static int RxNewNode(struct RxParser *P,e_RxNodeType Type)
+{
+    struct RxNode NewNode;
+
+    NewNode.Type=Type;
+    NewNode.Byte=0;
+    NewNode.Class=0;
+    NewNode.Min=0;
+    NewNode.Max=0;
+    NewNode.Greedy=true;
+    P->Nodes.push_back(NewNode);
+    return P->Nodes.size()-1;
+}
+
+static void RxClassAddRange(struct RxClass *C,int Lo,int Hi)
+{
+    int b;
+
+    for(b=Lo;b<=Hi;b++)
+        RxClassSet(C,b);
+}
+
+static void RxClassAddCType(struct RxClass *C,int (*Test)(int))
+{
+    int b;
+
+    for(b=0;b<128;b++)
+        if(Test(b))
+            RxClassSet(C,b);
+}
+
+static void RxClassInvert(struct RxClass *C)
+{
+    int r;
+
+    for(r=0;r<32;r++)
+        C->Bits[r]=~C->Bits[r];
+}
+
+static void RxClassMerge(struct RxClass *Dest,const struct RxClass *Src)
+{
+    int r;
+
+    for(r=0;r<32;r++)
+        Dest->Bits[r]|=Src->Bits[r];
+}
+
+static int RxHexDigit(char c)
+{
+    if(c>='0' && c<='9')
+        return c-'0';
+    if(c>='a' && c<='f')
+        return c-'a'+10;
+    if(c>='A' && c<='F')
+        return c-'A'+10;
+    return -1;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxParse_Escape
+ *
+ * SYNOPSIS:
+ *    static int RxParse_Escape(struct RxParser *P,struct RxClass *C,
+ *          bool InClass);
+ *
+ * PARAMETERS:
+ *    P [I] -- The parser.  'p' points just past the '\'
+ *    C [O] -- Any class escapes (\d \w \s, etc) are OR'ed into this
+ *    InClass [I] -- Are we inside a [] (\b means backspace in there)
+ *
+ * FUNCTION:
+ *    This function decodes a '\' escape.
+ *
+ * RETURNS:
+ *    The byte the escape stands for, or one of:
+ *       RXESC_BAD -- We don't support this (or it's bad)
+ *       RXESC_CLASS -- A class was added to 'C'
+ *       RXESC_WORDB / RXESC_NOTWORDB -- Word boundary assertion
+ ******************************************************************************/
+static int RxParse_Escape(struct RxParser *P,struct RxClass *C,bool InClass)
+{
+    struct RxClass Tmp;
+    char c;
+    int h1;
+    int h2;
+
+    c=*P->p;
+    if(c==0)
+        return RXESC_BAD;
+    P->p++;
+
+    memset(&Tmp,0x00,sizeof(Tmp));
+    switch(c)
+    {
+        case 'd':
+        case 'D':
+            RxClassAddRange(&Tmp,'0','9');
+        break;
+        case 'w':
+        case 'W':
+            RxClassAddCType(&Tmp,isalnum);
+            RxClassSet(&Tmp,'_');
+        break;
+        case 's':
+        case 'S':
+            RxClassAddCType(&Tmp,isspace);
+        break;
+        case 'b':
+            if(InClass)
+                return '\b';
+            return RXESC_WORDB;
+        case 'B':
+            if(InClass)
+                return RXESC_BAD;
+            return RXESC_NOTWORDB;
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'f':
+            return '\f';
+        case 'v':
+            return '\v';
+        case '0':
+            if(*P->p>='0' && *P->p<='9')
+                return RXESC_BAD;
+            return 0;
+        case 'x':
+            h1=RxHexDigit(P->p[0]);
+            if(h1<0)
+                return RXESC_BAD;
+            h2=RxHexDigit(P->p[1]);
+            if(h2<0)
+                return RXESC_BAD;
+            P->p+=2;
+            return h1*16+h2;
+        case 'c':
+            if(!isalpha((uint8_t)*P->p))
+                return RXESC_BAD;
+            return (uint8_t)(*P->p++)%32;
+        default:
+            /* Back references, \u, \k, etc.  Let std::regex deal with them */
+            if(isalnum((uint8_t)c))
+                return RXESC_BAD;
+            return (uint8_t)c;
+    }
+
+    /* If we get here we have a class in 'Tmp' */
+    if(isupper((uint8_t)c))
+        RxClassInvert(&Tmp);
+    RxClassMerge(C,&Tmp);
+    return RXESC_CLASS;
+}
+
+static bool RxParse_PosixClass(struct RxParser *P,struct RxClass *C)
+{
+    static const struct
+    {
+        const char *Name;
+        int (*Test)(int);
+    } PosixClasses[]=
+    {
+        {"alpha",isalpha},
+        {"digit",isdigit},
+        {"alnum",isalnum},
+        {"space",isspace},
+        {"upper",isupper},
+        {"lower",islower},
+        {"punct",ispunct},
+        {"xdigit",isxdigit},
+        {"cntrl",iscntrl},
+        {"print",isprint},
+        {"graph",isgraph},
+        {"blank",isblank},
+    };
+    const char *End;
+    unsigned int r;
+
+    /* 'p' points at "[:" */
+    End=strstr(P->p+2,":]");
+    if(End==NULL)
+        return false;
+
+    for(r=0;r<sizeof(PosixClasses)/sizeof(PosixClasses[0]);r++)
+    {
+        if(strlen(PosixClasses[r].Name)==(size_t)(End-(P->p+2)) &&
+                strncmp(PosixClasses[r].Name,P->p+2,End-(P->p+2))==0)
+        {
+            RxClassAddCType(C,PosixClasses[r].Test);
+            P->p=End+2;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int RxParse_Class(struct RxParser *P)
+{
+    struct RxClass C;
+    bool Negate;
+    int Lo;
+    int Hi;
+    int n;
+
+    /* 'p' points just past the '[' */
+    memset(&C,0x00,sizeof(C));
+    Negate=false;
+    if(*P->p=='^')
+    {
+        Negate=true;
+        P->p++;
+    }
+
+    /* "[]" and "[^]" are odd ones, let std::regex have them */
+    if(*P->p==']')
+    {
+        P->Unsupported=true;
+        return 0;
+    }
+
+    while(*P->p!=0 && *P->p!=']')
+    {
+        if(P->p[0]=='[' && P->p[1]==':')
+        {
+            if(!RxParse_PosixClass(P,&C))
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+            continue;
+        }
+
+        if(*P->p=='\\')
+        {
+            P->p++;
+            Lo=RxParse_Escape(P,&C,true);
+            if(Lo==RXESC_CLASS)
+                continue;
+            if(Lo<0)
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+        }
+        else
+        {
+            Lo=(uint8_t)*P->p++;
+        }
+
+        if(P->p[0]=='-' && P->p[1]!=']' && P->p[1]!=0)
+        {
+            P->p++;
+            if(*P->p=='\\')
+            {
+                P->p++;
+                Hi=RxParse_Escape(P,&C,true);
+            }
+            else if(P->p[0]=='[' && P->p[1]==':')
+            {
+                Hi=RXESC_BAD;
+            }
+            else
+            {
+                Hi=(uint8_t)*P->p++;
+            }
+            if(Hi<0 || Hi<Lo)
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+            RxClassAddRange(&C,Lo,Hi);
+        }
+        else
+        {
+            RxClassSet(&C,Lo);
+        }
+    }
+    if(*P->p!=']')
+    {
+        P->Unsupported=true;
+        return 0;
+    }
+    P->p++;
+
+    if(Negate)
+        RxClassInvert(&C);
+
+    P->Classes.push_back(C);
+    n=RxNewNode(P,e_RxNode_Class);
+    P->Nodes[n].Class=P->Classes.size()-1;
+    return n;
+}
+
+static int RxParse_Atom(struct RxParser *P)
+{
+    struct RxClass C;
+    int Esc;
+    int n;
+
+    switch(*P->p)
+    {
+        case '(':
+            P->p++;
+            if(*P->p=='?')
+            {
+                /* Only (?: is supported, look ahead goes to std::regex */
+                if(P->p[1]!=':')
+                {
+                    P->Unsupported=true;
+                    return 0;
+                }
+                P->p+=2;
+            }
+            if(++P->Depth>REGEX_MAX_DEPTH)
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+            n=RxParse_Alt(P);
+            P->Depth--;
+            if(P->Unsupported || *P->p!=')')
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+            P->p++;
+            return n;
+        case '[':
+            P->p++;
+            return RxParse_Class(P);
+        case '.':
+            P->p++;
+            return RxNewNode(P,e_RxNode_Any);
+        case '^':
+            P->p++;
+            return RxNewNode(P,e_RxNode_BOL);
+        case '$':
+            P->p++;
+            return RxNewNode(P,e_RxNode_EOL);
+        case '\\':
+            P->p++;
+            memset(&C,0x00,sizeof(C));
+            Esc=RxParse_Escape(P,&C,false);
+            switch(Esc)
+            {
+                case RXESC_BAD:
+                    P->Unsupported=true;
+                    return 0;
+                case RXESC_CLASS:
+                    P->Classes.push_back(C);
+                    n=RxNewNode(P,e_RxNode_Class);
+                    P->Nodes[n].Class=P->Classes.size()-1;
+                    return n;
+                case RXESC_WORDB:
+                    return RxNewNode(P,e_RxNode_WordB);
+                case RXESC_NOTWORDB:
+                    return RxNewNode(P,e_RxNode_NotWordB);
+                default:
+                    n=RxNewNode(P,e_RxNode_Byte);
+                    P->Nodes[n].Byte=Esc;
+                    return n;
+            }
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case '}':
+        case ']':
+            /* Errors (or odd cases), let std::regex decide */
+            P->Unsupported=true;
+            return 0;
+        default:
+            n=RxNewNode(P,e_RxNode_Byte);
+            P->Nodes[n].Byte=(uint8_t)*P->p++;
+            return n;
+    }
+}
+
+static bool RxParse_Number(struct RxParser *P,int *Value)
+{
+    int v;
+
+    if(*P->p<'0' || *P->p>'9')
+        return false;
+    v=0;
+    while(*P->p>='0' && *P->p<='9')
+    {
+        v=v*10+(*P->p-'0');
+        if(v>REGEX_MAX_REPEAT)
+            return false;
+        P->p++;
+    }
+    *Value=v;
+    return true;
+}
+
+static int RxParse_Repeat(struct RxParser *P)
+{
+    e_RxNodeType AtomType;
+    int Atom;
+    int Min;
+    int Max;
+    int n;
+
+    Atom=RxParse_Atom(P);
+    if(P->Unsupported)
+        return 0;
+
+    switch(*P->p)
+    {
+        case '*':
+            Min=0;
+            Max=REGEX_INF;
+            P->p++;
+        break;
+        case '+':
+            Min=1;
+            Max=REGEX_INF;
+            P->p++;
+        break;
+        case '?':
+            Min=0;
+            Max=1;
+            P->p++;
+        break;
+        case '{':
+            P->p++;
+            if(!RxParse_Number(P,&Min))
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+            Max=Min;
+            if(*P->p==',')
+            {
+                P->p++;
+                Max=REGEX_INF;
+                if(*P->p!='}' && (!RxParse_Number(P,&Max) || Max<Min))
+                {
+                    P->Unsupported=true;
+                    return 0;
+                }
+            }
+            if(*P->p!='}')
+            {
+                P->Unsupported=true;
+                return 0;
+            }
+            P->p++;
+        break;
+        default:
+            return Atom;
+    }
+
+    AtomType=P->Nodes[Atom].Type;
+    if(AtomType==e_RxNode_BOL || AtomType==e_RxNode_EOL ||
+            AtomType==e_RxNode_WordB || AtomType==e_RxNode_NotWordB)
+    {
+        P->Unsupported=true;
+        return 0;
+    }
+
+    n=RxNewNode(P,e_RxNode_Repeat);
+    P->Nodes[n].Min=Min;
+    P->Nodes[n].Max=Max;
+    P->Nodes[n].Kids.push_back(Atom);
+    if(*P->p=='?')
+    {
+        P->Nodes[n].Greedy=false;
+        P->p++;
+    }
+
+    /* "a**" and friends are errors */
+    if(*P->p=='*' || *P->p=='+' || *P->p=='?' || *P->p=='{')
+    {
+        P->Unsupported=true;
+        return 0;
+    }
+
+    return n;
+}
+
+static int RxParse_Concat(struct RxParser *P)
+{
+    int n;
+    int Kid;
+
+    n=RxNewNode(P,e_RxNode_Concat);
+    while(*P->p!=0 && *P->p!='|' && *P->p!=')')
+    {
+        Kid=RxParse_Repeat(P);
+        if(P->Unsupported)
+            return 0;
+        P->Nodes[n].Kids.push_back(Kid);
+    }
+    return n;
+}
+
+static int RxParse_Alt(struct RxParser *P)
+{
+    int First;
+    int Kid;
+    int n;
+
+    First=RxParse_Concat(P);
+    if(P->Unsupported || *P->p!='|')
+        return First;
+
+    n=RxNewNode(P,e_RxNode_Alt);
+    P->Nodes[n].Kids.push_back(First);
+    while(*P->p=='|')
+    {
+        P->p++;
+        Kid=RxParse_Concat(P);
+        if(P->Unsupported)
+            return 0;
+        P->Nodes[n].Kids.push_back(Kid);
+    }
+    return n;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxParse
+ *
+ * SYNOPSIS:
+ *    static bool RxParse(struct RxParser *P,const char *Pattern,int *Root);
+ *
+ * PARAMETERS:
+ *    P [I/O] -- The parser to fill in
+ *    Pattern [I] -- The regex to parse
+ *    Root [O] -- The index of the top node
+ *
+ * FUNCTION:
+ *    This function parses a regex into a tree of nodes.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- The pattern uses something we don't support (or is bad).
+ ******************************************************************************/
+static bool RxParse(struct RxParser *P,const char *Pattern,int *Root)
+{
+    P->p=Pattern;
+    P->Depth=0;
+    P->Unsupported=false;
+    P->Nodes.clear();
+    P->Classes.clear();
+
+    *Root=RxParse_Alt(P);
+    if(P->Unsupported || *P->p!=0)
+        return false;
+    return true;
+}
+
+static int RxEmit(struct TextMatchRegex *Rx,uint8_t Op,int32_t X,int32_t Y,
+        uint8_t Byte)
+{
+    struct RxInst Inst;
+
+    Inst.Op=Op;
+    Inst.Byte=Byte;
+    Inst.X=X;
+    Inst.Y=Y;
+    Rx->Prog.push_back(Inst);
+    return Rx->Prog.size()-1;
+}
+
+static void RxSetSplit(struct TextMatchRegex *Rx,int Split,int32_t Taken,
+        int32_t Skipped,bool Greedy)
+{
+    if(Greedy)
+    {
+        Rx->Prog[Split].X=Taken;
+        Rx->Prog[Split].Y=Skipped;
+    }
+    else
+    {
+        Rx->Prog[Split].X=Skipped;
+        Rx->Prog[Split].Y=Taken;
+    }
+}
+
+static bool RxCompileRepeat(struct TextMatchRegex *Rx,const struct RxParser *P,
+        const struct RxNode *Node)
+{
+    vector<int> Splits;
+    int Kid;
+    int Start;
+    int Split;
+    int r;
+
+    Kid=Node->Kids[0];
+    if(Node->Max==REGEX_INF)
+    {
+        if(Node->Min>0)
+        {
+            for(r=0;r<Node->Min-1;r++)
+                if(!RxCompileNode(Rx,P,Kid))
+                    return false;
+
+            /* L1: Kid; Split L1,L2; L2: */
+            Start=Rx->Prog.size();
+            if(!RxCompileNode(Rx,P,Kid))
+                return false;
+            Split=RxEmit(Rx,e_RxOp_Split,0,0,0);
+            RxSetSplit(Rx,Split,Start,Split+1,Node->Greedy);
+        }
+        else
+        {
+            /* L1: Split L2,L3; L2: Kid; Jmp L1; L3: */
+            Split=RxEmit(Rx,e_RxOp_Split,0,0,0);
+            if(!RxCompileNode(Rx,P,Kid))
+                return false;
+            RxEmit(Rx,e_RxOp_Jmp,Split,0,0);
+            RxSetSplit(Rx,Split,Split+1,Rx->Prog.size(),Node->Greedy);
+        }
+        return true;
+    }
+
+    for(r=0;r<Node->Min;r++)
+        if(!RxCompileNode(Rx,P,Kid))
+            return false;
+
+    /* Each optional copy can skip to the end (skipping one skips the rest) */
+    for(r=Node->Min;r<Node->Max;r++)
+    {
+        Splits.push_back(RxEmit(Rx,e_RxOp_Split,0,0,0));
+        if(!RxCompileNode(Rx,P,Kid))
+            return false;
+    }
+    for(r=0;r<(int)Splits.size();r++)
+        RxSetSplit(Rx,Splits[r],Splits[r]+1,Rx->Prog.size(),Node->Greedy);
+
+    return true;
+}
+
+static bool RxCompileNode(struct TextMatchRegex *Rx,const struct RxParser *P,
+        int n)
+{
+    const struct RxNode *Node;
+    vector<int> Jmps;
+    unsigned int k;
+    int Split;
+
+    if(Rx->Prog.size()>REGEX_MAX_PROG_SIZE)
+        return false;
+
+    Node=&P->Nodes[n];
+    switch(Node->Type)
+    {
+        case e_RxNode_Empty:
+        break;
+        case e_RxNode_Byte:
+            RxEmit(Rx,e_RxOp_Byte,0,0,Node->Byte);
+        break;
+        case e_RxNode_Class:
+            RxEmit(Rx,e_RxOp_Class,Node->Class,0,0);
+        break;
+        case e_RxNode_Any:
+            RxEmit(Rx,e_RxOp_Any,0,0,0);
+        break;
+        case e_RxNode_BOL:
+            RxEmit(Rx,e_RxOp_BOL,0,0,0);
+        break;
+        case e_RxNode_EOL:
+            RxEmit(Rx,e_RxOp_EOL,0,0,0);
+        break;
+        case e_RxNode_WordB:
+            RxEmit(Rx,e_RxOp_WordB,0,0,0);
+        break;
+        case e_RxNode_NotWordB:
+            RxEmit(Rx,e_RxOp_NotWordB,0,0,0);
+        break;
+        case e_RxNode_Concat:
+            for(k=0;k<Node->Kids.size();k++)
+                if(!RxCompileNode(Rx,P,Node->Kids[k]))
+                    return false;
+        break;
+        case e_RxNode_Alt:
+            /* Split L1,Next; L1: Kid; Jmp End; Next: ... */
+            for(k=0;k<Node->Kids.size()-1;k++)
+            {
+                Split=RxEmit(Rx,e_RxOp_Split,0,0,0);
+                if(!RxCompileNode(Rx,P,Node->Kids[k]))
+                    return false;
+                Jmps.push_back(RxEmit(Rx,e_RxOp_Jmp,0,0,0));
+                RxSetSplit(Rx,Split,Split+1,Rx->Prog.size(),true);
+            }
+            if(!RxCompileNode(Rx,P,Node->Kids[k]))
+                return false;
+            for(k=0;k<Jmps.size();k++)
+                Rx->Prog[Jmps[k]].X=Rx->Prog.size();
+        break;
+        case e_RxNode_Repeat:
+            if(!RxCompileRepeat(Rx,P,Node))
+                return false;
+        break;
+        case e_RxNodeMAX:
+        default:
+            return false;
+    }
+    return true;
+}
+
+static bool RxNodeAnchored(const struct RxParser *P,int n)
+{
+    const struct RxNode *Node;
+    unsigned int k;
+
+    Node=&P->Nodes[n];
+    switch(Node->Type)
+    {
+        case e_RxNode_BOL:
+            return true;
+        case e_RxNode_Concat:
+            if(Node->Kids.empty())
+                return false;
+            return RxNodeAnchored(P,Node->Kids[0]);
+        case e_RxNode_Alt:
+            for(k=0;k<Node->Kids.size();k++)
+                if(!RxNodeAnchored(P,Node->Kids[k]))
+                    return false;
+            return true;
+        case e_RxNode_Repeat:
+            return Node->Min>0 && RxNodeAnchored(P,Node->Kids[0]);
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxBuildPrefilter
+ *
+ * SYNOPSIS:
+ *    static void RxBuildPrefilter(struct TextMatchRegex *Rx);
+ *
+ * PARAMETERS:
+ *    Rx [I/O] -- The compiled regex
+ *
+ * FUNCTION:
+ *    This function works out what bytes a match can start with.  When
+ *    the VM has no threads running it uses this to skip straight to the next
+ *    place a match could start (with memchr() if there is only 1 byte).
+ *
+ *    If the pattern can match an empty string the prefilter is turned off.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxBuildPrefilter(struct TextMatchRegex *Rx)
+{
+    vector<int32_t> Stack;
+    vector<uint8_t> Seen;
+    const struct RxInst *Inst;
+    int32_t PC;
+    int b;
+
+    memset(Rx->FirstBytes,0x00,sizeof(Rx->FirstBytes));
+    Rx->UsePrefilter=false;
+    Rx->FirstByteCount=0;
+    Rx->FirstByte=0;
+
+    Seen.resize(Rx->Prog.size(),0);
+    Stack.push_back(0);
+    while(!Stack.empty())
+    {
+        PC=Stack.back();
+        Stack.pop_back();
+        if(Seen[PC])
+            continue;
+        Seen[PC]=1;
+        Inst=&Rx->Prog[PC];
+        switch(Inst->Op)
+        {
+            case e_RxOp_Byte:
+                Rx->FirstBytes[Inst->Byte]=1;
+            break;
+            case e_RxOp_Class:
+                for(b=0;b<256;b++)
+                    if(RxClassHas(&Rx->Classes[Inst->X],b))
+                        Rx->FirstBytes[b]=1;
+            break;
+            case e_RxOp_Any:
+                for(b=0;b<256;b++)
+                    if(b!='\n' && b!='\r')
+                        Rx->FirstBytes[b]=1;
+            break;
+            case e_RxOp_Split:
+                Stack.push_back(Inst->Y);
+                Stack.push_back(Inst->X);
+            break;
+            case e_RxOp_Jmp:
+                Stack.push_back(Inst->X);
+            break;
+            case e_RxOp_BOL:
+            case e_RxOp_EOL:
+            case e_RxOp_WordB:
+            case e_RxOp_NotWordB:
+                Stack.push_back(PC+1);
+            break;
+            case e_RxOp_Match:
+            default:
+                /* Can match empty, every position is a candidate */
+                return;
+        }
+    }
+
+    for(b=0;b<256;b++)
+    {
+        if(Rx->FirstBytes[b])
+        {
+            Rx->FirstByteCount++;
+            Rx->FirstByte=b;
+        }
+    }
+    Rx->UsePrefilter=Rx->FirstByteCount<256;
+}
+
+static uint32_t RxNextGen(struct TextMatchRegex *Rx)
+{
+    Rx->Gen++;
+    if(Rx->Gen==0)
+    {
+        memset(Rx->Visited.data(),0x00,Rx->Visited.size()*sizeof(uint32_t));
+        Rx->Gen=1;
+    }
+    return Rx->Gen;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    RxAddThread
+ *
+ * SYNOPSIS:
+ *    static void RxAddThread(struct TextMatchRegex *Rx,struct RxThreadList *L,
+ *          int32_t PC,uint32_t Start,const uint8_t *Str,uint32_t Len,
+ *          uint32_t Pos);
+ *
+ * PARAMETERS:
+ *    Rx [I] -- The regex
+ *    L [I/O] -- The thread list to add to
+ *    PC [I] -- The instruction the thread is at
+ *    Start [I] -- Where in the string the thread started matching
+ *    Str [I] -- The string
+ *    Len [I] -- The length of the string
+ *    Pos [I] -- The position in the string the thread is at
+ *
+ * FUNCTION:
+ *    This function adds a thread to a list following all the jumps, splits
+ *    and assertions.  Only threads sitting on instructions that eat a byte
+ *    (or match) end up in the list.  Threads are added in priority order and
+ *    each instruction is only added once per position, which is what keeps
+ *    things linear.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void RxAddThread(struct TextMatchRegex *Rx,struct RxThreadList *L,
+        int32_t PC,uint32_t Start,const uint8_t *Str,uint32_t Len,uint32_t Pos)
+{
+    const struct RxInst *Inst;
+    int32_t *Stack;
+    uint32_t *Visited;
+    int SP;
+
+    Stack=Rx->Stack.data();
+    Visited=Rx->Visited.data();
+    SP=0;
+    Stack[SP++]=PC;
+    while(SP>0)
+    {
+        PC=Stack[--SP];
+        if(Visited[PC]==L->Gen)
+            continue;
+        Visited[PC]=L->Gen;
+
+        Inst=&Rx->Prog[PC];
+        switch(Inst->Op)
+        {
+            case e_RxOp_Jmp:
+                Stack[SP++]=Inst->X;
+            break;
+            case e_RxOp_Split:
+                Stack[SP++]=Inst->Y;
+                Stack[SP++]=Inst->X;
+            break;
+            case e_RxOp_BOL:
+                if(Pos==0)
+                    Stack[SP++]=PC+1;
+            break;
+            case e_RxOp_EOL:
+                if(Pos==Len)
+                    Stack[SP++]=PC+1;
+            break;
+            case e_RxOp_WordB:
+                if(RxIsWordAt(Str,Len,(int64_t)Pos-1)!=RxIsWordAt(Str,Len,Pos))
+                    Stack[SP++]=PC+1;
+            break;
+            case e_RxOp_NotWordB:
+                if(RxIsWordAt(Str,Len,(int64_t)Pos-1)==RxIsWordAt(Str,Len,Pos))
+                    Stack[SP++]=PC+1;
+            break;
+            default:
+                L->Threads[L->Count].PC=PC;
+                L->Threads[L->Count].Start=Start;
+                L->Count++;
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_RegexCompile
+ *
+ * SYNOPSIS:
+ *    struct TextMatchRegex *TextMatch_RegexCompile(const char *Pattern);
+ *
+ * PARAMETERS:
+ *    Pattern [I] -- The regex to compile
+ *
+ * FUNCTION:
+ *    This function compiles a regex.  If the pattern uses something the VM
+ *    doesn't support then it is handed to std::regex instead.
+ *
+ * RETURNS:
+ *    The compiled regex or NULL if the pattern is bad.
+ *
+ * SEE ALSO:
+ *    TextMatch_RegexFree(), TextMatch_RegexSearch()
+ ******************************************************************************/
+struct TextMatchRegex *TextMatch_RegexCompile(const char *Pattern)
+{
+    struct TextMatchRegex *Rx;
+    struct RxParser P;
+    int Root;
+
+    Rx=NULL;
+    try
+    {
+        Rx=new struct TextMatchRegex;
+        Rx->UseStdRegex=false;
+        Rx->StdRx=NULL;
+        Rx->AnchoredStart=false;
+        Rx->UsePrefilter=false;
+        Rx->FirstByteCount=0;
+        Rx->FirstByte=0;
+        Rx->Gen=0;
+
+        if(!RxParse(&P,Pattern,&Root) || !RxCompileNode(Rx,&P,Root) ||
+                Rx->Prog.size()>REGEX_MAX_PROG_SIZE)
+        {
+            /* Not something we can run, let std::regex have a go */
+            Rx->Prog.clear();
+            Rx->UseStdRegex=true;
+            Rx->StdRx=new regex(Pattern,regex::ECMAScript|regex::optimize);
+            return Rx;
+        }
+        RxEmit(Rx,e_RxOp_Match,0,0,0);
+
+        Rx->Classes=P.Classes;
+        Rx->AnchoredStart=RxNodeAnchored(&P,Root);
+        RxBuildPrefilter(Rx);
+
+        Rx->ThreadMem.resize(Rx->Prog.size()*2);
+        Rx->Visited.resize(Rx->Prog.size(),0);
+        Rx->Stack.resize(Rx->Prog.size()*2+2);
+    }
+    catch(...)
+    {
+        if(Rx!=NULL)
+        {
+            delete Rx->StdRx;
+            delete Rx;
+        }
+        return NULL;
+    }
+    return Rx;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_RegexFree
+ *
+ * SYNOPSIS:
+ *    void TextMatch_RegexFree(struct TextMatchRegex *Rx);
+ *
+ * PARAMETERS:
+ *    Rx [I] -- The regex to free
+ *
+ * FUNCTION:
+ *    This function frees a regex allocated with TextMatch_RegexCompile().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    TextMatch_RegexCompile()
+ ******************************************************************************/
+void TextMatch_RegexFree(struct TextMatchRegex *Rx)
+{
+    if(Rx==NULL)
+        return;
+    delete Rx->StdRx;
+    delete Rx;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_RegexSearch
+ *
+ * SYNOPSIS:
+ *    bool TextMatch_RegexSearch(struct TextMatchRegex *Rx,const uint8_t *Str,
+ *          uint32_t Len,uint32_t *RetStart,uint32_t *RetLen);
+ *
+ * PARAMETERS:
+ *    Rx [I] -- The regex to run
+ *    Str [I] -- The string to search
+ *    Len [I] -- The number of bytes in 'Str'
+ *    RetStart [O] -- Where the match starts.  If this is NULL then we stop
+ *                    at the first match found (we don't need the span).
+ *    RetLen [O] -- The length of the match
+ *
+ * FUNCTION:
+ *    This function searches a string for the regex (the same as
+ *    std::regex_search()).  The match returned is the left most match
+ *    picked using the same priority rules as ECMAScript.
+ *
+ *    This is not reentrant (the VM scratch space is in 'Rx').
+ *
+ * RETURNS:
+ *    true -- There was a match
+ *    false -- No match
+ ******************************************************************************/
+bool TextMatch_RegexSearch(struct TextMatchRegex *Rx,const uint8_t *Str,
+        uint32_t Len,uint32_t *RetStart,uint32_t *RetLen)
+{
+    struct RxThreadList Lists[2];
+    struct RxThreadList *CList;
+    struct RxThreadList *NList;
+    struct RxThreadList *Tmp;
+    const struct RxInst *Inst;
+    const struct RxThread *Th;
+    const uint8_t *Found;
+    cmatch Match;
+    bool Matched;
+    uint32_t MatchStart;
+    uint32_t MatchEnd;
+    uint32_t Pos;
+    int t;
+
+    if(Rx->UseStdRegex)
+    {
+        try
+        {
+            if(!regex_search((const char *)Str,(const char *)Str+Len,Match,
+                    *Rx->StdRx))
+            {
+                return false;
+            }
+        }
+        catch(...)
+        {
+            return false;
+        }
+        if(RetStart!=NULL)
+        {
+            *RetStart=Match.position(0);
+            *RetLen=Match.length(0);
+        }
+        return true;
+    }
+
+    Lists[0].Threads=Rx->ThreadMem.data();
+    Lists[0].Count=0;
+    Lists[0].Gen=0;
+    Lists[1].Threads=Rx->ThreadMem.data()+Rx->Prog.size();
+    Lists[1].Count=0;
+    Lists[1].Gen=0;
+    CList=&Lists[0];
+    NList=&Lists[1];
+
+    Matched=false;
+    MatchStart=0;
+    MatchEnd=0;
+    for(Pos=0;Pos<=Len;Pos++)
+    {
+        /* Start a new (lowest priority) thread here */
+        if(!Matched && (Pos==0 || !Rx->AnchoredStart))
+        {
+            if(CList->Count==0)
+            {
+                if(Rx->UsePrefilter)
+                {
+                    if(Rx->AnchoredStart)
+                    {
+                        if(Pos>=Len || !Rx->FirstBytes[Str[Pos]])
+                            break;
+                    }
+                    else if(Rx->FirstByteCount==1)
+                    {
+                        if(Pos>=Len)
+                            break;
+                        Found=(const uint8_t *)memchr(Str+Pos,Rx->FirstByte,
+                                Len-Pos);
+                        if(Found==NULL)
+                            break;
+                        Pos=Found-Str;
+                    }
+                    else
+                    {
+                        while(Pos<Len && !Rx->FirstBytes[Str[Pos]])
+                            Pos++;
+                        if(Pos>=Len)
+                            break;
+                    }
+                }
+                CList->Gen=RxNextGen(Rx);
+            }
+            RxAddThread(Rx,CList,0,Pos,Str,Len,Pos);
+        }
+
+        if(CList->Count==0)
+        {
+            if(Matched || Rx->AnchoredStart)
+                break;
+            continue;
+        }
+
+        NList->Count=0;
+        NList->Gen=RxNextGen(Rx);
+        for(t=0;t<CList->Count;t++)
+        {
+            Th=&CList->Threads[t];
+            Inst=&Rx->Prog[Th->PC];
+            switch(Inst->Op)
+            {
+                case e_RxOp_Byte:
+                    if(Pos<Len && Str[Pos]==Inst->Byte)
+                        RxAddThread(Rx,NList,Th->PC+1,Th->Start,Str,Len,Pos+1);
+                break;
+                case e_RxOp_Class:
+                    if(Pos<Len && RxClassHas(&Rx->Classes[Inst->X],Str[Pos]))
+                        RxAddThread(Rx,NList,Th->PC+1,Th->Start,Str,Len,Pos+1);
+                break;
+                case e_RxOp_Any:
+                    if(Pos<Len && Str[Pos]!='\n' && Str[Pos]!='\r')
+                        RxAddThread(Rx,NList,Th->PC+1,Th->Start,Str,Len,Pos+1);
+                break;
+                case e_RxOp_Match:
+                    if(RetStart==NULL)
+                        return true;
+                    Matched=true;
+                    MatchStart=Th->Start;
+                    MatchEnd=Pos;
+                    /* Cut off all the lower priority threads */
+                    t=CList->Count;
+                break;
+                default:
+                break;
+            }
+        }
+        Tmp=CList;
+        CList=NList;
+        NList=Tmp;
+    }
+
+    if(!Matched)
+        return false;
+
+    *RetStart=MatchStart;
+    *RetLen=MatchEnd-MatchStart;
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    TextMatch_RegexAsLiteral
+ *
+ * SYNOPSIS:
+ *    bool TextMatch_RegexAsLiteral(const char *Pattern,std::string &Literal,
+ *          e_TextMatchRuleType &Type);
+ *
+ * PARAMETERS:
+ *    Pattern [I] -- The regex to look at
+ *    Literal [O] -- The plain string the regex is looking for
+ *    Type [O] -- What type of literal match this is (contains, starts with,
+ *                or ends with)
+ *
+ * FUNCTION:
+ *    This function checks if a regex is really just a plain string
+ *    ("error", "^ERR:", "done\.$").  These get moved into the literal
+ *    automatons which is much faster than running the VM.
+ *
+ * RETURNS:
+ *    true -- This is a literal, 'Literal' and 'Type' are filled in
+ *    false -- This needs a real regex
+ ******************************************************************************/
+bool TextMatch_RegexAsLiteral(const char *Pattern,std::string &Literal,
+        e_TextMatchRuleType &Type)
+{
+    struct RxParser P;
+    const struct RxNode *Root;
+    const struct RxNode *Kid;
+    unsigned int First;
+    unsigned int Last;
+    unsigned int k;
+    int RootIndex;
+
+    try
+    {
+        if(!RxParse(&P,Pattern,&RootIndex))
+            return false;
+    }
+    catch(...)
+    {
+        return false;
+    }
+
+    Root=&P.Nodes[RootIndex];
+    if(Root->Type!=e_RxNode_Concat || Root->Kids.empty())
+        return false;
+
+    First=0;
+    Last=Root->Kids.size();
+    Type=e_TextMatchRule_Contains;
+    if(P.Nodes[Root->Kids[0]].Type==e_RxNode_BOL)
+    {
+        Type=e_TextMatchRule_StartsWith;
+        First++;
+    }
+    if(P.Nodes[Root->Kids[Last-1]].Type==e_RxNode_EOL)
+    {
+        /* "^abc$" is an exact match, leave that to the VM */
+        if(Type!=e_TextMatchRule_Contains)
+            return false;
+        Type=e_TextMatchRule_EndsWith;
+        Last--;
+    }
+    if(First>=Last)
+        return false;
+
+    Literal.clear();
+    for(k=First;k<Last;k++)
+    {
+        Kid=&P.Nodes[Root->Kids[k]];
+        if(Kid->Type!=e_RxNode_Byte)
+            return false;
+        Literal.push_back((char)Kid->Byte);
+    }
+    return true;
+}
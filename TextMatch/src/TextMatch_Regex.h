@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * FILENAME: TextMatch_Regex.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    The regex part of the text match engine.  Patterns are compiled to
+ *    a small program that is run as a Pike VM so matching is linear in the
+ *    length of the line.  Patterns the VM does not support (back references,
+ *    look ahead, etc) fall back to std::regex.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __TEXTMATCH_REGEX_H_
+#define __TEXTMATCH_REGEX_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include "TextMatch.h"
+#include <stdint.h>
+#include <string>
+
+/***  DEFINES                          ***/
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+struct TextMatchRegex;
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+struct TextMatchRegex *TextMatch_RegexCompile(const char *Pattern);
+void TextMatch_RegexFree(struct TextMatchRegex *Rx);
+bool TextMatch_RegexSearch(struct TextMatchRegex *Rx,const uint8_t *Str,
+        uint32_t Len,uint32_t *RetStart,uint32_t *RetLen);
+bool TextMatch_RegexAsLiteral(const char *Pattern,std::string &Literal,
+        e_TextMatchRuleType &Type);
+
+#endif
@@ -0,0 +1,505 @@
+/*******************************************************************************
+ * FILENAME: ITSIndexTool.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This is a small command line tool for the timestamp index files that
+ *    the InsertTimeStamp plugin writes.  It binary searches the index for a
+ *    time range and prints the lines / byte range that arrived in it.
+ *
+ *    Usage:
+ *       ITSIndexTool [-r] [-q] IndexFile Start [End]
+ *
+ *    Start / End can be:
+ *       "YYYY-MM-DD HH:MM:SS[.frac]" -- Local time
+ *       "HH:MM:SS[.frac]" -- Local time on the day of the connect
+ *       "@Seconds[.frac]" -- Seconds since the Unix epoch
+ *    With -r they are seconds since the connect (using the monotonic times,
+ *    so clock changes don't matter).
+ *
+ *    If End is left off everything after Start is used.  -q prints just the
+ *    start and end byte offsets ("EOF" if the range goes to the end).
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "InsertTimeStamp_Index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*** DEFINES                  ***/
+#define ITSINDEX_HEADER_SIZE                64
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+struct IndexFile
+{
+    FILE *fh;
+    struct InsertTimeStampIndexHeader Header;
+    uint64_t RecordCount;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static bool OpenIndex(struct IndexFile *Index,const char *Filename);
+static bool ReadRec(struct IndexFile *Index,uint64_t RecNum,
+        struct InsertTimeStampIndexRec *Rec);
+static uint64_t FindFirstAtOrAfter(struct IndexFile *Index,uint64_t Target,
+        bool UseMono);
+static bool ParseTime(const char *Str,bool Relative,
+        const struct InsertTimeStampIndexHeader *Header,uint64_t *RetNS);
+static void PrintWallTime(uint64_t WallNS);
+static void PrintUsage(void);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    main
+ *
+ * SYNOPSIS:
+ *    int main(int argc,char *argv[]);
+ *
+ * PARAMETERS:
+ *    argc [I] -- The number of args
+ *    argv [I] -- The args
+ *
+ * FUNCTION:
+ *    Main entry point.
+ *
+ * RETURNS:
+ *    0 -- A range was found
+ *    1 -- Nothing in the range
+ *    2 -- There was an error
+ ******************************************************************************/
+int main(int argc,char *argv[])
+{
+    struct IndexFile Index;
+    struct InsertTimeStampIndexRec FirstRec;
+    struct InsertTimeStampIndexRec EndRec;
+    struct InsertTimeStampIndexRec LastRec;
+    const char *Args[3];
+    int ArgCount;
+    bool Relative;
+    bool Quiet;
+    uint64_t StartNS;
+    uint64_t EndNS;
+    uint64_t StartNS2Find;
+    uint64_t EndNS2Find;
+    uint64_t First;
+    uint64_t End;
+    int r;
+
+    Relative=false;
+    Quiet=false;
+    ArgCount=0;
+    for(r=1;r<argc;r++)
+    {
+        if(strcmp(argv[r],"-r")==0)
+            Relative=true;
+        else if(strcmp(argv[r],"-q")==0)
+            Quiet=true;
+        else if(ArgCount<3)
+            Args[ArgCount++]=argv[r];
+        else
+            ArgCount++;
+    }
+    if(ArgCount<2 || ArgCount>3)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    if(!OpenIndex(&Index,Args[0]))
+        return 2;
+
+    if(!ParseTime(Args[1],Relative,&Index.Header,&StartNS))
+    {
+        fprintf(stderr,"Bad start time \"%s\"\n",Args[1]);
+        return 2;
+    }
+    EndNS=UINT64_MAX;
+    if(ArgCount>2 && !ParseTime(Args[2],Relative,&Index.Header,&EndNS))
+    {
+        fprintf(stderr,"Bad end time \"%s\"\n",Args[2]);
+        return 2;
+    }
+
+    if(Relative)
+    {
+        StartNS2Find=Index.Header.ConnectMonoNS+StartNS;
+        EndNS2Find=EndNS==UINT64_MAX?UINT64_MAX:
+                Index.Header.ConnectMonoNS+EndNS;
+    }
+    else
+    {
+        StartNS2Find=StartNS;
+        EndNS2Find=EndNS;
+    }
+
+    First=FindFirstAtOrAfter(&Index,StartNS2Find,Relative);
+    End=FindFirstAtOrAfter(&Index,EndNS2Find,Relative);
+
+    if(First>=End || !ReadRec(&Index,First,&FirstRec) ||
+            !ReadRec(&Index,End-1,&LastRec))
+    {
+        if(!Quiet)
+            printf("No lines in that time range\n");
+        fclose(Index.fh);
+        return 1;
+    }
+
+    if(End<Index.RecordCount)
+    {
+        if(!ReadRec(&Index,End,&EndRec))
+            End=Index.RecordCount;
+    }
+
+    if(Quiet)
+    {
+        if(End<Index.RecordCount)
+        {
+            printf("%llu %llu\n",(unsigned long long)FirstRec.ByteOffset,
+                    (unsigned long long)EndRec.ByteOffset);
+        }
+        else
+        {
+            printf("%llu EOF\n",(unsigned long long)FirstRec.ByteOffset);
+        }
+    }
+    else
+    {
+        printf("Lines: %llu - %llu (%llu lines)\n",
+                (unsigned long long)FirstRec.LineNum,
+                (unsigned long long)LastRec.LineNum,
+                (unsigned long long)(LastRec.LineNum-FirstRec.LineNum+1));
+        if(End<Index.RecordCount)
+        {
+            printf("Bytes: %llu - %llu (%llu bytes)\n",
+                    (unsigned long long)FirstRec.ByteOffset,
+                    (unsigned long long)EndRec.ByteOffset,
+                    (unsigned long long)(EndRec.ByteOffset-
+                    FirstRec.ByteOffset));
+        }
+        else
+        {
+            printf("Bytes: %llu - EOF\n",
+                    (unsigned long long)FirstRec.ByteOffset);
+        }
+        printf("First: ");
+        PrintWallTime(FirstRec.WallNS);
+        printf(" (+%.6f)\n",(double)(FirstRec.MonoNS-
+                Index.Header.ConnectMonoNS)/1000000000.0);
+        printf("Last:  ");
+        PrintWallTime(LastRec.WallNS);
+        printf(" (+%.6f)\n",(double)(LastRec.MonoNS-
+                Index.Header.ConnectMonoNS)/1000000000.0);
+    }
+
+    fclose(Index.fh);
+    return 0;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    OpenIndex
+ *
+ * SYNOPSIS:
+ *    static bool OpenIndex(struct IndexFile *Index,const char *Filename);
+ *
+ * PARAMETERS:
+ *    Index [O] -- The index to fill in
+ *    Filename [I] -- The file to open
+ *
+ * FUNCTION:
+ *    This function opens an index file and checks the header.  If the file
+ *    wasn't closed (the record count is 0) the number of records is worked
+ *    out from the size of the file (skipping the unused records on the end).
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- There was an error (it has been printed)
+ ******************************************************************************/
+static bool OpenIndex(struct IndexFile *Index,const char *Filename)
+{
+    struct InsertTimeStampIndexRec Rec;
+    int64_t FileSize;
+    uint64_t Low;
+    uint64_t High;
+    uint64_t Mid;
+
+    Index->fh=fopen(Filename,"rb");
+    if(Index->fh==NULL)
+    {
+        fprintf(stderr,"Failed to open \"%s\"\n",Filename);
+        return false;
+    }
+
+    if(fread(&Index->Header,sizeof(Index->Header),1,Index->fh)!=1 ||
+            memcmp(Index->Header.Magic,ITSINDEX_MAGIC,
+            sizeof(Index->Header.Magic))!=0)
+    {
+        fprintf(stderr,"\"%s\" is not a timestamp index file\n",Filename);
+        fclose(Index->fh);
+        return false;
+    }
+    if(Index->Header.Version!=ITSINDEX_VERSION ||
+            Index->Header.RecordSize!=sizeof(struct InsertTimeStampIndexRec))
+    {
+        fprintf(stderr,"\"%s\" is an unsupported version\n",Filename);
+        fclose(Index->fh);
+        return false;
+    }
+
+    Index->RecordCount=Index->Header.RecordCount;
+    if(Index->RecordCount==0)
+    {
+        /* The file wasn't closed, the records are all at the start and
+           the rest of the file is 0's */
+#ifdef _WIN32
+        _fseeki64(Index->fh,0,SEEK_END);
+        FileSize=_ftelli64(Index->fh);
+#else
+        fseeko(Index->fh,0,SEEK_END);
+        FileSize=ftello(Index->fh);
+#endif
+        if(FileSize<ITSINDEX_HEADER_SIZE)
+            FileSize=ITSINDEX_HEADER_SIZE;
+        Index->RecordCount=(FileSize-ITSINDEX_HEADER_SIZE)/sizeof(Rec);
+
+        Low=0;
+        High=Index->RecordCount;
+        while(Low<High)
+        {
+            Mid=Low+(High-Low)/2;
+            if(ReadRec(Index,Mid,&Rec) && Rec.LineNum!=0)
+                Low=Mid+1;
+            else
+                High=Mid;
+        }
+        Index->RecordCount=Low;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ReadRec
+ *
+ * SYNOPSIS:
+ *    static bool ReadRec(struct IndexFile *Index,uint64_t RecNum,
+ *          struct InsertTimeStampIndexRec *Rec);
+ *
+ * PARAMETERS:
+ *    Index [I] -- The index to read from
+ *    RecNum [I] -- The record to read
+ *    Rec [O] -- The record
+ *
+ * FUNCTION:
+ *    This function reads one record from the index file.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- The record could not be read
+ ******************************************************************************/
+static bool ReadRec(struct IndexFile *Index,uint64_t RecNum,
+        struct InsertTimeStampIndexRec *Rec)
+{
+    int64_t Offset;
+
+    Offset=ITSINDEX_HEADER_SIZE+RecNum*sizeof(*Rec);
+#ifdef _WIN32
+    if(_fseeki64(Index->fh,Offset,SEEK_SET)!=0)
+        return false;
+#else
+    if(fseeko(Index->fh,Offset,SEEK_SET)!=0)
+        return false;
+#endif
+    return fread(Rec,sizeof(*Rec),1,Index->fh)==1;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    FindFirstAtOrAfter
+ *
+ * SYNOPSIS:
+ *    static uint64_t FindFirstAtOrAfter(struct IndexFile *Index,
+ *          uint64_t Target,bool UseMono);
+ *
+ * PARAMETERS:
+ *    Index [I] -- The index to search
+ *    Target [I] -- The time to look for (in ns)
+ *    UseMono [I] -- Search the monotonic times instead of the wall clock
+ *
+ * FUNCTION:
+ *    This function binary searches the index for the first record that
+ *    is at or after a time.
+ *
+ *    The wall clock search expects the clock didn't go backwards during
+ *    the capture.
+ *
+ * RETURNS:
+ *    The record number or the number of records if there isn't one.
+ ******************************************************************************/
+static uint64_t FindFirstAtOrAfter(struct IndexFile *Index,uint64_t Target,
+        bool UseMono)
+{
+    struct InsertTimeStampIndexRec Rec;
+    uint64_t Low;
+    uint64_t High;
+    uint64_t Mid;
+    uint64_t Value;
+
+    Low=0;
+    High=Index->RecordCount;
+    while(Low<High)
+    {
+        Mid=Low+(High-Low)/2;
+        if(!ReadRec(Index,Mid,&Rec))
+        {
+            High=Mid;
+            continue;
+        }
+        Value=UseMono?Rec.MonoNS:Rec.WallNS;
+        if(Value<Target)
+            Low=Mid+1;
+        else
+            High=Mid;
+    }
+    return Low;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    ParseTime
+ *
+ * SYNOPSIS:
+ *    static bool ParseTime(const char *Str,bool Relative,
+ *          const struct InsertTimeStampIndexHeader *Header,uint64_t *RetNS);
+ *
+ * PARAMETERS:
+ *    Str [I] -- The time to parse
+ *    Relative [I] -- Is this seconds since the connect
+ *    Header [I] -- The index header (for the date of the connect)
+ *    RetNS [O] -- The time in ns (since the epoch or since the connect)
+ *
+ * FUNCTION:
+ *    This function converts a time from the command line.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- The time could not be parsed
+ ******************************************************************************/
+static bool ParseTime(const char *Str,bool Relative,
+        const struct InsertTimeStampIndexHeader *Header,uint64_t *RetNS)
+{
+    struct tm TM;
+    time_t Connect;
+    time_t Sec;
+    double Frac;
+    char *End;
+    int Fields;
+    int Year;
+    int Mon;
+    int Day;
+    int Hour;
+    int Min;
+    int Chars;
+
+    if(Relative || *Str=='@')
+    {
+        if(*Str=='@')
+            Str++;
+        Frac=strtod(Str,&End);
+        if(End==Str || *End!=0 || Frac<0)
+            return false;
+        *RetNS=(uint64_t)(Frac*1000000000.0+0.5);
+        return true;
+    }
+
+    Chars=0;
+    Fields=sscanf(Str,"%d-%d-%d %d:%d:%n",&Year,&Mon,&Day,&Hour,&Min,&Chars);
+    if(Fields!=5 || Chars==0)
+    {
+        /* Just a time, use the day of the connect */
+        Chars=0;
+        if(sscanf(Str,"%d:%d:%n",&Hour,&Min,&Chars)!=2 || Chars==0)
+            return false;
+
+        Connect=Header->ConnectWallNS/1000000000;
+        TM=*localtime(&Connect);
+        Year=TM.tm_year+1900;
+        Mon=TM.tm_mon+1;
+        Day=TM.tm_mday;
+    }
+    Frac=strtod(Str+Chars,&End);
+    if(End==Str+Chars || *End!=0)
+        return false;
+
+    memset(&TM,0,sizeof(TM));
+    TM.tm_year=Year-1900;
+    TM.tm_mon=Mon-1;
+    TM.tm_mday=Day;
+    TM.tm_hour=Hour;
+    TM.tm_min=Min;
+    TM.tm_sec=(int)Frac;
+    TM.tm_isdst=-1;
+    Sec=mktime(&TM);
+    if(Sec==(time_t)-1)
+        return false;
+
+    *RetNS=(uint64_t)Sec*1000000000ULL+
+            (uint64_t)((Frac-(int)Frac)*1000000000.0+0.5);
+    return true;
+}
+
+static void PrintWallTime(uint64_t WallNS)
+{
+    char buff[100];
+    time_t Sec;
+
+    Sec=WallNS/1000000000;
+    strftime(buff,sizeof(buff),"%Y-%m-%d %H:%M:%S",localtime(&Sec));
+    printf("%s.%06u",buff,(unsigned)(WallNS%1000000000/1000));
+}
+
+static void PrintUsage(void)
+{
+    printf("USAGE:\n"
+           "   ITSIndexTool [-r] [-q] IndexFile Start [End]\n"
+           "WHERE:\n"
+           "   IndexFile -- The index written by the InsertTimeStamp plugin\n"
+           "   Start -- The start of the time range\n"
+           "   End -- The end of the time range (default is the end of the\n"
+           "          index)\n"
+           "   -r -- Start / End are seconds since the connect\n"
+           "   -q -- Only print the start and end byte offsets\n"
+           "TIMES:\n"
+           "   \"YYYY-MM-DD HH:MM:SS[.frac]\" -- Local time\n"
+           "   \"HH:MM:SS[.frac]\" -- Local time on the day of the connect\n"
+           "   \"@Seconds[.frac]\" -- Seconds since the Unix epoch\n");
+}
@@ -31,6 +31,8 @@
 
 /*** HEADER FILES TO INCLUDE  ***/
 #include "InsertTimeStamp.h"
+#include "InsertTimeStamp_Format.h"
+#include "InsertTimeStamp_Index.h"
 #include "PluginSDK/Plugin.h"
 #include <string.h>
 #include <time.h>
@@ -47,8 +49,15 @@ using namespace std;
 /*** TYPE DEFINITIONS         ***/
 struct InsertTimeStampData
 {
-    string DateFormat;
+    struct InsertTimeStampFormat Format;
     bool SeenNewLine;
+    struct InsertTimeStampTimes ConnectTime;
+
+    /* Timestamp index */
+    t_InsertTimeStampIndexType *Index;
+    string IndexFilename;
+    uint64_t LineCount;
+    uint64_t ByteCount;
 
     uint32_t FGColor;
     uint32_t BGColor;
@@ -62,6 +71,8 @@ struct InsertTimeStamp_SettingsWidgets
 
     /* Timestamp widgets */
     struct PI_TextInput *DateFormatInput;
+    struct PI_Checkbox *IndexEnabled;
+    struct PI_TextInput *IndexFilenameInput;
     struct PI_TextBox *ExplainInput;
 
     /* Styling widgets */
@@ -78,6 +89,7 @@ struct InsertTimeStamp_SettingsWidgets
 /*** FUNCTION PROTOTYPES      ***/
 static const struct DataProcessorInfo *InsertTimeStamp_GetProcessorInfo(unsigned int *SizeOfInfo);
 static void InsertTimeStamp_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHandle,const uint8_t RawByte,uint8_t *ProcessedChar,int *CharLen,PG_BOOL *Consumed);
+static uint32_t InsertTimeStamp_ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed);
 static t_DataProSettingsWidgetsType *InsertTimeStamp_AllocSettingsWidgets(t_WidgetSysHandle *WidgetHandle,t_PIKVList *Settings);
 static void InsertTimeStamp_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData);
 static void InsertTimeStamp_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivData,t_PIKVList *Settings);
@@ -85,6 +97,7 @@ static void InsertTimeStamp_ApplySettings(t_DataProcessorHandleType *ConDataHand
         t_PIKVList *Settings);
 static t_DataProcessorHandleType *InsertTimeStamp_AllocateData(void);
 static void InsertTimeStamp_FreeData(t_DataProcessorHandleType *DataHandle);
+static void InsertTimeStamp_InsertStamp(struct InsertTimeStampData *Data);
 
 /*** VARIABLE DEFINITIONS     ***/
 struct DataProcessorAPI m_InsertTimeStampCBs=
@@ -101,6 +114,8 @@ struct DataProcessorAPI m_InsertTimeStampCBs=
     InsertTimeStamp_FreeSettingsWidgets,
     InsertTimeStamp_SetSettingsFromWidgets,
     InsertTimeStamp_ApplySettings,
+    /* V4 */
+    InsertTimeStamp_ProcessIncomingTextBlock,       // ProcessIncomingTextBlock
 };
 struct DataProcessorInfo m_InsertTimeStamp_Info=
 {
@@ -114,6 +129,7 @@ struct DataProcessorInfo m_InsertTimeStamp_Info=
 static const struct DPS_API *m_ITS_DPS;
 static const struct PI_UIAPI *m_ITS_UIAPI;
 static const struct PI_SystemAPI *m_ITS_SysAPI;
+static bool m_ITS_HasInsertStyledString;
 
 /*******************************************************************************
  * NAME:
@@ -158,6 +174,14 @@ extern "C"
         m_ITS_DPS=SysAPI->GetAPI_DataProcessors();
         m_ITS_UIAPI=m_ITS_DPS->GetAPI_UI();
 
+        /* InsertStyledString() isn't in a released DPS API, only look at it
+           if the host says it has it (other hosts' DPS struct stops before
+           it) */
+        m_ITS_HasInsertStyledString=
+                (SysAPI->GetExperimentalID()==
+                DPS_API_EXPERIMENTAL_BLOCK_CALLS &&
+                m_ITS_DPS->InsertStyledString!=NULL);
+
         /* If we are have the correct experimental API */
         if(SysAPI->GetExperimentalID()>0 &&
                 SysAPI->GetExperimentalID()<1)
@@ -202,7 +226,14 @@ static t_DataProcessorHandleType *InsertTimeStamp_AllocateData(void)
         Data=new struct InsertTimeStampData;
 
         Data->SeenNewLine=false;
-        Data->DateFormat="%c:";
+        Data->Index=NULL;
+        Data->LineCount=0;
+        Data->ByteCount=0;
+        InsertTimeStamp_CompileFormat(&Data->Format,"%c:");
+
+        /* This is where the since connect time counts from */
+        InsertTimeStamp_GetTimes(&Data->ConnectTime);
+        InsertTimeStamp_ResetFormatClock(&Data->Format,&Data->ConnectTime);
     }
     catch(...)
     {
@@ -237,6 +268,9 @@ static void InsertTimeStamp_FreeData(t_DataProcessorHandleType *DataHandle)
 {
     struct InsertTimeStampData *Data=(struct InsertTimeStampData *)DataHandle;
 
+    if(Data->Index!=NULL)
+        InsertTimeStamp_IndexClose(Data->Index);
+
     delete Data;
 }
 
@@ -335,21 +369,129 @@ void InsertTimeStamp_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHand
         PG_BOOL *Consumed)
 {
     struct InsertTimeStampData *Data=(struct InsertTimeStampData *)DataHandle;
-    char buff[100];
-    time_t current_time;
-    struct tm *time_info;
+
+    if(Data->SeenNewLine && RawByte!='\r')
+    {
+        Data->SeenNewLine=false;
+        InsertTimeStamp_InsertStamp(Data);
+    }
+
+    Data->ByteCount++;
+    if(RawByte=='\n')
+    {
+        /* We are at the end of the line, note that we should output a new
+           timestamp , see if it matches anything */
+        Data->SeenNewLine=true;
+        Data->LineCount++;
+    }
+}
+
+/*******************************************************************************
+ *  NAME:
+ *    InsertTimeStamp_ProcessIncomingTextBlock
+ *
+ *  SYNOPSIS:
+ *    uint32_t InsertTimeStamp_ProcessIncomingTextBlock(
+ *          t_DataProcessorHandleType *DataHandle,const uint8_t *Data,
+ *          uint32_t Len,PG_BOOL *Consumed);
+ *
+ *  PARAMETERS:
+ *    DataHandle [I] -- The data handle to work on
+ *    Data [I] -- The block of bytes that came in
+ *    Len [I] -- The number of bytes in 'Data'
+ *    Consumed [I/O] -- This tells the system (and other filters) if the
+ *                      bytes have been used up (we never do)
+ *
+ *  FUNCTION:
+ *    This is the block version of InsertTimeStamp_ProcessIncomingTextByte().
+ *    We take everything up to and including the next '\n' in one go.  The
+ *    timestamp goes in when we are called with the first byte of the next
+ *    line (so a '\r' after the '\n' is still taken on it's own first).
+ *
+ *  RETURNS:
+ *    The number of bytes from the start of 'Data' we handled.
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_ProcessIncomingTextByte()
+ ******************************************************************************/
+uint32_t InsertTimeStamp_ProcessIncomingTextBlock(t_DataProcessorHandleType *DataHandle,
+        const uint8_t *Data,uint32_t Len,PG_BOOL *Consumed)
+{
+    struct InsertTimeStampData *TSData=(struct InsertTimeStampData *)DataHandle;
+    const uint8_t *Pos;
+    uint32_t Count;
+
+    if(TSData->SeenNewLine)
+    {
+        if(Data[0]=='\r')
+        {
+            TSData->ByteCount++;
+            return 1;
+        }
+        TSData->SeenNewLine=false;
+        InsertTimeStamp_InsertStamp(TSData);
+    }
+
+    Pos=(const uint8_t *)memchr(Data,'\n',Len);
+    if(Pos==NULL)
+    {
+        Count=Len;
+    }
+    else
+    {
+        Count=Pos-Data+1;
+        TSData->SeenNewLine=true;
+        TSData->LineCount++;
+    }
+    TSData->ByteCount+=Count;
+
+    return Count;
+}
+
+/*******************************************************************************
+ *  NAME:
+ *    InsertTimeStamp_InsertStamp
+ *
+ *  SYNOPSIS:
+ *    static void InsertTimeStamp_InsertStamp(struct InsertTimeStampData *Data);
+ *
+ *  PARAMETERS:
+ *    Data [I] -- The data for this connection
+ *
+ *  FUNCTION:
+ *    This function renders the timestamp for a new line, adds it to the
+ *    index (if there is one), and inserts it on the screen with our styling.
+ *
+ *  RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_RenderFormat(), InsertTimeStamp_IndexAppend()
+ ******************************************************************************/
+static void InsertTimeStamp_InsertStamp(struct InsertTimeStampData *Data)
+{
+    struct InsertTimeStampTimes Now;
     uint32_t SavedFGColor;
     uint32_t SavedBGColor;
     uint32_t SavedULineColor;
     uint32_t SavedAttribs;
 
-    if(Data->SeenNewLine && RawByte!='\r')
+    InsertTimeStamp_GetTimes(&Now);
+    InsertTimeStamp_RenderFormat(&Data->Format,&Now);
+    if(Data->Index!=NULL)
+    {
+        InsertTimeStamp_IndexAppend(Data->Index,Data->LineCount+1,
+                Data->ByteCount,&Now);
+    }
+    if(Data->Format.OutLen>0 && m_ITS_HasInsertStyledString)
+    {
+        /* One call, the current styling is left alone */
+        m_ITS_DPS->InsertStyledString((uint8_t *)Data->Format.Out,
+                Data->Format.OutLen,Data->FGColor,Data->BGColor,
+                Data->FGColor,Data->Attribs);
+    }
+    else if(Data->Format.OutLen>0)
     {
-        Data->SeenNewLine=false;
-        time(&current_time);
-        time_info = localtime(&current_time);
-        strftime(buff,sizeof(buff)-1,Data->DateFormat.c_str(),time_info);
-
         /* Save the current styling */
         SavedFGColor=m_ITS_DPS->GetFGColor();
         SavedBGColor=m_ITS_DPS->GetBGColor();
@@ -362,7 +504,8 @@ void InsertTimeStamp_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHand
         m_ITS_DPS->SetULineColor(Data->FGColor);
         m_ITS_DPS->SetAttribs(Data->Attribs);
 
-        m_ITS_DPS->InsertString((uint8_t *)buff,strlen(buff));
+        m_ITS_DPS->InsertString((uint8_t *)Data->Format.Out,
+                Data->Format.OutLen);
 
         /* Restore the styling */
         m_ITS_DPS->SetFGColor(SavedFGColor);
@@ -370,13 +513,6 @@ void InsertTimeStamp_ProcessIncomingTextByte(t_DataProcessorHandleType *DataHand
         m_ITS_DPS->SetULineColor(SavedULineColor);
         m_ITS_DPS->SetAttribs(SavedAttribs);
     }
-
-    if(RawByte=='\n')
-    {
-        /* We are at the end of the line, note that we should output a new
-           timestamp , see if it matches anything */
-        Data->SeenNewLine=true;
-    }
 }
 
 /*******************************************************************************
@@ -426,6 +562,8 @@ t_DataProSettingsWidgetsType *InsertTimeStamp_AllocSettingsWidgets(t_WidgetSysHa
 
         /* Zero everything */
         WData->DateFormatInput=NULL;
+        WData->IndexEnabled=NULL;
+        WData->IndexFilenameInput=NULL;
         WData->ExplainInput=NULL;
         WData->TimestampTabHandle=NULL;
         WData->StyleTabHandle=NULL;
@@ -453,6 +591,17 @@ t_DataProSettingsWidgetsType *InsertTimeStamp_AllocSettingsWidgets(t_WidgetSysHa
         if(WData->DateFormatInput==NULL)
             throw(0);
 
+        WData->IndexEnabled=m_ITS_UIAPI->AddCheckbox(
+                WData->TimestampTabHandle,"Write timestamp index file",
+                NULL,NULL);
+        if(WData->IndexEnabled==NULL)
+            throw(0);
+
+        WData->IndexFilenameInput=m_ITS_UIAPI->AddTextInput(
+                WData->TimestampTabHandle,"Index Filename",NULL,NULL);
+        if(WData->IndexFilenameInput==NULL)
+            throw(0);
+
         WData->ExplainInput=m_ITS_UIAPI->AddTextBox(WData->TimestampTabHandle,
                 "Help",
                 "The date format uses the same format as strftime():\n\n"
@@ -481,7 +630,18 @@ t_DataProSettingsWidgetsType *InsertTimeStamp_AllocSettingsWidgets(t_WidgetSysHa
                 "%W -- Week number (00-53)\n"
                 "%y -- Year (00-99)\n"
                 "%Y -- Year (0000-9999)\n"
-                "%z -- +hhmm or -hhmm numeric timezone\n");
+                "%z -- +hhmm or -hhmm numeric timezone\n"
+                "\n"
+                "Extra (not in strftime()):\n\n"
+                "%L -- Milliseconds (000-999)\n"
+                "%f -- Microseconds (000000-999999)\n"
+                "%J -- Time since connect in seconds (S.uuuuuu)\n"
+                "%K -- Time since the previous line in seconds (S.uuuuuu)\n"
+                "\n"
+                "The timestamp index file has a record for each timestamped\n"
+                "line (line number, byte offset, monotonic and wall clock\n"
+                "time).  Use the ITSIndexTool to find the lines / bytes for\n"
+                "a time range.\n");
         if(WData->ExplainInput==NULL)
             throw(0);
 
@@ -533,6 +693,20 @@ t_DataProSettingsWidgetsType *InsertTimeStamp_AllocSettingsWidgets(t_WidgetSysHa
         m_ITS_UIAPI->SetTextInputText(WData->TimestampTabHandle,
                 WData->DateFormatInput->Ctrl,Str);
 
+        Str=m_ITS_SysAPI->KVGetItem(Settings,"IndexEnabled");
+        if(Str!=NULL)
+            Num=strtol(Str,NULL,10);
+        else
+            Num=0;
+        m_ITS_UIAPI->SetCheckboxChecked(WData->TimestampTabHandle,
+                WData->IndexEnabled->Ctrl,Num?true:false);
+
+        Str=m_ITS_SysAPI->KVGetItem(Settings,"IndexFilename");
+        if(Str==NULL)
+            Str="";
+        m_ITS_UIAPI->SetTextInputText(WData->TimestampTabHandle,
+                WData->IndexFilenameInput->Ctrl,Str);
+
         Str=m_ITS_SysAPI->KVGetItem(Settings,"FGColor");
         if(Str!=NULL)
             Num=strtol(Str,NULL,16);
@@ -658,6 +832,14 @@ void InsertTimeStamp_FreeSettingsWidgets(t_DataProSettingsWidgetsType *PrivData)
                 WData->DateFormatInput);
     }
 
+    if(WData->IndexFilenameInput!=NULL)
+    {
+        m_ITS_UIAPI->FreeTextInput(WData->TimestampTabHandle,
+                WData->IndexFilenameInput);
+    }
+    if(WData->IndexEnabled!=NULL)
+        m_ITS_UIAPI->FreeCheckbox(WData->TimestampTabHandle,WData->IndexEnabled);
+
     if(WData->ExplainInput!=NULL)
         m_ITS_UIAPI->FreeTextBox(WData->TimestampTabHandle,WData->ExplainInput);
 
@@ -697,6 +879,15 @@ void InsertTimeStamp_SetSettingsFromWidgets(t_DataProSettingsWidgetsType *PrivDa
             WData->DateFormatInput->Ctrl);
     m_ITS_SysAPI->KVAddItem(Settings,"DateFormat",Str.c_str());
 
+    Value=m_ITS_UIAPI->IsCheckboxChecked(WData->TimestampTabHandle,
+            WData->IndexEnabled->Ctrl);
+    sprintf(buff,"%d",Value);
+    m_ITS_SysAPI->KVAddItem(Settings,"IndexEnabled",buff);
+
+    Str=m_ITS_UIAPI->GetTextInputText(WData->TimestampTabHandle,
+            WData->IndexFilenameInput->Ctrl);
+    m_ITS_SysAPI->KVAddItem(Settings,"IndexFilename",Str.c_str());
+
     Value=m_ITS_UIAPI->GetColorPickValue(WData->StyleTabHandle,
             WData->FgColor->Ctrl);
     sprintf(buff,"%06X",Value);
@@ -768,11 +959,32 @@ static void InsertTimeStamp_ApplySettings(t_DataProcessorHandleType *DataHandle,
     struct InsertTimeStampData *Data=(struct InsertTimeStampData *)DataHandle;
     const char *Str;
     uint32_t Num;
+    bool Enabled;
 
     Str=m_ITS_SysAPI->KVGetItem(Settings,"DateFormat");
     if(Str==NULL)
         Str="%c:";
-    Data->DateFormat=Str;
+    InsertTimeStamp_CompileFormat(&Data->Format,Str);
+
+    /* Timestamp index */
+    Str=m_ITS_SysAPI->KVGetItem(Settings,"IndexEnabled");
+    Enabled=(Str!=NULL && atoi(Str));
+
+    Str=m_ITS_SysAPI->KVGetItem(Settings,"IndexFilename");
+    if(Str==NULL || !Enabled)
+        Str="";
+
+    if(Data->Index!=NULL && Data->IndexFilename!=Str)
+    {
+        InsertTimeStamp_IndexClose(Data->Index);
+        Data->Index=NULL;
+    }
+    if(Data->Index==NULL && *Str!=0)
+    {
+        /* If we can't make the file we just don't write an index */
+        Data->Index=InsertTimeStamp_IndexOpen(Str,&Data->ConnectTime);
+    }
+    Data->IndexFilename=Str;
 
     /* Styles */
     Data->Attribs=0;
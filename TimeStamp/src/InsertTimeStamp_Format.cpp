@@ -0,0 +1,711 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_Format.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the timestamp formatter in it.  The format string (the
+ *    same format as strftime()) is compiled into a list of segments when
+ *    the settings are applied.  When a timestamp is needed:
+ *       - If the second hasn't changed the last string is used as is.
+ *       - If the second changed (but not the minute) only the segments that
+ *         use the seconds are redone (no localtime() call).
+ *       - Otherwise localtime() is called (once a minute) and everything is
+ *         redone.
+ *
+ *    The numeric fields are formatted by hand, anything that depends on the
+ *    locale (day / month names, %c, etc) is still done with strftime() but
+ *    only for that one conversion and only when it changes.
+ *
+ *    We also add some conversions strftime() doesn't have (for timing
+ *    things):
+ *       %L -- Milliseconds of the wall clock
+ *       %f -- Microseconds of the wall clock
+ *       %J -- Time since connect (monotonic clock)
+ *       %K -- Time since the last line (monotonic clock)
+ *    These are redone for every line.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "InsertTimeStamp_Format.h"
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef _WIN32
+#include <chrono>
+#endif
+
+/*** DEFINES                  ***/
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+
+/*** FUNCTION PROTOTYPES      ***/
+static struct InsertTimeStampFmtSeg *InsertTimeStamp_AddSeg(
+        struct InsertTimeStampFormat *Fmt,e_ITSFmtSegType Type);
+static void InsertTimeStamp_AddLiteral(struct InsertTimeStampFormat *Fmt,
+        const char *Str,unsigned int Len);
+static void InsertTimeStamp_AddStrftime(struct InsertTimeStampFormat *Fmt,
+        const char *Conv,unsigned int Len);
+static void InsertTimeStamp_RenderSeg(struct InsertTimeStampFormat *Fmt,
+        struct InsertTimeStampFmtSeg *Seg,
+        const struct InsertTimeStampTimes *Now);
+static void InsertTimeStamp_LocalTime(time_t Now,struct tm *Result);
+static unsigned int InsertTimeStamp_PutElapsed(char *Dest,
+        const struct timespec *Start,const struct timespec *End);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+static inline unsigned int InsertTimeStamp_Put2(char *Dest,int Value)
+{
+    Dest[0]='0'+Value/10%10;
+    Dest[1]='0'+Value%10;
+    return 2;
+}
+
+static inline unsigned int InsertTimeStamp_Put2Space(char *Dest,int Value)
+{
+    Dest[0]=Value<10?' ':'0'+Value/10%10;
+    Dest[1]='0'+Value%10;
+    return 2;
+}
+
+static inline unsigned int InsertTimeStamp_PutFrac(char *Dest,
+        unsigned int Value,unsigned int Digits)
+{
+    unsigned int r;
+
+    for(r=Digits;r>0;r--)
+    {
+        Dest[r-1]='0'+Value%10;
+        Value/=10;
+    }
+    return Digits;
+}
+
+static unsigned int InsertTimeStamp_PutInt(char *Dest,int64_t Value)
+{
+    char Tmp[21];
+    unsigned int Len;
+    unsigned int r;
+    bool Neg;
+    uint64_t v;
+
+    Neg=Value<0;
+    v=Neg?-(uint64_t)Value:(uint64_t)Value;
+    Len=0;
+    do
+    {
+        Tmp[Len++]='0'+v%10;
+        v/=10;
+    } while(v!=0);
+
+    r=0;
+    if(Neg)
+        Dest[r++]='-';
+    while(Len>0)
+        Dest[r++]=Tmp[--Len];
+    return r;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_CompileFormat
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_CompileFormat(struct InsertTimeStampFormat *Fmt,
+ *          const char *Format);
+ *
+ * PARAMETERS:
+ *    Fmt [O] -- The compiled format to fill in
+ *    Format [I] -- The strftime() style format string
+ *
+ * FUNCTION:
+ *    This function breaks a format string into segments.  Literal text is
+ *    stored as is, the numeric fields become fields we format ourself,
+ *    composite conversions (%F %T %D %R) are expanded, and everything else
+ *    (including any conversion with flags or a width) is left to strftime().
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_RenderFormat()
+ ******************************************************************************/
+void InsertTimeStamp_CompileFormat(struct InsertTimeStampFormat *Fmt,
+        const char *Format)
+{
+    const char *s;
+    const char *Start;
+    char Conv;
+
+    Fmt->SegCount=0;
+    Fmt->HasTimeFields=false;
+    Fmt->HasPerLineFields=false;
+    Fmt->CacheValid=false;
+    Fmt->CachedSecond=0;
+    Fmt->MinuteStart=0;
+    Fmt->OutLen=0;
+    Fmt->Out[0]=0;
+
+    /* Pick up any timezone changes */
+    tzset();
+
+    s=Format;
+    while(*s!=0)
+    {
+        if(*s!='%')
+        {
+            InsertTimeStamp_AddLiteral(Fmt,s,1);
+            s++;
+            continue;
+        }
+
+        /* Skip any flags / width / modifier (glibc extensions) */
+        Start=s++;
+        while(*s!=0 && strchr("_-0^#",*s)!=NULL)
+            s++;
+        while(*s>='0' && *s<='9')
+            s++;
+        if(*s=='E' || *s=='O')
+            s++;
+        if(*s==0)
+        {
+            /* A % on the end, just output it */
+            InsertTimeStamp_AddLiteral(Fmt,Start,s-Start);
+            break;
+        }
+        Conv=*s++;
+
+        /* Our own conversions (we ignore any flags on these) */
+        switch(Conv)
+        {
+            case 'L':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_MilliSec);
+            continue;
+            case 'f':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_MicroSec);
+            continue;
+            case 'J':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_SinceConnect);
+            continue;
+            case 'K':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_SinceLastLine);
+            continue;
+            default:
+            break;
+        }
+
+        if(s-Start>2)
+        {
+            InsertTimeStamp_AddStrftime(Fmt,Start,s-Start);
+            continue;
+        }
+
+        switch(Conv)
+        {
+            case '%':
+                InsertTimeStamp_AddLiteral(Fmt,"%",1);
+            break;
+            case 'n':
+                InsertTimeStamp_AddLiteral(Fmt,"\n",1);
+            break;
+            case 't':
+                InsertTimeStamp_AddLiteral(Fmt,"\t",1);
+            break;
+            case 'Y':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Year);
+            break;
+            case 'y':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Year2);
+            break;
+            case 'C':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Century);
+            break;
+            case 'm':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Month);
+            break;
+            case 'd':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Day);
+            break;
+            case 'e':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_DaySpace);
+            break;
+            case 'j':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_DayOfYear);
+            break;
+            case 'H':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Hour24);
+            break;
+            case 'k':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Hour24Space);
+            break;
+            case 'I':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Hour12);
+            break;
+            case 'l':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Hour12Space);
+            break;
+            case 'M':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Minute);
+            break;
+            case 'S':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Second);
+            break;
+            case 'u':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_WeekDay1);
+            break;
+            case 'w':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_WeekDay0);
+            break;
+            case 's':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Epoch);
+            break;
+            case 'F':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Year);
+                InsertTimeStamp_AddLiteral(Fmt,"-",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Month);
+                InsertTimeStamp_AddLiteral(Fmt,"-",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Day);
+            break;
+            case 'T':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Hour24);
+                InsertTimeStamp_AddLiteral(Fmt,":",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Minute);
+                InsertTimeStamp_AddLiteral(Fmt,":",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Second);
+            break;
+            case 'R':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Hour24);
+                InsertTimeStamp_AddLiteral(Fmt,":",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Minute);
+            break;
+            case 'D':
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Month);
+                InsertTimeStamp_AddLiteral(Fmt,"/",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Day);
+                InsertTimeStamp_AddLiteral(Fmt,"/",1);
+                InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Year2);
+            break;
+            default:
+                InsertTimeStamp_AddStrftime(Fmt,Start,s-Start);
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_ResetFormatClock
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_ResetFormatClock(struct InsertTimeStampFormat *Fmt,
+ *          const struct InsertTimeStampTimes *Now);
+ *
+ * PARAMETERS:
+ *    Fmt [I/O] -- The format to reset
+ *    Now [I] -- The time of the connect
+ *
+ * FUNCTION:
+ *    This function sets the time that the since connect (%J) and since last
+ *    line (%K) conversions count from.  This is not changed by
+ *    InsertTimeStamp_CompileFormat() so the settings can be changed without
+ *    losing the connect time.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_RenderFormat()
+ ******************************************************************************/
+void InsertTimeStamp_ResetFormatClock(struct InsertTimeStampFormat *Fmt,
+        const struct InsertTimeStampTimes *Now)
+{
+    Fmt->ConnectTime=Now->Mono;
+    Fmt->LastLineTime=Now->Mono;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_RenderFormat
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_RenderFormat(struct InsertTimeStampFormat *Fmt,
+ *          const struct InsertTimeStampTimes *Now);
+ *
+ * PARAMETERS:
+ *    Fmt [I/O] -- The compiled format.  The output is left in 'Out' /
+ *                 'OutLen'.
+ *    Now [I] -- The times to render (from InsertTimeStamp_GetTimes())
+ *
+ * FUNCTION:
+ *    This function renders the timestamp for a line.  Only the segments that
+ *    changed since the last call are redone.  This does not allocate any
+ *    memory.
+ *
+ *    This should be called once for each line as it also moves the time the
+ *    since last line (%K) conversion counts from.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_CompileFormat()
+ ******************************************************************************/
+void InsertTimeStamp_RenderFormat(struct InsertTimeStampFormat *Fmt,
+        const struct InsertTimeStampTimes *Now)
+{
+    struct InsertTimeStampFmtSeg *Seg;
+    unsigned int Len;
+    bool FullRedo;
+    bool NewSecond;
+    time_t Sec;
+    int s;
+
+    Sec=Now->Wall.tv_sec;
+    FullRedo=false;
+    NewSecond=false;
+    if(!Fmt->CacheValid || (Fmt->HasTimeFields && Sec!=Fmt->CachedSecond))
+    {
+        NewSecond=true;
+        if(!Fmt->CacheValid || Sec<Fmt->MinuteStart ||
+                Sec>=Fmt->MinuteStart+60)
+        {
+            /* New minute, we need to ask for the local time again (this is
+               where the timezone / DST is taken care of) */
+            InsertTimeStamp_LocalTime(Sec,&Fmt->CachedTM);
+            Fmt->MinuteStart=Sec-Fmt->CachedTM.tm_sec;
+            FullRedo=true;
+        }
+        else
+        {
+            Fmt->CachedTM.tm_sec=Sec-Fmt->MinuteStart;
+        }
+        Fmt->CachedSecond=Sec;
+    }
+
+    if(NewSecond || Fmt->HasPerLineFields)
+    {
+        Fmt->OutLen=0;
+        for(s=0;s<Fmt->SegCount;s++)
+        {
+            Seg=&Fmt->Segs[s];
+            if(Seg->Type!=e_ITSFmtSeg_Literal && (FullRedo || Seg->PerLine ||
+                    (NewSecond && Seg->PerSecond)))
+            {
+                InsertTimeStamp_RenderSeg(Fmt,Seg,Now);
+            }
+
+            Len=Seg->Len;
+            if(Fmt->OutLen+Len>=ITSFORMAT_MAX_OUTPUT)
+                Len=ITSFORMAT_MAX_OUTPUT-1-Fmt->OutLen;
+            memcpy(&Fmt->Out[Fmt->OutLen],Seg->Text,Len);
+            Fmt->OutLen+=Len;
+        }
+        Fmt->Out[Fmt->OutLen]=0;
+        Fmt->CacheValid=true;
+    }
+
+    Fmt->LastLineTime=Now->Mono;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_GetTimes
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_GetTimes(struct InsertTimeStampTimes *Now);
+ *
+ * PARAMETERS:
+ *    Now [O] -- The current wall clock and monotonic times
+ *
+ * FUNCTION:
+ *    This function reads the clocks.  It should be called once per line.
+ *    On Linux this is clock_gettime() which is a vDSO call (no system call).
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+void InsertTimeStamp_GetTimes(struct InsertTimeStampTimes *Now)
+{
+#ifdef _WIN32
+    std::chrono::nanoseconds Mono;
+
+    timespec_get(&Now->Wall,TIME_UTC);
+
+    Mono=std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+    Now->Mono.tv_sec=Mono.count()/1000000000;
+    Now->Mono.tv_nsec=Mono.count()%1000000000;
+#else
+    clock_gettime(CLOCK_REALTIME,&Now->Wall);
+    clock_gettime(CLOCK_MONOTONIC,&Now->Mono);
+#endif
+}
+
+static void InsertTimeStamp_LocalTime(time_t Now,struct tm *Result)
+{
+#ifdef _WIN32
+    localtime_s(Result,&Now);
+#else
+    localtime_r(&Now,Result);
+#endif
+}
+
+static struct InsertTimeStampFmtSeg *InsertTimeStamp_AddSeg(
+        struct InsertTimeStampFormat *Fmt,e_ITSFmtSegType Type)
+{
+    struct InsertTimeStampFmtSeg *Seg;
+
+    if(Fmt->SegCount>=ITSFORMAT_MAX_SEGMENTS)
+        return NULL;
+
+    Seg=&Fmt->Segs[Fmt->SegCount++];
+    Seg->Type=Type;
+    Seg->Len=0;
+    Seg->Conv[0]=0;
+
+    /* The only fields that change every second */
+    Seg->PerSecond=(Type==e_ITSFmtSeg_Second || Type==e_ITSFmtSeg_Epoch);
+
+    /* The sub second fields change every line */
+    Seg->PerLine=(Type==e_ITSFmtSeg_MilliSec || Type==e_ITSFmtSeg_MicroSec ||
+            Type==e_ITSFmtSeg_SinceConnect || Type==e_ITSFmtSeg_SinceLastLine);
+    if(Seg->PerLine)
+        Fmt->HasPerLineFields=true;
+
+    if(Type!=e_ITSFmtSeg_Literal)
+        Fmt->HasTimeFields=true;
+
+    return Seg;
+}
+
+static void InsertTimeStamp_AddLiteral(struct InsertTimeStampFormat *Fmt,
+        const char *Str,unsigned int Len)
+{
+    struct InsertTimeStampFmtSeg *Seg;
+    unsigned int Bytes;
+
+    while(Len>0)
+    {
+        /* Add on to the last literal if we can */
+        Seg=NULL;
+        if(Fmt->SegCount>0)
+            Seg=&Fmt->Segs[Fmt->SegCount-1];
+        if(Seg==NULL || Seg->Type!=e_ITSFmtSeg_Literal ||
+                Seg->Len>=ITSFORMAT_MAX_SEG_TEXT)
+        {
+            Seg=InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Literal);
+            if(Seg==NULL)
+                return;
+        }
+
+        Bytes=ITSFORMAT_MAX_SEG_TEXT-Seg->Len;
+        if(Bytes>Len)
+            Bytes=Len;
+        memcpy(&Seg->Text[Seg->Len],Str,Bytes);
+        Seg->Len+=Bytes;
+        Str+=Bytes;
+        Len-=Bytes;
+    }
+}
+
+static void InsertTimeStamp_AddStrftime(struct InsertTimeStampFormat *Fmt,
+        const char *Conv,unsigned int Len)
+{
+    struct InsertTimeStampFmtSeg *Seg;
+
+    if(Len>=sizeof(Seg->Conv))
+        return;
+
+    Seg=InsertTimeStamp_AddSeg(Fmt,e_ITSFmtSeg_Strftime);
+    if(Seg==NULL)
+        return;
+
+    memcpy(Seg->Conv,Conv,Len);
+    Seg->Conv[Len]=0;
+
+    /* Anything that might have the seconds in it needs doing every second */
+    Seg->PerSecond=strchr("cSsTXr+",Conv[Len-1])!=NULL;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_RenderSeg
+ *
+ * SYNOPSIS:
+ *    static void InsertTimeStamp_RenderSeg(struct InsertTimeStampFormat *Fmt,
+ *          struct InsertTimeStampFmtSeg *Seg,
+ *          const struct InsertTimeStampTimes *Now);
+ *
+ * PARAMETERS:
+ *    Fmt [I] -- The format this segment is part of ('CachedTM' must be
+ *               up to date)
+ *    Seg [I/O] -- The segment to render
+ *    Now [I] -- The times we are rendering
+ *
+ * FUNCTION:
+ *    This function renders one segment into its 'Text' buffer.
+ *
+ * RETURNS:
+ *    NONE
+ ******************************************************************************/
+static void InsertTimeStamp_RenderSeg(struct InsertTimeStampFormat *Fmt,
+        struct InsertTimeStampFmtSeg *Seg,
+        const struct InsertTimeStampTimes *Now)
+{
+    const struct tm *TM=&Fmt->CachedTM;
+    int Value;
+
+    switch(Seg->Type)
+    {
+        case e_ITSFmtSeg_Year:
+            Seg->Len=InsertTimeStamp_PutInt(Seg->Text,TM->tm_year+1900);
+        break;
+        case e_ITSFmtSeg_Year2:
+            Value=(TM->tm_year+1900)%100;
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,Value<0?-Value:Value);
+        break;
+        case e_ITSFmtSeg_Century:
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,(TM->tm_year+1900)/100);
+        break;
+        case e_ITSFmtSeg_Month:
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,TM->tm_mon+1);
+        break;
+        case e_ITSFmtSeg_Day:
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,TM->tm_mday);
+        break;
+        case e_ITSFmtSeg_DaySpace:
+            Seg->Len=InsertTimeStamp_Put2Space(Seg->Text,TM->tm_mday);
+        break;
+        case e_ITSFmtSeg_DayOfYear:
+            Value=TM->tm_yday+1;
+            Seg->Text[0]='0'+Value/100;
+            Seg->Len=1+InsertTimeStamp_Put2(&Seg->Text[1],Value%100);
+        break;
+        case e_ITSFmtSeg_Hour24:
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,TM->tm_hour);
+        break;
+        case e_ITSFmtSeg_Hour24Space:
+            Seg->Len=InsertTimeStamp_Put2Space(Seg->Text,TM->tm_hour);
+        break;
+        case e_ITSFmtSeg_Hour12:
+        case e_ITSFmtSeg_Hour12Space:
+            Value=TM->tm_hour%12;
+            if(Value==0)
+                Value=12;
+            if(Seg->Type==e_ITSFmtSeg_Hour12)
+                Seg->Len=InsertTimeStamp_Put2(Seg->Text,Value);
+            else
+                Seg->Len=InsertTimeStamp_Put2Space(Seg->Text,Value);
+        break;
+        case e_ITSFmtSeg_Minute:
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,TM->tm_min);
+        break;
+        case e_ITSFmtSeg_Second:
+            Seg->Len=InsertTimeStamp_Put2(Seg->Text,TM->tm_sec);
+        break;
+        case e_ITSFmtSeg_WeekDay1:
+            Seg->Text[0]='0'+(TM->tm_wday==0?7:TM->tm_wday);
+            Seg->Len=1;
+        break;
+        case e_ITSFmtSeg_WeekDay0:
+            Seg->Text[0]='0'+TM->tm_wday;
+            Seg->Len=1;
+        break;
+        case e_ITSFmtSeg_Epoch:
+            Seg->Len=InsertTimeStamp_PutInt(Seg->Text,Now->Wall.tv_sec);
+        break;
+        case e_ITSFmtSeg_MilliSec:
+            Seg->Len=InsertTimeStamp_PutFrac(Seg->Text,
+                    Now->Wall.tv_nsec/1000000,3);
+        break;
+        case e_ITSFmtSeg_MicroSec:
+            Seg->Len=InsertTimeStamp_PutFrac(Seg->Text,
+                    Now->Wall.tv_nsec/1000,6);
+        break;
+        case e_ITSFmtSeg_SinceConnect:
+            Seg->Len=InsertTimeStamp_PutElapsed(Seg->Text,&Fmt->ConnectTime,
+                    &Now->Mono);
+        break;
+        case e_ITSFmtSeg_SinceLastLine:
+            Seg->Len=InsertTimeStamp_PutElapsed(Seg->Text,&Fmt->LastLineTime,
+                    &Now->Mono);
+        break;
+        case e_ITSFmtSeg_Strftime:
+            Seg->Len=strftime(Seg->Text,sizeof(Seg->Text),Seg->Conv,TM);
+        break;
+        case e_ITSFmtSeg_Literal:
+        case e_ITSFmtSegMAX:
+        default:
+        break;
+    }
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_PutElapsed
+ *
+ * SYNOPSIS:
+ *    static unsigned int InsertTimeStamp_PutElapsed(char *Dest,
+ *          const struct timespec *Start,const struct timespec *End);
+ *
+ * PARAMETERS:
+ *    Dest [O] -- Where to put the text (must have room for 28 chars)
+ *    Start [I] -- The start time
+ *    End [I] -- The end time
+ *
+ * FUNCTION:
+ *    This function formats the time between 2 monotonic times as seconds
+ *    with microseconds (S.uuuuuu).
+ *
+ * RETURNS:
+ *    The number of chars written to 'Dest'
+ ******************************************************************************/
+static unsigned int InsertTimeStamp_PutElapsed(char *Dest,
+        const struct timespec *Start,const struct timespec *End)
+{
+    int64_t Sec;
+    int64_t NSec;
+    unsigned int Len;
+
+    Sec=(int64_t)End->tv_sec-(int64_t)Start->tv_sec;
+    NSec=(int64_t)End->tv_nsec-(int64_t)Start->tv_nsec;
+    if(NSec<0)
+    {
+        NSec+=1000000000;
+        Sec--;
+    }
+    if(Sec<0)
+    {
+        Sec=0;
+        NSec=0;
+    }
+
+    Len=InsertTimeStamp_PutInt(Dest,Sec);
+    Dest[Len++]='.';
+    Len+=InsertTimeStamp_PutFrac(&Dest[Len],NSec/1000,6);
+    return Len;
+}
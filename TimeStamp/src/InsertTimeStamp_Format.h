@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_Format.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the compiled version of the timestamp format string.  The
+ *    format is broken into segments once (when the settings are applied) and
+ *    the rendered string is cached so only the parts that changed get redone.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __INSERTTIMESTAMP_FORMAT_H_
+#define __INSERTTIMESTAMP_FORMAT_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+#include <time.h>
+
+/***  DEFINES                          ***/
+#define ITSFORMAT_MAX_SEGMENTS              64
+#define ITSFORMAT_MAX_SEG_TEXT              64
+#define ITSFORMAT_MAX_OUTPUT                256
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+typedef enum
+{
+    e_ITSFmtSeg_Literal,
+    e_ITSFmtSeg_Year,           // %Y
+    e_ITSFmtSeg_Year2,          // %y
+    e_ITSFmtSeg_Century,        // %C
+    e_ITSFmtSeg_Month,          // %m
+    e_ITSFmtSeg_Day,            // %d
+    e_ITSFmtSeg_DaySpace,       // %e
+    e_ITSFmtSeg_DayOfYear,      // %j
+    e_ITSFmtSeg_Hour24,         // %H
+    e_ITSFmtSeg_Hour24Space,    // %k
+    e_ITSFmtSeg_Hour12,         // %I
+    e_ITSFmtSeg_Hour12Space,    // %l
+    e_ITSFmtSeg_Minute,         // %M
+    e_ITSFmtSeg_Second,         // %S
+    e_ITSFmtSeg_WeekDay1,       // %u
+    e_ITSFmtSeg_WeekDay0,       // %w
+    e_ITSFmtSeg_Epoch,          // %s
+    e_ITSFmtSeg_MilliSec,       // %L
+    e_ITSFmtSeg_MicroSec,       // %f
+    e_ITSFmtSeg_SinceConnect,   // %J
+    e_ITSFmtSeg_SinceLastLine,  // %K
+    e_ITSFmtSeg_Strftime,       // Anything else, handed to strftime()
+    e_ITSFmtSegMAX
+} e_ITSFmtSegType;
+
+struct InsertTimeStampTimes
+{
+    struct timespec Wall;       // CLOCK_REALTIME
+    struct timespec Mono;       // CLOCK_MONOTONIC
+};
+
+struct InsertTimeStampFmtSeg
+{
+    e_ITSFmtSegType Type;
+    bool PerSecond;             // Does this change every second
+    bool PerLine;               // Does this change every line
+    char Conv[16];              // The conversion for e_ITSFmtSeg_Strftime
+    char Text[ITSFORMAT_MAX_SEG_TEXT];
+    unsigned int Len;
+};
+
+struct InsertTimeStampFormat
+{
+    struct InsertTimeStampFmtSeg Segs[ITSFORMAT_MAX_SEGMENTS];
+    int SegCount;
+    bool HasTimeFields;
+    bool HasPerLineFields;
+
+    /* Monotonic times for the since connect / delta fields */
+    struct timespec ConnectTime;
+    struct timespec LastLineTime;
+
+    /* The cache */
+    bool CacheValid;
+    time_t CachedSecond;
+    time_t MinuteStart;         // The time 'CachedTM' was at 0 seconds
+    struct tm CachedTM;
+    char Out[ITSFORMAT_MAX_OUTPUT];
+    unsigned int OutLen;
+};
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+void InsertTimeStamp_CompileFormat(struct InsertTimeStampFormat *Fmt,
+        const char *Format);
+void InsertTimeStamp_ResetFormatClock(struct InsertTimeStampFormat *Fmt,
+        const struct InsertTimeStampTimes *Now);
+void InsertTimeStamp_RenderFormat(struct InsertTimeStampFormat *Fmt,
+        const struct InsertTimeStampTimes *Now);
+void InsertTimeStamp_GetTimes(struct InsertTimeStampTimes *Now);
+
+#endif
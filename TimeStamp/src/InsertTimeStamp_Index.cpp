@@ -0,0 +1,230 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_Index.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file writes the timestamp index (sidecar) file.  The file is
+ *    written though a memory mapped window so adding a record is just a
+ *    copy into memory, the OS writes the pages out to disk.  When the
+ *    window fills up the next part of the file is mapped.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "InsertTimeStamp_Index.h"
+#include "InsertTimeStamp_Format.h"
+#include "OS/InsertTimeStamp_MapFile.h"
+#include <string.h>
+
+/*** DEFINES                  ***/
+#define ITSINDEX_WINDOW_SIZE                (4*1024*1024)   // Must be a multiple of 64K and the record size
+#define ITSINDEX_HEADER_SIZE                64
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+struct InsertTimeStampIndexData
+{
+    t_ITSMapFileType *File;
+    uint8_t *Window;
+    uint64_t WindowOffset;      // Where 'Window' is in the file
+    uint32_t WindowPos;         // The next free byte in 'Window'
+    uint64_t RecordCount;
+    struct InsertTimeStampIndexHeader Header;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static inline uint64_t InsertTimeStamp_TS2NS(const struct timespec *ts);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+static inline uint64_t InsertTimeStamp_TS2NS(const struct timespec *ts)
+{
+    return (uint64_t)ts->tv_sec*1000000000ULL+(uint64_t)ts->tv_nsec;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_IndexOpen
+ *
+ * SYNOPSIS:
+ *    t_InsertTimeStampIndexType *InsertTimeStamp_IndexOpen(
+ *          const char *Filename,const struct InsertTimeStampTimes *ConnectTime);
+ *
+ * PARAMETERS:
+ *    Filename [I] -- The index file to create
+ *    ConnectTime [I] -- The time of the connect (stored in the header)
+ *
+ * FUNCTION:
+ *    This function creates a new index file and maps the first window of it.
+ *
+ * RETURNS:
+ *    A handle to the index or NULL if the file could not be created.
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_IndexAppend(), InsertTimeStamp_IndexClose()
+ ******************************************************************************/
+t_InsertTimeStampIndexType *InsertTimeStamp_IndexOpen(const char *Filename,
+        const struct InsertTimeStampTimes *ConnectTime)
+{
+    struct InsertTimeStampIndexData *Index;
+
+    Index=NULL;
+    try
+    {
+        Index=new struct InsertTimeStampIndexData;
+        Index->File=NULL;
+        Index->RecordCount=0;
+
+        memset(&Index->Header,0,sizeof(Index->Header));
+        memcpy(Index->Header.Magic,ITSINDEX_MAGIC,sizeof(Index->Header.Magic));
+        Index->Header.Version=ITSINDEX_VERSION;
+        Index->Header.RecordSize=sizeof(struct InsertTimeStampIndexRec);
+        Index->Header.RecordCount=0;
+        Index->Header.ConnectMonoNS=InsertTimeStamp_TS2NS(&ConnectTime->Mono);
+        Index->Header.ConnectWallNS=InsertTimeStamp_TS2NS(&ConnectTime->Wall);
+
+        Index->File=InsertTimeStamp_OS_MapFileCreate(Filename);
+        if(Index->File==NULL)
+            throw(0);
+
+        Index->WindowOffset=0;
+        Index->Window=InsertTimeStamp_OS_MapFileWindow(Index->File,0,
+                ITSINDEX_WINDOW_SIZE);
+        if(Index->Window==NULL)
+            throw(0);
+
+        /* The header goes at the start of the first window (the record
+           count is filled in when we close) */
+        memcpy(Index->Window,&Index->Header,sizeof(Index->Header));
+        Index->WindowPos=ITSINDEX_HEADER_SIZE;
+    }
+    catch(...)
+    {
+        if(Index!=NULL)
+        {
+            if(Index->File!=NULL)
+                InsertTimeStamp_OS_MapFileClose(Index->File,0);
+            delete Index;
+        }
+        return NULL;
+    }
+
+    return (t_InsertTimeStampIndexType *)Index;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_IndexAppend
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_IndexAppend(t_InsertTimeStampIndexType *Index,
+ *          uint64_t LineNum,uint64_t ByteOffset,
+ *          const struct InsertTimeStampTimes *Now);
+ *
+ * PARAMETERS:
+ *    Index [I] -- The index to add to
+ *    LineNum [I] -- The line number (starting at 1)
+ *    ByteOffset [I] -- The offset of the start of the line in the received
+ *                      bytes
+ *    Now [I] -- The time the line started
+ *
+ * FUNCTION:
+ *    This function adds a record to the index.  This is normally just a
+ *    copy into the mapped window.  When the window is full the next window
+ *    is mapped (every 128K records).
+ *
+ *    If the next window can't be mapped the index stops being written.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_IndexOpen()
+ ******************************************************************************/
+void InsertTimeStamp_IndexAppend(t_InsertTimeStampIndexType *Index,
+        uint64_t LineNum,uint64_t ByteOffset,
+        const struct InsertTimeStampTimes *Now)
+{
+    struct InsertTimeStampIndexData *IData=(struct InsertTimeStampIndexData *)Index;
+    struct InsertTimeStampIndexRec Rec;
+
+    if(IData->Window==NULL)
+        return;
+
+    if(IData->WindowPos+sizeof(Rec)>ITSINDEX_WINDOW_SIZE)
+    {
+        IData->WindowOffset+=ITSINDEX_WINDOW_SIZE;
+        IData->WindowPos=0;
+        IData->Window=InsertTimeStamp_OS_MapFileWindow(IData->File,
+                IData->WindowOffset,ITSINDEX_WINDOW_SIZE);
+        if(IData->Window==NULL)
+            return;
+    }
+
+    Rec.LineNum=LineNum;
+    Rec.ByteOffset=ByteOffset;
+    Rec.MonoNS=InsertTimeStamp_TS2NS(&Now->Mono);
+    Rec.WallNS=InsertTimeStamp_TS2NS(&Now->Wall);
+    memcpy(&IData->Window[IData->WindowPos],&Rec,sizeof(Rec));
+
+    IData->WindowPos+=sizeof(Rec);
+    IData->RecordCount++;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_IndexClose
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_IndexClose(t_InsertTimeStampIndexType *Index);
+ *
+ * PARAMETERS:
+ *    Index [I] -- The index to close
+ *
+ * FUNCTION:
+ *    This function finishes off the index file (sets the record count and
+ *    trims the unused part of the last window) and frees the index.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_IndexOpen()
+ ******************************************************************************/
+void InsertTimeStamp_IndexClose(t_InsertTimeStampIndexType *Index)
+{
+    struct InsertTimeStampIndexData *IData=(struct InsertTimeStampIndexData *)Index;
+    uint64_t FinalSize;
+
+    FinalSize=ITSINDEX_HEADER_SIZE+IData->RecordCount*
+            sizeof(struct InsertTimeStampIndexRec);
+
+    IData->Header.RecordCount=IData->RecordCount;
+    InsertTimeStamp_OS_MapFileWriteAt(IData->File,0,&IData->Header,
+            sizeof(IData->Header));
+    InsertTimeStamp_OS_MapFileClose(IData->File,FinalSize);
+
+    delete IData;
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_Index.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the timestamp index (sidecar) file in it.  The index is a
+ *    header followed by fixed size records, one for each line that was
+ *    timestamped.  The records are in the order they arrived so they can be
+ *    binary searched by time.
+ *
+ *    All the numbers are stored in the byte order of the machine that wrote
+ *    the file.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __INSERTTIMESTAMP_INDEX_H_
+#define __INSERTTIMESTAMP_INDEX_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+#define ITSINDEX_MAGIC                      "WTTSIDX1"
+#define ITSINDEX_VERSION                    1
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+struct InsertTimeStampIndexHeader
+{
+    char Magic[8];              // ITSINDEX_MAGIC (no \0)
+    uint32_t Version;           // ITSINDEX_VERSION
+    uint32_t RecordSize;        // sizeof(struct InsertTimeStampIndexRec)
+    uint64_t RecordCount;       // 0 if the file wasn't closed
+    uint64_t ConnectMonoNS;     // CLOCK_MONOTONIC at connect
+    uint64_t ConnectWallNS;     // CLOCK_REALTIME at connect
+    uint8_t Reserved[24];
+};
+
+struct InsertTimeStampIndexRec
+{
+    uint64_t LineNum;           // First line is 1 (0 = unused record)
+    uint64_t ByteOffset;        // Offset of the line in the received bytes
+    uint64_t MonoNS;            // CLOCK_MONOTONIC when the line started
+    uint64_t WallNS;            // CLOCK_REALTIME when the line started
+};
+
+struct InsertTimeStampIndex {int PrivateDataHere;};
+typedef struct InsertTimeStampIndex t_InsertTimeStampIndexType;
+
+struct InsertTimeStampTimes;
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+t_InsertTimeStampIndexType *InsertTimeStamp_IndexOpen(const char *Filename,
+        const struct InsertTimeStampTimes *ConnectTime);
+void InsertTimeStamp_IndexAppend(t_InsertTimeStampIndexType *Index,
+        uint64_t LineNum,uint64_t ByteOffset,
+        const struct InsertTimeStampTimes *Now);
+void InsertTimeStamp_IndexClose(t_InsertTimeStampIndexType *Index);
+
+#endif
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_MapFile.h
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This has the OS functions for writing a file though a memory mapped
+ *    window.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * HISTORY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *       Created
+ *
+ *******************************************************************************/
+#ifndef __INSERTTIMESTAMP_MAPFILE_H_
+#define __INSERTTIMESTAMP_MAPFILE_H_
+
+/***  HEADER FILES TO INCLUDE          ***/
+#include <stdint.h>
+
+/***  DEFINES                          ***/
+
+/***  MACROS                           ***/
+
+/***  TYPE DEFINITIONS                 ***/
+struct ITSMapFile {int PrivateDataHere;};
+typedef struct ITSMapFile t_ITSMapFileType;
+
+/***  CLASS DEFINITIONS                ***/
+
+/***  GLOBAL VARIABLE DEFINITIONS      ***/
+
+/***  EXTERNAL FUNCTION PROTOTYPES     ***/
+t_ITSMapFileType *InsertTimeStamp_OS_MapFileCreate(const char *Filename);
+uint8_t *InsertTimeStamp_OS_MapFileWindow(t_ITSMapFileType *File,
+        uint64_t Offset,uint32_t Size);
+bool InsertTimeStamp_OS_MapFileWriteAt(t_ITSMapFileType *File,
+        uint64_t Offset,const void *Data,uint32_t Size);
+void InsertTimeStamp_OS_MapFileClose(t_ITSMapFileType *File,
+        uint64_t FinalSize);
+
+#endif
@@ -0,0 +1,259 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_OS_MapFile.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the Linux version of the memory mapped file writer in it.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "../InsertTimeStamp_MapFile.h"
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*** DEFINES                  ***/
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+struct ITSMapFileData
+{
+    int fd;
+    uint8_t *Window;
+    uint32_t WindowSize;
+    uint64_t FileSize;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static void InsertTimeStamp_OS_UnmapWindow(struct ITSMapFileData *Data);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileCreate
+ *
+ * SYNOPSIS:
+ *    t_ITSMapFileType *InsertTimeStamp_OS_MapFileCreate(const char *Filename);
+ *
+ * PARAMETERS:
+ *    Filename [I] -- The file to create.  If it exists it is truncated.
+ *
+ * FUNCTION:
+ *    This function creates a new file to be written with
+ *    InsertTimeStamp_OS_MapFileWindow().
+ *
+ * RETURNS:
+ *    A handle to the file or NULL if it could not be created.
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileWindow(), InsertTimeStamp_OS_MapFileClose()
+ ******************************************************************************/
+t_ITSMapFileType *InsertTimeStamp_OS_MapFileCreate(const char *Filename)
+{
+    struct ITSMapFileData *Data;
+
+    Data=NULL;
+    try
+    {
+        Data=new struct ITSMapFileData;
+        Data->Window=NULL;
+        Data->WindowSize=0;
+        Data->FileSize=0;
+
+        Data->fd=open(Filename,O_RDWR|O_CREAT|O_TRUNC|O_CLOEXEC,0644);
+        if(Data->fd<0)
+            throw(0);
+    }
+    catch(...)
+    {
+        if(Data!=NULL)
+            delete Data;
+        return NULL;
+    }
+
+    return (t_ITSMapFileType *)Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileWindow
+ *
+ * SYNOPSIS:
+ *    uint8_t *InsertTimeStamp_OS_MapFileWindow(t_ITSMapFileType *File,
+ *          uint64_t Offset,uint32_t Size);
+ *
+ * PARAMETERS:
+ *    File [I] -- The file to map
+ *    Offset [I] -- The offset into the file to map.  This must be a multiple
+ *                  of 64K.
+ *    Size [I] -- The number of bytes to map
+ *
+ * FUNCTION:
+ *    This function maps part of the file into memory so it can be written
+ *    to.  The file is grown to cover the window if needed.  Any window
+ *    that was mapped before is unmapped (so pointers to it are no longer
+ *    valid).
+ *
+ *    The disk space for the window is allocated before it is mapped.  A
+ *    sparse file would have the page faults that fill it in fail with
+ *    SIGBUS when the disk is full, this way we return NULL instead.
+ *
+ *    The pages are written back to the disk by the OS, the caller just
+ *    writes to memory.
+ *
+ * RETURNS:
+ *    A pointer to the start of the window or NULL if there was an error.
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileCreate()
+ ******************************************************************************/
+uint8_t *InsertTimeStamp_OS_MapFileWindow(t_ITSMapFileType *File,
+        uint64_t Offset,uint32_t Size)
+{
+    struct ITSMapFileData *Data=(struct ITSMapFileData *)File;
+    void *Mem;
+
+    InsertTimeStamp_OS_UnmapWindow(Data);
+
+    if(Offset+Size>Data->FileSize)
+    {
+        /* posix_fallocate() returns the error (it doesn't set errno) */
+        if(posix_fallocate(Data->fd,Data->FileSize,
+                Offset+Size-Data->FileSize)!=0)
+        {
+            return NULL;
+        }
+        Data->FileSize=Offset+Size;
+    }
+
+    Mem=mmap(NULL,Size,PROT_READ|PROT_WRITE,MAP_SHARED,Data->fd,Offset);
+    if(Mem==MAP_FAILED)
+        return NULL;
+
+    Data->Window=(uint8_t *)Mem;
+    Data->WindowSize=Size;
+
+    return Data->Window;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileWriteAt
+ *
+ * SYNOPSIS:
+ *    bool InsertTimeStamp_OS_MapFileWriteAt(t_ITSMapFileType *File,
+ *          uint64_t Offset,const void *Data,uint32_t Size);
+ *
+ * PARAMETERS:
+ *    File [I] -- The file to write to
+ *    Offset [I] -- Where in the file to write
+ *    Data [I] -- The data to write
+ *    Size [I] -- The number of bytes to write
+ *
+ * FUNCTION:
+ *    This function does a normal write to the file (without mapping it).
+ *    This is for things like headers that are only updated once in a while.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- There was an error
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileWindow()
+ ******************************************************************************/
+bool InsertTimeStamp_OS_MapFileWriteAt(t_ITSMapFileType *File,
+        uint64_t Offset,const void *Data,uint32_t Size)
+{
+    struct ITSMapFileData *FData=(struct ITSMapFileData *)File;
+    const uint8_t *Pos;
+    ssize_t Written;
+
+    Pos=(const uint8_t *)Data;
+    while(Size>0)
+    {
+        Written=pwrite(FData->fd,Pos,Size,Offset);
+        if(Written<0)
+        {
+            if(errno==EINTR)
+                continue;
+            return false;
+        }
+        Pos+=Written;
+        Offset+=Written;
+        Size-=Written;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileClose
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_OS_MapFileClose(t_ITSMapFileType *File,
+ *          uint64_t FinalSize);
+ *
+ * PARAMETERS:
+ *    File [I] -- The file to close
+ *    FinalSize [I] -- The size to cut the file down to (the windows grow
+ *                     the file in big steps)
+ *
+ * FUNCTION:
+ *    This function unmaps any window, sets the file size, and closes the
+ *    file.  The handle is freed.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileCreate()
+ ******************************************************************************/
+void InsertTimeStamp_OS_MapFileClose(t_ITSMapFileType *File,
+        uint64_t FinalSize)
+{
+    struct ITSMapFileData *Data=(struct ITSMapFileData *)File;
+
+    InsertTimeStamp_OS_UnmapWindow(Data);
+
+    if(ftruncate(Data->fd,FinalSize)<0)
+    {
+        /* Nothing we can do, the reader will ignore the unused records */
+    }
+    close(Data->fd);
+
+    delete Data;
+}
+
+static void InsertTimeStamp_OS_UnmapWindow(struct ITSMapFileData *Data)
+{
+    if(Data->Window!=NULL)
+        munmap(Data->Window,Data->WindowSize);
+    Data->Window=NULL;
+    Data->WindowSize=0;
+}
@@ -0,0 +1,251 @@
+/*******************************************************************************
+ * FILENAME: InsertTimeStamp_OS_MapFile.cpp
+ *
+ * PROJECT:
+ *    Whippy Term
+ *
+ * FILE DESCRIPTION:
+ *    This file has the Windows version of the memory mapped file writer in it.
+ *
+ * COPYRIGHT:
+ *    Copyright 2025 Paul Hutchinson.
+ *
+ *    This program is free software: you can redistribute it and/or modify it
+ *    under the terms of the GNU General Public License as published by the
+ *    Free Software Foundation, either version 3 of the License, or (at your
+ *    option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program. If not, see https://www.gnu.org/licenses/.
+ *
+ * CREATED BY:
+ *    Paul Hutchinson (18 Oct 2025)
+ *
+ ******************************************************************************/
+
+/*** HEADER FILES TO INCLUDE  ***/
+#include "../InsertTimeStamp_MapFile.h"
+#include <windows.h>
+#include <string.h>
+
+/*** DEFINES                  ***/
+
+/*** MACROS                   ***/
+
+/*** TYPE DEFINITIONS         ***/
+struct ITSMapFileData
+{
+    HANDLE hFile;
+    HANDLE hMapping;
+    uint8_t *Window;
+    uint64_t FileSize;
+};
+
+/*** FUNCTION PROTOTYPES      ***/
+static void InsertTimeStamp_OS_UnmapWindow(struct ITSMapFileData *Data);
+
+/*** VARIABLE DEFINITIONS     ***/
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileCreate
+ *
+ * SYNOPSIS:
+ *    t_ITSMapFileType *InsertTimeStamp_OS_MapFileCreate(const char *Filename);
+ *
+ * PARAMETERS:
+ *    Filename [I] -- The file to create.  If it exists it is truncated.
+ *
+ * FUNCTION:
+ *    This function creates a new file to be written with
+ *    InsertTimeStamp_OS_MapFileWindow().
+ *
+ * RETURNS:
+ *    A handle to the file or NULL if it could not be created.
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileWindow(), InsertTimeStamp_OS_MapFileClose()
+ ******************************************************************************/
+t_ITSMapFileType *InsertTimeStamp_OS_MapFileCreate(const char *Filename)
+{
+    struct ITSMapFileData *Data;
+
+    Data=NULL;
+    try
+    {
+        Data=new struct ITSMapFileData;
+        Data->hMapping=NULL;
+        Data->Window=NULL;
+        Data->FileSize=0;
+
+        Data->hFile=CreateFileA(Filename,GENERIC_READ|GENERIC_WRITE,
+                FILE_SHARE_READ,NULL,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL,NULL);
+        if(Data->hFile==INVALID_HANDLE_VALUE)
+            throw(0);
+    }
+    catch(...)
+    {
+        if(Data!=NULL)
+            delete Data;
+        return NULL;
+    }
+
+    return (t_ITSMapFileType *)Data;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileWindow
+ *
+ * SYNOPSIS:
+ *    uint8_t *InsertTimeStamp_OS_MapFileWindow(t_ITSMapFileType *File,
+ *          uint64_t Offset,uint32_t Size);
+ *
+ * PARAMETERS:
+ *    File [I] -- The file to map
+ *    Offset [I] -- The offset into the file to map.  This must be a multiple
+ *                  of 64K.
+ *    Size [I] -- The number of bytes to map
+ *
+ * FUNCTION:
+ *    This function maps part of the file into memory so it can be written
+ *    to.  The file is grown to cover the window if needed.  Any window
+ *    that was mapped before is unmapped (so pointers to it are no longer
+ *    valid).
+ *
+ * RETURNS:
+ *    A pointer to the start of the window or NULL if there was an error.
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileCreate()
+ ******************************************************************************/
+uint8_t *InsertTimeStamp_OS_MapFileWindow(t_ITSMapFileType *File,
+        uint64_t Offset,uint32_t Size)
+{
+    struct ITSMapFileData *Data=(struct ITSMapFileData *)File;
+    uint64_t NewSize;
+    void *Mem;
+
+    InsertTimeStamp_OS_UnmapWindow(Data);
+
+    /* The mapping object sets the size of the file */
+    NewSize=Offset+Size;
+    if(NewSize<Data->FileSize)
+        NewSize=Data->FileSize;
+    Data->hMapping=CreateFileMappingA(Data->hFile,NULL,PAGE_READWRITE,
+            (DWORD)(NewSize>>32),(DWORD)(NewSize&0xFFFFFFFF),NULL);
+    if(Data->hMapping==NULL)
+        return NULL;
+    Data->FileSize=NewSize;
+
+    Mem=MapViewOfFile(Data->hMapping,FILE_MAP_WRITE,(DWORD)(Offset>>32),
+            (DWORD)(Offset&0xFFFFFFFF),Size);
+    if(Mem==NULL)
+    {
+        CloseHandle(Data->hMapping);
+        Data->hMapping=NULL;
+        return NULL;
+    }
+
+    Data->Window=(uint8_t *)Mem;
+
+    return Data->Window;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileWriteAt
+ *
+ * SYNOPSIS:
+ *    bool InsertTimeStamp_OS_MapFileWriteAt(t_ITSMapFileType *File,
+ *          uint64_t Offset,const void *Data,uint32_t Size);
+ *
+ * PARAMETERS:
+ *    File [I] -- The file to write to
+ *    Offset [I] -- Where in the file to write
+ *    Data [I] -- The data to write
+ *    Size [I] -- The number of bytes to write
+ *
+ * FUNCTION:
+ *    This function does a normal write to the file (without mapping it).
+ *    This is for things like headers that are only updated once in a while.
+ *
+ * RETURNS:
+ *    true -- Things worked out
+ *    false -- There was an error
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileWindow()
+ ******************************************************************************/
+bool InsertTimeStamp_OS_MapFileWriteAt(t_ITSMapFileType *File,
+        uint64_t Offset,const void *Data,uint32_t Size)
+{
+    struct ITSMapFileData *FData=(struct ITSMapFileData *)File;
+    OVERLAPPED Overlapped;
+    DWORD Written;
+
+    memset(&Overlapped,0,sizeof(Overlapped));
+    Overlapped.Offset=(DWORD)(Offset&0xFFFFFFFF);
+    Overlapped.OffsetHigh=(DWORD)(Offset>>32);
+
+    if(!WriteFile(FData->hFile,Data,Size,&Written,&Overlapped) ||
+            Written!=Size)
+    {
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * NAME:
+ *    InsertTimeStamp_OS_MapFileClose
+ *
+ * SYNOPSIS:
+ *    void InsertTimeStamp_OS_MapFileClose(t_ITSMapFileType *File,
+ *          uint64_t FinalSize);
+ *
+ * PARAMETERS:
+ *    File [I] -- The file to close
+ *    FinalSize [I] -- The size to cut the file down to (the windows grow
+ *                     the file in big steps)
+ *
+ * FUNCTION:
+ *    This function unmaps any window, sets the file size, and closes the
+ *    file.  The handle is freed.
+ *
+ * RETURNS:
+ *    NONE
+ *
+ * SEE ALSO:
+ *    InsertTimeStamp_OS_MapFileCreate()
+ ******************************************************************************/
+void InsertTimeStamp_OS_MapFileClose(t_ITSMapFileType *File,
+        uint64_t FinalSize)
+{
+    struct ITSMapFileData *Data=(struct ITSMapFileData *)File;
+    LARGE_INTEGER Pos;
+
+    InsertTimeStamp_OS_UnmapWindow(Data);
+
+    Pos.QuadPart=FinalSize;
+    if(SetFilePointerEx(Data->hFile,Pos,NULL,FILE_BEGIN))
+        SetEndOfFile(Data->hFile);
+    CloseHandle(Data->hFile);
+
+    delete Data;
+}
+
+static void InsertTimeStamp_OS_UnmapWindow(struct ITSMapFileData *Data)
+{
+    if(Data->Window!=NULL)
+        UnmapViewOfFile(Data->Window);
+    if(Data->hMapping!=NULL)
+        CloseHandle(Data->hMapping);
+    Data->Window=NULL;
+    Data->hMapping=NULL;
+}